@@ -12,10 +12,13 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <nlohmann/json.hpp>
 
 #include "config/system_info.h"
 #include "config/optimism_config.h"
+#include "config/log_config.h"
+#include "config/metrics_config.h"
 #include "config/process_config.h"
 
 /**
@@ -29,7 +32,11 @@ public:
   std::string version;
   SystemInfo systemInfo;
   OptimismConfig optimismConfig;
+  LogConfig logConfig;
+  MetricsConfig metricsConfig;
   ProcessConfig processConfig;
+  // 配置文件中未登记的键 key: JSON Pointer value: 原始值 保存时原样写回
+  std::map<std::string, nlohmann::json> unknownFields;
 
   // 构造函数
   AppConfig();
@@ -53,11 +60,11 @@ public:
   bool operator==(const AppConfig &other) const;
   bool operator!=(const AppConfig &other) const;
 
-  // 转换为 JSON 对象
-  // nlohmann::json toJson() const;
+  // 转换为 JSON 对象 不包含未登记的键
+  nlohmann::ordered_json toJson() const;
 
   // 从 JSON 对象转换
-  // void fromJson(const nlohmann::json &json);
+  void fromJson(const nlohmann::json &json);
 
   // 转换为字符串
   std::string toString() const;
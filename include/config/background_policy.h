@@ -0,0 +1,55 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 10:12:31
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 10:12:31
+ * @FilePath: \GameOptimizerPro\include\config\background_policy.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * @class BackgroundPolicy
+ * @brief 后台策略配置类，负责存储游戏会话期间对后台进程采取的措施
+ * @note 该类使用 nlohmann::json 库来处理 JSON 数据
+ */
+class BackgroundPolicy
+{
+public:
+  BackgroundPolicy();
+  ~BackgroundPolicy();
+
+  // 是否在游戏时对后台进程启用能效模式 (EcoQoS)
+  bool efficiencyMode = false;
+  // 是否对游戏进程树之外的所有进程启用能效模式，否则只作用于后台进程列表
+  bool throttleAllBackground = false;
+  // 是否在游戏启动时回收后台进程的工作集
+  bool trimWorkingSet = false;
+  // 单次回收的内存预算 (MB)，回收量达到预算后停止，0 表示不限制
+  int trimBudgetMB = 1024;
+  // 不回收工作集的进程名列表 (如语音、录制软件)
+  std::vector<std::string> trimExclusionList;
+  // 是否在游戏时监视内存压力，并在内存不足时分级回收后台进程内存
+  bool memoryPressureResponse = false;
+
+  // 赋值运算符
+  BackgroundPolicy &operator=(const BackgroundPolicy &other);
+
+  // 移动赋值运算符
+  BackgroundPolicy &operator=(BackgroundPolicy &&other) noexcept;
+
+  // 比较运算符
+  bool operator==(const BackgroundPolicy &other) const;
+  bool operator!=(const BackgroundPolicy &other) const;
+
+  std::string toString() const;
+  void fromJson(const nlohmann::json &json);
+  nlohmann::ordered_json toJson() const;
+  void clear();
+};
@@ -0,0 +1,78 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 14:20:36
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 14:20:36
+ * @FilePath: \GameOptimizerPro\include\config\config_diff.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "config/app_config.h"
+
+/**
+ * @class ConfigDiff
+ * @brief 配置差异类，记录两份配置之间哪些设置发生了变化
+ * @note 配置热更新时只把发生变化的设置下发给对应的模块，
+ *       每个标志对应一个可以独立应用的设置（一个开关及其参数）
+ */
+class ConfigDiff
+{
+public:
+  // 开机自启动
+  bool autoStartUp = false;
+  // 自动限制反作弊开关
+  bool autoLimitAntiCheat = false;
+  // 电源计划（开关或GUID）
+  bool powerPlan = false;
+  // 限制后台活动
+  bool limitBackgroundActivity = false;
+  // 网络延迟优化
+  bool optimizeNetworkDelay = false;
+  // 系统调度优化
+  bool optimizeSystemScheduling = false;
+  // 系统服务优化
+  bool optimizeSystemService = false;
+  // 后台能效模式（开关或作用范围）
+  bool backgroundEfficiency = false;
+  // 游戏时回收内存（开关、预算或排除列表）
+  bool workingSetTrim = false;
+  // 内存压力响应（开关、预算或排除列表）
+  bool memoryPressureResponse = false;
+  // 游戏文件预读（开关或预算）
+  bool gamePrefetch = false;
+  // 日志写入方式（异步开关、刷盘策略或输出格式）
+  bool logging = false;
+  // 指标导出（开关、文件路径或间隔）
+  bool metrics = false;
+  // 游戏进程列表
+  bool gameProcessList = false;
+  // 反作弊进程列表
+  bool antiCheatProcessList = false;
+  // 后台进程列表
+  bool backgroundProcessList = false;
+
+  /**
+   * @brief 计算两份配置之间的差异
+   * @param {AppConfig} &oldConfig 当前生效的配置
+   * @param {AppConfig} &newConfig 新配置
+   * @return {ConfigDiff} 配置差异
+   */
+  static ConfigDiff compute(const AppConfig &oldConfig, const AppConfig &newConfig);
+
+  /**
+   * @brief 是否没有任何需要应用的变化
+   * @return {bool}
+   */
+  bool empty() const;
+
+  /**
+   * @brief 发生变化的设置名称列表，用于日志
+   * @return {string}
+   */
+  std::string toString() const;
+};
@@ -0,0 +1,379 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:52:36
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:52:36
+ * @FilePath: \GameOptimizerPro\include\config\config_reflection.h
+ * @Description: 配置类的编译期字段描述，序列化、反序列化和各配置类的 toJson/fromJson 都由字段描述驱动
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "config/app_config.h"
+
+/**
+ * @struct ConfigField
+ * @brief 配置字段描述符，记录字段在 JSON 中的键名和对应的成员指针
+ */
+template <typename Owner, typename Member>
+struct ConfigField
+{
+  using OwnerType = Owner;
+  using MemberType = Member;
+
+  const char *key;
+  Member Owner::*member;
+};
+
+template <typename Owner, typename Member>
+constexpr ConfigField<Owner, Member> configField(const char *key, Member Owner::*member)
+{
+  return ConfigField<Owner, Member>{key, member};
+}
+
+/**
+ * @struct ConfigSchema
+ * @brief 配置类的字段列表，fields() 返回 ConfigField 的 tuple，顺序即保存到文件中的顺序
+ * @note 新增配置字段时只需在对应的特化中登记一次
+ */
+template <typename T>
+struct ConfigSchema;
+
+template <>
+struct ConfigSchema<SystemInfo>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("os", &SystemInfo::os),
+        configField("arch", &SystemInfo::arch),
+        configField("cpu", &SystemInfo::cpu));
+  }
+};
+
+template <>
+struct ConfigSchema<PowerPlan>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("optimizePowerPlan", &PowerPlan::optimizePowerPlan),
+        configField("lockPowerPlan", &PowerPlan::lockPowerPlan),
+        configField("powerPlanGuid", &PowerPlan::powerPlanGuid));
+  }
+};
+
+template <>
+struct ConfigSchema<BackgroundPolicy>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("efficiencyMode", &BackgroundPolicy::efficiencyMode),
+        configField("throttleAllBackground", &BackgroundPolicy::throttleAllBackground),
+        configField("trimWorkingSet", &BackgroundPolicy::trimWorkingSet),
+        configField("trimBudgetMB", &BackgroundPolicy::trimBudgetMB),
+        configField("trimExclusionList", &BackgroundPolicy::trimExclusionList),
+        configField("memoryPressureResponse", &BackgroundPolicy::memoryPressureResponse));
+  }
+};
+
+template <>
+struct ConfigSchema<OptimismConfig>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("autoStartUp", &OptimismConfig::autoStartUp),
+        configField("autoLimitAntiCheat", &OptimismConfig::autoLimitAntiCheat),
+        configField("powerPlan", &OptimismConfig::powerPlan),
+        configField("limitBackgroundActivity", &OptimismConfig::limitBackgroundActivity),
+        configField("optimizeNetworkDelay", &OptimismConfig::optimizeNetworkDelay),
+        configField("optimizeSystemScheduling", &OptimismConfig::optimizeSystemScheduling),
+        configField("optimizeSystemService", &OptimismConfig::optimizeSystemService),
+        configField("gamePrefetch", &OptimismConfig::gamePrefetch),
+        configField("prefetchBudgetMB", &OptimismConfig::prefetchBudgetMB),
+        configField("backgroundPolicy", &OptimismConfig::backgroundPolicy));
+  }
+};
+
+template <>
+struct ConfigSchema<LogLevels>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("default", &LogLevels::defaultLevel),
+        configField("process", &LogLevels::process),
+        configField("registry", &LogLevels::registry),
+        configField("power", &LogLevels::power),
+        configField("service", &LogLevels::service),
+        configField("config", &LogLevels::config),
+        configField("ui", &LogLevels::ui));
+  }
+};
+
+template <>
+struct ConfigSchema<LogConfig>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("asyncLogging", &LogConfig::asyncLogging),
+        configField("flushPolicy", &LogConfig::flushPolicy),
+        configField("flushIntervalMs", &LogConfig::flushIntervalMs),
+        configField("format", &LogConfig::format),
+        configField("maxFileSizeMB", &LogConfig::maxFileSizeMB),
+        configField("rotateIntervalHours", &LogConfig::rotateIntervalHours),
+        configField("maxArchiveFiles", &LogConfig::maxArchiveFiles),
+        configField("compressArchives", &LogConfig::compressArchives),
+        configField("rateLimitBurst", &LogConfig::rateLimitBurst),
+        configField("rateLimitWindowSeconds", &LogConfig::rateLimitWindowSeconds),
+        configField("flightRecorder", &LogConfig::flightRecorder),
+        configField("levels", &LogConfig::levels));
+  }
+};
+
+template <>
+struct ConfigSchema<MetricsConfig>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("enabled", &MetricsConfig::enabled),
+        configField("filePath", &MetricsConfig::filePath),
+        configField("exportIntervalSeconds", &MetricsConfig::exportIntervalSeconds),
+        configField("traceGameSession", &MetricsConfig::traceGameSession));
+  }
+};
+
+template <>
+struct ConfigSchema<ProcessInfo>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("name", &ProcessInfo::name),
+        configField("status", &ProcessInfo::status),
+        configField("processList", &ProcessInfo::processList),
+        configField("ioPriority", &ProcessInfo::ioPriority));
+  }
+};
+
+template <>
+struct ConfigSchema<ProcessConfig>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("gameProcessList", &ProcessConfig::gameProcessList),
+        configField("antiCheatProcessList", &ProcessConfig::antiCheatProcessList),
+        configField("backgroundProcessList", &ProcessConfig::backgroundProcessList));
+  }
+};
+
+template <>
+struct ConfigSchema<AppConfig>
+{
+  static constexpr auto fields()
+  {
+    return std::make_tuple(
+        configField("version", &AppConfig::version),
+        configField("systemInfo", &AppConfig::systemInfo),
+        configField("optimismConfig", &AppConfig::optimismConfig),
+        configField("logConfig", &AppConfig::logConfig),
+        configField("metricsConfig", &AppConfig::metricsConfig),
+        configField("processConfig", &AppConfig::processConfig));
+  }
+};
+
+namespace ConfigReflection
+{
+  // 是否为登记了字段描述的配置类
+  template <typename T, typename = void>
+  struct IsConfigObject : std::false_type
+  {
+  };
+
+  template <typename T>
+  struct IsConfigObject<T, std::void_t<decltype(ConfigSchema<T>::fields())>> : std::true_type
+  {
+  };
+
+  template <typename T>
+  struct IsVector : std::false_type
+  {
+  };
+
+  template <typename T>
+  struct IsVector<std::vector<T>> : std::true_type
+  {
+  };
+
+  /**
+   * @brief 按声明顺序访问配置类的每个字段描述符
+   */
+  template <typename T, typename Visitor>
+  void forEachField(Visitor &&visitor)
+  {
+    std::apply([&visitor](const auto &...fields)
+               { (visitor(fields), ...); },
+               ConfigSchema<T>::fields());
+  }
+
+  /**
+   * @brief 配置类的字段数量
+   */
+  template <typename T>
+  constexpr size_t fieldCount()
+  {
+    return std::tuple_size<decltype(ConfigSchema<T>::fields())>::value;
+  }
+
+  /**
+   * @brief 按键名查找字段下标
+   * @return {int} 字段下标 未登记的键返回 -1
+   */
+  template <typename T>
+  int findField(const std::string &key)
+  {
+    int index = 0;
+    int found = -1;
+    forEachField<T>([&](const auto &field)
+                    {
+                      if (found < 0 && std::strcmp(field.key, key.c_str()) == 0)
+                      {
+                        found = index;
+                      }
+                      ++index; });
+    return found;
+  }
+
+  /**
+   * @brief 按下标访问字段描述符
+   */
+  template <typename T, typename Visitor>
+  void visitField(int fieldIndex, Visitor &&visitor)
+  {
+    int index = 0;
+    forEachField<T>([&](const auto &field)
+                    {
+                      if (index++ == fieldIndex)
+                      {
+                        visitor(field);
+                      } });
+  }
+
+  /**
+   * @brief 字段取该值时不写入文件 保持配置文件简洁
+   */
+  template <typename T>
+  bool isOmitted(const T &)
+  {
+    return false;
+  }
+
+  inline bool isOmitted(const IoPriority &ioPriority)
+  {
+    return ioPriority == IoPriority::UNCHANGED;
+  }
+
+  // ---- 基于 nlohmann::json DOM 的转换，供各配置类的 toJson/fromJson 使用 ----
+
+  template <typename T>
+  nlohmann::ordered_json toJson(const T &value);
+
+  inline nlohmann::ordered_json valueToJson(const IoPriority &ioPriority)
+  {
+    return ProcessInfo::ioPriorityToString(ioPriority);
+  }
+
+  template <typename T>
+  nlohmann::ordered_json valueToJson(const T &value)
+  {
+    if constexpr (IsConfigObject<T>::value)
+    {
+      return toJson(value);
+    }
+    else if constexpr (IsVector<T>::value)
+    {
+      nlohmann::ordered_json array = nlohmann::ordered_json::array();
+      for (const auto &element : value)
+      {
+        array.push_back(valueToJson(element));
+      }
+      return array;
+    }
+    else
+    {
+      return nlohmann::ordered_json(value);
+    }
+  }
+
+  template <typename T>
+  nlohmann::ordered_json toJson(const T &value)
+  {
+    nlohmann::ordered_json json = nlohmann::ordered_json::object();
+    forEachField<T>([&](const auto &field)
+                    {
+                      const auto &member = value.*(field.member);
+                      if (!isOmitted(member))
+                      {
+                        json[field.key] = valueToJson(member);
+                      } });
+    return json;
+  }
+
+  template <typename Json, typename T>
+  void fromJson(const Json &json, T &value);
+
+  template <typename Json>
+  void valueFromJson(const Json &json, IoPriority &ioPriority)
+  {
+    ioPriority = ProcessInfo::ioPriorityFromString(json.template get<std::string>());
+  }
+
+  template <typename Json, typename T>
+  void valueFromJson(const Json &json, T &value)
+  {
+    if constexpr (IsConfigObject<T>::value)
+    {
+      fromJson(json, value);
+    }
+    else if constexpr (IsVector<T>::value)
+    {
+      value.clear();
+      for (const auto &element : json)
+      {
+        value.emplace_back();
+        valueFromJson(element, value.back());
+      }
+    }
+    else
+    {
+      value = json.template get<T>();
+    }
+  }
+
+  template <typename Json, typename T>
+  void fromJson(const Json &json, T &value)
+  {
+    forEachField<T>([&](const auto &field)
+                    {
+                      auto it = json.find(field.key);
+                      if (it != json.end())
+                      {
+                        valueFromJson(*it, value.*(field.member));
+                      } });
+  }
+} // namespace ConfigReflection
@@ -0,0 +1,45 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 16:05:12
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 16:05:12
+ * @FilePath: \GameOptimizerPro\include\config\config_serializer.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <istream>
+#include <string>
+
+#include "config/app_config.h"
+
+/**
+ * @class ConfigSerializer
+ * @brief 配置文件序列化类，由 ConfigSchema 中的字段描述驱动
+ *
+ * 读取时使用 SAX 单次遍历配置文件，事件直接写入配置对象的成员，不构建 JSON DOM；
+ * 写出时按字段描述顺序流式生成与 dump(4) 相同格式的文本。
+ * 未登记的键按 JSON Pointer 保存在 AppConfig::unknownFields 中，保存时原样写回。
+ */
+class ConfigSerializer
+{
+public:
+  /**
+   * @brief 解析配置文件
+   * @param {istream} &input 配置文件流
+   * @param {AppConfig} &config 传入默认配置 文件中出现的字段覆盖默认值
+   * @param {string} &error 失败时的错误描述
+   * @return {bool} 是否解析成功
+   * @note 类型不符的字段和非法进程名会被忽略并记录警告，不影响其他字段
+   */
+  static bool read(std::istream &input, AppConfig &config, std::string &error);
+
+  /**
+   * @brief 序列化配置
+   * @param {AppConfig} &config 配置
+   * @return {string} 4 空格缩进的 JSON 文本，配置嵌套在 appConfig 键下
+   */
+  static std::string write(const AppConfig &config);
+};
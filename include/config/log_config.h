@@ -0,0 +1,68 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 16:58:14
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 16:58:14
+ * @FilePath: \GameOptimizerPro\include\config\log_config.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include "config/log_levels.h"
+
+/**
+ * @class LogConfig
+ * @brief 日志配置类，负责存储日志写入方式的相关配置
+ * @note 该类使用 nlohmann::json 库来处理 JSON 数据
+ */
+class LogConfig
+{
+public:
+  LogConfig();
+  ~LogConfig();
+
+  // 是否使用后台线程异步写日志
+  bool asyncLogging = true;
+  // 异步模式的刷盘策略 batch: 每批刷盘 interval: 按间隔刷盘 error: 出现警告或错误时刷盘
+  std::string flushPolicy;
+  // interval 策略的刷盘间隔 毫秒
+  int flushIntervalMs = 1000;
+  // 输出格式 text: 文本日志 binary: 二进制日志（使用 LogDecoder 转换为文本）
+  std::string format;
+  // 单个日志文件的大小上限 MB 超过后轮换 0 表示不按大小轮换
+  int maxFileSizeMB = 10;
+  // 按时间轮换的间隔 小时 24 即每天零点轮换 0 表示不按时间轮换
+  int rotateIntervalHours = 24;
+  // 保留的历史日志分段数量
+  int maxArchiveFiles = 10;
+  // 是否在后台压缩历史日志分段
+  bool compressArchives = true;
+  // 限流日志点每个错误码在一个窗口内最多写出的记录数 0 表示不限流
+  int rateLimitBurst = 10;
+  // 限流窗口 秒 超出的记录合并为每个窗口一条汇总
+  int rateLimitWindowSeconds = 10;
+  // 是否在内存中保存最近的全部日志 崩溃或严重错误时转储
+  bool flightRecorder = true;
+  // 默认级别和各模块的级别
+  LogLevels levels;
+
+  // 赋值运算符
+  LogConfig &operator=(const LogConfig &other);
+
+  // 移动赋值运算符
+  LogConfig &operator=(LogConfig &&other) noexcept;
+
+  // 比较运算符
+  bool operator==(const LogConfig &other) const;
+  bool operator!=(const LogConfig &other) const;
+
+  std::string toString() const;
+  void fromJson(const nlohmann::json &json);
+  nlohmann::ordered_json toJson() const;
+  void clear();
+};
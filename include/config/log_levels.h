@@ -0,0 +1,57 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 18:52:26
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 18:52:26
+ * @FilePath: \GameOptimizerPro\include\config\log_levels.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+/**
+ * @class LogLevels
+ * @brief 日志级别配置类，负责存储默认级别和各模块的级别
+ * @note 级别取值 debug/info/warn/error/off，模块级别为空时使用默认级别
+ * @note 该类使用 nlohmann::json 库来处理 JSON 数据
+ */
+class LogLevels
+{
+public:
+  LogLevels();
+  ~LogLevels();
+
+  // 默认级别
+  std::string defaultLevel;
+  // 进程监视、后台进程管理
+  std::string process;
+  // 注册表
+  std::string registry;
+  // 电源计划
+  std::string power;
+  // 系统服务
+  std::string service;
+  // 配置读写、游戏数据库
+  std::string config;
+  // 界面、托盘
+  std::string ui;
+
+  // 赋值运算符
+  LogLevels &operator=(const LogLevels &other);
+
+  // 移动赋值运算符
+  LogLevels &operator=(LogLevels &&other) noexcept;
+
+  // 比较运算符
+  bool operator==(const LogLevels &other) const;
+  bool operator!=(const LogLevels &other) const;
+
+  std::string toString() const;
+  void fromJson(const nlohmann::json &json);
+  nlohmann::ordered_json toJson() const;
+  void clear();
+};
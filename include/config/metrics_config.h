@@ -0,0 +1,50 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 21:04:46
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 21:04:46
+ * @FilePath: \GameOptimizerPro\include\config\metrics_config.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+/**
+ * @class MetricsConfig
+ * @brief 指标配置类，负责存储运行指标导出的相关配置
+ * @note 该类使用 nlohmann::json 库来处理 JSON 数据
+ */
+class MetricsConfig
+{
+public:
+  MetricsConfig();
+  ~MetricsConfig();
+
+  // 是否定期导出运行指标
+  bool enabled = true;
+  // 导出文件路径 OpenMetrics 文本格式
+  std::string filePath;
+  // 导出间隔 秒
+  int exportIntervalSeconds = 15;
+  // 是否追踪游戏会话 会话开始时开启性能追踪 结束时导出到日志目录
+  bool traceGameSession = false;
+
+  // 赋值运算符
+  MetricsConfig &operator=(const MetricsConfig &other);
+
+  // 移动赋值运算符
+  MetricsConfig &operator=(MetricsConfig &&other) noexcept;
+
+  // 比较运算符
+  bool operator==(const MetricsConfig &other) const;
+  bool operator!=(const MetricsConfig &other) const;
+
+  std::string toString() const;
+  void fromJson(const nlohmann::json &json);
+  nlohmann::ordered_json toJson() const;
+  void clear();
+};
@@ -11,6 +11,7 @@
 
 #include <nlohmann/json.hpp>
 #include "config/power_plan.h"
+#include "config/background_policy.h"
 
 /**
  * @class OptimismConfig
@@ -38,6 +39,12 @@ public:
   bool optimizeSystemScheduling = false;
   // 是否优化系统服务
   bool optimizeSystemService = false;
+  // 后台策略
+  BackgroundPolicy backgroundPolicy;
+  // 是否在游戏启动时预读游戏文件
+  bool gamePrefetch = false;
+  // 单次预读的 I/O 预算 (MB)，0 表示不限制
+  int prefetchBudgetMB = 2048;
 
   //赋值运算符
   OptimismConfig &operator=(const OptimismConfig &other);
@@ -49,7 +56,7 @@ public:
   bool operator==(const OptimismConfig &other) const;
   bool operator!=(const OptimismConfig &other) const;
 
-  nlohmann::json toJson() const;
+  nlohmann::ordered_json toJson() const;
   void fromJson(const nlohmann::json &json);
 
   std::string toString() const;
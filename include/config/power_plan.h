@@ -44,6 +44,6 @@ public:
   
   std::string toString() const;
   void fromJson(const nlohmann::json &json);
-  nlohmann::json toJson() const;
+  nlohmann::ordered_json toJson() const;
   void clear();
 };
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <nlohmann/json.hpp>
 
 #include "config/process_info.h"
@@ -25,6 +26,8 @@ public:
   std::vector<ProcessInfo> gameProcessList;
   // 反作弊进程列表
   std::vector<ProcessInfo> antiCheatProcessList;
+  // 后台进程列表（游戏时启用能效模式等后台策略）
+  std::vector<ProcessInfo> backgroundProcessList;
 
   // 赋值运算符
   ProcessConfig &operator=(const ProcessConfig &other);
@@ -36,7 +39,21 @@ public:
   bool operator==(const ProcessConfig &other) const;
   bool operator!=(const ProcessConfig &other) const;
 
-  nlohmann::json toJson() const;
+  /**
+   * @brief 将进程信息列表展开为进程名数组
+   * @param {vector<ProcessInfo>} &processInfoList 进程信息列表
+   * @return {vector<string>} 进程名数组
+   */
+  static std::vector<std::string> flatten(const std::vector<ProcessInfo> &processInfoList);
+
+  /**
+   * @brief 收集进程信息列表中配置的 I/O 优先级
+   * @param {vector<ProcessInfo>} &processInfoList 进程信息列表
+   * @return {map<string, IoPriority>} key: 进程名 value: I/O 优先级 未配置的进程不会出现
+   */
+  static std::map<std::string, IoPriority> ioPriorityRules(const std::vector<ProcessInfo> &processInfoList);
+
+  nlohmann::ordered_json toJson() const;
   void fromJson(const nlohmann::json &json);
   std::string toString() const;
   void clear();
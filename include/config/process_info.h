@@ -42,6 +42,20 @@ enum class ProcessStatus
   RESTRICT_FAILED   // 反作弊进程：限制失败
 };
 
+/**
+ * @enum IoPriority
+ * @brief 进程 I/O 优先级枚举，取值与 Windows 的 IO_PRIORITY_HINT 一致
+ * @note UNCHANGED 表示不修改该进程列表的 I/O 优先级
+ */
+enum class IoPriority
+{
+  UNCHANGED = -1,
+  VERY_LOW = 0,
+  LOW = 1,
+  NORMAL = 2,
+  HIGH = 3
+};
+
 /**
  * @class ProcessInfo
  * @brief 进程信息类，负责存储进程的名称、类型、状态等信息
@@ -64,6 +78,8 @@ public:
   std::vector<std::string> processList;
   // 当前设置状态
   bool status = false;
+  // 限制时设置的 I/O 优先级
+  IoPriority ioPriority = IoPriority::UNCHANGED;
 
   // 赋值运算符
   ProcessInfo &operator=(const ProcessInfo &other);
@@ -75,8 +91,12 @@ public:
   bool operator==(const ProcessInfo &other) const;
   bool operator!=(const ProcessInfo &other) const;
 
-  nlohmann::json toJson() const;
+  nlohmann::ordered_json toJson() const;
   void fromJson(const nlohmann::json &json);
   std::string toString() const;
   void clear();
+
+  // I/O 优先级与配置文件字符串之间的转换 ("veryLow" "low" "normal" "high")
+  static std::string ioPriorityToString(IoPriority ioPriority);
+  static IoPriority ioPriorityFromString(const std::string &ioPriority);
 };
@@ -38,7 +38,7 @@ public:
   bool operator==(const SystemInfo &other) const;
   bool operator!=(const SystemInfo &other) const;
 
-  nlohmann::json toJson() const;
+  nlohmann::ordered_json toJson() const;
   void fromJson(const nlohmann::json &json);
 
   std::string toString() const;
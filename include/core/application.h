@@ -13,11 +13,13 @@
 #include <thread>
 #include <memory>
 #include <atomic>
+#include <functional>
 #include <QSystemTrayIcon>
 
 #include "log/logging.h"
 #include "core/config_manager.h"
 #include "core/optimizer.h"
+#include "metrics/metrics_exporter.h"
 
 /**
  * @class Application
@@ -32,7 +34,7 @@ public:
 
   /**
    * @brief 开启/关闭 优化游戏进程
-   * @param {int} gameIndex 游戏索引
+   * @param {int} gameIndex 游戏在当前配置中的索引 超出范围时返回false
    * @param {bool} isOptimize 是否优化
    * @return {bool} 是否设置成功
    */
@@ -95,23 +97,103 @@ public:
    */
   bool setSystemServiceOptimization(bool isOptimize);
 
+  /**
+   * @brief 开启/关闭 后台能效模式
+   * @param {bool} isEnable 是否开启
+   * @param {bool} isQuit 是否为退出状态 退出时不保存配置
+   * @return {bool} 是否设置成功
+   */
+  bool setBackgroundEfficiencyMode(bool isEnable, bool isQuit = false);
+
+  /**
+   * @brief 开启/关闭 游戏启动时回收后台进程内存
+   * @param {bool} isEnable 是否开启
+   * @param {bool} isQuit 是否为退出状态 退出时不保存配置
+   * @return {bool} 是否设置成功
+   */
+  bool setWorkingSetTrim(bool isEnable, bool isQuit = false);
+
+  /**
+   * @brief 开启/关闭 游戏时内存压力响应
+   * @param {bool} isEnable 是否开启
+   * @param {bool} isQuit 是否为退出状态 退出时不保存配置
+   * @return {bool} 是否设置成功
+   */
+  bool setMemoryPressureResponse(bool isEnable, bool isQuit = false);
+
+  /**
+   * @brief 开启/关闭 游戏文件预读
+   * @param {bool} isEnable 是否开启
+   * @param {bool} isQuit 是否为退出状态 退出时不保存配置
+   * @return {bool} 是否设置成功
+   */
+  bool setGamePrefetch(bool isEnable, bool isQuit = false);
+
+  /**
+   * @brief 设置配置热更新完成回调
+   * @param callback 配置文件被外部修改且变化的设置应用完成后在主线程调用，用于刷新界面
+   */
+  void setOnConfigReloadedCallback(std::function<void()> callback);
+
   // getters and setters
 
   /**
    * @brief 获取当前配置 / get current config
-   * @return AppConfig 当前配置 / current config
-   * @note 该函数返回当前配置的副本，修改不会影响原配置
+   * @return shared_ptr<const AppConfig> 当前配置快照 / current config snapshot
+   * @note 快照不可变且不拷贝配置，修改配置会发布新的快照，不影响已取得的快照
    */
-  AppConfig getCurrentConfig() const;
+  std::shared_ptr<const AppConfig> getCurrentConfig() const;
 
   // 状态获取
   bool isOptimizing() const { return m_isOptimizing; }
   ConfigManager &getConfigManager() { return *m_configManager; }
 
 private:
-  AppConfig m_currentConfig{DefaultConfig::Get()};
+  /**
+   * @brief 把配置文件中发生变化的设置应用到各个模块
+   * @param {ConfigDiff} &diff 配置差异
+   * @param {shared_ptr<const AppConfig>} &oldConfig 旧配置快照
+   * @param {shared_ptr<const AppConfig>} &newConfig 新配置快照
+   * @note 只处理发生变化的设置，应用失败的开关按实际状态写回配置文件
+   */
+  void applyConfigChange(const ConfigDiff &diff,
+                         const std::shared_ptr<const AppConfig> &oldConfig,
+                         const std::shared_ptr<const AppConfig> &newConfig);
+
+  /**
+   * @brief 按游戏进程列表的变化增删游戏进程注册表优化
+   * @param {vector<ProcessInfo>} &oldList 旧游戏进程列表
+   * @param {vector<ProcessInfo>} &newList 新游戏进程列表 设置失败的条目状态会被置为未优化
+   * @return {bool} 是否全部设置成功
+   */
+  bool applyGameProcessListChange(const std::vector<ProcessInfo> &oldList, std::vector<ProcessInfo> &newList);
+
+  /**
+   * @brief 按注册表中的实际状态更新配置中各游戏的优化状态，有变化时刷新界面
+   * @note 在主线程调用；配置中的状态可能因外部修改注册表或上次运行中途退出而与实际不符
+   */
+  void syncGameProcessStatus();
+
+  /**
+   * @brief 按日志配置设置日志写入方式
+   * @param {LogConfig} &logConfig 日志配置
+   */
+  void applyLogConfig(const LogConfig &logConfig);
+
+  /**
+   * @brief 按指标配置启动、重启或停止指标导出，并设置是否追踪游戏会话
+   * @param {MetricsConfig} &metricsConfig 指标配置
+   */
+  void applyMetricsConfig(const MetricsConfig &metricsConfig);
+
   std::unique_ptr<ConfigManager> m_configManager{nullptr};
   std::unique_ptr<Optimizer> m_optimizer;
+  // 指标导出器 按配置定期写出指标文件
+  std::unique_ptr<MetricsExporter> m_metricsExporter;
   std::atomic<bool> m_isOptimizing{false};
   QSystemTrayIcon *m_trayIcon = nullptr;
+  // 预读清单保存目录 位于配置文件目录下
+  std::wstring m_prefetchDirectory;
+  // 配置热更新完成回调
+  std::function<void()> m_onConfigReloadedCallback = nullptr;
 };
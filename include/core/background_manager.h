@@ -0,0 +1,98 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 11:02:37
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 11:02:37
+ * @FilePath: \GameOptimizerPro\include\core\background_manager.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+#include "log/logging.h"
+#include "utils/system_utils.h"
+#include "config/process_info.h"
+
+/**
+ * @class BackgroundManager
+ * @brief 后台进程管理器类，负责在游戏会话期间对后台进程启用能效模式 (EcoQoS)
+ *
+ * 通过 SetProcessInformation(ProcessPowerThrottling) 将后台进程标记为节能执行，
+ * 系统会将其调度到能效核心或降低频率运行，从而把性能核心和功耗余量留给游戏。
+ * 同时按进程列表的配置降低后台进程的 I/O 优先级，减少与游戏加载资源时的磁盘争用。
+ * 应用前记录每个进程的原始节流状态、I/O 优先级和创建时间，还原时校验创建时间以避免 PID 复用。
+ */
+class BackgroundManager
+{
+public:
+  BackgroundManager();
+  ~BackgroundManager();
+
+  // 禁用拷贝构造和赋值
+  BackgroundManager(const BackgroundManager &) = delete;
+  BackgroundManager &operator=(const BackgroundManager &) = delete;
+
+  /**
+   * @brief 对后台进程启用能效模式
+   * @param {vector<std::string>} &processNames 后台进程名列表 只匹配当前会话中的进程
+   * @param {vector<DWORD>} &gameProcessIds 游戏进程PID 其进程树不会被限制
+   * @param {bool} throttleAll 是否限制所有当前会话中的非关键进程 (忽略进程名列表)
+   * @param {map<std::string, IoPriority>} &ioPriorityRules 进程名对应的 I/O 优先级
+   * @return {bool} 是否有进程被成功限制
+   */
+  bool applyEfficiencyMode(const std::vector<std::string> &processNames,
+                           const std::vector<DWORD> &gameProcessIds,
+                           bool throttleAll,
+                           const std::map<std::string, IoPriority> &ioPriorityRules = {});
+
+  /**
+   * @brief 还原所有被限制进程的节流状态
+   * @return {bool} 是否全部还原成功
+   */
+  bool revertEfficiencyMode();
+
+  /**
+   * @brief 是否有进程处于本程序施加的能效模式下
+   * @return {bool}
+   */
+  bool isEfficiencyModeApplied() const;
+
+private:
+  // 被限制的进程记录
+  struct ThrottledProcess
+  {
+    DWORD processId = 0;
+    FILETIME creationTime{};
+    std::wstring exeName;
+    bool throttled = false;
+    PROCESS_POWER_THROTTLING_STATE originalState{};
+    bool hasOriginalState = false;
+    bool ioPriorityChanged = false;
+    ULONG originalIoPriority = 2;
+  };
+
+  /**
+   * @brief 对单个进程启用能效模式并设置 I/O 优先级
+   * @param {ProcessEntry} &processEntry 进程快照信息
+   * @param {IoPriority} ioPriority I/O 优先级 UNCHANGED 表示不修改
+   * @return {bool} 是否限制成功
+   */
+  bool throttleProcess(const ProcessEntry &processEntry, IoPriority ioPriority);
+
+  /**
+   * @brief 还原单个进程的节流状态和 I/O 优先级
+   * @param {ThrottledProcess} &throttledProcess 被限制的进程记录
+   * @return {bool} 是否还原成功 进程已退出也视为成功
+   */
+  bool restoreProcess(const ThrottledProcess &throttledProcess);
+
+  std::vector<ThrottledProcess> m_throttledProcesses;
+  mutable std::mutex m_mutex;
+};
@@ -13,12 +13,19 @@
 #include <vector>
 #include <string>
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
 #include <windows.h>
 
 #include <nlohmann/json.hpp>
 
 #include "config/app_config.h"
+#include "config/config_diff.h"
+#include "config/config_serializer.h"
 
 #include "log/logging.h"
 #include "utils/system_utils.h"
@@ -45,6 +52,33 @@ struct DefaultConfig
     config.optimismConfig.optimizeNetworkDelay = false;
     config.optimismConfig.optimizeSystemScheduling = false;
     config.optimismConfig.optimizeSystemService = false;
+    config.optimismConfig.backgroundPolicy.efficiencyMode = false;
+    config.optimismConfig.backgroundPolicy.throttleAllBackground = false;
+    config.optimismConfig.backgroundPolicy.trimWorkingSet = false;
+    config.optimismConfig.backgroundPolicy.trimBudgetMB = 1024;
+    config.optimismConfig.backgroundPolicy.memoryPressureResponse = false;
+    config.optimismConfig.gamePrefetch = false;
+    config.optimismConfig.prefetchBudgetMB = 2048;
+
+    // 日志配置默认值
+    config.logConfig.asyncLogging = true;
+    config.logConfig.flushPolicy = "batch";
+    config.logConfig.flushIntervalMs = 1000;
+    config.logConfig.format = "text";
+    config.logConfig.maxFileSizeMB = 10;
+    config.logConfig.rotateIntervalHours = 24;
+    config.logConfig.maxArchiveFiles = 10;
+    config.logConfig.compressArchives = true;
+    config.logConfig.rateLimitBurst = 10;
+    config.logConfig.rateLimitWindowSeconds = 10;
+    config.logConfig.flightRecorder = true;
+    config.logConfig.levels.defaultLevel = "info";
+
+    // 指标配置默认值
+    config.metricsConfig.enabled = true;
+    config.metricsConfig.filePath = "logs/metrics.prom";
+    config.metricsConfig.exportIntervalSeconds = 15;
+    config.metricsConfig.traceGameSession = false;
 
     return config;
   }
@@ -57,6 +91,11 @@ struct DefaultConfig
 class ConfigManager
 {
 public:
+  // 配置文件变化回调函数类型 参数为配置差异、旧配置快照和新配置快照
+  using ConfigChangedCallback = std::function<void(const ConfigDiff &,
+                                                   const std::shared_ptr<const AppConfig> &,
+                                                   const std::shared_ptr<const AppConfig> &)>;
+
   /**
    * @brief 构造函数
    * @param {wstring} &configPath 配置路径
@@ -76,22 +115,52 @@ public:
    * @brief 启动/停止配置文件监控
    * @param {bool} enable
    * @return {bool}
+   * @note 使用 ReadDirectoryChangesW 监听配置文件所在目录，连续的写入在防抖时间后合并为一次重新加载
    */
   bool setConfigMonitor(bool enable);
 
   /**
-   * @brief 获取当前配置的副本
-   * @return {AppConfig} 当前配置的副本
+   * @brief 设置配置文件变化回调
+   * @param callback 配置文件被外部修改并成功加载后调用，只在有设置发生变化时调用
+   * @note 回调在监控线程中执行
+   */
+  void setOnConfigChangedCallback(ConfigChangedCallback callback);
+
+  /**
+   * @brief 获取当前配置快照
+   * @return {shared_ptr<const AppConfig>} 当前配置快照
+   * @note 快照发布后不再修改，读取时不加锁也不拷贝配置，持有的快照不受之后修改的影响
    */
-  AppConfig getConfig();
+  std::shared_ptr<const AppConfig> getSnapshot() const;
+
+  /**
+   * @brief 获取配置代数
+   * @return {uint64_t} 每发布一次新快照加一，代数不变说明配置没有变化
+   */
+  uint64_t getGeneration() const;
 
   /**
    * @brief 设置配置
    * @param {AppConfig} &config 配置
    * @return {bool} 是否设置成功
+   * @note 只标记配置待保存，连续修改在安静期结束后合并为一次写入
    */
   bool setConfig(const AppConfig &config);
 
+  /**
+   * @brief 在当前快照的副本上修改配置并发布为新快照
+   * @param modifier 修改函数 在写锁内执行，不能再调用 ConfigManager 的接口
+   * @return {bool} 是否设置成功
+   */
+  bool updateConfig(const std::function<void(AppConfig &)> &modifier);
+
+  /**
+   * @brief 立即写入待保存的配置
+   * @return {bool} 是否保存成功
+   * @note 用于退出时确保最后的修改落盘，内容未变化时不写入
+   */
+  bool flushConfig();
+
 private:
   /**
    * @brief 获取配置路径
@@ -108,16 +177,57 @@ private:
 
   /**
    * @brief 保存配置 允许传入路径或使用默认
-   * @param {wstring} &configPath 配置路径
+   * @param {wstring} &configPath 配置路径 与当前配置文件不同时视为导出，不改变当前配置文件及其保存状态
    * @return {bool} 是否保存成功
+   * @note 内容与上次保存的哈希一致时跳过写入，内容变化时才轮换备份
    */
   bool saveConfig(const std::wstring &configPath = L"");
 
+  /**
+   * @brief 把配置序列化为 JSON 文本
+   * @param {AppConfig} &config 配置
+   * @return {string} UTF-8 编码的 JSON 文本
+   */
+  std::string serializeConfig(const AppConfig &config) const;
+
+  /**
+   * @brief 原子写入配置文件 先写临时文件并刷盘，再重命名替换原文件
+   * @param {wstring} &configPath 配置路径
+   * @param {string} &content 文件内容
+   * @return {bool} 是否写入成功
+   */
+  bool writeConfigFile(const std::wstring &configPath, const std::string &content) const;
+
+  /**
+   * @brief 轮换配置文件备份 .bak 为最新备份，更早的备份依次为 .bak.1、.bak.2
+   * @param {wstring} &configPath 配置路径
+   */
+  void rotateBackups(const std::wstring &configPath) const;
+
+  /**
+   * @brief 配置保存线程主循环
+   */
+  void runPersistLoop();
+
+  /**
+   * @brief 解析配置文件
+   * @param {wstring} &configPath 配置路径
+   * @param {AppConfig} &config 解析结果 失败时不修改
+   * @return {bool} 是否解析并验证成功
+   */
+  bool parseConfigFile(const std::wstring &configPath, AppConfig &config) const;
+
   /**
    * @brief 重新加载配置
+   * @note 新配置解析失败时保留当前配置，成功时只把发生变化的设置通知给回调
    */
   void reloadConfig();
 
+  /**
+   * @brief 配置文件监控线程主循环
+   */
+  void runMonitorLoop();
+
   /**
    * @brief 验证配置
    * @param {AppConfig} &config 配置
@@ -125,11 +235,41 @@ private:
    */
   bool validateConfig(const AppConfig &config) const;
 
-  // 配置类
-  AppConfig m_appConfig;
+  /**
+   * @brief 发布新的配置快照 调用时需持有 m_mutex
+   * @param {shared_ptr<const AppConfig>} config 新配置快照
+   */
+  void publishConfig(std::shared_ptr<const AppConfig> config);
+
+  // 当前配置快照 通过 atomic_load/atomic_store 读取和替换
+  std::shared_ptr<const AppConfig> m_snapshot;
+  // 配置代数
+  std::atomic<uint64_t> m_generation{0};
   // 配置文件路径
   std::wstring m_configPath;
 
-  // 线程安全的互斥锁
+  // 写配置时的互斥锁 读取快照不需要加锁
   std::mutex m_mutex;
+
+  // 配置保存线程 等待安静期后写入待保存的配置
+  std::thread m_persistThread;
+  std::condition_variable m_persistCv;
+  bool m_stopPersist = false;
+  // 已写入文件的配置代数 与当前代数不同说明有未写入文件的修改
+  uint64_t m_persistedGeneration = 0;
+  // 最后一次修改的时间
+  std::chrono::steady_clock::time_point m_lastChangeTime;
+  // 上次写入文件的内容哈希
+  size_t m_persistedHash = 0;
+  // 保证同一时间只有一个线程写文件
+  std::mutex m_saveMutex;
+  // 上次为主配置文件轮换备份时待写入内容的哈希 写入失败重试时不再轮换 由 m_saveMutex 保护
+  size_t m_rotatedHash = 0;
+
+  // 配置文件监控线程
+  std::thread m_monitorThread;
+  // 通知监控线程退出的事件
+  HANDLE m_monitorStopEvent = nullptr;
+  std::atomic<bool> m_isMonitoring{false};
+  ConfigChangedCallback m_onConfigChangedCallback = nullptr;
 };
\ No newline at end of file
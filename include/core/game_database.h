@@ -0,0 +1,116 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:10:27
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:10:27
+ * @FilePath: \GameOptimizerPro\include\core\game_database.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <windows.h>
+
+#include "config/process_info.h"
+
+#include "log/logging.h"
+#include "utils/game_db_format.h"
+
+/**
+ * @struct GameTitle
+ * @brief 数据库中一条游戏/反作弊记录的只读视图
+ * @note name 指向内存映射的字符串表，仅在数据库打开期间有效
+ */
+struct GameTitle
+{
+  std::string_view name;
+  GameDb::TitleType type = GameDb::TitleType::Game;
+  IoPriority ioPriority = IoPriority::UNCHANGED;
+  uint8_t flags = GameDb::FlagNone;
+};
+
+/**
+ * @class GameDatabase
+ * @brief 游戏数据库类，以内存映射方式加载编译好的二进制游戏数据库
+ *
+ * 数据库由 GameDbCompiler 从 JSON/CSV 编译生成，打开时只校验文件头和各段边界，
+ * 不做任何解析，启动耗时与数据库大小无关；按可执行文件名查找为一次哈希加桶内比较。
+ */
+class GameDatabase
+{
+public:
+  GameDatabase();
+  ~GameDatabase();
+
+  // 禁用拷贝构造和赋值
+  GameDatabase(const GameDatabase &) = delete;
+  GameDatabase &operator=(const GameDatabase &) = delete;
+
+  /**
+   * @brief 打开数据库文件
+   * @param {wstring} &databasePath 数据库路径
+   * @return {bool} 是否打开成功
+   */
+  bool open(const std::wstring &databasePath);
+
+  /**
+   * @brief 关闭数据库并解除内存映射
+   */
+  void close();
+
+  /**
+   * @brief 数据库是否已打开
+   * @return {bool}
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief 数据库中的条目数量
+   * @return {uint32_t}
+   */
+  uint32_t titleCount() const;
+
+  /**
+   * @brief 按可执行文件名查找条目 不区分大小写
+   * @param {string_view} exeName UTF-8 编码的可执行文件名
+   * @return {optional<GameTitle>} 找到的条目
+   */
+  std::optional<GameTitle> find(std::string_view exeName) const;
+
+  /**
+   * @brief 按可执行文件名查找条目 不区分大小写
+   * @param {wstring} &exeName 可执行文件名
+   * @return {optional<GameTitle>} 找到的条目
+   */
+  std::optional<GameTitle> find(const std::wstring &exeName) const;
+
+private:
+  /**
+   * @brief 校验文件头和各段边界
+   * @param {size_t} fileSize 文件大小
+   * @return {bool} 是否合法
+   */
+  bool validate(size_t fileSize) const;
+
+  /**
+   * @brief 读取字符串表中的字符串
+   * @param {uint32_t} offset 字符串偏移
+   * @return {string_view} 越界时返回空
+   */
+  std::string_view stringAt(uint32_t offset) const;
+
+  HANDLE m_hFile = INVALID_HANDLE_VALUE;
+  HANDLE m_hMapping = nullptr;
+  const uint8_t *m_view = nullptr;
+
+  // 指向映射内存中的各段
+  const GameDb::Header *m_header = nullptr;
+  const GameDb::TitleRecord *m_titles = nullptr;
+  const uint32_t *m_buckets = nullptr;
+  const GameDb::ExeEntry *m_entries = nullptr;
+  const char *m_strings = nullptr;
+};
@@ -0,0 +1,129 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 13:20:44
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 13:20:44
+ * @FilePath: \GameOptimizerPro\include\core\memory_manager.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <psapi.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+#pragma comment(lib, "psapi.lib")
+
+#include "log/logging.h"
+#include "utils/system_utils.h"
+
+/**
+ * @struct TrimReport
+ * @brief 工作集回收结果
+ */
+struct TrimReport
+{
+  size_t processCount = 0;     // 被回收的进程数
+  SIZE_T bytesReclaimed = 0;   // 回收的字节数
+  double elapsedMs = 0.0;      // 回收耗时 (毫秒)
+  bool budgetReached = false;  // 是否达到预算后提前停止
+};
+
+/**
+ * @class MemoryManager
+ * @brief 内存管理器类，负责在游戏启动时回收后台进程的工作集
+ *
+ * 按工作集从大到小对当前用户会话中的后台进程调用 EmptyWorkingSet，
+ * 将其私有页面换出到备用列表，为游戏腾出物理内存。
+ * 被换出的页面在后台进程再次访问时会按需调回，因此该操作可安全执行，无需还原。
+ * 内存持续紧张时还可以降低后台进程的内存优先级，使其页面优先被系统换出，该操作需要在会话结束时还原。
+ */
+class MemoryManager
+{
+public:
+  MemoryManager();
+  ~MemoryManager();
+
+  // 禁用拷贝构造和赋值
+  MemoryManager(const MemoryManager &) = delete;
+  MemoryManager &operator=(const MemoryManager &) = delete;
+
+  /**
+   * @brief 回收后台进程的工作集
+   * @param {vector<DWORD>} &gameProcessIds 游戏进程PID 其进程树不会被回收
+   * @param {vector<std::string>} &exclusionList 不回收的进程名列表
+   * @param {SIZE_T} budgetBytes 回收预算 达到后停止 0 表示不限制
+   * @return {TrimReport} 回收结果
+   */
+  TrimReport trimBackgroundWorkingSets(const std::vector<DWORD> &gameProcessIds,
+                                       const std::vector<std::string> &exclusionList,
+                                       SIZE_T budgetBytes);
+
+  /**
+   * @brief 将后台进程的内存优先级降低为 MEMORY_PRIORITY_VERY_LOW
+   * @param {vector<DWORD>} &gameProcessIds 游戏进程PID 其进程树不会被降低
+   * @param {vector<std::string>} &exclusionList 不降低的进程名列表
+   * @return {size_t} 被降低优先级的进程数
+   */
+  size_t lowerBackgroundMemoryPriority(const std::vector<DWORD> &gameProcessIds,
+                                       const std::vector<std::string> &exclusionList);
+
+  /**
+   * @brief 还原被降低的内存优先级
+   * @return {bool} 是否全部还原成功
+   */
+  bool restoreMemoryPriority();
+
+private:
+  // 回收候选进程
+  struct TrimCandidate
+  {
+    DWORD processId = 0;
+    std::wstring exeName;
+    SIZE_T workingSetSize = 0;
+  };
+
+  // 被降低内存优先级的进程记录
+  struct LoweredProcess
+  {
+    DWORD processId = 0;
+    FILETIME creationTime{};
+    std::wstring exeName;
+    ULONG originalPriority = MEMORY_PRIORITY_NORMAL;
+  };
+
+  /**
+   * @brief 收集当前用户会话中可以处理的后台进程
+   * @param {vector<DWORD>} &gameProcessIds 游戏进程PID 其进程树会被排除
+   * @param {vector<std::string>} &exclusionList 排除的进程名列表
+   * @return {vector<ProcessEntry>} 后台进程列表
+   * @note 排除自身、前台窗口进程、系统关键进程和会话0中的服务进程
+   */
+  static std::vector<ProcessEntry> collectBackgroundProcesses(const std::vector<DWORD> &gameProcessIds,
+                                                              const std::vector<std::string> &exclusionList);
+
+  /**
+   * @brief 回收单个进程的工作集
+   * @param {TrimCandidate} &candidate 候选进程
+   * @return {SIZE_T} 回收的字节数 失败时返回 0
+   */
+  SIZE_T trimProcess(const TrimCandidate &candidate);
+
+  /**
+   * @brief 获取进程的工作集大小
+   * @param {HANDLE} hProcess 进程句柄
+   * @return {SIZE_T} 工作集大小 失败时返回 0
+   */
+  static SIZE_T getWorkingSetSize(HANDLE hProcess);
+
+  std::vector<LoweredProcess> m_loweredProcesses;
+  std::mutex m_mutex;
+
+  // 工作集小于该值的进程不值得回收
+  static constexpr SIZE_T kMinWorkingSetSize = 32ull * 1024 * 1024;
+};
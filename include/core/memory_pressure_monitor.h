@@ -0,0 +1,94 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 14:05:16
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 14:05:16
+ * @FilePath: \GameOptimizerPro\include\core\memory_pressure_monitor.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+#include "log/logging.h"
+
+/**
+ * @class MemoryPressureMonitor
+ * @brief 内存压力监视器类，在系统物理内存不足时分级通知调用方
+ *
+ * 使用 CreateMemoryResourceNotification 订阅系统的内存不足/充足通知，
+ * 监视线程阻塞在 WaitForMultipleObjects 上，空闲时不占用 CPU。
+ * 内存不足时按级别触发回调，若冷却时间后仍然不足则升级到下一级别，
+ * 内存恢复充足后级别清零。
+ */
+class MemoryPressureMonitor
+{
+public:
+  // 压力级别
+  enum class PressureLevel
+  {
+    None = 0,
+    TrimBackground = 1, // 回收后台进程工作集
+    LowerPriority = 2,  // 降低后台进程内存优先级
+    Alert = 3           // 通知用户
+  };
+
+  // 压力回调函数类型
+  using PressureCallback = std::function<void(PressureLevel)>;
+
+  MemoryPressureMonitor();
+  ~MemoryPressureMonitor();
+
+  // 禁用拷贝构造和赋值
+  MemoryPressureMonitor(const MemoryPressureMonitor &) = delete;
+  MemoryPressureMonitor &operator=(const MemoryPressureMonitor &) = delete;
+
+  /**
+   * @brief 开始监视内存压力
+   * @return {bool} 是否启动成功
+   */
+  bool start();
+
+  /**
+   * @brief 停止监视内存压力
+   * @note 不能在压力回调中调用
+   */
+  void stop();
+
+  /**
+   * @brief 是否正在监视
+   * @return {bool}
+   */
+  bool isRunning() const;
+
+  /**
+   * @brief 设置压力回调
+   * @param callback 在监视线程中调用
+   */
+  void setOnPressureCallback(PressureCallback callback);
+
+private:
+  /**
+   * @brief 监视线程主函数
+   */
+  void runMonitorLoop();
+
+  HANDLE m_stopEvent = nullptr;
+  HANDLE m_lowMemoryEvent = nullptr;
+  HANDLE m_highMemoryEvent = nullptr;
+
+  std::thread m_monitorThread;
+  std::atomic<bool> m_isRunning{false};
+  std::mutex m_setMutex;
+
+  PressureCallback m_onPressureCallback = nullptr;
+
+  // 升级到下一级别前的冷却时间 (毫秒)
+  static constexpr DWORD kEscalationIntervalMs = 10000;
+};
@@ -0,0 +1,127 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:58:34
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:58:34
+ * @FilePath: \GameOptimizerPro\include\core\nic_inventory.h
+ * @Description: 网卡清单缓存，网络接口或默认路由变化时失效
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "log/logging.h"
+#include "core/registry_manager.h"
+#include "utils/registry_key.h"
+
+/**
+ * @struct NicInfo
+ * @brief 网卡信息
+ */
+struct NicInfo
+{
+  // 网卡的 NetCfgInstanceId 例如 {4D36E972-...} 同时是 Tcpip 接口注册表项的名称
+  std::string interfaceId;
+  // 是否承载默认路由 (0.0.0.0/0 或 ::/0) 即当前实际联网的网卡
+  bool hasDefaultRoute = false;
+};
+
+/**
+ * @class NicInventory
+ * @brief 网卡清单类，缓存网卡列表和默认路由所在的网卡
+ *
+ * 第一次获取时枚举网卡类注册表项并过滤出有 Tcpip 接口项的网卡，之后直接返回缓存。
+ * 使用 NotifyIpInterfaceChange 订阅网卡的添加和移除，使用 NotifyRouteChange2 订阅默认路由的变化，
+ * 收到通知时只使缓存失效并调用变化回调，下一次获取时才重新枚举。
+ * 订阅失败时不缓存，每次获取都重新枚举。
+ */
+class NicInventory
+{
+public:
+  // 网卡或默认路由变化时的回调函数类型 在系统通知线程中调用
+  using ChangedCallback = std::function<void()>;
+
+  /**
+   * @param {RegistryManager} *registryManager 注册表管理器 生命周期长于本对象
+   * @param {RegistryKey} &classKey 网卡类注册表项 keyValueList[0] 为 NetCfgInstanceId 值名称
+   * @param {RegistryKey} &interfacesKey Tcpip 接口注册表项 子项名称为网卡ID
+   */
+  NicInventory(RegistryManager *registryManager, const RegistryKey &classKey, const RegistryKey &interfacesKey);
+  ~NicInventory();
+
+  // 禁用拷贝构造和赋值
+  NicInventory(const NicInventory &) = delete;
+  NicInventory &operator=(const NicInventory &) = delete;
+
+  /**
+   * @brief 订阅网卡和路由变化通知
+   * @return {bool} 是否订阅成功
+   */
+  bool start();
+
+  /**
+   * @brief 取消订阅 正在执行的变化回调结束后才返回
+   * @note 不能在变化回调中调用
+   */
+  void stop();
+
+  /**
+   * @brief 使缓存失效并调用变化回调 下一次获取时重新枚举
+   */
+  void invalidate();
+
+  /**
+   * @brief 获取网卡清单 缓存有效时不访问注册表
+   * @param {vector<NicInfo>} &interfaces 输出 有 Tcpip 接口项的网卡
+   * @return {bool} 没有有效网卡时返回false
+   */
+  bool getInterfaces(std::vector<NicInfo> &interfaces);
+
+  /**
+   * @brief 设置变化回调 可以在订阅后替换
+   * @param callback 在系统通知线程中调用，应尽快返回，不能在回调中调用 stop 或本函数
+   */
+  void setOnChangedCallback(ChangedCallback callback);
+
+private:
+  /**
+   * @brief 枚举网卡并标记默认路由所在的网卡
+   */
+  bool scanInterfaces(std::vector<NicInfo> &interfaces);
+
+  /**
+   * @brief 读取路由表中默认路由所在网卡的ID
+   * @param {unordered_set<string>} &interfaceIds 输出 小写的网卡ID
+   */
+  static bool getDefaultRouteInterfaceIds(std::unordered_set<std::string> &interfaceIds);
+
+  RegistryManager *m_registryManager = nullptr;
+  RegistryKey m_classKey;
+  RegistryKey m_interfacesKey;
+
+  // NotifyIpInterfaceChange 和 NotifyRouteChange2 返回的句柄
+  HANDLE m_interfaceNotification = nullptr;
+  HANDLE m_routeNotification = nullptr;
+  std::mutex m_setMutex;
+  // 两种通知都订阅成功后才缓存
+  std::atomic<bool> m_isSubscribed{false};
+
+  // 每次变化加一 与 m_builtGeneration 不同时缓存失效
+  std::atomic<unsigned long long> m_generation{1};
+  // 保护 m_interfaces 和 m_builtGeneration 重新枚举期间持有
+  std::mutex m_mutex;
+  std::vector<NicInfo> m_interfaces;
+  unsigned long long m_builtGeneration = 0;
+
+  // 保护 m_onChangedCallback 调用回调期间持有
+  std::mutex m_callbackMutex;
+  ChangedCallback m_onChangedCallback = nullptr;
+};
@@ -13,6 +13,11 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
 #include <windows.h>
 #include <QSystemTrayIcon>
 
@@ -22,6 +27,14 @@
 #include "core/registry_manager.h"
 #include "core/power_manager.h"
 #include "core/service_manager.h"
+#include "core/session_manager.h"
+#include "core/background_manager.h"
+#include "core/memory_manager.h"
+#include "core/memory_pressure_monitor.h"
+#include "core/registry_watcher.h"
+#include "core/nic_inventory.h"
+#include "core/prefetch_manager.h"
+#include "core/game_database.h"
 
 #include "utils/registry_key.h"
 
@@ -53,9 +66,11 @@ public:
      * @brief: 开启/关闭 自动限制反作弊进程
      * @param bool isAutoLimit 是否自动限制
      * @param vector<std::string> &processNames 要监听的进程名称
+     * @param map<std::string, IoPriority> &ioPriorityRules 进程名对应的 I/O 优先级
      * @return bool 是否设置成功
      */
-    bool setAutoLimitAntiCheat(bool isAutoLimit, const std::vector<std::string> &processNames = {});
+    bool setAutoLimitAntiCheat(bool isAutoLimit, const std::vector<std::string> &processNames = {},
+                               const std::map<std::string, IoPriority> &ioPriorityRules = {});
 
     /**
      * @brief 设置游戏优化电源计划
@@ -103,10 +118,17 @@ public:
     /**
      * @brief 检查游戏进程注册表
      * @param vector<std::string> &processNames 游戏进程名称
-     * @return bool 是否检查成功
+     * @return bool 是否全部进程都已设置注册表性能选项
+     * @note 按 Image File Execution Options 的枚举结果查询，每个进程 O(1)；枚举完成前逐个打开注册表项检查
      */
     bool checkGameProcessRegistry(const std::vector<std::string> &processNames);
 
+    /**
+     * @brief 设置游戏进程优化状态变化回调
+     * @param callback 枚举到的已设置性能选项的进程发生变化时在注册表监视线程中调用，包括启动后的第一次枚举
+     */
+    void setOnGameProcessStatusChangedCallback(std::function<void()> callback);
+
     /**
      * @brief 设置/删除游戏进程注册表
      * @param vector<std::string> &processNames 游戏进程名称
@@ -114,6 +136,102 @@ public:
      */
     bool setGameProcessRegistry(const std::vector<std::string> &processNames, bool isOptimize);
 
+    /**
+     * @brief 开启/关闭 后台能效模式
+     * @param bool isEnable 是否开启
+     * @param vector<std::string> &gameProcessNames 游戏进程名称 用于判断游戏会话
+     * @param vector<std::string> &backgroundProcessNames 后台进程名称
+     * @param bool throttleAll 是否限制所有非关键后台进程
+     * @param map<std::string, IoPriority> &ioPriorityRules 后台进程名对应的 I/O 优先级
+     * @return bool 是否设置成功
+     * @note 开启后仅在游戏会话期间生效，游戏全部退出后自动还原
+     */
+    bool setBackgroundEfficiencyMode(bool isEnable,
+                                     const std::vector<std::string> &gameProcessNames = {},
+                                     const std::vector<std::string> &backgroundProcessNames = {},
+                                     bool throttleAll = false,
+                                     const std::map<std::string, IoPriority> &ioPriorityRules = {});
+
+    /**
+     * @brief 开启/关闭 游戏启动时回收后台进程工作集
+     * @param bool isEnable 是否开启
+     * @param vector<std::string> &gameProcessNames 游戏进程名称 用于判断游戏会话
+     * @param vector<std::string> &exclusionList 不回收的进程名称
+     * @param int budgetMB 单次回收预算 (MB) 0 表示不限制
+     * @return bool 是否设置成功
+     */
+    bool setWorkingSetTrim(bool isEnable,
+                           const std::vector<std::string> &gameProcessNames = {},
+                           const std::vector<std::string> &exclusionList = {},
+                           int budgetMB = 0);
+
+    /**
+     * @brief 开启/关闭 游戏时内存压力响应
+     * @param bool isEnable 是否开启
+     * @param vector<std::string> &gameProcessNames 游戏进程名称 用于判断游戏会话
+     * @param vector<std::string> &exclusionList 不处理的进程名称
+     * @param int budgetMB 单次回收预算 (MB) 0 表示不限制
+     * @return bool 是否设置成功
+     * @note 仅在游戏会话期间监视，内存不足时依次回收后台工作集、降低后台内存优先级、通知用户
+     */
+    bool setMemoryPressureResponse(bool isEnable,
+                                   const std::vector<std::string> &gameProcessNames = {},
+                                   const std::vector<std::string> &exclusionList = {},
+                                   int budgetMB = 0);
+
+    /**
+     * @brief 开启/关闭 游戏文件预读
+     * @param bool isEnable 是否开启
+     * @param vector<std::string> &gameProcessNames 游戏进程名称 用于判断游戏会话
+     * @param wstring &manifestDirectory 预读清单保存目录
+     * @param int budgetMB 单次预读预算 (MB) 0 表示不限制
+     * @return bool 是否设置成功
+     * @note 游戏首次运行时只学习读取的文件，之后每次启动时按清单预热文件缓存
+     */
+    bool setGamePrefetch(bool isEnable,
+                         const std::vector<std::string> &gameProcessNames = {},
+                         const std::wstring &manifestDirectory = L"",
+                         int budgetMB = 0);
+
+    /**
+     * @brief 游戏进程列表变化后重新订阅游戏会话监听
+     * @param vector<std::string> &gameProcessNames 新的游戏进程名称
+     * @return bool 是否设置成功
+     * @note 会话监听未开启时不做任何操作，会话进行中时会先结束当前会话再按新列表重新扫描
+     */
+    bool restartSessionMonitor(const std::vector<std::string> &gameProcessNames);
+
+    /**
+     * @brief 设置注册表撤销日志 还原配置中已关闭但日志中仍有记录的注册表优化，并监视已开启的注册表优化
+     * @param wstring &journalPath 撤销日志文件路径
+     * @param bool limitBackgroundActivity 配置中是否开启后台活动限制
+     * @param bool optimizeNetworkDelay 配置中是否开启网络延迟优化
+     * @param bool optimizeSystemScheduling 配置中是否开启系统调度优化
+     * @note 应在开启各项功能之前调用；开启优化时记录的原始值在关闭时还原，重启后仍然有效
+     * @note 已开启的优化被其他程序改回时自动重新写入，短时间内反复被改回时只记录日志并通知用户
+     * @note 同时枚举一次已设置性能选项的游戏进程，之后在 Image File Execution Options 变化时重新枚举
+     * @note 撤销日志无法加载时以空日志继续，只跳过还原未完成修改的步骤
+     */
+    void initRegistryOptimizations(const std::wstring &journalPath,
+                                   bool limitBackgroundActivity,
+                                   bool optimizeNetworkDelay,
+                                   bool optimizeSystemScheduling);
+
+    /**
+     * @brief 设置游戏数据库
+     * @param shared_ptr<const GameDatabase> gameDatabase 已打开的游戏数据库
+     * @note 应在开启各项功能之前调用，数据库中的游戏参与会话判断，反作弊条目参与自动限制
+     */
+    void setGameDatabase(std::shared_ptr<const GameDatabase> gameDatabase);
+
+    /**
+     * @brief 设置是否追踪游戏会话
+     * @param bool isEnable 是否开启
+     * @note 开启后每次游戏会话开始时开启性能追踪，会话结束时导出到日志目录；
+     *       只有开启了至少一项会话期间生效的功能（后台能效、内存回收、内存压力响应、文件预读）时才会监听游戏会话
+     */
+    void setSessionTracing(bool isEnable);
+
 private:
     // ATL Module Instance - Required for CComObject, etc.
     CComModule m_Module;
@@ -122,9 +240,49 @@ private:
     std::unique_ptr<PowerManager> m_powerManager{nullptr};
     std::unique_ptr<RegistryManager> m_registryManager{nullptr};
     std::unique_ptr<ServiceManager> m_serviceManager{nullptr};
+    std::unique_ptr<SessionManager> m_sessionManager{nullptr};
+    std::unique_ptr<BackgroundManager> m_backgroundManager{nullptr};
+    std::unique_ptr<MemoryManager> m_memoryManager{nullptr};
+    std::unique_ptr<MemoryPressureMonitor> m_memoryPressureMonitor{nullptr};
+    std::unique_ptr<PrefetchManager> m_prefetchManager{nullptr};
+    std::unique_ptr<RegistryWatcher> m_registryWatcher{nullptr};
+    std::unique_ptr<NicInventory> m_nicInventory{nullptr};
     QSystemTrayIcon *m_trayIcon{nullptr};
 
+    // 游戏会话期间生效的功能
+    std::atomic<bool> m_backgroundEfficiency{false};
+    bool m_throttleAllBackground = false;
+    std::vector<std::string> m_backgroundProcessNames;
+    std::map<std::string, IoPriority> m_backgroundIoPriorityRules;
+    // 配置中的反作弊进程 key: 小写进程名 value: I/O 优先级 设置时转换一次
+    std::unordered_map<std::wstring, IoPriority> m_antiCheatProcesses;
+    std::shared_ptr<const GameDatabase> m_gameDatabase{nullptr};
+    std::atomic<bool> m_trimWorkingSet{false};
+    std::vector<std::string> m_trimExclusionList;
+    SIZE_T m_trimBudgetBytes = 0;
+    std::atomic<bool> m_memoryPressureResponse{false};
+    std::atomic<bool> m_gamePrefetch{false};
+    ULONGLONG m_prefetchBudgetBytes = 0;
+    std::atomic<bool> m_sessionTracing{false};
+    std::mutex m_sessionMutex;
+
+    // 自动限制反作弊和游戏会话共用一个进程事件订阅 以下成员由 m_listenerMutex 保护
+    std::mutex m_listenerMutex;
+    std::atomic<bool> m_autoLimitAntiCheat{false};
+    std::vector<std::string> m_antiCheatListenNames;
+    bool m_sessionListening = false;
+    std::vector<std::string> m_sessionListenNames;
+    // 当前订阅的小写进程名 为空时订阅所有进程
+    std::vector<std::string> m_listenerProcessNames;
+
+    // Image File Execution Options 下含有 PerfOptions 的进程名 小写
+    std::unordered_set<std::string> m_perfOptionsProcesses;
+    bool m_perfOptionsLoaded = false;
+    std::mutex m_perfOptionsMutex;
+    std::function<void()> m_onGameProcessStatusChangedCallback = nullptr;
+
     // 储存注册表项的map
+    // originValue 只在撤销日志中没有原始值记录时用于还原，开启优化时会先记录注册表中的实际值
     std::map<std::string, RegistryKey> m_registryKeys = {
         {"AutoStartup",
          RegistryKey(
@@ -183,7 +341,89 @@ private:
     bool isStartupEnabled();
 
     /**
-     * @brief 设置监听器回调函数
+     * @brief 设置监听器回调函数 进程事件同时分发给游戏会话和自动限制反作弊
      */
     void setListenerCallback();
+
+    /**
+     * @brief 按自动限制反作弊和游戏会话的需要更新共用的进程事件订阅
+     * @return bool 是否更新成功 两者都不需要时停止订阅
+     * @note 设置了游戏数据库或任一方没有指定进程名时订阅所有进程，否则只订阅两者进程名的并集
+     */
+    bool updateProcessListener();
+
+    /**
+     * @brief 判断进程是否为反作弊进程
+     * @param wstring &processName 进程名
+     * @param IoPriority &ioPriority 输出该进程应设置的 I/O 优先级 配置优先于游戏数据库
+     * @return bool 在配置的反作弊进程列表中或在游戏数据库中登记为反作弊
+     */
+    bool isAntiCheatProcess(const std::wstring &processName, IoPriority &ioPriority);
+
+    /**
+     * @brief 设置游戏会话回调函数
+     */
+    void setSessionCallback();
+
+    /**
+     * @brief 根据会话功能的开关状态启动或停止游戏会话监听
+     * @param vector<std::string> &gameProcessNames 游戏进程名称
+     * @return bool 是否设置成功
+     */
+    bool updateSessionMonitor(const std::vector<std::string> &gameProcessNames);
+
+    /**
+     * @brief 设置内存压力回调函数
+     */
+    void setMemoryPressureCallback();
+
+    /**
+     * @brief 按当前预算和排除列表回收后台进程工作集，并通过托盘通知回收结果
+     */
+    void trimBackgroundMemory();
+
+    /**
+     * @brief 显示托盘通知 可以在任意线程调用
+     * @note 托盘图标只能在主线程中使用，通知转到主线程后显示
+     * @param QString &message 通知内容
+     * @param MessageIcon icon 通知图标
+     */
+    void showTrayMessage(const QString &message, QSystemTrayIcon::MessageIcon icon = QSystemTrayIcon::Information);
+
+    /**
+     * @brief 设置预读报告回调函数
+     */
+    void setPrefetchCallback();
+
+    /**
+     * @brief 生成注册表优化的写操作
+     * @param string &name 变更集名称 例如 OptimizeBackgroundActivity
+     * @param bool isOptimize true 为优化后的值，false 为没有原始值记录时使用的默认原始值
+     * @param RegistryBatch &batch 输出 写操作
+     * @return bool 是否生成成功 网络延迟优化在没有有效网卡时失败
+     * @note 网络延迟优化只写入承载默认路由的网卡 没有默认路由时写入全部网卡
+     */
+    bool buildRegistryOptimization(const std::string &name, bool isOptimize, RegistryBatch &batch);
+
+    /**
+     * @brief 监视已开启的注册表优化涉及的注册表项 被改回时重新写入
+     * @param string &name 变更集名称
+     */
+    void watchRegistryOptimization(const std::string &name);
+
+    /**
+     * @brief 设置注册表优化被反复改回时的通知回调函数
+     */
+    void setRegistryWatcherCallback();
+
+    /**
+     * @brief 设置网卡或默认路由变化时的回调函数 网络延迟优化开启时重新检查
+     */
+    void setNicInventoryCallback();
+
+    /**
+     * @brief 枚举 Image File Execution Options 下含有 PerfOptions 的进程名
+     * @return bool 是否枚举成功 结果变化时调用游戏进程优化状态变化回调
+     */
+    bool refreshGameProcessStatus();
 };
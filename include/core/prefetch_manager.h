@@ -0,0 +1,165 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:32:08
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:32:08
+ * @FilePath: \GameOptimizerPro\include\core\prefetch_manager.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <psapi.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+#pragma comment(lib, "psapi.lib")
+
+#include "log/logging.h"
+#include "utils/system_utils.h"
+
+/**
+ * @struct PrefetchReport
+ * @brief 一次游戏会话的预读结果
+ */
+struct PrefetchReport
+{
+  std::wstring gameName;           // 游戏进程名
+  size_t prefetchedFiles = 0;      // 预读的文件数
+  ULONGLONG prefetchedBytes = 0;   // 预读的字节数
+  double prefetchElapsedMs = 0.0;  // 预读耗时 (毫秒)
+  bool budgetReached = false;      // 是否因达到预算而提前停止
+  size_t usedFiles = 0;            // 本次会话中游戏实际使用的文件数
+  ULONGLONG usedBytes = 0;         // 本次会话中游戏实际使用的字节数
+  ULONGLONG hitBytes = 0;          // 预读且被使用的字节数
+  double hitRate = 0.0;            // 命中率 hitBytes / prefetchedBytes
+  double coverage = 0.0;           // 覆盖率 hitBytes / usedBytes
+};
+
+/**
+ * @class PrefetchManager
+ * @brief 游戏文件预读管理器类，负责学习游戏启动时读取的文件并在下次启动时预热文件缓存
+ *
+ * 游戏会话开始后，工作线程先按上次记录的清单在 I/O 预算内预读文件，
+ * 然后在学习窗口内定期扫描游戏进程中映射的镜像和数据文件，会话结束时写回清单并计算命中率。
+ * 预读使用文件映射加 PrefetchVirtualMemory，按批次提交并等待完成，保证同时在途的 I/O 有上限。
+ */
+class PrefetchManager
+{
+public:
+  // 预读报告回调函数类型
+  using ReportCallback = std::function<void(const PrefetchReport &)>;
+
+  /**
+   * @brief 构造函数
+   * @param {wstring} &manifestDirectory 清单保存目录
+   */
+  explicit PrefetchManager(const std::wstring &manifestDirectory = L"");
+  ~PrefetchManager();
+
+  // 禁用拷贝构造和赋值
+  PrefetchManager(const PrefetchManager &) = delete;
+  PrefetchManager &operator=(const PrefetchManager &) = delete;
+
+  /**
+   * @brief 设置清单保存目录
+   * @param {wstring} &manifestDirectory 清单保存目录
+   */
+  void setManifestDirectory(const std::wstring &manifestDirectory);
+
+  /**
+   * @brief 开始一次游戏会话的预读和学习
+   * @param {wstring} &gameName 游戏进程名 用作清单文件名
+   * @param {DWORD} processId 游戏进程PID
+   * @param {ULONGLONG} budgetBytes 预读预算 0 表示不限制
+   * @return {bool} 是否启动成功
+   */
+  bool startSession(const std::wstring &gameName, DWORD processId, ULONGLONG budgetBytes);
+
+  /**
+   * @brief 结束当前会话 保存清单并输出命中率
+   */
+  void stopSession();
+
+  /**
+   * @brief 设置预读报告回调
+   * @param callback 会话结束时在工作线程中调用
+   */
+  void setOnReportCallback(ReportCallback callback);
+
+private:
+  // 清单条目
+  struct ManifestEntry
+  {
+    std::wstring path;
+    ULONGLONG size = 0;
+  };
+
+  /**
+   * @brief 工作线程主函数
+   */
+  void runSession(std::wstring gameName, DWORD processId, ULONGLONG budgetBytes);
+
+  /**
+   * @brief 按清单预读文件
+   * @param {vector<ManifestEntry>} &manifest 清单
+   * @param {ULONGLONG} budgetBytes 预读预算
+   * @param {PrefetchReport} &report 预读结果
+   * @param {map<wstring, ULONGLONG>} &prefetched 输出 已预读的文件及字节数
+   */
+  void prefetchFiles(const std::vector<ManifestEntry> &manifest, ULONGLONG budgetBytes,
+                     PrefetchReport &report, std::map<std::wstring, ULONGLONG> &prefetched);
+
+  /**
+   * @brief 扫描进程中映射的文件
+   * @param {HANDLE} hProcess 进程句柄 需要 PROCESS_QUERY_INFORMATION | PROCESS_VM_READ 权限
+   * @param {vector<ManifestEntry>} &files 输出 按首次发现顺序追加新文件
+   */
+  static void collectMappedFiles(HANDLE hProcess, std::vector<ManifestEntry> &files);
+
+  /**
+   * @brief 将设备路径转换为盘符路径
+   * @param {wstring} &devicePath 形如 \Device\HarddiskVolume3\Games\a.pak
+   * @param {vector<pair<wstring, wstring>>} &dosDevices 盘符与设备名的对应关系
+   * @return {wstring} 形如 D:\Games\a.pak 转换失败时返回空字符串
+   */
+  static std::wstring devicePathToDosPath(const std::wstring &devicePath,
+                                          const std::vector<std::pair<std::wstring, std::wstring>> &dosDevices);
+
+  /**
+   * @brief 获取所有盘符对应的设备名
+   * @return {vector<pair<wstring, wstring>>} first: 盘符 (C:) second: 设备名 (\Device\HarddiskVolume3)
+   */
+  static std::vector<std::pair<std::wstring, std::wstring>> getDosDevices();
+
+  /**
+   * @brief 获取游戏对应的清单文件路径
+   */
+  std::wstring getManifestPath(const std::wstring &gameName) const;
+
+  static bool loadManifest(const std::wstring &manifestPath, std::vector<ManifestEntry> &manifest);
+  static bool saveManifest(const std::wstring &manifestPath, const std::vector<ManifestEntry> &manifest);
+
+  std::wstring m_manifestDirectory;
+  std::thread m_workerThread;
+  HANDLE m_stopEvent = nullptr;
+  std::atomic<bool> m_isRunning{false};
+  std::mutex m_setMutex;
+
+  ReportCallback m_onReportCallback = nullptr;
+
+  // 学习窗口和采样间隔 (毫秒)
+  static constexpr DWORD kLearningWindowMs = 180000;
+  static constexpr DWORD kSampleIntervalMs = 15000;
+  // 单批次映射并预读的字节数上限
+  static constexpr ULONGLONG kBatchBytes = 256ull * 1024 * 1024;
+  // 清单最多记录的文件数
+  static constexpr size_t kMaxManifestEntries = 4096;
+};
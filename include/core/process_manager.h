@@ -71,7 +71,7 @@ public:
    * @brief 启动对指定进程列表的异步监听。
    *
    * 会创建一个新的监听线程，在该线程中初始化 COM (MTA), WMI 并注册事件。
-   * @param processNames 要监听的进程名称列表 (例如 "notepad.exe")。
+   * @param processNames 要监听的进程名称列表 (例如 "notepad.exe")，为空时监听所有进程。
    * @return 如果成功启动监听线程则返回 true，否则返回 false。
    */
   bool startListening(const std::vector<std::string> &processNames);
@@ -124,6 +124,15 @@ public:
    */
   bool restrictAntiCheatProcessPS(const std::wstring &processName, DWORD processId);
 
+  /**
+   * @brief: 设置进程 I/O 优先级并校验
+   * @param wstring &processName
+   * @param DWORD processId
+   * @param ULONG ioPriority 0: 非常低 1: 低 2: 正常 3: 高
+   * @return bool 是否设置成功
+   */
+  bool restrictProcessIoPriority(const std::wstring &processName, DWORD processId, ULONG ioPriority);
+
 private:
   /**
    * @brief 监听线程的主函数。
@@ -164,7 +173,7 @@ private:
 
   /**
    * @brief 为指定的进程列表注册 WMI 事件通知。
-   * @param processNames 要监听的进程名称列表。
+   * @param processNames 要监听的进程名称列表，为空时注册一组不过滤进程名的查询。
    * @return 如果所有事件都成功注册，则返回 true，否则返回 false。
    * @note 此函数应在监听线程中，在 WMI 和 EventSink 初始化成功后调用。
    *
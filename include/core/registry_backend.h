@@ -0,0 +1,221 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 22:36:12
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 22:36:12
+ * @FilePath: \GameOptimizerPro\include\core\registry_backend.h
+ * @Description: 注册表访问后端，RegistryManager 的全部注册表调用经过该接口，Win32 实现访问系统注册表，内存实现用于基准测试
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 规范化注册表路径 转为小写并去掉多余的反斜杠 用于按路径比较和分组
+ * @param {string} &path 子键路径 例如 SYSTEM\\CurrentControlSet\\
+ * @return {string} 规范化后的路径 例如 system\\currentcontrolset
+ */
+std::string normalizeRegistryPath(const std::string &path);
+
+/**
+ * @class RegistryBackend
+ * @brief 注册表访问接口 返回值与 Win32 注册表函数相同 成功为 ERROR_SUCCESS
+ * @note hKey 参数可以是预定义根键，也可以是 openKey/createKey 返回的句柄
+ */
+class RegistryBackend
+{
+public:
+  virtual ~RegistryBackend() = default;
+
+  /**
+   * @brief 打开已存在的注册表项
+   * @param {HKEY} hKey 父项
+   * @param {string} &subKey 子键路径
+   * @param {REGSAM} access 访问权限
+   * @param {HKEY} &result 输出 打开的句柄 用 closeKey 关闭
+   */
+  virtual LONG openKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result) = 0;
+
+  /**
+   * @brief 打开注册表项 不存在时连同中间项一起创建
+   */
+  virtual LONG createKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result) = 0;
+
+  virtual LONG closeKey(HKEY hKey) = 0;
+
+  /**
+   * @brief 读取值
+   * @param {DWORD} &type 输出 值类型
+   * @param {vector<BYTE>} &data 输出 值数据
+   */
+  virtual LONG queryValue(HKEY hKey, const std::string &valueName, DWORD &type, std::vector<BYTE> &data) = 0;
+
+  virtual LONG setValue(HKEY hKey, const std::string &valueName, DWORD type, const BYTE *data, DWORD size) = 0;
+
+  virtual LONG deleteValue(HKEY hKey, const std::string &valueName) = 0;
+
+  /**
+   * @brief 删除注册表项及其全部子项
+   */
+  virtual LONG deleteTree(HKEY hKey, const std::string &subKey) = 0;
+
+  /**
+   * @brief 枚举直接子项
+   * @param {DWORD} index 从 0 开始的序号 超出时返回 ERROR_NO_MORE_ITEMS
+   * @param {string} &name 输出 子项名称
+   */
+  virtual LONG enumSubKey(HKEY hKey, DWORD index, std::string &name) = 0;
+
+  /**
+   * @brief 检查句柄指向的项是否仍然存在 项被删除后返回 ERROR_KEY_DELETED
+   */
+  virtual LONG queryKeyInfo(HKEY hKey) = 0;
+
+  virtual LONG saveKey(HKEY hKey, const std::string &filePath) = 0;
+
+  virtual LONG restoreKey(HKEY hKey, const std::string &filePath) = 0;
+
+  /**
+   * @brief 开始注册表事务
+   * @return {HANDLE} 事务句柄 后端不支持事务或创建失败时返回 nullptr，调用方改用日志补偿
+   */
+  virtual HANDLE beginTransaction()
+  {
+    return nullptr;
+  }
+
+  /**
+   * @brief 提交事务并关闭事务句柄
+   */
+  virtual LONG commitTransaction(HANDLE)
+  {
+    return ERROR_NOT_SUPPORTED;
+  }
+
+  /**
+   * @brief 回滚事务并关闭事务句柄
+   */
+  virtual LONG rollbackTransaction(HANDLE)
+  {
+    return ERROR_NOT_SUPPORTED;
+  }
+
+  /**
+   * @brief 在事务中打开或创建注册表项 通过返回的句柄所做的修改在提交前对其他句柄不可见
+   * @param {HANDLE} transaction beginTransaction 返回的事务句柄
+   */
+  virtual LONG createKeyTransacted(HKEY, const std::string &, REGSAM, HANDLE, HKEY &)
+  {
+    return ERROR_NOT_SUPPORTED;
+  }
+
+  /**
+   * @brief 在事务中打开已存在的注册表项
+   */
+  virtual LONG openKeyTransacted(HKEY, const std::string &, REGSAM, HANDLE, HKEY &)
+  {
+    return ERROR_NOT_SUPPORTED;
+  }
+};
+
+/**
+ * @class Win32RegistryBackend
+ * @brief 访问系统注册表 事务使用内核事务管理器（KTM）
+ */
+class Win32RegistryBackend : public RegistryBackend
+{
+public:
+  LONG openKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result) override;
+  LONG createKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result) override;
+  LONG closeKey(HKEY hKey) override;
+  LONG queryValue(HKEY hKey, const std::string &valueName, DWORD &type, std::vector<BYTE> &data) override;
+  LONG setValue(HKEY hKey, const std::string &valueName, DWORD type, const BYTE *data, DWORD size) override;
+  LONG deleteValue(HKEY hKey, const std::string &valueName) override;
+  LONG deleteTree(HKEY hKey, const std::string &subKey) override;
+  LONG enumSubKey(HKEY hKey, DWORD index, std::string &name) override;
+  LONG queryKeyInfo(HKEY hKey) override;
+  LONG saveKey(HKEY hKey, const std::string &filePath) override;
+  LONG restoreKey(HKEY hKey, const std::string &filePath) override;
+  HANDLE beginTransaction() override;
+  LONG commitTransaction(HANDLE transaction) override;
+  LONG rollbackTransaction(HANDLE transaction) override;
+  LONG createKeyTransacted(HKEY hKey, const std::string &subKey, REGSAM access, HANDLE transaction, HKEY &result) override;
+  LONG openKeyTransacted(HKEY hKey, const std::string &subKey, REGSAM access, HANDLE transaction, HKEY &result) override;
+};
+
+/**
+ * @class MemoryRegistryBackend
+ * @brief 内存中的注册表 路径不区分大小写 用于在没有系统注册表的环境中测试和测量 RegistryManager
+ * @note 统计打开句柄的次数，用于比较批量写入、句柄缓存前后的打开次数
+ * @note 不支持 saveKey/restoreKey，返回 ERROR_NOT_SUPPORTED
+ * @note 不支持事务，RegistryManager 的变更集改用撤销日志补偿
+ */
+class MemoryRegistryBackend : public RegistryBackend
+{
+public:
+  LONG openKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result) override;
+  LONG createKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result) override;
+  LONG closeKey(HKEY hKey) override;
+  LONG queryValue(HKEY hKey, const std::string &valueName, DWORD &type, std::vector<BYTE> &data) override;
+  LONG setValue(HKEY hKey, const std::string &valueName, DWORD type, const BYTE *data, DWORD size) override;
+  LONG deleteValue(HKEY hKey, const std::string &valueName) override;
+  LONG deleteTree(HKEY hKey, const std::string &subKey) override;
+  LONG enumSubKey(HKEY hKey, DWORD index, std::string &name) override;
+  LONG queryKeyInfo(HKEY hKey) override;
+  LONG saveKey(HKEY hKey, const std::string &filePath) override;
+  LONG restoreKey(HKEY hKey, const std::string &filePath) override;
+
+  // openKey 和 createKey 成功的次数
+  uint64_t openCount() const
+  {
+    return m_openCount.load(std::memory_order_relaxed);
+  }
+
+  // 当前未关闭的句柄数
+  size_t openHandleCount() const;
+
+private:
+  struct Value
+  {
+    DWORD type = REG_NONE;
+    std::vector<BYTE> data;
+  };
+
+  struct Key
+  {
+    // 保留原始大小写 枚举时返回
+    std::string name;
+    // key: 小写的值名称
+    std::map<std::string, Value> values;
+  };
+
+  /**
+   * @brief 把父项和子键拼成完整的规范化路径 调用方需持有 m_mutex
+   * @return {bool} hKey 不是有效的根键或句柄时返回 false
+   */
+  bool resolve(HKEY hKey, const std::string &subKey, std::string &path) const;
+
+  /**
+   * @brief 查找句柄指向的项 调用方需持有 m_mutex
+   */
+  Key *findKey(HKEY hKey, LONG &result);
+
+  HKEY allocateHandle(const std::string &path);
+
+  mutable std::mutex m_mutex;
+  // key: 规范化的完整路径 根键以其数值表示 例如 80000002\\system
+  std::map<std::string, Key> m_keys;
+  // key: 句柄 value: 句柄指向的规范化路径
+  std::unordered_map<uintptr_t, std::string> m_handles;
+  uintptr_t m_nextHandle = 0x1000;
+  std::atomic<uint64_t> m_openCount{0};
+};
@@ -0,0 +1,76 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:41:08
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:41:08
+ * @FilePath: \GameOptimizerPro\include\core\registry_journal.h
+ * @Description: 注册表撤销日志，记录变更集写入前的原始值并持久化，重启或崩溃后仍能还原
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @struct RegistryValueSnapshot
+ * @brief 注册表值在变更集写入前的状态
+ */
+struct RegistryValueSnapshot
+{
+  HKEY hRoot = nullptr;
+  std::string subKey;
+  std::string valueName;
+  // 写入前值是否存在 不存在时撤销为删除该值
+  bool existed = false;
+  DWORD type = REG_NONE;
+  std::vector<BYTE> data;
+};
+
+/**
+ * @class RegistryJournal
+ * @brief 按变更集名称保存原始值 每次修改后先写临时文件、刷盘再替换日志文件
+ * @note 未设置文件路径时只保存在内存中
+ * @note 非线程安全 由 RegistryManager 加锁调用
+ */
+class RegistryJournal
+{
+public:
+  /**
+   * @brief 从文件加载日志 文件不存在时视为空日志
+   * @param {wstring} &filePath 日志文件路径 之后的修改都写入该文件
+   * @return {bool} 文件存在但无法解析时返回false，此时日志为空，原文件重命名为 .bad
+   */
+  bool load(const std::wstring &filePath);
+
+  /**
+   * @brief 查找变更集的原始值
+   * @return {const vector<RegistryValueSnapshot> *} 没有记录时返回 nullptr
+   */
+  const std::vector<RegistryValueSnapshot> *find(const std::string &name) const;
+
+  /**
+   * @brief 记录或替换变更集的原始值并写入文件
+   * @return {bool} 写入文件失败时返回false，内存中的记录保持不变
+   */
+  bool put(const std::string &name, const std::vector<RegistryValueSnapshot> &snapshots);
+
+  /**
+   * @brief 删除变更集的记录并写入文件
+   * @return {bool} 写入文件失败时返回false，内存中的记录保持不变
+   */
+  bool erase(const std::string &name);
+
+private:
+  /**
+   * @brief 把 changeSets 写入日志文件
+   */
+  bool save(const std::map<std::string, std::vector<RegistryValueSnapshot>> &changeSets) const;
+
+  std::wstring m_filePath;
+  // key: 变更集名称 value: 按写入顺序记录的原始值
+  std::map<std::string, std::vector<RegistryValueSnapshot>> m_changeSets;
+};
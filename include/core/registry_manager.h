@@ -10,22 +10,156 @@
 
 #pragma once
 
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <windows.h>
 
 #include "log/logging.h"
+#include "core/registry_backend.h"
+#include "core/registry_journal.h"
+
+/**
+ * @struct RegistryApplyReport
+ * @brief 批量写入的结果 每个写入值或删除值操作对应一条记录
+ */
+struct RegistryApplyReport
+{
+  enum class Status
+  {
+    // 已经是目标状态 没有写入
+    Unchanged,
+    // 已写入
+    Changed,
+    // 写入失败或因同批次的其他失败被回滚
+    Failed
+  };
+
+  struct Entry
+  {
+    HKEY hRoot;
+    std::string subKey;
+    std::string valueName;
+    Status status;
+  };
+
+  std::vector<Entry> entries;
+
+  size_t count(Status status) const;
+
+  /**
+   * @brief 汇总 例如 "修改 2 项，未变 1 项，失败 0 项"
+   */
+  std::string toString() const;
+};
+
+/**
+ * @class RegistryBatch
+ * @brief 一组注册表写操作 由 RegistryManager::applyBatch 按注册表项分组执行
+ * @note 同一注册表项的操作只打开一次句柄，项内按加入的顺序执行
+ */
+class RegistryBatch
+{
+public:
+  /**
+   * @brief 确保注册表项存在 不存在时连同中间项一起创建
+   * @note 同一项的其他操作会通过创建得到的句柄执行
+   */
+  void createKey(HKEY hRoot, const std::string &subKey);
+
+  void setDWORD(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD value);
+
+  void setString(HKEY hRoot, const std::string &subKey, const std::string &valueName, const std::string &value);
+
+  /**
+   * @brief 写入任意类型的值 用于按原始类型和数据还原
+   * @param {DWORD} type 值类型 例如 REG_DWORD
+   * @param {vector<BYTE>} data 值数据
+   */
+  void setValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD type, std::vector<BYTE> data);
+
+  /**
+   * @brief 删除值 值或注册表项不存在时视为成功
+   */
+  void deleteValue(HKEY hRoot, const std::string &subKey, const std::string &valueName);
+
+  /**
+   * @brief 删除注册表项及其全部子项 项不存在时视为成功
+   * @note 无法记录整棵子树的原始值 只能通过 applyBatch 执行，不能用于变更集
+   */
+  void deleteKey(HKEY hRoot, const std::string &subKey);
+
+  /**
+   * @brief 批次涉及的注册表项 按首次出现的顺序去重
+   */
+  std::vector<std::pair<HKEY, std::string>> keys() const;
+
+  size_t size() const
+  {
+    return m_operations.size();
+  }
+
+  bool empty() const
+  {
+    return m_operations.empty();
+  }
+
+  void clear()
+  {
+    m_operations.clear();
+  }
+
+private:
+  friend class RegistryManager;
+
+  enum class OperationType
+  {
+    CreateKey,
+    SetValue,
+    DeleteValue,
+    DeleteKey
+  };
+
+  struct Operation
+  {
+    OperationType type;
+    HKEY hRoot;
+    std::string subKey;
+    std::string valueName;
+    DWORD valueType = REG_NONE;
+    std::vector<BYTE> data;
+  };
+
+  std::vector<Operation> m_operations;
+};
 
 /**
  * @class RegistryManager
  * @brief 注册表管理器类，该类负责对注册表的基本操作，包括备份、恢复、创建子键、设置值、删除键和检查键是否存在等
  * @note 该类使用单例模式实现，确保全局只有一个实例
+ * @note 注册表调用经过 RegistryBackend，默认访问系统注册表；
+ *       读操作使用最多 kKeyCacheCapacity 个只读句柄的 LRU 缓存，写操作每次单独打开句柄
+ * @note 变更集在写入前记录原始值到撤销日志，整体写入：后端支持事务时在一个注册表事务中提交，
+ *       否则失败时按写入前的值补偿
  */
 class RegistryManager
 {
 public:
-  RegistryManager();
+  /**
+   * @brief 构造函数
+   * @param {unique_ptr<RegistryBackend>} backend 注册表访问后端 为空时使用 Win32RegistryBackend
+   */
+  explicit RegistryManager(std::unique_ptr<RegistryBackend> backend = nullptr);
   ~RegistryManager();
 
+  RegistryManager(const RegistryManager &) = delete;
+  RegistryManager &operator=(const RegistryManager &) = delete;
+
   /**
    * @brief 备份注册表项
    * @param {HKEY} hRoot 根键
@@ -100,6 +234,71 @@ public:
    */
   bool checkRegistryKey(HKEY hRoot, const std::string &subKey, const std::string &keyName);
 
+  /**
+   * @brief 读取注册表项的DWORD值 使用缓存的只读句柄
+   * @param {HKEY} hRoot 根键
+   * @param {string} &subKey 子键
+   * @param {string} &valueName 值名称
+   * @param {DWORD} &value 输出 值
+   * @return {bool} 值存在且类型为 REG_DWORD 时返回true，否则返回false
+   */
+  bool getRegistryDWORDValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD &value);
+
+  /**
+   * @brief 读取注册表项的字符串值 使用缓存的只读句柄
+   * @param {string} &value 输出 值 不含结尾的空字符
+   * @return {bool} 值存在且类型为 REG_SZ 或 REG_EXPAND_SZ 时返回true，否则返回false
+   */
+  bool getRegistryStringValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, std::string &value);
+
+  /**
+   * @brief 批量执行注册表写操作 先读取全部当前值，只写入与目标不同的值，按注册表项分组，每个项只打开一次
+   * @param {RegistryBatch} &batch 操作列表 描述目标状态
+   * @param {RegistryApplyReport} *report 输出 每个值的结果 可为 nullptr
+   * @return {bool} 全部成功返回true；某个项打开失败或某个操作失败时继续执行其余操作，最后返回false
+   */
+  bool applyBatch(const RegistryBatch &batch, RegistryApplyReport *report = nullptr);
+
+  /**
+   * @brief 比较注册表的当前状态与批次描述的目标状态 不写入
+   * @param {RegistryBatch} &batch 操作列表 描述目标状态
+   * @param {RegistryApplyReport} &report 输出 与目标不同的值标记为 Changed
+   * @return {bool} 全部值都已是目标状态时返回true
+   * @note 使用缓存的只读句柄读取
+   */
+  bool compareBatch(const RegistryBatch &batch, RegistryApplyReport &report);
+
+  /**
+   * @brief 设置撤销日志文件并加载其中的记录
+   * @param {wstring} &filePath 日志文件路径 未设置时撤销日志只保存在内存中
+   * @return {bool} 日志文件无法解析时返回false
+   */
+  bool setJournalPath(const std::wstring &filePath);
+
+  /**
+   * @brief 以变更集写入一批操作 全部成功或全部不生效
+   * @param {string} &name 变更集名称 用于之后撤销
+   * @param {RegistryBatch} &batch 操作列表 其中的写入值和删除值操作会先记录原始值
+   * @param {RegistryApplyReport} *report 输出 每个值的结果 可为 nullptr
+   * @return {bool} 全部写入成功返回true；记录原始值、写入日志或任何操作失败时返回false，注册表保持写入前的状态
+   * @note 同名变更集已有记录时保留最早记录的原始值，只补充新出现的值
+   * @note 已经是目标状态的值不写入，全部值都已是目标状态时不打开任何写句柄
+   */
+  bool applyChangeSet(const std::string &name, const RegistryBatch &batch, RegistryApplyReport *report = nullptr);
+
+  /**
+   * @brief 把变更集涉及的值还原为记录的原始值 成功后删除记录
+   * @param {string} &name 变更集名称
+   * @param {RegistryApplyReport} *report 输出 每个值的结果 可为 nullptr
+   * @return {bool} 没有记录或还原失败时返回false，失败时记录保留，可以再次撤销
+   */
+  bool revertChangeSet(const std::string &name, RegistryApplyReport *report = nullptr);
+
+  /**
+   * @brief 变更集是否有原始值记录
+   */
+  bool hasChangeSet(const std::string &name);
+
   /**
    * @brief 获取所有网络接口卡ID
    * @param hRoot 注册表根键
@@ -125,4 +324,89 @@ public:
    * @return 成功时返回true，失败时返回false
    */
   bool filterInvalidNetworkInterfaceCardIds(HKEY hRoot, const std::string &subKey, std::vector<std::string> &nicIds);
+
+  /**
+   * @brief 一次枚举出含有指定子项的子项名称 例如 Image File Execution Options 下含有 PerfOptions 的进程名
+   * @param {HKEY} hRoot 注册表根键
+   * @param {string} &subKey 要枚举的注册表项
+   * @param {string} &childName 子项下要查找的项名称
+   * @param {unordered_set<string>} &names 输出 转为小写的子项名称
+   * @return {bool} 打开 subKey 失败时返回false
+   * @note subKey 只打开一次，各子项相对其句柄打开后立即关闭，不占用只读句柄缓存
+   */
+  bool getSubKeysWithChild(HKEY hRoot, const std::string &subKey, const std::string &childName, std::unordered_set<std::string> &names);
+
+private:
+  // 缓存的只读句柄数量上限 覆盖网卡类 GUID 下的全部子项
+  static constexpr size_t kKeyCacheCapacity = 64;
+
+  struct CachedKey
+  {
+    std::string cacheKey;
+    HKEY hKey;
+  };
+
+  /**
+   * @brief 读取批量操作涉及的当前值 只保留会改变注册表的操作
+   * @param {RegistryBatch} &pending 输出 需要执行的操作 创建项的操作只在项不存在时保留
+   * @param {vector<size_t>} &entryIndex 输出 pending 中每个操作对应的 report 条目序号 创建项的操作为 SIZE_MAX
+   * @param {RegistryApplyReport} &report 输出 每个写入值或删除值操作一条记录 需要写入的记为 Changed
+   * @param {vector<RegistryValueSnapshot>} *before 输出 每个值第一次出现时的当前值 可为 nullptr
+   * @return {bool} before 不为 nullptr 且读取出错时返回false；否则读取出错的值照常写入
+   */
+  bool planBatch(const RegistryBatch &batch, RegistryBatch &pending, std::vector<size_t> &entryIndex,
+                 RegistryApplyReport &report, std::vector<RegistryValueSnapshot> *before);
+
+  /**
+   * @brief 按组写入批量操作
+   * @param {HANDLE} transaction 事务句柄 为 nullptr 时直接写入
+   * @param {bool} stopOnError 是否在第一个失败的操作处停止
+   * @param {vector<bool>} *failed 输出 每个操作是否失败 与 batch 中的顺序相同 可为 nullptr
+   * @return {bool} 全部成功返回true
+   */
+  bool writeBatch(const RegistryBatch &batch, HANDLE transaction, bool stopOnError, std::vector<bool> *failed);
+
+  /**
+   * @brief 整体写入 支持事务时在事务中写入并提交，否则失败时写入 before 补偿
+   * @param {vector<RegistryValueSnapshot>} *before 写入前的值 为 nullptr 时不补偿，继续写入其余操作
+   * @param {vector<bool>} *failed 输出 每个操作是否失败 回滚或补偿时全部记为失败 可为 nullptr
+   */
+  bool writeAtomically(const RegistryBatch &batch, const std::vector<RegistryValueSnapshot> *before, std::vector<bool> *failed);
+
+  /**
+   * @brief 把写入失败的操作对应的条目记为 Failed
+   */
+  static void markFailed(const std::vector<size_t> &entryIndex, const std::vector<bool> &failed, RegistryApplyReport &report);
+
+  /**
+   * @brief 读取值的当前状态 项或值不存在时 existed 为 false
+   * @return {bool} 读取出错时返回false
+   */
+  bool captureValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, RegistryValueSnapshot &snapshot);
+
+  /**
+   * @brief 用缓存的只读句柄执行读操作 句柄指向的项已被删除时重新打开一次
+   * @param {function<LONG(HKEY)>} read 读操作 在持有缓存锁时调用
+   * @return {LONG} 打开失败时为打开的错误码，否则为读操作的返回值
+   */
+  LONG readWithCachedKey(HKEY hRoot, const std::string &subKey, const std::function<LONG(HKEY)> &read);
+
+  /**
+   * @brief 查找或打开只读句柄 调用方需持有 m_keyCacheMutex
+   */
+  LONG acquireCachedKey(HKEY hRoot, const std::string &subKey, HKEY &hKey);
+
+  /**
+   * @brief 关闭 subKey 及其子项的缓存句柄 调用方需持有 m_keyCacheMutex
+   */
+  void evictCachedKeys(HKEY hRoot, const std::string &subKey);
+
+  std::unique_ptr<RegistryBackend> m_backend;
+  // 保护撤销日志 同一时间只写入一个变更集
+  std::mutex m_changeSetMutex;
+  RegistryJournal m_journal;
+  std::mutex m_keyCacheMutex;
+  // 最近使用的在前
+  std::list<CachedKey> m_keyCache;
+  std::unordered_map<std::string, std::list<CachedKey>::iterator> m_keyCacheIndex;
 };
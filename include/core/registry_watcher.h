@@ -0,0 +1,189 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:56:12
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:56:12
+ * @FilePath: \GameOptimizerPro\include\core\registry_watcher.h
+ * @Description: 注册表变更监视器，检测已开启的优化被其他程序改回并重新写入
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "log/logging.h"
+
+/**
+ * @class RegistryWatcher
+ * @brief 注册表变更监视器类，在优化涉及的注册表项被修改时通知调用方检查偏离
+ *
+ * 对每个注册表项调用 RegNotifyChangeKeyValue 注册变更事件，所有事件由一个监视线程
+ * 通过 WaitForMultipleObjects 等待，没有变更时不轮询。
+ * 变更先合并一段时间再检查；每个监视的检查有最小间隔，重新写入次数超出上限后只报告偏离，
+ * 避免与其他程序反复争夺同一个值。
+ */
+class RegistryWatcher
+{
+public:
+  // 检测到偏离时的处理方式
+  enum class DriftAction
+  {
+    Reapply, // 重新写入目标值
+    Report   // 重新写入次数已达上限 只报告
+  };
+
+  /**
+   * 检查回调函数类型 在监视线程中调用
+   * @return 是否检测到偏离
+   */
+  using CheckCallback = std::function<bool(DriftAction)>;
+
+  // 监视进入只报告状态时的回调函数类型 参数为监视名称
+  using ThrottledCallback = std::function<void(const std::string &)>;
+
+  RegistryWatcher();
+  ~RegistryWatcher();
+
+  // 禁用拷贝构造和赋值
+  RegistryWatcher(const RegistryWatcher &) = delete;
+  RegistryWatcher &operator=(const RegistryWatcher &) = delete;
+
+  /**
+   * @brief 监视一组注册表项 同名监视已存在时替换
+   * @param {string} &name 监视名称 例如变更集名称
+   * @param {vector<pair<HKEY, string>>} &keys 注册表项 只监视项中值的变化，不含子项
+   * @param {CheckCallback} callback 检查回调 添加后立即检查一次，之后在项变化时检查
+   * @param {bool} watchSubtree 是否同时监视子项的创建、删除和子项中值的变化
+   * @return {bool} 监视线程启动失败时返回false
+   * @note 不能在回调中调用
+   */
+  bool watch(const std::string &name, const std::vector<std::pair<HKEY, std::string>> &keys, CheckCallback callback,
+             bool watchSubtree = false);
+
+  /**
+   * @brief 停止监视 正在执行的检查回调结束后才返回
+   * @note 不能在回调中调用
+   */
+  void unwatch(const std::string &name);
+
+  /**
+   * @brief 计划检查一次 与注册表变更一样合并并遵守最小检查间隔
+   * @note 可以在回调中和其他线程中调用 未监视时忽略
+   */
+  void check(const std::string &name);
+
+  /**
+   * @brief 替换监视的注册表项 保留检查计划和重新写入次数
+   * @return {bool} 注册表项是否变化 没有变化时不重新注册
+   * @note 可以在回调中调用
+   */
+  bool updateKeys(const std::string &name, const std::vector<std::pair<HKEY, std::string>> &keys);
+
+  /**
+   * @brief 停止监视线程并清空所有监视
+   * @note 不能在回调中调用
+   */
+  void stop();
+
+  /**
+   * @brief 设置进入只报告状态时的回调
+   * @param callback 在监视线程中调用，每个重新写入周期内最多调用一次
+   */
+  void setOnThrottledCallback(ThrottledCallback callback);
+
+private:
+  struct Watch
+  {
+    std::vector<std::pair<HKEY, std::string>> keys;
+    CheckCallback callback;
+    bool watchSubtree = false;
+    // 计划检查的时间 (GetTickCount64) 0 表示没有计划
+    ULONGLONG dueTick = 0;
+    ULONGLONG lastCheckTick = 0;
+    // 重新写入周期内每次重新写入的时间
+    std::deque<ULONGLONG> reapplyTicks;
+    bool throttled = false;
+  };
+
+  // 监视线程中打开的注册表项 句柄只在监视线程中使用
+  struct WatchedKey
+  {
+    std::string name;
+    HKEY hKey = nullptr;
+    HANDLE event = nullptr;
+    bool watchSubtree = false;
+  };
+
+  /**
+   * @brief 启动监视线程 调用方持有 m_setMutex
+   */
+  bool startLocked();
+
+  /**
+   * @brief 监视线程主函数
+   */
+  void runWatchLoop();
+
+  /**
+   * @brief 按当前的监视重新打开注册表项并注册变更事件
+   * @return {size_t} 无法打开的注册表项数 例如项已被删除
+   */
+  size_t rebuildWatchedKeys(std::vector<WatchedKey> &watchedKeys);
+
+  /**
+   * @brief 注册下一次变更事件 每次事件触发后都需要重新注册
+   */
+  static bool armWatchedKey(const WatchedKey &watchedKey);
+
+  static void closeWatchedKeys(std::vector<WatchedKey> &watchedKeys);
+
+  /**
+   * @brief 计划检查 已有计划时保持不变 调用方持有 m_watchMutex
+   */
+  void scheduleCheckLocked(Watch &watch);
+
+  /**
+   * @brief 执行到期的检查
+   * @param {bool} &checked 输出 是否执行了检查
+   * @return {DWORD} 距下一次计划检查的毫秒数 没有计划时为 INFINITE
+   */
+  DWORD runDueChecks(bool &checked);
+
+  HANDLE m_stopEvent = nullptr;
+  // 监视集合变化时通知监视线程重新注册
+  HANDLE m_wakeEvent = nullptr;
+
+  std::thread m_watchThread;
+  std::atomic<bool> m_isRunning{false};
+  std::mutex m_setMutex;
+
+  // 保护 m_watches 和 m_watchesChanged
+  std::mutex m_watchMutex;
+  // 执行检查回调期间持有 先于 m_watchMutex 加锁
+  std::mutex m_callbackMutex;
+  std::map<std::string, Watch> m_watches;
+  bool m_watchesChanged = false;
+
+  // WaitForMultipleObjects 最多等待 64 个句柄 其中两个为停止和唤醒事件
+  static constexpr size_t kMaxWatchedKeys = MAXIMUM_WAIT_OBJECTS - 2;
+
+  ThrottledCallback m_onThrottledCallback = nullptr;
+
+  // 变更后等待合并的时间 (毫秒) 写入多个值时只检查一次
+  static constexpr DWORD kDebounceMs = 1000;
+  // 同一监视两次检查的最小间隔 (毫秒)
+  static constexpr DWORD kMinCheckIntervalMs = 5000;
+  // 重新写入周期 (毫秒) 和周期内的重新写入次数上限
+  static constexpr DWORD kReapplyWindowMs = 10 * 60 * 1000;
+  static constexpr size_t kMaxReappliesPerWindow = 3;
+};
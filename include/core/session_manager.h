@@ -0,0 +1,138 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 10:40:18
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 10:40:18
+ * @FilePath: \GameOptimizerPro\include\core\session_manager.h
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <atomic>
+
+#include "log/logging.h"
+#include "core/game_database.h"
+#include "utils/system_utils.h"
+
+/**
+ * @class SessionManager
+ * @brief 游戏会话管理器类，负责判断游戏会话的开始和结束
+ *
+ * 不单独订阅进程事件，由 Optimizer 把共享的进程创建和销毁事件转发给 onProcessCreated/onProcessDestroyed，
+ * 第一个游戏进程启动时视为会话开始，最后一个游戏进程退出时视为会话结束，
+ * 并通过回调通知需要在游戏期间生效的各项优化操作。
+ * 配置中的游戏进程和游戏数据库中的游戏均视为游戏进程。
+ */
+class SessionManager
+{
+public:
+  // 会话回调函数类型 参数为触发该事件的游戏进程名和PID
+  using SessionCallback = std::function<void(const std::wstring &, DWORD)>;
+
+  SessionManager();
+  ~SessionManager();
+
+  // 禁用拷贝构造和赋值
+  SessionManager(const SessionManager &) = delete;
+  SessionManager &operator=(const SessionManager &) = delete;
+
+  /**
+   * @brief 设置游戏数据库
+   * @param {shared_ptr<const GameDatabase>} gameDatabase 已打开的游戏数据库 为空时只使用配置中的游戏进程
+   * @note 在下一次 startMonitoring 时生效
+   */
+  void setGameDatabase(std::shared_ptr<const GameDatabase> gameDatabase);
+
+  /**
+   * @brief 开始处理游戏进程事件
+   * @param {vector<std::string>} &gameProcessNames 游戏进程名列表 设置了游戏数据库时可以为空
+   * @return {bool} 游戏进程列表为空且没有游戏数据库时返回false
+   * @note 订阅进程事件后应调用 scanRunningGameProcesses，游戏先于监听启动时也能进入会话
+   */
+  bool startMonitoring(const std::vector<std::string> &gameProcessNames);
+
+  /**
+   * @brief 停止处理游戏进程事件
+   * @return {bool} 是否停止成功
+   * @note 如果会话仍在进行中，会先触发会话结束回调以便各项操作还原
+   */
+  bool stopMonitoring();
+
+  /**
+   * @brief 是否正在监听游戏进程
+   * @return {bool}
+   */
+  bool isMonitoring() const;
+
+  /**
+   * @brief 游戏会话是否正在进行
+   * @return {bool}
+   */
+  bool isSessionActive() const;
+
+  /**
+   * @brief 获取当前正在运行的游戏进程PID
+   * @return {vector<DWORD>} 游戏进程PID列表
+   */
+  std::vector<DWORD> getGameProcessIds() const;
+
+  /**
+   * @brief 设置会话开始回调
+   * @param callback 第一个游戏进程启动时调用
+   */
+  void setOnSessionStartedCallback(SessionCallback callback);
+
+  /**
+   * @brief 设置会话结束回调
+   * @param callback 最后一个游戏进程退出时调用
+   */
+  void setOnSessionEndedCallback(SessionCallback callback);
+
+  /**
+   * @brief 进程创建事件处理 未开始监听或不是游戏进程时忽略
+   * @param processName 进程名
+   * @param processId 进程PID
+   */
+  void onProcessCreated(const std::wstring &processName, DWORD processId);
+
+  /**
+   * @brief 进程销毁事件处理 不是会话中记录的游戏进程时忽略
+   * @param processName 进程名
+   * @param processId 进程PID
+   */
+  void onProcessDestroyed(const std::wstring &processName, DWORD processId);
+
+  /**
+   * @brief 扫描已经在运行的游戏进程
+   */
+  void scanRunningGameProcesses();
+
+private:
+  /**
+   * @brief 判断进程是否为游戏进程
+   * @param {wstring} &processName 进程名
+   * @return {bool} 在配置的游戏进程列表中或在游戏数据库中登记为游戏
+   */
+  bool isGameProcess(const std::wstring &processName) const;
+
+  std::atomic<bool> m_isMonitoring{false};
+
+  // 正在运行的游戏进程 key: PID value: 进程名
+  std::map<DWORD, std::wstring> m_gameProcesses;
+  // 配置中的游戏进程名
+  std::vector<std::wstring> m_gameProcessNames;
+  std::shared_ptr<const GameDatabase> m_gameDatabase{nullptr};
+  mutable std::mutex m_mutex;
+
+  SessionCallback m_onSessionStartedCallback = nullptr;
+  SessionCallback m_onSessionEndedCallback = nullptr;
+};
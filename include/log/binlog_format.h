@@ -0,0 +1,288 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 17:20:45
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 17:20:45
+ * @FilePath: \GameOptimizerPro\include\log\binlog_format.h
+ * @Description: 二进制日志格式定义（程序和 LogDecoder 共用）
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/**
+ * 二进制日志文件布局（小端）
+ *
+ *   FileHeader
+ *   Record...
+ *
+ * 每条记录以 1 字节 RecordType 开头：
+ *   Site:  uint32 siteId, uint8 level, int32 line,
+ *          uint16 functionBytes, function, uint16 fileBytes, file, uint32 formatBytes, format
+ *   Event: uint32 siteId, uint64 timestamp(UTC FILETIME), int32 hr, uint32 argsBytes, args
+ *
+ * 日志点第一次出现在文件中时先写一条 Site 记录，之后的 Event 只引用编号。
+ * 参数区由若干个 1 字节 ArgType 开头的参数组成，整数和浮点数为 8 字节，
+ * 布尔值为 1 字节，字符串为 uint32 字节数加原始字节（UTF-8 或 UTF-16LE）。
+ * 格式串中的 {} 依次替换为参数。
+ *
+ * 文本日志和 LogDecoder 的输出都是 UTF-8，下面的转换函数由两者共用。
+ */
+namespace BinLog
+{
+  constexpr char kMagic[8] = {'G', 'O', 'P', 'B', 'L', 'O', 'G', '\0'};
+  constexpr uint32_t kVersion = 1;
+
+#pragma pack(push, 1)
+  struct FileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+  };
+#pragma pack(pop)
+
+  enum class RecordType : uint8_t
+  {
+    Site = 1,
+    Event = 2
+  };
+
+  enum class ArgType : uint8_t
+  {
+    Int = 1,
+    UInt = 2,
+    Double = 3,
+    Bool = 4,
+    Utf8 = 5,
+    Utf16 = 6
+  };
+
+  /**
+   * @struct Arg
+   * @brief 解码后的参数 字符串参数指向参数区中的原始字节
+   */
+  struct Arg
+  {
+    ArgType type = ArgType::Int;
+    int64_t intValue = 0;
+    uint64_t uintValue = 0;
+    double doubleValue = 0.0;
+    bool boolValue = false;
+    const char *data = nullptr;
+    uint32_t bytes = 0;
+  };
+
+  /**
+   * @brief 从参数区读取一个参数
+   * @param {const char *&} cursor 读取位置 成功后移动到下一个参数
+   * @param {const char *} end 参数区末尾
+   * @param {Arg} &arg 输出
+   * @return {bool} 参数区已读完或数据损坏时返回 false
+   */
+  inline bool readArg(const char *&cursor, const char *end, Arg &arg)
+  {
+    if (cursor >= end)
+    {
+      return false;
+    }
+
+    arg.type = static_cast<ArgType>(*cursor);
+    const char *value = cursor + 1;
+    size_t size = 0;
+    switch (arg.type)
+    {
+    case ArgType::Int:
+    case ArgType::UInt:
+    case ArgType::Double:
+      size = 8;
+      if (static_cast<size_t>(end - value) < size)
+      {
+        return false;
+      }
+      std::memcpy(&arg.intValue, value, 8);
+      std::memcpy(&arg.uintValue, value, 8);
+      std::memcpy(&arg.doubleValue, value, 8);
+      break;
+    case ArgType::Bool:
+      size = 1;
+      if (end - value < 1)
+      {
+        return false;
+      }
+      arg.boolValue = *value != 0;
+      break;
+    case ArgType::Utf8:
+    case ArgType::Utf16:
+      if (end - value < 4)
+      {
+        return false;
+      }
+      std::memcpy(&arg.bytes, value, 4);
+      value += 4;
+      size = arg.bytes;
+      if (static_cast<size_t>(end - value) < size)
+      {
+        return false;
+      }
+      arg.data = value;
+      break;
+    default:
+      return false;
+    }
+
+    cursor = value + size;
+    return true;
+  }
+
+  /**
+   * @brief 按格式串渲染消息
+   * @param {const char *} format 格式串 {} 为参数占位符
+   * @param {const char *} args 参数区
+   * @param {size_t} argsBytes 参数区字节数
+   * @param onText 追加格式串中的文本片段 (const char *text, size_t length)
+   * @param onArg 追加一个参数 (const Arg &)
+   * @note 参数多于占位符时多余的参数依次追加在末尾 少于占位符时保留 {}
+   */
+  template <typename OnText, typename OnArg>
+  void render(const char *format, const char *args, size_t argsBytes, OnText &&onText, OnArg &&onArg)
+  {
+    const char *cursor = args;
+    const char *end = args + argsBytes;
+    const char *text = format;
+    Arg arg;
+
+    for (const char *p = format; *p; ++p)
+    {
+      if (p[0] == '{' && p[1] == '}')
+      {
+        if (!readArg(cursor, end, arg))
+        {
+          continue;
+        }
+        onText(text, static_cast<size_t>(p - text));
+        onArg(arg);
+        ++p;
+        text = p + 1;
+      }
+    }
+    onText(text, std::strlen(text));
+
+    while (readArg(cursor, end, arg))
+    {
+      onText(" ", 1);
+      onArg(arg);
+    }
+  }
+
+  /**
+   * @brief 把 UTF-16LE 字节追加为 UTF-8
+   * @param {string} &output 输出
+   * @param {const char *} data UTF-16LE 字节 不要求按 2 字节对齐
+   * @param {size_t} bytes 字节数
+   * @note ASCII 字符直接复制，非法的代理项替换为 U+FFFD
+   */
+  inline void appendUtf16(std::string &output, const char *data, size_t bytes)
+  {
+    const unsigned char *units = reinterpret_cast<const unsigned char *>(data);
+    const size_t count = bytes / 2;
+    auto unitAt = [units](size_t index)
+    {
+      return static_cast<uint32_t>(units[index * 2]) | (static_cast<uint32_t>(units[index * 2 + 1]) << 8);
+    };
+
+    size_t offset = output.size();
+    output.resize(offset + count * 3);
+    char *out = &output[0];
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint32_t codePoint = unitAt(i);
+      if (codePoint < 0x80)
+      {
+        out[offset++] = static_cast<char>(codePoint);
+        continue;
+      }
+
+      if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < count && unitAt(i + 1) >= 0xDC00 && unitAt(i + 1) <= 0xDFFF)
+      {
+        // 代理对共占 6 字节 输出 4 字节 不会超出预留的空间
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (unitAt(i + 1) - 0xDC00);
+        ++i;
+      }
+      else if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+      {
+        codePoint = 0xFFFD;
+      }
+
+      if (codePoint < 0x800)
+      {
+        out[offset++] = static_cast<char>(0xC0 | (codePoint >> 6));
+        out[offset++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+      else if (codePoint < 0x10000)
+      {
+        out[offset++] = static_cast<char>(0xE0 | (codePoint >> 12));
+        out[offset++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[offset++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+      else
+      {
+        out[offset++] = static_cast<char>(0xF0 | (codePoint >> 18));
+        out[offset++] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out[offset++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[offset++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+    }
+    output.resize(offset);
+  }
+
+  /**
+   * @brief 把整数追加为十进制文本
+   */
+  template <typename T>
+  void appendNumber(std::string &output, T value)
+  {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    output.append(buffer, static_cast<size_t>(result.ptr - buffer));
+  }
+
+  /**
+   * @brief 把参数追加为 UTF-8 文本
+   */
+  inline void appendArgText(std::string &output, const Arg &arg)
+  {
+    switch (arg.type)
+    {
+    case ArgType::Int:
+      appendNumber(output, arg.intValue);
+      break;
+    case ArgType::UInt:
+      appendNumber(output, arg.uintValue);
+      break;
+    case ArgType::Double:
+    {
+      char buffer[32];
+      const int length = std::snprintf(buffer, sizeof(buffer), "%g", arg.doubleValue);
+      output.append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+      break;
+    }
+    case ArgType::Bool:
+      output += arg.boolValue ? "true" : "false";
+      break;
+    case ArgType::Utf8:
+      output.append(arg.data, arg.bytes);
+      break;
+    case ArgType::Utf16:
+      appendUtf16(output, arg.data, arg.bytes);
+      break;
+    }
+  }
+} // namespace BinLog
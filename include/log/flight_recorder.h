@@ -0,0 +1,90 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 19:48:51
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 19:48:51
+ * @FilePath: \GameOptimizerPro\include\log\flight_recorder.h
+ * @Description: 飞行记录器，在内存中循环保存最近的日志记录（包括未写入文件的调试日志）
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "log/log_queue.h"
+
+/**
+ * @class FlightRecorder
+ * @brief 固定大小的无锁环形缓冲，保存最近的日志记录头和原始参数
+ * @note 写入只有一次 fetch_add 和一次 memcpy，不格式化、不分配内存，满了直接覆盖最旧的记录
+ * @note 每个槽带有序号（顺序锁），读取时序号前后一致才算有效；
+ *       同一个槽只有在一条记录写入期间环形缓冲被绕过一整圈时才会有两个写入者，这种记录可能不完整，
+ *       解码参数时会检查边界
+ * @note 参数区超过 kSlotArgsBytes 时截断，跨过末尾的字符串参数截短，其余参数在转储时按缺少参数处理
+ */
+class FlightRecorder
+{
+public:
+  // 单个槽的大小 包含序号和记录头
+  static constexpr size_t kSlotSize = 256;
+  // 每个槽可用于存放参数区的字节数
+  static constexpr size_t kSlotArgsBytes = kSlotSize - sizeof(uint64_t) - sizeof(LogRecordHeader);
+
+  /**
+   * @brief 构造函数
+   * @param {size_t} slotCount 槽数量 向上取整为 2 的幂
+   */
+  explicit FlightRecorder(size_t slotCount);
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  /**
+   * @brief 记录一条日志 任何线程都可以调用
+   * @param {LogRecordHeader} &header 记录头
+   * @param {const void *} args 参数区
+   */
+  void record(const LogRecordHeader &header, const void *args);
+
+  /**
+   * @brief 读取指定序号的记录
+   * @param {uint64_t} index 记录序号 有效范围为 [end() - capacity(), end())
+   * @param {LogRecordHeader} &header 输出 记录头 argsBytes 为截断后的长度
+   * @param {char *} args 输出 参数区 至少 kSlotArgsBytes 字节
+   * @return {bool} 记录已被覆盖或正在写入时返回 false
+   */
+  bool read(uint64_t index, LogRecordHeader &header, char *args) const;
+
+  /**
+   * @brief 下一条记录的序号 即已记录的总数
+   */
+  uint64_t end() const
+  {
+    return m_next.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const
+  {
+    return m_mask + 1;
+  }
+
+private:
+  struct Slot
+  {
+    // 0 表示空槽 序号为 i 的记录写入中为 2i+1，写完为 2i+2
+    std::atomic<uint64_t> sequence{0};
+    LogRecordHeader header;
+    char args[kSlotArgsBytes];
+  };
+
+  static_assert(sizeof(Slot) == kSlotSize, "FlightRecorder slot layout");
+
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask;
+  alignas(64) std::atomic<uint64_t> m_next{0};
+};
@@ -0,0 +1,89 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 18:20:37
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 18:20:37
+ * @FilePath: \GameOptimizerPro\include\log\log_archiver.h
+ * @Description: 日志归档线程，压缩轮换出的日志分段并按保留数量清理
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <windows.h>
+
+/**
+ * @class LogArchiver
+ * @brief 日志归档器，在后台线程中压缩日志分段并删除超出保留数量的旧分段
+ * @note 日志文件 dir/stem.ext 轮换出的分段命名为 dir/stem.YYYYMMDD-HHMMSS-mmm.ext，
+ *       压缩后为 dir/stem.YYYYMMDD-HHMMSS-mmm.ext.gz（gzip 格式，可直接用常见解压工具打开）
+ * @note 写线程只负责重命名当前文件并提交归档请求，不等待压缩完成；
+ *       归档线程不持有日志文件锁，可以正常记录日志
+ */
+class LogArchiver
+{
+public:
+  LogArchiver();
+  ~LogArchiver();
+
+  LogArchiver(const LogArchiver &) = delete;
+  LogArchiver &operator=(const LogArchiver &) = delete;
+
+  /**
+   * @brief 设置归档参数 下一次整理时生效
+   * @param {int} maxArchives 每个日志文件保留的分段数量 0 表示不清理
+   * @param {bool} compress 是否压缩分段
+   */
+  void configure(int maxArchives, bool compress);
+
+  /**
+   * @brief 请求整理指定日志文件的分段 压缩尚未压缩的分段并清理超出保留数量的分段
+   * @param {wstring} &logFilePath 当前日志文件路径
+   * @note 只把请求放入队列，立即返回；同一个日志文件已在队列中时不重复添加
+   */
+  void submit(const std::wstring &logFilePath);
+
+  /**
+   * @brief 停止归档线程 正在压缩的分段放弃压缩，下次启动时重新处理
+   */
+  void stop();
+
+  /**
+   * @brief 生成分段的文件名
+   * @param {wstring} &logFilePath 当前日志文件路径
+   * @param {SYSTEMTIME} &localTime 轮换时间（本地时间）
+   * @return {wstring} 分段路径
+   */
+  static std::wstring segmentPath(const std::wstring &logFilePath, const SYSTEMTIME &localTime);
+
+private:
+  void workerLoop();
+
+  /**
+   * @brief 整理一个日志文件的分段
+   */
+  void maintain(const std::wstring &logFilePath);
+
+  /**
+   * @brief 把分段压缩为 gzip 文件 成功后删除原分段
+   * @return {bool} 是否压缩成功
+   */
+  bool compressSegment(const std::wstring &segment);
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<std::wstring> m_pending;
+  bool m_stop = false;
+  // 压缩过程中检查 以便尽快退出
+  std::atomic<bool> m_abort{false};
+
+  std::atomic<int> m_maxArchives{0};
+  std::atomic<bool> m_compress{false};
+};
@@ -0,0 +1,106 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 19:12:26
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 19:12:26
+ * @FilePath: \GameOptimizerPro\include\log\log_limiter.h
+ * @Description: 日志限流，按日志点和错误码合并重复的错误日志
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <windows.h>
+
+struct LogSite;
+
+/**
+ * @class LogLimiter
+ * @brief 日志限流器，由 LOG_*_LIMITED 宏在每个调用位置静态定义
+ * @note 同一日志点的每个错误码使用一个令牌桶：桶容量为 burst，每个窗口补充 burst 个令牌，
+ *       令牌用完后的记录只计数，窗口结束后写出一条“重复 K 次”的汇总
+ * @note 被合并的记录不进入日志队列，也不会刷盘；只在日志点开启时才会调用
+ */
+class LogLimiter
+{
+public:
+  constexpr LogLimiter() = default;
+
+  LogLimiter(const LogLimiter &) = delete;
+  LogLimiter &operator=(const LogLimiter &) = delete;
+
+  /**
+   * @brief 判断这条记录是否写出 需要时先写出之前被合并记录的汇总
+   * @param {LogSite} &site 日志点
+   * @param {HRESULT} hr 错误码 与日志点一起作为限流的键
+   * @return {bool} 是否写出
+   */
+  bool allow(const LogSite &site, HRESULT hr);
+
+  /**
+   * @brief 设置限流参数 立即对所有日志点生效
+   * @param {int} burst 每个日志点和错误码在一个窗口内最多写出的记录数 0 表示不限流
+   * @param {int} windowSeconds 窗口长度 秒
+   */
+  static void configure(int burst, int windowSeconds);
+
+  /**
+   * @brief 写出所有日志点尚未写出的汇总 关闭日志前调用
+   */
+  static void flushAll();
+
+private:
+  // 每个日志点跟踪的错误码数量 超出时替换最久未出现的错误码
+  static constexpr size_t kSlots = 4;
+
+  struct Slot
+  {
+    HRESULT hr = S_OK;
+    bool used = false;
+    // 剩余令牌 以千分之一个令牌为单位 避免浮点运算
+    uint64_t tokens = 0;
+    uint64_t lastRefillMs = 0;
+    uint64_t lastSeenMs = 0;
+    // 第一条被合并记录的时间和被合并的数量
+    uint64_t suppressedSinceMs = 0;
+    uint64_t suppressed = 0;
+  };
+
+  // 需要写出的汇总 在释放自旋锁后写出
+  struct Summary
+  {
+    HRESULT hr = S_OK;
+    uint64_t count = 0;
+    uint64_t elapsedMs = 0;
+  };
+
+  void lock();
+  void unlock();
+
+  /**
+   * @brief 取出槽中被合并的数量作为汇总 调用方需持有自旋锁
+   */
+  static bool takeSummary(Slot &slot, uint64_t now, Summary &summary);
+
+  /**
+   * @brief 写出一条汇总记录
+   */
+  static void writeSummary(const LogSite &site, const Summary &summary);
+
+  /**
+   * @brief 第一次调用时加入全局链表 供 flushAll 遍历
+   */
+  void registerOnce(const LogSite &site);
+
+  std::atomic_flag m_lock = ATOMIC_FLAG_INIT;
+  std::atomic<bool> m_registered{false};
+  const LogSite *m_site = nullptr;
+  LogLimiter *m_next = nullptr;
+  Slot m_slots[kSlots] = {};
+
+  static std::atomic<LogLimiter *> s_head;
+  static std::atomic<int> s_burst;
+  static std::atomic<int> s_windowMs;
+};
@@ -0,0 +1,115 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 16:41:27
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 16:41:27
+ * @FilePath: \GameOptimizerPro\include\log\log_queue.h
+ * @Description: 异步日志使用的多生产者单消费者环形队列
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct LogSite;
+
+/**
+ * @struct LogRecordHeader
+ * @brief 日志记录头，紧跟编码后的参数区
+ * @note 日志点的级别、函数名、行号和格式串都在静态的 LogSite 中，记录只保存指针；
+ *       格式化和编码转换都在写线程中完成
+ */
+struct LogRecordHeader
+{
+  // 记录时间 UTC FILETIME
+  uint64_t timestamp = 0;
+  LogSite *site = nullptr;
+  int32_t hr = 0;
+  uint32_t argsBytes = 0;
+};
+
+/**
+ * @class LogQueue
+ * @brief 有界的多生产者单消费者环形队列
+ * @note 队列由固定大小的槽组成，每个槽带有序号（Vyukov 有界队列），
+ *       一条记录按长度占用一个或多个连续的槽，生产者用一次 CAS 认领所需的槽，
+ *       写完后逐个发布；消费者按顺序取出记录并归还槽位，全程不加锁
+ */
+class LogQueue
+{
+public:
+  // 单个槽的大小 包含 8 字节序号
+  static constexpr size_t kSlotSize = 128;
+  // 每个槽可用于存放数据的字节数
+  static constexpr size_t kSlotPayload = kSlotSize - sizeof(uint64_t);
+  // 单条记录最多占用的槽数
+  static constexpr size_t kMaxRecordSlots = 64;
+  // 单条记录参数区的最大字节数 由生产者在编码参数时保证
+  static constexpr size_t kMaxArgsBytes = kMaxRecordSlots * kSlotPayload - sizeof(LogRecordHeader);
+
+  /**
+   * @brief 构造函数
+   * @param {size_t} slotCount 槽数量 向上取整为 2 的幂
+   */
+  explicit LogQueue(size_t slotCount);
+  ~LogQueue();
+
+  LogQueue(const LogQueue &) = delete;
+  LogQueue &operator=(const LogQueue &) = delete;
+
+  /**
+   * @brief 写入一条记录
+   * @param {LogRecordHeader} &header 记录头 argsBytes 不超过 kMaxArgsBytes
+   * @param {const void *} args 参数区
+   * @param {bool} waitIfFull 队列已满时是否等待消费者腾出空间
+   * @return {bool} 是否写入 队列已满且不等待时返回 false
+   */
+  bool push(const LogRecordHeader &header, const void *args, bool waitIfFull);
+
+  /**
+   * @brief 取出一条记录
+   * @param {vector<char>} &record 输出 记录头加参数区 重复使用以避免分配
+   * @return {bool} 队列为空时返回 false
+   * @note 只能由单个消费者调用
+   */
+  bool pop(std::vector<char> &record);
+
+  /**
+   * @brief 队列中是否有已发布的记录
+   */
+  bool hasPending() const;
+
+  /**
+   * @brief 已占用的槽数 用于判断积压程度
+   */
+  size_t pendingSlots() const;
+
+  /**
+   * @brief 槽总数
+   */
+  size_t capacity() const;
+
+private:
+  struct alignas(64) Slot
+  {
+    std::atomic<uint64_t> sequence;
+    char payload[kSlotPayload];
+  };
+  static_assert(sizeof(Slot) == kSlotSize, "LogQueue slot size mismatch");
+
+  // 从第 position 个槽起跨槽写入/读取连续字节
+  void writeBytes(uint64_t position, size_t offset, const void *data, size_t bytes);
+  void readBytes(uint64_t position, size_t offset, void *data, size_t bytes) const;
+
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask = 0;
+
+  // 生产者和消费者的位置放在不同的缓存行上 避免伪共享
+  alignas(64) std::atomic<uint64_t> m_enqueuePosition{0};
+  alignas(64) std::atomic<uint64_t> m_dequeuePosition{0};
+};
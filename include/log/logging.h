@@ -12,32 +12,159 @@
 #include <string>
 #include <fstream>
 #include <windows.h>
-#include <locale>
 #include <filesystem>
 #include <iostream>
 #include <sstream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <condition_variable>
+#include <cstdint>
 #include <type_traits>
+#include <string_view>
+#include <vector>
+#include <array>
 #include <cstring>
 #include <comdef.h> // For _com_error
 
 #include "core/config_manager.h"
+#include "log/binlog_format.h"
+#include "log/log_limiter.h"
+#include "log/log_queue.h"
 #include "utils/system_utils.h"
 
 #if defined(_MSC_VER)
-#define LOG_FUNC_NAME __FUNCTIONW__ // MSVC provides __FUNCTIONW__ as const wchar_t*
+#define LOG_FUNC_NAME __FUNCTION__ // MSVC provides __FUNCTION__ as a string literal
 #else
-// GCC/Clang provide __func__ as const char* (UTF-8 usually)
-// We need to convert it. Using a helper function directly in the macro.
-#define LOG_FUNC_NAME MultiByteToWide(__func__)
+// GCC/Clang provide __func__ as a static const char array
+#define LOG_FUNC_NAME __func__
 #endif
 
-#define LOG_INFO(msg) Logging::log(Logging::LogLevel::LOG_INFO, (msg), LOG_FUNC_NAME, __LINE__)
-#define LOG_WARN(msg) Logging::log(Logging::LogLevel::LOG_WARNING, (msg), LOG_FUNC_NAME, __LINE__)
-#define LOG_ERROR(msg) Logging::log(Logging::LogLevel::LOG_ERROR, (msg), LOG_FUNC_NAME, __LINE__)
-#define LOG_DEBUG(msg) Logging::log(Logging::LogLevel::LOG_DEBUG, (msg), LOG_FUNC_NAME, __LINE__)
+// 日志级别的严重程度 用于编译期和运行时的级别过滤
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+// 只用于运行时 关闭模块的全部日志
+#define LOG_LEVEL_OFF 4
 
-#define LOG_HRESULT(msg, hr) Logging::log(Logging::LogLevel::LOG_ERROR, (msg), LOG_FUNC_NAME, __LINE__, hr)
+// 编译期最低日志级别 低于该级别的日志语句不生成代码，由 CMake 的 LOG_MIN_LEVEL 设置
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// 日志语句所属的模块 源文件在包含头文件之前定义，例: #define LOG_MODULE Logging::Module::Registry
+#ifndef LOG_MODULE
+#define LOG_MODULE Logging::Module::General
+#endif
+
+// 每个日志点定义一个静态的 LogSite（常量初始化，没有运行时开销），调用时只传递日志点和原始参数
+// 模块级别未开启且飞行记录器关闭时只有两次比较和分支，不会求值参数
+// 模块级别未开启但飞行记录器开启时只写入内存中的环形缓冲，不写文件
+#define LOG_SITE_(level, hr, format, ...)                                          \
+  do                                                                               \
+  {                                                                                \
+    const bool logToFile_ = Logging::isEnabled(LOG_MODULE, level);                 \
+    if (logToFile_ || Logging::isRecording())                                      \
+    {                                                                              \
+      static LogSite logSite_(level, __FILE__, LOG_FUNC_NAME, __LINE__, format);   \
+      Logging::write(logSite_, hr, logToFile_, __VA_ARGS__);                       \
+    }                                                                              \
+  } while (0)
+
+// 限流的日志点 同一日志点同一错误码在一个窗口内只写出前几条，其余合并为一条汇总
+// 用于错误可能连续重复出现的位置（WMI 回调、错误回调等），被合并的记录不进入队列
+#define LOG_SITE_LIMITED_(level, hr, format, ...)                                  \
+  do                                                                               \
+  {                                                                                \
+    const bool logToFile_ = Logging::isEnabled(LOG_MODULE, level);                 \
+    if (logToFile_ || Logging::isRecording())                                      \
+    {                                                                              \
+      static LogSite logSite_(level, __FILE__, LOG_FUNC_NAME, __LINE__, format);   \
+      static LogLimiter logLimiter_;                                               \
+      const HRESULT logHr_ = (hr);                                                 \
+      if (logLimiter_.allow(logSite_, logHr_))                                     \
+      {                                                                            \
+        Logging::write(logSite_, logHr_, logToFile_, __VA_ARGS__);                 \
+      }                                                                            \
+    }                                                                              \
+  } while (0)
+
+// 编译期关闭的日志语句 参数只出现在不求值的 sizeof 中，不生成代码，也不会产生未使用变量的警告
+#define LOG_COMPILED_OUT_(...)                                                     \
+  do                                                                               \
+  {                                                                                \
+    (void)sizeof(Logging::discard(__VA_ARGS__));                                   \
+  } while (0)
+
+// 延迟格式化 格式串中的 {} 依次替换为参数，调用方不拼接字符串，格式化在写线程中完成
+// 例: LOG_INFO_FMT("游戏进程启动: {} PID: {}", processName, processId);
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(msg) LOG_SITE_(Logging::LogLevel::LOG_DEBUG, S_OK, "{}", (msg))
+#define LOG_DEBUG_FMT(format, ...) LOG_SITE_(Logging::LogLevel::LOG_DEBUG, S_OK, format, __VA_ARGS__)
+#else
+#define LOG_DEBUG(msg) LOG_COMPILED_OUT_(msg)
+#define LOG_DEBUG_FMT(format, ...) LOG_COMPILED_OUT_(format, __VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(msg) LOG_SITE_(Logging::LogLevel::LOG_INFO, S_OK, "{}", (msg))
+#define LOG_INFO_FMT(format, ...) LOG_SITE_(Logging::LogLevel::LOG_INFO, S_OK, format, __VA_ARGS__)
+#else
+#define LOG_INFO(msg) LOG_COMPILED_OUT_(msg)
+#define LOG_INFO_FMT(format, ...) LOG_COMPILED_OUT_(format, __VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(msg) LOG_SITE_(Logging::LogLevel::LOG_WARNING, S_OK, "{}", (msg))
+#define LOG_WARN_FMT(format, ...) LOG_SITE_(Logging::LogLevel::LOG_WARNING, S_OK, format, __VA_ARGS__)
+#define LOG_WARN_LIMITED(msg, hr) LOG_SITE_LIMITED_(Logging::LogLevel::LOG_WARNING, (hr), "{}", (msg))
+#else
+#define LOG_WARN(msg) LOG_COMPILED_OUT_(msg)
+#define LOG_WARN_FMT(format, ...) LOG_COMPILED_OUT_(format, __VA_ARGS__)
+#define LOG_WARN_LIMITED(msg, hr) LOG_COMPILED_OUT_(msg, hr)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(msg) LOG_SITE_(Logging::LogLevel::LOG_ERROR, S_OK, "{}", (msg))
+#define LOG_ERROR_FMT(format, ...) LOG_SITE_(Logging::LogLevel::LOG_ERROR, S_OK, format, __VA_ARGS__)
+#define LOG_HRESULT(msg, hr) LOG_SITE_(Logging::LogLevel::LOG_ERROR, (hr), "{}", (msg))
+#define LOG_HRESULT_FMT(hr, format, ...) LOG_SITE_(Logging::LogLevel::LOG_ERROR, (hr), format, __VA_ARGS__)
+#define LOG_HRESULT_LIMITED(msg, hr) LOG_SITE_LIMITED_(Logging::LogLevel::LOG_ERROR, (hr), "{}", (msg))
+#define LOG_HRESULT_FMT_LIMITED(hr, format, ...) LOG_SITE_LIMITED_(Logging::LogLevel::LOG_ERROR, (hr), format, __VA_ARGS__)
+#else
+#define LOG_ERROR(msg) LOG_COMPILED_OUT_(msg)
+#define LOG_ERROR_FMT(format, ...) LOG_COMPILED_OUT_(format, __VA_ARGS__)
+#define LOG_HRESULT(msg, hr) LOG_COMPILED_OUT_(msg, hr)
+#define LOG_HRESULT_FMT(hr, format, ...) LOG_COMPILED_OUT_(hr, format, __VA_ARGS__)
+#define LOG_HRESULT_LIMITED(msg, hr) LOG_COMPILED_OUT_(msg, hr)
+#define LOG_HRESULT_FMT_LIMITED(hr, format, ...) LOG_COMPILED_OUT_(hr, format, __VA_ARGS__)
+#endif
+
+class LogArchiver;
+class FlightRecorder;
+
+/**
+ * @struct LogSite
+ * @brief 日志点描述符，由日志宏在每个调用位置静态定义
+ * @note 级别、文件、函数名、行号和格式串在编译期确定，
+ *       编号在二进制日志第一次写入该日志点时分配，只由持有日志文件锁的线程访问
+ */
+struct LogSite
+{
+  constexpr LogSite(int logLevel, const char *fileName, const char *functionName, int lineNumber, const char *formatString)
+      : level(logLevel), file(fileName), function(functionName), line(lineNumber), format(formatString)
+  {
+  }
+
+  int level;
+  const char *file;
+  const char *function;
+  int line;
+  const char *format;
+  uint32_t id = 0;
+};
 
 /**
  * @class Logging
@@ -46,6 +173,13 @@
  * @note 日志级别包括 INFO、WARNING、ERROR 和 DEBUG
  * @note 支持多种字符串类型的消息和函数名
  * @note 日志文件路径在初始化时设置，默认路径为当前目录下的 log/game_optimizer.log
+ * @note 调用方只把日志点指针和参数的原始字节写入记录，
+ *       时间格式化、编码转换、消息渲染和写盘都在写线程（同步模式下在调用线程）中完成
+ * @note 二进制输出写入同名的 .binlog 文件，只保存日志点编号和原始参数，使用 LogDecoder 转换为文本
+ * @note 日志文件按大小或时间轮换，轮换只重命名当前文件，压缩和清理由 LogArchiver 在后台完成
+ * @note LOG_*_LIMITED 宏按日志点和错误码限流，错误连续重复时只写出前几条和周期性的汇总
+ * @note 飞行记录器在内存中保存最近的记录（包括级别未开启的调试日志），
+ *       在程序崩溃、严重的 WMI 错误或托盘菜单操作时转储为文本文件
  */
 class Logging
 {
@@ -58,113 +192,200 @@ public:
     LOG_DEBUG
   };
 
+  /**
+   * @brief 异步模式的刷盘策略
+   */
+  enum class FlushPolicy
+  {
+    // 每写完一批记录刷盘
+    EveryBatch,
+    // 按固定间隔刷盘
+    Interval,
+    // 只在批次中有警告或错误时刷盘
+    OnError
+  };
+
+  /**
+   * @brief 日志模块 每个模块可以单独设置运行时级别
+   */
+  enum class Module
+  {
+    General,
+    Process,
+    Registry,
+    Power,
+    Service,
+    Config,
+    Ui,
+    Count
+  };
+
+  static constexpr size_t kModuleCount = static_cast<size_t>(Module::Count);
+
+  /**
+   * @brief 飞行记录器的转储原因
+   */
+  enum class DumpTrigger
+  {
+    // 用户从托盘菜单请求
+    Manual,
+    // 严重错误 两次转储至少间隔 kErrorDumpIntervalMs
+    Error,
+    // 未处理的异常或致命信号 转储后不再写日志
+    Crash
+  };
+
+  /**
+   * @brief 日志输出格式
+   */
+  enum class OutputFormat
+  {
+    // 文本日志
+    Text,
+    // 二进制日志 需要用 LogDecoder 查看
+    Binary
+  };
+
+  /**
+   * @struct Options
+   * @brief 日志运行参数
+   */
+  struct Options
+  {
+    // 是否使用异步写线程
+    bool async = true;
+    // 刷盘策略
+    FlushPolicy flushPolicy = FlushPolicy::EveryBatch;
+    // Interval 策略的刷盘间隔 毫秒
+    int flushIntervalMs = 1000;
+    // 输出格式
+    OutputFormat format = OutputFormat::Text;
+    // 单个日志文件的大小上限 超过后轮换 0 表示不按大小轮换
+    uint64_t maxFileBytes = 0;
+    // 按时间轮换的间隔 小时 以本地时间对齐（24 即每天零点） 0 表示不按时间轮换
+    int rotateIntervalHours = 0;
+    // 每个日志文件保留的分段数量 0 表示不清理
+    int maxArchives = 0;
+    // 是否在后台压缩轮换出的分段
+    bool compressArchives = false;
+    // 各模块的最低级别 LOG_LEVEL_* 按 Module 的顺序
+    std::array<int, kModuleCount> moduleLevels = {};
+    // 限流日志点每个错误码在一个窗口内最多写出的记录数 0 表示不限流
+    int rateLimitBurst = 10;
+    // 限流窗口 秒 持续重复时每个窗口写出一条汇总
+    int rateLimitWindowSeconds = 10;
+    // 是否在内存中记录全部级别的最近日志 供崩溃或出错时转储
+    bool flightRecorder = false;
+  };
+
   static bool initialize(const std::wstring &logFilePath);
   static void shutdown();
 
   /**
-   * @brief 日志记录函数（模板）.
-   * @tparam MsgType 日志消息类型 (e.g., std::string, std::wstring, const char*, etc.).
-   * @tparam FuncNameType 函数名类型 (e.g., std::wstring, const wchar_t*).
+   * @brief 应用日志运行参数
+   * @param {Options} &options 日志运行参数
+   * @note 切换为同步模式时先停止写线程并写完队列中的记录
+   */
+  static void configure(const Options &options);
+
+  /**
+   * @brief 刷盘策略、输出格式与配置文件中字符串的相互转换
+   * @note 无法识别的字符串按默认值 EveryBatch/Text 处理
+   */
+  static FlushPolicy flushPolicyFromString(const std::string &flushPolicy);
+  static std::string flushPolicyToString(FlushPolicy flushPolicy);
+  static OutputFormat outputFormatFromString(const std::string &format);
+
+  /**
+   * @brief 配置文件中的级别字符串转换为 LOG_LEVEL_*
+   * @param {string} &level debug/info/warn/error/off 无法识别时按 info 处理
    */
-  template <typename MsgType, typename FuncNameType>
-  static void log(
-      LogLevel level,
-      const MsgType &message,
-      const FuncNameType &functionName,
-      int line,
-      HRESULT hr = S_OK)
+  static int levelFromString(const std::string &level);
+
+  /**
+   * @brief 日志语句是否开启 由日志宏在求值参数前调用
+   * @param {Module} module 日志模块
+   * @param {int} level 日志级别 LogLevel
+   */
+  static bool isEnabled(Module module, int level)
   {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    return levelSeverity(level) >= m_moduleLevels[static_cast<size_t>(module)].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 飞行记录器是否开启 开启时级别未开启的日志语句也会写入内存
+   */
+  static bool isRecording()
+  {
+    return m_recording.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 把飞行记录器中的记录转储到日志目录下的 <日志名>.flight-YYYYMMDD-HHMMSS-mmm.log
+   * @param {DumpTrigger} trigger 转储原因
+   * @param {string} &detail 附加说明 写在转储文件的第一行
+   * @return {bool} 是否写出了转储文件 飞行记录器关闭、正在转储或错误转储过于频繁时返回 false
+   * @note 不持有日志文件锁 崩溃时也可以调用
+   */
+  static bool dumpFlightRecorder(DumpTrigger trigger, const std::string &detail);
+
+  /**
+   * @brief 安装未处理异常、std::terminate 和致命信号的处理函数 崩溃时转储飞行记录器
+   * @note 在 initialize 之后调用一次 处理函数转储后交给原来的处理函数或系统默认处理
+   */
+  static void installCrashHandlers();
+
+  /**
+   * @brief 编译期关闭的日志语句使用 只在 sizeof 中出现，不需要定义
+   */
+  template <typename... Args>
+  static bool discard(const Args &...args);
 
-    if (!m_isInitialized)
+  /**
+   * @brief 记录一条日志 由日志宏调用
+   * @param {LogSite} &site 日志点
+   * @param {HRESULT} hr 错误码 失败时附加描述
+   * @param {bool} toFile 是否写入日志文件 为 false 时只写入飞行记录器
+   * @param args 参数 字符串、整数、浮点数和布尔值按原始字节保存，其他类型先转换为字符串
+   */
+  template <typename... Args>
+  static void write(LogSite &site, HRESULT hr, bool toFile, const Args &...args)
+  {
+    if (!m_isInitialized.load(std::memory_order_acquire))
     {
       // 如果日志未初始化，输出到标准错误流
       std::wcerr << L"Log attempt before initialization." << std::endl;
       return;
     }
 
-    // 确保日志流已打开且准备就绪
-    if (!m_logFileStream.is_open() || m_logFileStream.fail())
-    {
-      if (!ReopenLogFile())
-      {
-        // 尝试重新打开文件
-        // 如果重新打开失败，无法记录日志。输出到标准错误流可能是一个选项。
-        std::wcerr << L"Cannot write to log file: " << m_logFilePath << std::endl;
-        return;
-      }
-    }
-
     try
     {
-      // 使用 GetSystemTime 获取 UTC 时间
-      SYSTEMTIME st;
-      GetLocalTime(&st);
+      // 参数区使用线程私有的缓冲 重复使用避免分配
+      std::string &argsBuffer = getArgsBuffer();
+      argsBuffer.clear();
+      (encodeArg(argsBuffer, args), ...);
+
+      LogRecordHeader header;
+      FILETIME fileTime;
+      GetSystemTimeAsFileTime(&fileTime);
+      header.timestamp = (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+      header.site = &site;
+      header.hr = static_cast<int32_t>(hr);
+      header.argsBytes = static_cast<uint32_t>(argsBuffer.size());
 
-      // 确定日志级别字符串
-      const wchar_t *levelStr = L"UNKNOWN";
-      switch (level)
+      if (m_recording.load(std::memory_order_relaxed))
       {
-      // 添加空格以对齐
-      case LogLevel::LOG_INFO:
-        levelStr = L"INFO";
-        break;
-      case LogLevel::LOG_WARNING:
-        levelStr = L"WARN";
-        break;
-      case LogLevel::LOG_ERROR:
-        levelStr = L"ERROR";
-        break;
-      case LogLevel::LOG_DEBUG:
-        levelStr = L"DEBUG";
-        break;
+        recordFlight(header, argsBuffer.data());
       }
-
-      // 将消息和函数名转换为 wstring 类型
-      std::wstring wideMessage = GetWideString(message);
-      std::wstring wideFuncName = GetWideString(functionName);
-
-      // 格式化并写入日志条目
-      // [YYYY-MM-DD HH:MM:SS.ms][LEVEL][Function:Line] Message (HRESULT: 0x...)
-      wchar_t timeBuf[64];
-      swprintf_s(timeBuf, L"%04d-%02d-%02d %02d:%02d:%02d.%03d",
-                 st.wYear, st.wMonth, st.wDay,
-                 st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
-
-      m_logFileStream << L"[" << timeBuf << L"]"
-                      << L"[" << levelStr << L"]"
-                      << L"[" << wideFuncName << L":" << line << L"] "
-                      << wideMessage;
-
-      // 如果它是错误代码，附加 HRESULT 和描述
-      if (FAILED(hr))
+      if (!toFile)
       {
-        // 将 HRESULT 转换为宽字符串
-        // 使用 swprintf_s 格式化 HRESULT
-        // 0x00000000 是一个有效的 HRESULT，表示成功
-        // 但我们只在失败时附加它
-        wchar_t hrBuf[20];
-        swprintf_s(hrBuf, L"0x%08X", static_cast<unsigned int>(hr));
-        _com_error err(hr);
-        // 将错误消息转换为宽字符串
-        std::wstring hrMessage = GetWideString(err.ErrorMessage());
-        // 附加 HRESULT 和描述
-        m_logFileStream << L" (HRESULT: " << hrBuf << L", Description: " << hrMessage << L")";
+        return;
       }
-
-      // 结束日志条目
-      m_logFileStream << std::endl;
-
-      // 不需要显式刷新，因为 std::endl 默认使用 unitbuf，
-      // 但刷新确保立即写入，特别是在错误/崩溃时。
-      m_logFileStream.flush();
-    }
-    catch (const std::ios_base::failure &e)
-    {
-      // 处理写入/刷新期间的潜在流错误
-      std::cerr << "Log stream I/O error: " << e.what() << std::endl;
-      // 考虑关闭流或标记日志记录器失败以防止循环
-      m_logFileStream.close();
+      if (m_async.load(std::memory_order_acquire) && enqueue(header, argsBuffer.data()))
+      {
+        return;
+      }
+      writeSync(header, argsBuffer.data());
     }
     catch (const std::exception &e)
     {
@@ -186,73 +407,248 @@ public:
 private:
   // --- 私有成员 ---
   static std::mutex m_mutex;
-  static std::wofstream m_logFileStream;
-  static bool m_isInitialized;
+  static std::ofstream m_logFileStream;
+  static std::atomic<bool> m_isInitialized;
   static std::wstring m_logFilePath;
 
+  // 二进制输出
+  static std::atomic<int> m_outputFormat;
+  static std::ofstream m_binaryFileStream;
+  static std::wstring m_binaryFilePath;
+  // 当前二进制文件中已写入定义的日志点编号
+  static std::vector<bool> m_writtenSites;
+  static uint32_t m_nextSiteId;
+
+  // 异步模式
+  static std::atomic<bool> m_async;
+  static std::unique_ptr<LogQueue> m_queue;
+  static std::thread m_writerThread;
+  static std::mutex m_writerMutex;
+  static std::condition_variable m_writerCondition;
+  static std::atomic<bool> m_stopWriter;
+  static std::atomic<bool> m_wakeWriter;
+  static std::atomic<int> m_flushPolicy;
+  static std::atomic<int> m_flushIntervalMs;
+  // 队列已满时丢弃的 INFO/DEBUG 记录数
+  static std::atomic<uint64_t> m_droppedCount;
+  // 串行化 configure/shutdown 对写线程的启停
+  static std::mutex m_configureMutex;
+
+  // 日志轮换 文件大小和分段起始时间（UTC FILETIME）只在持有 m_mutex 时访问
+  static std::atomic<uint64_t> m_maxFileBytes;
+  static std::atomic<int> m_rotateIntervalHours;
+  static uint64_t m_textFileBytes;
+  static uint64_t m_textSegmentStart;
+  static uint64_t m_binaryFileBytes;
+  static uint64_t m_binarySegmentStart;
+  static std::unique_ptr<LogArchiver> m_archiver;
+
+  // 各模块的最低级别 LOG_LEVEL_* 初始为 DEBUG 即应用配置前全部记录
+  static std::atomic<int> m_moduleLevels[kModuleCount];
+
+  // 飞行记录器 在 initialize 中创建 之后不再释放 崩溃处理函数可能在任何时候访问
+  static std::unique_ptr<FlightRecorder> m_flightRecorder;
+  static std::atomic<bool> m_recording;
+  static std::atomic<bool> m_dumping;
+  static std::atomic<uint64_t> m_lastErrorDumpMs;
+
   // --- 私有帮助函数 ---
 
   /**
-   * @brief: 将各种字符串类型转换为 std::wstring 用于日志记录。
-   * @tparam T 输入类型
-   * @tparam input 输入字符串
-   * @return 转换后的 std::wstring
+   * @brief LogLevel 对应的严重程度 LOG_LEVEL_*
+   */
+  static constexpr int levelSeverity(int level)
+  {
+    switch (level)
+    {
+    case LOG_DEBUG:
+      return LOG_LEVEL_DEBUG;
+    case LOG_INFO:
+      return LOG_LEVEL_INFO;
+    case LOG_WARNING:
+      return LOG_LEVEL_WARN;
+    default:
+      return LOG_LEVEL_ERROR;
+    }
+  }
+
+  /**
+   * @brief 写入飞行记录器
+   */
+  static void recordFlight(const LogRecordHeader &header, const void *args);
+
+  /**
+   * @brief 调用线程的参数区缓冲
+   */
+  static std::string &getArgsBuffer();
+
+  /**
+   * @brief 写入一个参数 参数区超过 LogQueue::kMaxArgsBytes 时截断字符串、丢弃后续参数
+   */
+  static void appendArg(std::string &buffer, BinLog::ArgType type, const void *value, size_t bytes);
+  static void appendStringArg(std::string &buffer, BinLog::ArgType type, const void *data, size_t bytes);
+
+  /**
+   * @brief 按参数类型编码
+   * @tparam T 参数类型
+   * @param buffer 参数区
+   * @param value 参数
    */
   template <typename T>
-  static std::wstring GetWideString(const T &input)
+  static void encodeArg(std::string &buffer, const T &value)
   {
-    // 处理 const/ref 限定符
     using DecayedT = std::decay_t<T>;
 
-    // 如果 T 已经是 std::wstring
-    if constexpr (std::is_same_v<DecayedT, std::wstring>)
+    if constexpr (std::is_same_v<DecayedT, bool>)
     {
-      return input;
+      const uint8_t flag = value ? 1 : 0;
+      appendArg(buffer, BinLog::ArgType::Bool, &flag, sizeof(flag));
     }
-    // 如果 T 是 const wchar_t*
-    else if constexpr (std::is_convertible_v<DecayedT, const wchar_t *>)
+    else if constexpr (std::is_enum_v<DecayedT>)
+    {
+      encodeArg(buffer, static_cast<std::underlying_type_t<DecayedT>>(value));
+    }
+    else if constexpr (std::is_integral_v<DecayedT> && std::is_signed_v<DecayedT>)
+    {
+      const int64_t number = value;
+      appendArg(buffer, BinLog::ArgType::Int, &number, sizeof(number));
+    }
+    else if constexpr (std::is_integral_v<DecayedT>)
+    {
+      const uint64_t number = value;
+      appendArg(buffer, BinLog::ArgType::UInt, &number, sizeof(number));
+    }
+    else if constexpr (std::is_floating_point_v<DecayedT>)
     {
-      // 隐式转换在这里有效
-      const wchar_t *ptr = input;
-      // 处理空指针
-      return std::wstring(ptr ? ptr : L"");
+      const double number = value;
+      appendArg(buffer, BinLog::ArgType::Double, &number, sizeof(number));
     }
-    // 如果 T 是 std::string（假设 UTF-8）
-    else if constexpr (std::is_same_v<DecayedT, std::string>)
+    else if constexpr (std::is_same_v<DecayedT, std::string> || std::is_same_v<DecayedT, std::string_view>)
     {
-      // UTF-8 转换为 UTF-16
-      return MultiByteToWide(input.c_str());
+      appendStringArg(buffer, BinLog::ArgType::Utf8, value.data(), value.size());
     }
-    // 如果 T 是 const char*（假设 UTF-8）
     else if constexpr (std::is_convertible_v<DecayedT, const char *>)
     {
-      // 隐式转换
-      const char *ptr = input;
-      // UTF-8 转换为 UTF-16
-      return MultiByteToWide(ptr);
+      const char *ptr = value;
+      ptr = ptr ? ptr : "";
+      appendStringArg(buffer, BinLog::ArgType::Utf8, ptr, strlen(ptr));
+    }
+    else if constexpr (std::is_same_v<DecayedT, std::wstring> || std::is_same_v<DecayedT, std::wstring_view>)
+    {
+      appendStringArg(buffer, BinLog::ArgType::Utf16, value.data(), value.size() * sizeof(wchar_t));
+    }
+    else if constexpr (std::is_convertible_v<DecayedT, const wchar_t *>)
+    {
+      const wchar_t *ptr = value;
+      ptr = ptr ? ptr : L"";
+      appendStringArg(buffer, BinLog::ArgType::Utf16, ptr, wcslen(ptr) * sizeof(wchar_t));
     }
-    // 其他类型（例如数字）的回退 - 使用 wstringstream
     else
     {
-      try
-      {
-        std::wstringstream wss;
-        // 尝试流插入
-        wss << input;
-        if (wss.fail())
-        {
-          return L"[Stream Conversion Failed]";
-        }
-        return wss.str();
-      }
-      catch (...)
+      const std::string text = GetUtf8String(value);
+      appendStringArg(buffer, BinLog::ArgType::Utf8, text.data(), text.size());
+    }
+  }
+
+  /**
+   * @brief: 将非字符串类型转换为 UTF-8 字符串用于日志记录。
+   * @tparam T 输入类型
+   * @tparam input 输入
+   * @return 转换后的 std::string
+   */
+  template <typename T>
+  static std::string GetUtf8String(const T &input)
+  {
+    try
+    {
+      std::ostringstream oss;
+      // 尝试流插入
+      oss << input;
+      if (oss.fail())
       {
-        // 捕获流插入期间的潜在异常
-        return L"[Conversion Exception]";
+        return "[Stream Conversion Failed]";
       }
+      return oss.str();
+    }
+    catch (...)
+    {
+      // 捕获流插入期间的潜在异常
+      return "[Conversion Exception]";
     }
   }
 
+  /**
+   * @brief 把记录写入异步队列
+   * @return {bool} 写入失败（写线程未运行）时返回 false 由调用方同步写入
+   * @note 队列已满时 WARNING/ERROR 等待写线程腾出空间，INFO/DEBUG 直接丢弃并计数
+   */
+  static bool enqueue(const LogRecordHeader &header, const void *args);
+
+  /**
+   * @brief 同步写入一条记录并刷盘
+   */
+  static void writeSync(const LogRecordHeader &header, const void *args);
+
+  /**
+   * @brief 按当前输出格式把记录追加到文本或二进制批次 调用方需持有 m_mutex
+   */
+  static void appendRecord(const LogRecordHeader &header, const char *args, size_t argsBytes,
+                           std::string &textBatch, std::string &binaryBatch);
+
+  /**
+   * @brief 把记录格式化为一行文本
+   * @note [YYYY-MM-DD HH:MM:SS.ms][LEVEL][Function:Line] Message (HRESULT: 0x..., Description: ...)
+   */
+  static void formatRecord(const LogRecordHeader &header, const char *args, size_t argsBytes, std::string &output);
+
+  /**
+   * @brief 把记录编码为二进制日志记录 日志点第一次出现时先写入日志点定义
+   */
+  static void encodeRecord(const LogRecordHeader &header, const char *args, size_t argsBytes, std::string &output);
+
+  /**
+   * @brief 取出队列中的记录 调用方需持有 m_mutex
+   * @return {bool} 批次中是否包含警告或错误
+   */
+  static bool drainQueue(std::string &textBatch, std::string &binaryBatch);
+
+  /**
+   * @brief 把批次写入日志文件 调用方需持有 m_mutex
+   */
+  static bool writeToFile(const std::string &textBatch, const std::string &binaryBatch, bool flush);
+
+  /**
+   * @brief 打开二进制日志文件 新文件写入文件头
+   */
+  static bool openBinaryFile();
+
+  /**
+   * @brief 在编码下一批记录前检查并轮换日志文件 调用方需持有 m_mutex
+   * @note 二进制日志必须在编码前轮换，新文件中的日志点定义才能重新写入
+   */
+  static void rotateFilesIfNeeded();
+
+  /**
+   * @brief 当前文件是否达到大小上限或跨过了时间间隔
+   */
+  static bool shouldRotate(uint64_t fileBytes, uint64_t segmentStart, uint64_t now);
+
+  /**
+   * @brief 把已关闭的日志文件重命名为分段并提交归档
+   * @return {bool} 是否重命名成功
+   */
+  static bool archiveFile(const std::wstring &filePath, uint64_t now);
+
+  /**
+   * @brief 读取刚打开的日志文件的大小和分段起始时间
+   * @note 追加写入已有文件时分段从文件最后修改时间算起，上次运行留下的旧文件也能按时间轮换
+   */
+  static void beginSegment(const std::wstring &filePath, uint64_t &fileBytes, uint64_t &segmentStart);
+
+  static void startWriter();
+  static void stopWriter();
+  static void writerLoop();
+
   /**
    * @brief: 尝试重新打开日志文件，如果它已关闭或失败。
    * @return {bool} 如果文件打开且准备就绪，返回 true，否则返回 false。
@@ -0,0 +1,372 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 20:31:07
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 20:31:07
+ * @FilePath: \GameOptimizerPro\include\metrics\metrics.h
+ * @Description: 运行指标（计数器、仪表、直方图）的注册表，快照导出为 OpenMetrics 文本
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "metrics/tracing.h"
+
+// 指标标签 key: 标签名 value: 标签值
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @class MetricCounter
+ * @brief 单调递增的计数器
+ * @note 按当前处理器编号分片，每个分片独占一个缓存行，不同核心上的线程累加时不会争用同一缓存行；
+ *       读取时把各分片相加
+ */
+class MetricCounter
+{
+public:
+  MetricCounter() = default;
+
+  MetricCounter(const MetricCounter &) = delete;
+  MetricCounter &operator=(const MetricCounter &) = delete;
+
+  /**
+   * @brief 累加 任何线程都可以调用
+   * @param {uint64_t} value 增量
+   */
+  void inc(uint64_t value = 1)
+  {
+    m_shards[GetCurrentProcessorNumber() & (kShards - 1)].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const;
+
+private:
+  // 分片数量 为 2 的幂 核心更多时多个核心共用一个分片
+  static constexpr size_t kShards = 16;
+
+  struct alignas(64) Shard
+  {
+    std::atomic<uint64_t> value{0};
+  };
+
+  Shard m_shards[kShards];
+};
+
+/**
+ * @class MetricGauge
+ * @brief 可增可减的仪表 保存当前值
+ */
+class MetricGauge
+{
+public:
+  MetricGauge() = default;
+
+  MetricGauge(const MetricGauge &) = delete;
+  MetricGauge &operator=(const MetricGauge &) = delete;
+
+  void set(int64_t value)
+  {
+    m_value.store(value, std::memory_order_relaxed);
+  }
+
+  void add(int64_t value)
+  {
+    m_value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  int64_t value() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int64_t> m_value{0};
+};
+
+/**
+ * @class MetricHistogram
+ * @brief 耗时直方图 桶边界在注册时固定
+ * @note 记录时只对命中的桶和总和各做一次原子加法，不加锁；总和以纳秒整数累加，导出时换算为秒
+ * @note 导出时总数取各桶之和，保证并发记录时 _count 与 +Inf 桶一致
+ */
+class MetricHistogram
+{
+public:
+  /**
+   * @brief 构造函数
+   * @param {vector<double>} bounds 各桶的上界 秒 升序
+   */
+  explicit MetricHistogram(const std::vector<double> &bounds);
+
+  MetricHistogram(const MetricHistogram &) = delete;
+  MetricHistogram &operator=(const MetricHistogram &) = delete;
+
+  /**
+   * @brief 记录一次耗时 任何线程都可以调用
+   * @param {nanoseconds} duration 耗时
+   */
+  void observe(std::chrono::nanoseconds duration);
+
+  /**
+   * @brief 读取各桶的计数（非累积）最后一个为 +Inf 桶
+   * @param {vector<uint64_t>} &buckets 输出 各桶计数
+   * @param {uint64_t} &sumNanoseconds 输出 总耗时 纳秒
+   */
+  void snapshot(std::vector<uint64_t> &buckets, uint64_t &sumNanoseconds) const;
+
+  const std::vector<double> &bounds() const
+  {
+    return m_bounds;
+  }
+
+  // 默认的桶边界 覆盖 100 微秒到 30 秒 适用于注册表、服务和配置文件操作
+  static const std::vector<double> &defaultBounds();
+
+private:
+  std::vector<double> m_bounds;
+  std::vector<int64_t> m_boundsNanoseconds;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+  std::atomic<uint64_t> m_sumNanoseconds{0};
+};
+
+/**
+ * @class MetricTimer
+ * @brief 作用域计时器 析构时把经过的时间记录到直方图
+ */
+class MetricTimer
+{
+public:
+  explicit MetricTimer(MetricHistogram &histogram)
+      : m_histogram(histogram), m_start(std::chrono::steady_clock::now())
+  {
+  }
+
+  ~MetricTimer()
+  {
+    m_histogram.observe(std::chrono::steady_clock::now() - m_start);
+  }
+
+  MetricTimer(const MetricTimer &) = delete;
+  MetricTimer &operator=(const MetricTimer &) = delete;
+
+private:
+  MetricHistogram &m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @class MetricOperation
+ * @brief 一类操作的指标：<name>{op,result} 计数器按成功/失败计数，<name>_duration_seconds{op} 直方图记录耗时
+ * @note 通常定义为函数内的静态变量，配合 MetricOperationScope 使用
+ * @note 追踪开启时同时记录一个区间，分类取指标名称去掉 gop_ 前缀和 _operations 后缀，例如 registry
+ */
+class MetricOperation
+{
+public:
+  /**
+   * @brief 构造函数 向注册表登记三个指标系列
+   * @param {string} &name 指标名称 例如 gop_registry_operations
+   * @param {string} &subject 操作的说明 用于生成 HELP 文本
+   * @param {string} &op 操作名称 作为 op 标签
+   */
+  MetricOperation(const std::string &name, const std::string &subject, const std::string &op);
+
+  MetricOperation(const MetricOperation &) = delete;
+  MetricOperation &operator=(const MetricOperation &) = delete;
+
+  MetricCounter &success;
+  MetricCounter &failure;
+  MetricHistogram &duration;
+  // 追踪区间的分类和名称 生命周期与操作相同
+  const std::string traceCategory;
+  const std::string traceName;
+};
+
+/**
+ * @class MetricOperationScope
+ * @brief 操作的作用域 析构时记录耗时和结果
+ * @note 默认按失败计数，成功的返回路径调用 finish(true)；提前返回或抛出异常都按失败计数
+ */
+class MetricOperationScope
+{
+public:
+  explicit MetricOperationScope(MetricOperation &operation)
+      : m_operation(operation), m_start(std::chrono::steady_clock::now())
+#if TRACE_ENABLED
+        ,
+        m_trace(operation.traceCategory.c_str(), operation.traceName.c_str())
+#endif
+  {
+  }
+
+  ~MetricOperationScope()
+  {
+    m_operation.duration.observe(std::chrono::steady_clock::now() - m_start);
+    (m_succeeded ? m_operation.success : m_operation.failure).inc();
+  }
+
+  MetricOperationScope(const MetricOperationScope &) = delete;
+  MetricOperationScope &operator=(const MetricOperationScope &) = delete;
+
+  /**
+   * @brief 设置操作结果
+   * @param {bool} succeeded 是否成功
+   * @return {bool} 原样返回 succeeded 便于直接 return
+   */
+  bool finish(bool succeeded)
+  {
+    m_succeeded = succeeded;
+    return succeeded;
+  }
+
+  /**
+   * @brief 追踪区间是否在记录 追踪关闭或编译期禁用时返回false
+   */
+  bool traceActive() const
+  {
+#if TRACE_ENABLED
+    return m_trace.active();
+#else
+    return false;
+#endif
+  }
+
+#if TRACE_ENABLED
+  /**
+   * @brief 设置追踪区间的说明 例如注册表路径、服务名
+   * @note 通过 METRIC_TRACE_DETAIL 调用 说明只在追踪开启时求值
+   */
+  template <typename Text>
+  void setTraceDetail(const Text &detail)
+  {
+    m_trace.setDetail(detail);
+  }
+#endif
+
+private:
+  MetricOperation &m_operation;
+  std::chrono::steady_clock::time_point m_start;
+  bool m_succeeded = false;
+#if TRACE_ENABLED
+  TraceScope m_trace;
+#endif
+};
+
+// 设置操作作用域的追踪说明 说明只在追踪开启时求值 追踪关闭时不拼接字符串
+#if TRACE_ENABLED
+#define METRIC_TRACE_DETAIL(scope, detail) \
+  do                                       \
+  {                                        \
+    if ((scope).traceActive())             \
+    {                                      \
+      (scope).setTraceDetail(detail);      \
+    }                                      \
+  } while (0)
+#else
+#define METRIC_TRACE_DETAIL(scope, detail) \
+  do                                       \
+  {                                        \
+  } while (0)
+#endif
+
+/**
+ * @class MetricsRegistry
+ * @brief 指标注册表 全局只有一个实例
+ * @note 注册时加锁，同名同标签的指标只创建一次，返回的引用在程序运行期间一直有效；
+ *       调用方在函数内的静态变量或模块的静态结构中保存引用，之后的更新不经过注册表
+ * @note 同一名称只能注册为同一种类型，名称按 OpenMetrics 规范使用小写加下划线，计数器不带 _total 后缀
+ */
+class MetricsRegistry
+{
+public:
+  static MetricsRegistry &instance();
+
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+  /**
+   * @brief 获取或注册计数器
+   * @param {string} &name 指标名称
+   * @param {string} &help 说明
+   * @param {MetricLabels} &labels 标签
+   * @return {MetricCounter &}
+   */
+  MetricCounter &counter(const std::string &name, const std::string &help, const MetricLabels &labels = {});
+
+  /**
+   * @brief 获取或注册仪表
+   */
+  MetricGauge &gauge(const std::string &name, const std::string &help, const MetricLabels &labels = {});
+
+  /**
+   * @brief 获取或注册耗时直方图 单位为秒
+   * @param {vector<double>} &bounds 桶上界 只在第一次注册时使用
+   */
+  MetricHistogram &histogram(const std::string &name, const std::string &help, const MetricLabels &labels = {},
+                             const std::vector<double> &bounds = MetricHistogram::defaultBounds());
+
+  /**
+   * @brief 注册在导出时取值的指标 用于进程 CPU 时间、内存等由系统统计的值
+   * @param {bool} isCounter 是否为计数器 否则为仪表
+   * @param {function<double()>} callback 取值函数 在导出线程中调用
+   */
+  void callback(const std::string &name, const std::string &help, bool isCounter, std::function<double()> callback);
+
+  /**
+   * @brief 生成全部指标的 OpenMetrics 文本快照
+   * @return {string} 以 # EOF 结尾的 UTF-8 文本
+   */
+  std::string toOpenMetrics() const;
+
+private:
+  enum class Type
+  {
+    Counter,
+    Gauge,
+    Histogram
+  };
+
+  struct Series
+  {
+    // 渲染好的标签 例如 {op="set",result="success"} 无标签时为空
+    std::string labels;
+    std::unique_ptr<MetricCounter> counter;
+    std::unique_ptr<MetricGauge> gauge;
+    std::unique_ptr<MetricHistogram> histogram;
+    std::function<double()> callback;
+  };
+
+  struct Family
+  {
+    std::string name;
+    std::string help;
+    Type type = Type::Counter;
+    std::vector<std::unique_ptr<Series>> series;
+  };
+
+  MetricsRegistry();
+
+  /**
+   * @brief 查找或创建指标系列 调用方需持有 m_mutex
+   */
+  Series &findOrCreate(const std::string &name, const std::string &help, Type type, const MetricLabels &labels);
+
+  /**
+   * @brief 注册本进程的 CPU 时间、内存和句柄数
+   */
+  void registerProcessMetrics();
+
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<Family>> m_families;
+};
@@ -0,0 +1,73 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 20:52:19
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 20:52:19
+ * @FilePath: \GameOptimizerPro\include\metrics\metrics_exporter.h
+ * @Description: 定期把指标快照写入 OpenMetrics 文本文件，供监控程序采集
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @class MetricsExporter
+ * @brief 指标导出器，后台线程按间隔写出 MetricsRegistry 的快照
+ * @note 先写入同目录的临时文件再替换目标文件，采集方不会读到写了一半的快照
+ */
+class MetricsExporter
+{
+public:
+  MetricsExporter();
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+  /**
+   * @brief 开始导出 已在导出时按新参数重新启动
+   * @param {wstring} &filePath 导出文件路径
+   * @param {int} intervalSeconds 导出间隔 秒
+   * @return {bool} 是否启动成功
+   */
+  bool start(const std::wstring &filePath, int intervalSeconds);
+
+  /**
+   * @brief 停止导出 停止前写出最后一次快照
+   */
+  void stop();
+
+  /**
+   * @brief 是否正在导出
+   * @return {bool}
+   */
+  bool isRunning() const;
+
+  /**
+   * @brief 立即写出一次快照
+   * @param {wstring} &filePath 导出文件路径
+   * @return {bool} 是否写入成功
+   */
+  static bool writeSnapshot(const std::wstring &filePath);
+
+private:
+  /**
+   * @brief 导出线程主函数
+   */
+  void runExportLoop();
+
+  std::thread m_exportThread;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopRequested = false;
+  std::atomic<bool> m_isRunning{false};
+
+  std::wstring m_filePath;
+  int m_intervalSeconds = 15;
+};
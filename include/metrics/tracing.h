@@ -0,0 +1,162 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 21:42:15
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 21:42:15
+ * @FilePath: \GameOptimizerPro\include\metrics\tracing.h
+ * @Description: 性能追踪，记录各模块操作的耗时区间，导出为 Chrome trace 事件格式（chrome://tracing、Perfetto UI 可直接打开）
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// 编译期开关 为 0 时追踪宏不生成代码 由 CMake 选项 ENABLE_TRACING 设置
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#define TRACE_CONCAT_INNER_(a, b) a##b
+#define TRACE_CONCAT_(a, b) TRACE_CONCAT_INNER_(a, b)
+
+// 在当前作用域记录一个区间 category 和 name 必须是字符串字面量或生命周期覆盖整个程序的字符串
+// 追踪关闭时只有一次原子读取和分支
+#if TRACE_ENABLED
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT_(traceScope_, __LINE__)(category, name)
+// 附带说明（服务名、网卡 ID 等）的区间 说明只在追踪开启时求值
+#define TRACE_SCOPE_DETAIL(category, name, detail)                  \
+  TraceScope TRACE_CONCAT_(traceScope_, __LINE__)(category, name); \
+  if (TRACE_CONCAT_(traceScope_, __LINE__).active())               \
+  TRACE_CONCAT_(traceScope_, __LINE__).setDetail(detail)
+#else
+#define TRACE_SCOPE(category, name) \
+  do                                \
+  {                                 \
+  } while (0)
+#define TRACE_SCOPE_DETAIL(category, name, detail) \
+  do                                               \
+  {                                                \
+  } while (0)
+#endif
+
+/**
+ * @class Tracing
+ * @brief 性能追踪，静态类
+ * @note 每个线程写入自己的缓冲，只在第一次记录时加全局锁登记缓冲；
+ *       区间结束时加的是本线程缓冲的锁，只有导出时才会与导出线程竞争
+ * @note 每个线程最多保存 kMaxEventsPerThread 个区间，超出的区间丢弃并计数
+ */
+class Tracing
+{
+public:
+  // 每个线程在一次追踪中最多保存的区间数
+  static constexpr size_t kMaxEventsPerThread = 65536;
+
+  /**
+   * @brief 追踪是否开启 由 TraceScope 在计时前调用
+   */
+  static bool isEnabled()
+  {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 开始一次追踪 清空之前记录的区间
+   */
+  static void start();
+
+  /**
+   * @brief 停止追踪 已记录的区间保留到下次 start
+   */
+  static void stop();
+
+  /**
+   * @brief 停止追踪并导出到日志目录下的 <日志名>.trace-YYYYMMDD-HHMMSS-mmm.json
+   * @param {wstring} &filePath 输出 导出文件路径
+   * @return {bool} 是否导出成功
+   */
+  static bool stopAndExport(std::wstring &filePath);
+
+  /**
+   * @brief 把已记录的区间写为 Chrome trace 事件格式的 JSON
+   * @param {wstring} &filePath 导出文件路径
+   * @param {size_t} &eventCount 输出 写出的区间数
+   * @return {bool} 是否写入成功
+   */
+  static bool exportChromeTrace(const std::wstring &filePath, size_t &eventCount);
+
+  /**
+   * @brief 设置当前线程在追踪视图中显示的名称
+   * @param {char *} name 线程名称
+   */
+  static void setThreadName(const char *name);
+
+  /**
+   * @brief 记录一个已结束的区间
+   * @param {char *} category 分类
+   * @param {char *} name 名称
+   * @param {uint64_t} startNs 开始时间 steady_clock 纳秒
+   * @param {uint64_t} endNs 结束时间 steady_clock 纳秒
+   * @param {string} &&detail 说明 可为空
+   */
+  static void record(const char *category, const char *name, uint64_t startNs, uint64_t endNs, std::string &&detail);
+
+  static uint64_t nowNs()
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+  }
+
+private:
+  static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @class TraceScope
+ * @brief 作用域区间 构造时开始、析构时结束 由 TRACE_SCOPE 宏定义
+ */
+class TraceScope
+{
+public:
+  TraceScope(const char *category, const char *name)
+      : m_category(category), m_name(name), m_startNs(Tracing::isEnabled() ? Tracing::nowNs() : 0)
+  {
+  }
+
+  ~TraceScope()
+  {
+    if (m_startNs != 0)
+    {
+      Tracing::record(m_category, m_name, m_startNs, Tracing::nowNs(), std::move(m_detail));
+    }
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  /**
+   * @brief 区间是否在记录 追踪关闭时开始的区间不记录
+   */
+  bool active() const
+  {
+    return m_startNs != 0;
+  }
+
+  void setDetail(const std::string &detail)
+  {
+    m_detail = detail;
+  }
+
+  void setDetail(const std::wstring &detail);
+
+private:
+  const char *m_category;
+  const char *m_name;
+  uint64_t m_startNs;
+  std::string m_detail;
+};
@@ -66,6 +66,11 @@ private:
      */
     void loadGameProcessFromConfig(const std::vector<ProcessInfo> &gameProcesses);
 
+    /**
+     * @brief: 配置文件热更新后按当前配置刷新开关按钮和游戏列表
+     */
+    void refreshFromConfig();
+
     /**
      * @brief: 开关按钮点击事件
      */
@@ -21,6 +21,7 @@
 
 #include "ui/mainwnd.h"
 #include "log/logging.h"
+#include "metrics/tracing.h"
 #include "utils/system_utils.h"
 
 /**
@@ -32,6 +33,8 @@ enum class ActionType
 {
   ShowMain,
   OpenLog,
+  DumpDiagnostics,
+  ToggleTrace,
   About,
   Quit
 };
@@ -113,6 +116,20 @@ private slots:
    */
   void openLog();
 
+  /**
+   * @brief 导出诊断记录
+   *
+   * 把飞行记录器中最近的日志（包括未写入日志文件的调试日志）转储到日志目录，并用托盘消息提示结果。
+   */
+  void dumpDiagnostics();
+
+  /**
+   * @brief 开始或停止性能追踪
+   *
+   * 未在追踪时开始记录各模块操作的耗时区间；正在追踪时停止并导出到日志目录，用托盘消息提示导出路径。
+   */
+  void toggleTrace();
+
   /**
    * @brief 显示关于对话框
    *
@@ -0,0 +1,117 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:02:44
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:02:44
+ * @FilePath: \GameOptimizerPro\include\utils\game_db_format.h
+ * @Description: 游戏数据库二进制格式，由数据库编译工具写入，程序运行时内存映射后直接读取
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * 文件布局（小端序，所有偏移均相对于文件开头，各段按 8 字节对齐）:
+ *
+ *   Header
+ *   TitleRecord[titleCount]          每个游戏/反作弊的策略记录
+ *   uint32_t buckets[bucketCount+1]  按哈希分桶的索引，第 i 桶的条目为 entries[buckets[i], buckets[i+1])
+ *   ExeEntry[entryCount]             可执行文件名索引，按桶排序
+ *   char strings[stringsSize]        字符串表，UTF-8 编码，以 '\0' 结尾
+ *
+ * 可执行文件名在字符串表中统一保存为小写，查找时先转小写再计算哈希。
+ */
+namespace GameDb
+{
+  constexpr char kMagic[4] = {'G', 'O', 'D', 'B'};
+  constexpr uint32_t kVersion = 1;
+  // 可执行文件名的最大长度 超出的名称不会被收录
+  constexpr size_t kMaxExeNameLength = 260;
+
+  // 条目类型
+  enum class TitleType : uint8_t
+  {
+    Game = 1,
+    AntiCheat = 2
+  };
+
+  // 条目策略标志
+  enum TitleFlags : uint8_t
+  {
+    FlagNone = 0,
+    // 不对该游戏进行文件预读
+    FlagSkipPrefetch = 1 << 0,
+  };
+
+  struct Header
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t titleCount;
+    uint32_t entryCount;
+    // 桶数量 为 2 的幂
+    uint32_t bucketCount;
+    uint32_t titlesOffset;
+    uint32_t bucketsOffset;
+    uint32_t entriesOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+    uint32_t fileSize;
+    uint32_t reserved;
+  };
+
+  struct TitleRecord
+  {
+    // 名称在字符串表中的偏移
+    uint32_t nameOffset;
+    // TitleType
+    uint8_t type;
+    // IoPriority 的取值 -1 表示不修改
+    int8_t ioPriority;
+    // TitleFlags 组合
+    uint8_t flags;
+    uint8_t reserved;
+  };
+
+  struct ExeEntry
+  {
+    // 小写可执行文件名的哈希
+    uint64_t hash;
+    // 小写可执行文件名在字符串表中的偏移
+    uint32_t nameOffset;
+    // 所属 TitleRecord 的下标
+    uint32_t titleIndex;
+  };
+
+  static_assert(sizeof(Header) == 48, "GameDb::Header layout changed");
+  static_assert(sizeof(TitleRecord) == 8, "GameDb::TitleRecord layout changed");
+  static_assert(sizeof(ExeEntry) == 16, "GameDb::ExeEntry layout changed");
+
+  /**
+   * @brief ASCII 字母转小写，其余字节保持不变
+   */
+  constexpr char toLowerAscii(char c)
+  {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+
+  /**
+   * @brief 计算可执行文件名的哈希 (FNV-1a 64位)
+   * @param {string_view} lowerName 已转为小写的可执行文件名
+   * @return {uint64_t} 哈希值
+   */
+  inline uint64_t hashName(std::string_view lowerName)
+  {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : lowerName)
+    {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+} // namespace GameDb
@@ -11,10 +11,24 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <unordered_set>
 #include <windows.h>
+#include <tlhelp32.h>
 
 #include "log\logging.h"
 
+/**
+ * @struct ProcessEntry
+ * @brief 进程快照条目，包含进程ID、父进程ID和可执行文件名
+ */
+struct ProcessEntry
+{
+  DWORD processId = 0;
+  DWORD parentProcessId = 0;
+  std::wstring exeName;
+};
+
 /**
  * @brief 检查进程名是否合法
  * @param {wstring} &processName 进程名
@@ -106,4 +120,51 @@ std::wstring RunPowerShellCommand(const std::wstring &command);
  * @param affinityMask CPU 亲和性掩码
  * @return bool 是否成功
  */
-bool SetProcessPriorityAndAffinity(const std::wstring &processName, const std::wstring &priority, DWORD_PTR affinityMask);
\ No newline at end of file
+bool SetProcessPriorityAndAffinity(const std::wstring &processName, const std::wstring &priority, DWORD_PTR affinityMask);
+
+/**
+ * @brief 获取当前系统的进程快照
+ * @return {vector<ProcessEntry>} 进程快照，失败时返回空数组
+ */
+std::vector<ProcessEntry> getProcessSnapshot();
+
+/**
+ * @brief 收集指定进程及其所有子进程的PID
+ * @param {vector<ProcessEntry>} &snapshot 进程快照
+ * @param {vector<DWORD>} &rootProcessIds 根进程PID
+ * @return {unordered_set<DWORD>} 进程树PID集合
+ */
+std::unordered_set<DWORD> collectProcessTree(const std::vector<ProcessEntry> &snapshot, const std::vector<DWORD> &rootProcessIds);
+
+/**
+ * @brief 是否为不允许限制的系统关键进程
+ * @param {wstring} &exeName 进程名
+ * @return {bool}
+ */
+bool isCriticalSystemProcess(const std::wstring &exeName);
+
+/**
+ * @brief 获取进程的 I/O 优先级
+ * @param {HANDLE} hProcess 进程句柄 需要 PROCESS_QUERY_LIMITED_INFORMATION 权限
+ * @param {ULONG} &ioPriority 输出 I/O 优先级 0: 非常低 1: 低 2: 正常 3: 高
+ * @return {bool} 是否获取成功
+ */
+bool getProcessIoPriority(HANDLE hProcess, ULONG &ioPriority);
+
+/**
+ * @brief 设置进程的 I/O 优先级，并回读校验是否生效
+ * @param {HANDLE} hProcess 进程句柄 需要 PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION 权限
+ * @param {ULONG} ioPriority I/O 优先级 0: 非常低 1: 低 2: 正常 3: 高 (高需要 SeIncreaseBasePriorityPrivilege)
+ * @return {bool} 是否设置成功
+ * @note 通过 ntdll 中的 NtSetInformationProcess(ProcessIoPriority) 实现
+ */
+bool setProcessIoPriority(HANDLE hProcess, ULONG ioPriority);
+
+/**
+ * @brief 原子地写入文件 先写同目录下的 .tmp 临时文件并刷盘，再替换目标文件
+ * @param {wstring} &filePath 目标文件路径
+ * @param {string} &content 文件内容
+ * @return {bool} 是否写入成功 失败时删除临时文件，目标文件保持原内容
+ * @note 任何时刻目标文件都是完整的旧内容或新内容
+ */
+bool writeFileAtomically(const std::wstring &filePath, const std::string &content);
@@ -9,6 +9,7 @@
  */
 
 #include "config/app_config.h"
+#include "config/config_reflection.h"
 
 AppConfig::AppConfig()
 {
@@ -23,7 +24,10 @@ AppConfig::AppConfig(const AppConfig &other)
   version = other.version;
   systemInfo = other.systemInfo;
   optimismConfig = other.optimismConfig;
+  logConfig = other.logConfig;
+  metricsConfig = other.metricsConfig;
   processConfig = other.processConfig;
+  unknownFields = other.unknownFields;
 }
 
 AppConfig::AppConfig(AppConfig &&other) noexcept
@@ -31,7 +35,10 @@ AppConfig::AppConfig(AppConfig &&other) noexcept
   version = std::move(other.version);
   systemInfo = std::move(other.systemInfo);
   optimismConfig = std::move(other.optimismConfig);
+  logConfig = std::move(other.logConfig);
+  metricsConfig = std::move(other.metricsConfig);
   processConfig = std::move(other.processConfig);
+  unknownFields = std::move(other.unknownFields);
 }
 
 AppConfig &AppConfig::operator=(const AppConfig &other)
@@ -39,7 +46,10 @@ AppConfig &AppConfig::operator=(const AppConfig &other)
   version = other.version;
   systemInfo = other.systemInfo;
   optimismConfig = other.optimismConfig;
+  logConfig = other.logConfig;
+  metricsConfig = other.metricsConfig;
   processConfig = other.processConfig;
+  unknownFields = other.unknownFields;
   return *this;
 }
 
@@ -48,7 +58,10 @@ AppConfig &AppConfig::operator=(AppConfig &&other) noexcept
   version = std::move(other.version);
   systemInfo = std::move(other.systemInfo);
   optimismConfig = std::move(other.optimismConfig);
+  logConfig = std::move(other.logConfig);
+  metricsConfig = std::move(other.metricsConfig);
   processConfig = std::move(other.processConfig);
+  unknownFields = std::move(other.unknownFields);
   return *this;
 }
 
@@ -57,7 +70,10 @@ bool AppConfig::operator==(const AppConfig &other) const
   return version == other.version &&
          systemInfo == other.systemInfo &&
          optimismConfig == other.optimismConfig &&
-         processConfig == other.processConfig;
+         logConfig == other.logConfig &&
+         metricsConfig == other.metricsConfig &&
+         processConfig == other.processConfig &&
+         unknownFields == other.unknownFields;
 }
 
 bool AppConfig::operator!=(const AppConfig &other) const
@@ -65,36 +81,15 @@ bool AppConfig::operator!=(const AppConfig &other) const
   return !(*this == other);
 }
 
-// TODO: AppConfig 从json文件加载配置
-// void AppConfig::fromJson(const nlohmann::json &json)
-// {
-//   version = json["version"];
-//   if (json.contains("systemInfo"))
-//   {
-//     systemInfo.fromJson(json["systemInfo"]);
-//   }
-//   if (json.contains("optimismConfig"))
-//   {
-//     optimismConfig.fromJson(json["optimismConfig"]);
-//   }
-//   json gameProcessesJson;
-//   if (json.contains("gameProcesses"))
-//   {
-//     for (const auto &process : json["gameProcesses"])
-//   }
-// }
+void AppConfig::fromJson(const nlohmann::json &json)
+{
+  ConfigReflection::fromJson(json, *this);
+}
 
-// TODO: AppConfig 转换为json
-// nlohmann::json AppConfig::toJson() const
-// {
-//   nlohmann::json json;
-//   json["version"] = version;
-//   json["systemInfo"] = systemInfo.toJson();
-//   json["optimismConfig"] = optimismConfig.toJson();
-//   json["gameProcesses"] = gameProcesses.toJson();
-//   json["antiCheatProcesses"] = antiCheatProcesses.toJson();
-//   return json;
-// }
+nlohmann::ordered_json AppConfig::toJson() const
+{
+  return ConfigReflection::toJson(*this);
+}
 
 // TODO: AppConfig 转换为字符串
 // std::string AppConfig::toString() const
@@ -108,5 +103,8 @@ void AppConfig::clear()
   version.clear();
   systemInfo.clear();
   optimismConfig.clear();
+  logConfig.clear();
+  metricsConfig.clear();
   processConfig.clear();
+  unknownFields.clear();
 }
@@ -0,0 +1,104 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 10:13:02
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 10:13:02
+ * @FilePath: \GameOptimizerPro\src\config\background_policy.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "config/background_policy.h"
+#include "config/config_reflection.h"
+
+BackgroundPolicy::BackgroundPolicy()
+{
+  efficiencyMode = false;
+  throttleAllBackground = false;
+  trimWorkingSet = false;
+  trimBudgetMB = 1024;
+  trimExclusionList.clear();
+  memoryPressureResponse = false;
+}
+
+BackgroundPolicy::~BackgroundPolicy()
+{
+  clear();
+}
+
+void BackgroundPolicy::clear()
+{
+  efficiencyMode = false;
+  throttleAllBackground = false;
+  trimWorkingSet = false;
+  trimBudgetMB = 1024;
+  trimExclusionList.clear();
+  memoryPressureResponse = false;
+}
+
+BackgroundPolicy &BackgroundPolicy::operator=(const BackgroundPolicy &other)
+{
+  if (this != &other)
+  {
+    efficiencyMode = other.efficiencyMode;
+    throttleAllBackground = other.throttleAllBackground;
+    trimWorkingSet = other.trimWorkingSet;
+    trimBudgetMB = other.trimBudgetMB;
+    trimExclusionList = other.trimExclusionList;
+    memoryPressureResponse = other.memoryPressureResponse;
+  }
+  return *this;
+}
+
+BackgroundPolicy &BackgroundPolicy::operator=(BackgroundPolicy &&other) noexcept
+{
+  if (this != &other)
+  {
+    efficiencyMode = std::move(other.efficiencyMode);
+    throttleAllBackground = std::move(other.throttleAllBackground);
+    trimWorkingSet = std::move(other.trimWorkingSet);
+    trimBudgetMB = std::move(other.trimBudgetMB);
+    trimExclusionList = std::move(other.trimExclusionList);
+    memoryPressureResponse = std::move(other.memoryPressureResponse);
+  }
+  return *this;
+}
+
+bool BackgroundPolicy::operator==(const BackgroundPolicy &other) const
+{
+  return efficiencyMode == other.efficiencyMode &&
+         throttleAllBackground == other.throttleAllBackground &&
+         trimWorkingSet == other.trimWorkingSet &&
+         trimBudgetMB == other.trimBudgetMB &&
+         trimExclusionList == other.trimExclusionList &&
+         memoryPressureResponse == other.memoryPressureResponse;
+}
+
+bool BackgroundPolicy::operator!=(const BackgroundPolicy &other) const
+{
+  return !(*this == other);
+}
+
+std::string BackgroundPolicy::toString() const
+{
+  std::string exclusionList;
+  for (const auto &processName : trimExclusionList)
+  {
+    exclusionList += processName + " ";
+  }
+  return "efficiencyMode: " + std::to_string(efficiencyMode) +
+         " throttleAllBackground: " + std::to_string(throttleAllBackground) +
+         " trimWorkingSet: " + std::to_string(trimWorkingSet) +
+         " trimBudgetMB: " + std::to_string(trimBudgetMB) +
+         " trimExclusionList: " + exclusionList +
+         " memoryPressureResponse: " + std::to_string(memoryPressureResponse);
+}
+
+void BackgroundPolicy::fromJson(const nlohmann::json &json)
+{
+  ConfigReflection::fromJson(json, *this);
+}
+
+nlohmann::ordered_json BackgroundPolicy::toJson() const
+{
+  return ConfigReflection::toJson(*this);
+}
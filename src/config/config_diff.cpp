@@ -0,0 +1,87 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 14:21:10
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 14:21:10
+ * @FilePath: \GameOptimizerPro\src\config\config_diff.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "config/config_diff.h"
+
+ConfigDiff ConfigDiff::compute(const AppConfig &oldConfig, const AppConfig &newConfig)
+{
+  const auto &oldOptimism = oldConfig.optimismConfig;
+  const auto &newOptimism = newConfig.optimismConfig;
+  const auto &oldPolicy = oldOptimism.backgroundPolicy;
+  const auto &newPolicy = newOptimism.backgroundPolicy;
+
+  ConfigDiff diff;
+  diff.autoStartUp = oldOptimism.autoStartUp != newOptimism.autoStartUp;
+  diff.autoLimitAntiCheat = oldOptimism.autoLimitAntiCheat != newOptimism.autoLimitAntiCheat;
+  diff.powerPlan = oldOptimism.powerPlan != newOptimism.powerPlan;
+  diff.limitBackgroundActivity = oldOptimism.limitBackgroundActivity != newOptimism.limitBackgroundActivity;
+  diff.optimizeNetworkDelay = oldOptimism.optimizeNetworkDelay != newOptimism.optimizeNetworkDelay;
+  diff.optimizeSystemScheduling = oldOptimism.optimizeSystemScheduling != newOptimism.optimizeSystemScheduling;
+  diff.optimizeSystemService = oldOptimism.optimizeSystemService != newOptimism.optimizeSystemService;
+
+  diff.backgroundEfficiency = oldPolicy.efficiencyMode != newPolicy.efficiencyMode ||
+                              oldPolicy.throttleAllBackground != newPolicy.throttleAllBackground;
+  // 回收预算和排除列表同时被游戏时回收内存和内存压力响应使用
+  const bool trimParamsChanged = oldPolicy.trimBudgetMB != newPolicy.trimBudgetMB ||
+                                 oldPolicy.trimExclusionList != newPolicy.trimExclusionList;
+  diff.workingSetTrim = oldPolicy.trimWorkingSet != newPolicy.trimWorkingSet || trimParamsChanged;
+  diff.memoryPressureResponse = oldPolicy.memoryPressureResponse != newPolicy.memoryPressureResponse || trimParamsChanged;
+  diff.gamePrefetch = oldOptimism.gamePrefetch != newOptimism.gamePrefetch ||
+                      oldOptimism.prefetchBudgetMB != newOptimism.prefetchBudgetMB;
+
+  diff.logging = oldConfig.logConfig != newConfig.logConfig;
+  diff.metrics = oldConfig.metricsConfig != newConfig.metricsConfig;
+
+  diff.gameProcessList = oldConfig.processConfig.gameProcessList != newConfig.processConfig.gameProcessList;
+  diff.antiCheatProcessList = oldConfig.processConfig.antiCheatProcessList != newConfig.processConfig.antiCheatProcessList;
+  diff.backgroundProcessList = oldConfig.processConfig.backgroundProcessList != newConfig.processConfig.backgroundProcessList;
+  return diff;
+}
+
+bool ConfigDiff::empty() const
+{
+  return !(autoStartUp || autoLimitAntiCheat || powerPlan || limitBackgroundActivity ||
+           optimizeNetworkDelay || optimizeSystemScheduling || optimizeSystemService ||
+           backgroundEfficiency || workingSetTrim || memoryPressureResponse || gamePrefetch ||
+           logging || metrics || gameProcessList || antiCheatProcessList || backgroundProcessList);
+}
+
+std::string ConfigDiff::toString() const
+{
+  std::string result;
+  auto append = [&result](bool changed, const char *name)
+  {
+    if (changed)
+    {
+      if (!result.empty())
+      {
+        result += ", ";
+      }
+      result += name;
+    }
+  };
+
+  append(autoStartUp, "autoStartUp");
+  append(autoLimitAntiCheat, "autoLimitAntiCheat");
+  append(powerPlan, "powerPlan");
+  append(limitBackgroundActivity, "limitBackgroundActivity");
+  append(optimizeNetworkDelay, "optimizeNetworkDelay");
+  append(optimizeSystemScheduling, "optimizeSystemScheduling");
+  append(optimizeSystemService, "optimizeSystemService");
+  append(backgroundEfficiency, "backgroundEfficiency");
+  append(workingSetTrim, "workingSetTrim");
+  append(memoryPressureResponse, "memoryPressureResponse");
+  append(gamePrefetch, "gamePrefetch");
+  append(logging, "logging");
+  append(metrics, "metrics");
+  append(gameProcessList, "gameProcessList");
+  append(antiCheatProcessList, "antiCheatProcessList");
+  append(backgroundProcessList, "backgroundProcessList");
+  return result;
+}
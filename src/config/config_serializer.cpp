@@ -0,0 +1,1008 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 16:06:40
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 16:06:40
+ * @FilePath: \GameOptimizerPro\src\config\config_serializer.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#define LOG_MODULE Logging::Module::Config
+
+#include "config/config_serializer.h"
+
+#include <climits>
+#include <cstdint>
+
+#include "config/config_reflection.h"
+#include "log/logging.h"
+#include "utils/system_utils.h"
+
+namespace
+{
+  // 配置文件的根对象只有 appConfig 一个键
+  constexpr const char *kAppConfigKey = "appConfig";
+
+  // ---- 字段取值校验 返回 false 时保留原值 ----
+
+  template <typename Owner, typename Member>
+  bool validateValue(const Owner &, Member Owner::*, Member &)
+  {
+    return true;
+  }
+
+  bool validateValue(const PowerPlan &, std::string PowerPlan::*member, std::string &value)
+  {
+    // 简单验证GUID格式
+    return member != &PowerPlan::powerPlanGuid || (!value.empty() && value.front() == '{' && value.back() == '}');
+  }
+
+  bool validateValue(const OptimismConfig &, int OptimismConfig::*, int &value)
+  {
+    value = value < 0 ? 0 : value;
+    return true;
+  }
+
+  bool validateValue(const BackgroundPolicy &, int BackgroundPolicy::*, int &value)
+  {
+    value = value < 0 ? 0 : value;
+    return true;
+  }
+
+  bool validateValue(const LogConfig &, std::string LogConfig::*member, std::string &value)
+  {
+    if (member == &LogConfig::format)
+    {
+      return value == "text" || value == "binary";
+    }
+    return value == "batch" || value == "interval" || value == "error";
+  }
+
+  bool validateValue(const LogConfig &, int LogConfig::*member, int &value)
+  {
+    // 轮换大小、间隔和限流数量为 0 表示关闭
+    if (member == &LogConfig::maxFileSizeMB || member == &LogConfig::rotateIntervalHours ||
+        member == &LogConfig::rateLimitBurst)
+    {
+      return value >= 0;
+    }
+    return value > 0;
+  }
+
+  bool validateValue(const MetricsConfig &, std::string MetricsConfig::*, std::string &value)
+  {
+    return !value.empty();
+  }
+
+  bool validateValue(const MetricsConfig &, int MetricsConfig::*, int &value)
+  {
+    return value > 0;
+  }
+
+  bool validateValue(const LogLevels &, std::string LogLevels::*member, std::string &value)
+  {
+    // 模块级别为空时使用默认级别
+    if (value.empty())
+    {
+      return member != &LogLevels::defaultLevel;
+    }
+    return value == "debug" || value == "info" || value == "warn" || value == "error" || value == "off";
+  }
+
+  // 列表元素校验 不合法的元素被丢弃
+  bool acceptElement(const ProcessInfo &processInfo)
+  {
+    return !processInfo.name.empty() && !processInfo.processList.empty();
+  }
+
+  // JSON Pointer 转义 (RFC 6901)
+  std::string escapePointerToken(const std::string &token)
+  {
+    std::string escaped;
+    escaped.reserve(token.size());
+    for (char c : token)
+    {
+      if (c == '~')
+        escaped += "~0";
+      else if (c == '/')
+        escaped += "~1";
+      else
+        escaped += c;
+    }
+    return escaped;
+  }
+
+  std::string unescapePointerToken(const std::string &token)
+  {
+    std::string unescaped;
+    unescaped.reserve(token.size());
+    for (size_t i = 0; i < token.size(); ++i)
+    {
+      if (token[i] == '~' && i + 1 < token.size())
+      {
+        unescaped += token[i + 1] == '1' ? '/' : '~';
+        ++i;
+      }
+      else
+      {
+        unescaped += token[i];
+      }
+    }
+    return unescaped;
+  }
+
+  /**
+   * SAX 事件中的标量值
+   */
+  struct ScalarValue
+  {
+    enum class Kind
+    {
+      Null,
+      Boolean,
+      Integer,
+      Float,
+      String
+    };
+
+    Kind kind = Kind::Null;
+    bool boolean = false;
+    int64_t integer = 0;
+    std::string *string = nullptr;
+  };
+
+  bool convertScalar(const ScalarValue &scalar, bool &value)
+  {
+    if (scalar.kind != ScalarValue::Kind::Boolean)
+      return false;
+    value = scalar.boolean;
+    return true;
+  }
+
+  bool convertScalar(const ScalarValue &scalar, int &value)
+  {
+    if (scalar.kind != ScalarValue::Kind::Integer || scalar.integer < INT_MIN || scalar.integer > INT_MAX)
+      return false;
+    value = static_cast<int>(scalar.integer);
+    return true;
+  }
+
+  bool convertScalar(const ScalarValue &scalar, std::string &value)
+  {
+    if (scalar.kind != ScalarValue::Kind::String)
+      return false;
+    value = std::move(*scalar.string);
+    return true;
+  }
+
+  bool convertScalar(const ScalarValue &scalar, IoPriority &value)
+  {
+    if (scalar.kind != ScalarValue::Kind::String)
+      return false;
+    value = ProcessInfo::ioPriorityFromString(*scalar.string);
+    return true;
+  }
+
+  template <typename T>
+  struct IsScalar : std::integral_constant<bool, std::is_same<T, bool>::value || std::is_same<T, int>::value ||
+                                                     std::is_same<T, std::string>::value || std::is_same<T, IoPriority>::value>
+  {
+  };
+
+  class SaxReader;
+
+  /**
+   * 解析栈中的一层 对应一个正在填充的对象或数组
+   */
+  struct Frame;
+
+  struct FrameOps
+  {
+    // 对象层: 按键名查找字段下标
+    int (*findField)(const std::string &key);
+    // 对象层: 字段下标对应的键名
+    const char *(*fieldName)(int fieldIndex);
+    // 返回 false 表示类型不符 由 SaxReader 跳过该值
+    bool (*scalar)(SaxReader &reader, Frame &frame, const ScalarValue &value);
+    bool (*startObject)(SaxReader &reader, Frame &frame);
+    bool (*startArray)(SaxReader &reader, Frame &frame);
+    // 数组层: 子元素解析完成
+    void (*elementEnd)(SaxReader &reader, Frame &frame);
+  };
+
+  struct Frame
+  {
+    const FrameOps *ops = nullptr;
+    void *target = nullptr;
+    // 当前键对应的字段下标
+    int fieldIndex = -1;
+    // 在父对象中的键名 指向字段描述中的静态字符串
+    const char *key = nullptr;
+    // 在父数组中的下标
+    size_t index = 0;
+    bool isElement = false;
+  };
+
+  /**
+   * SAX 事件处理器 按字段描述把值直接写入配置对象
+   */
+  class SaxReader
+  {
+  public:
+    explicit SaxReader(AppConfig &config) : m_config(config)
+    {
+      m_stack.reserve(8);
+    }
+
+    bool hasAppConfig() const { return m_hasAppConfig; }
+    const std::string &error() const { return m_error; }
+    AppConfig &config() { return m_config; }
+
+    void push(const FrameOps *ops, void *target, const char *key)
+    {
+      Frame frame;
+      frame.ops = ops;
+      frame.target = target;
+      frame.key = key;
+      m_stack.push_back(frame);
+    }
+
+    void pushElement(const FrameOps *ops, void *target, size_t index)
+    {
+      Frame frame;
+      frame.ops = ops;
+      frame.target = target;
+      frame.index = index;
+      frame.isElement = true;
+      m_stack.push_back(frame);
+    }
+
+    void markAppConfig() { m_hasAppConfig = true; }
+
+    // 当前层的 JSON Pointer 只在遇到未登记的键或需要告警时生成
+    std::string currentPath() const
+    {
+      std::string path;
+      for (size_t i = 1; i < m_stack.size(); ++i)
+      {
+        path += '/';
+        path += m_stack[i].isElement ? std::to_string(m_stack[i].index) : escapePointerToken(m_stack[i].key);
+      }
+      return path;
+    }
+
+    // 丢弃被拒绝的数组元素下保存的未登记键
+    void discardUnknownFields(const std::string &elementPath)
+    {
+      const std::string prefix = elementPath + "/";
+      auto &unknownFields = m_config.unknownFields;
+      auto it = unknownFields.lower_bound(prefix);
+      while (it != unknownFields.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+      {
+        it = unknownFields.erase(it);
+      }
+    }
+
+    void warnDropped(const std::string &path, const char *reason)
+    {
+      LOG_WARN_FMT("配置项 {} {}，已忽略", path, reason);
+    }
+
+    // ---- nlohmann::json SAX 接口 ----
+
+    bool null()
+    {
+      ScalarValue value;
+      return scalar(value);
+    }
+
+    bool boolean(bool val)
+    {
+      ScalarValue value;
+      value.kind = ScalarValue::Kind::Boolean;
+      value.boolean = val;
+      return scalar(value);
+    }
+
+    bool number_integer(nlohmann::json::number_integer_t val)
+    {
+      ScalarValue value;
+      value.kind = ScalarValue::Kind::Integer;
+      value.integer = val;
+      return scalar(value);
+    }
+
+    bool number_unsigned(nlohmann::json::number_unsigned_t val)
+    {
+      ScalarValue value;
+      if (val <= static_cast<nlohmann::json::number_unsigned_t>(INT64_MAX))
+      {
+        value.kind = ScalarValue::Kind::Integer;
+        value.integer = static_cast<int64_t>(val);
+      }
+      else
+      {
+        value.kind = ScalarValue::Kind::Float;
+      }
+      if (m_capture != CaptureState::None)
+      {
+        return captureScalar(val);
+      }
+      return scalar(value);
+    }
+
+    bool number_float(nlohmann::json::number_float_t val, const nlohmann::json::string_t &)
+    {
+      if (m_capture != CaptureState::None)
+      {
+        return captureScalar(val);
+      }
+      ScalarValue value;
+      value.kind = ScalarValue::Kind::Float;
+      return scalar(value);
+    }
+
+    bool string(nlohmann::json::string_t &val)
+    {
+      ScalarValue value;
+      value.kind = ScalarValue::Kind::String;
+      value.string = &val;
+      return scalar(value);
+    }
+
+    bool binary(nlohmann::json::binary_t &)
+    {
+      m_error = "配置文件包含不支持的二进制值";
+      return false;
+    }
+
+    bool start_object(std::size_t)
+    {
+      if (m_capture != CaptureState::None)
+      {
+        return captureStart(nlohmann::json::object());
+      }
+      if (m_stack.empty())
+      {
+        push(&kDocumentOps, &m_config, nullptr);
+        return true;
+      }
+      Frame &frame = m_stack.back();
+      if (!frame.ops->startObject(*this, frame))
+      {
+        beginSkip(frame);
+        return captureStart(nlohmann::json::object());
+      }
+      return true;
+    }
+
+    bool key(nlohmann::json::string_t &val)
+    {
+      if (m_capture != CaptureState::None)
+      {
+        m_captureKey = val;
+        return true;
+      }
+      Frame &frame = m_stack.back();
+      frame.fieldIndex = frame.ops->findField(val);
+      if (frame.fieldIndex < 0)
+      {
+        // 未登记的键 保存下一个值
+        m_capture = CaptureState::Pending;
+        m_captureDiscard = false;
+        m_capturePath = currentPath() + "/" + escapePointerToken(val);
+      }
+      return true;
+    }
+
+    bool end_object()
+    {
+      if (m_capture == CaptureState::Active)
+      {
+        return captureEnd();
+      }
+      popFrame();
+      return true;
+    }
+
+    bool start_array(std::size_t)
+    {
+      if (m_capture != CaptureState::None)
+      {
+        return captureStart(nlohmann::json::array());
+      }
+      if (m_stack.empty())
+      {
+        m_error = "配置文件根节点不是对象";
+        return false;
+      }
+      Frame &frame = m_stack.back();
+      if (!frame.ops->startArray(*this, frame))
+      {
+        beginSkip(frame);
+        return captureStart(nlohmann::json::array());
+      }
+      return true;
+    }
+
+    bool end_array()
+    {
+      if (m_capture == CaptureState::Active)
+      {
+        return captureEnd();
+      }
+      popFrame();
+      return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string &, const nlohmann::json::exception &ex)
+    {
+      m_error = std::string(ex.what()) + " at byte " + std::to_string(position);
+      return false;
+    }
+
+  private:
+    enum class CaptureState
+    {
+      None,
+      // 下一个值需要保存或跳过
+      Pending,
+      // 正在保存或跳过一个对象或数组
+      Active
+    };
+
+    static const FrameOps kDocumentOps;
+
+    bool scalar(const ScalarValue &value)
+    {
+      if (m_capture != CaptureState::None)
+      {
+        switch (value.kind)
+        {
+        case ScalarValue::Kind::Boolean:
+          return captureScalar(value.boolean);
+        case ScalarValue::Kind::Integer:
+          return captureScalar(value.integer);
+        case ScalarValue::Kind::String:
+          return captureScalar(std::move(*value.string));
+        default:
+          return captureScalar(nullptr);
+        }
+      }
+      if (m_stack.empty())
+      {
+        m_error = "配置文件根节点不是对象";
+        return false;
+      }
+      Frame &frame = m_stack.back();
+      if (!frame.ops->scalar(*this, frame, value))
+      {
+        warnDropped(fieldPath(frame), "类型不符");
+      }
+      return true;
+    }
+
+    // 当前层正在处理的字段路径 数组层为数组本身的路径
+    std::string fieldPath(const Frame &frame) const
+    {
+      if (!frame.ops->fieldName || frame.fieldIndex < 0)
+      {
+        return currentPath();
+      }
+      return currentPath() + "/" + escapePointerToken(frame.ops->fieldName(frame.fieldIndex));
+    }
+
+    void popFrame()
+    {
+      m_stack.pop_back();
+      if (!m_stack.empty() && m_stack.back().ops->elementEnd)
+      {
+        m_stack.back().ops->elementEnd(*this, m_stack.back());
+      }
+    }
+
+    // 类型不符的对象或数组整体跳过
+    void beginSkip(const Frame &frame)
+    {
+      warnDropped(fieldPath(frame), "类型不符");
+      m_capture = CaptureState::Pending;
+      m_captureDiscard = true;
+    }
+
+    template <typename Value>
+    bool captureScalar(Value &&value)
+    {
+      if (m_capture == CaptureState::Pending)
+      {
+        finishCapture(nlohmann::json(std::forward<Value>(value)));
+        return true;
+      }
+      insertCaptured(nlohmann::json(std::forward<Value>(value)));
+      return true;
+    }
+
+    bool captureStart(nlohmann::json &&container)
+    {
+      if (m_capture == CaptureState::Pending)
+      {
+        m_capture = CaptureState::Active;
+        m_captureRoot = std::move(container);
+        m_captureStack.push_back(&m_captureRoot);
+        return true;
+      }
+      m_captureStack.push_back(insertCaptured(std::move(container)));
+      return true;
+    }
+
+    bool captureEnd()
+    {
+      m_captureStack.pop_back();
+      if (m_captureStack.empty())
+      {
+        finishCapture(std::move(m_captureRoot));
+      }
+      return true;
+    }
+
+    nlohmann::json *insertCaptured(nlohmann::json &&value)
+    {
+      nlohmann::json *parent = m_captureStack.back();
+      if (parent->is_object())
+      {
+        nlohmann::json &slot = (*parent)[m_captureKey];
+        slot = std::move(value);
+        return &slot;
+      }
+      parent->push_back(std::move(value));
+      return &parent->back();
+    }
+
+    void finishCapture(nlohmann::json &&value)
+    {
+      if (!m_captureDiscard)
+      {
+        m_config.unknownFields[m_capturePath] = std::move(value);
+      }
+      m_capture = CaptureState::None;
+      m_captureRoot = nullptr;
+    }
+
+    AppConfig &m_config;
+    std::vector<Frame> m_stack;
+    bool m_hasAppConfig = false;
+    std::string m_error;
+
+    CaptureState m_capture = CaptureState::None;
+    bool m_captureDiscard = false;
+    std::string m_capturePath;
+    std::string m_captureKey;
+    nlohmann::json m_captureRoot;
+    std::vector<nlohmann::json *> m_captureStack;
+  };
+
+  template <typename T>
+  struct ObjectOps;
+  template <typename T>
+  struct ObjectListOps;
+
+  bool noScalar(SaxReader &, Frame &, const ScalarValue &) { return false; }
+  bool noContainer(SaxReader &, Frame &) { return false; }
+
+  /**
+   * 进程名列表层 非法进程名被丢弃
+   */
+  struct StringListOps
+  {
+    static bool scalar(SaxReader &reader, Frame &frame, const ScalarValue &value)
+    {
+      if (value.kind != ScalarValue::Kind::String)
+      {
+        return false;
+      }
+      if (!isValidProcessName(*value.string))
+      {
+        reader.warnDropped(reader.currentPath() + " \"" + *value.string + "\"", "不是合法的进程名");
+        return true;
+      }
+      static_cast<std::vector<std::string> *>(frame.target)->push_back(std::move(*value.string));
+      return true;
+    }
+
+    static constexpr FrameOps kOps = {nullptr, nullptr, &scalar, &noContainer, &noContainer, nullptr};
+  };
+
+  /**
+   * 配置对象层 按字段类型分派
+   */
+  template <typename T>
+  struct ObjectOps
+  {
+    static int findField(const std::string &key)
+    {
+      return ConfigReflection::findField<T>(key);
+    }
+
+    static const char *fieldName(int fieldIndex)
+    {
+      const char *name = "";
+      ConfigReflection::visitField<T>(fieldIndex, [&name](const auto &field)
+                                      { name = field.key; });
+      return name;
+    }
+
+    static bool scalar(SaxReader &, Frame &frame, const ScalarValue &value)
+    {
+      bool accepted = false;
+      T &object = *static_cast<T *>(frame.target);
+      ConfigReflection::visitField<T>(frame.fieldIndex, [&](const auto &field)
+                                      {
+        using Member = typename std::decay_t<decltype(field)>::MemberType;
+        if constexpr (IsScalar<Member>::value)
+        {
+          Member member{};
+          if (convertScalar(value, member))
+          {
+            accepted = true;
+            if (validateValue(object, field.member, member))
+            {
+              object.*(field.member) = std::move(member);
+            }
+          }
+        } });
+      return accepted;
+    }
+
+    static bool startObject(SaxReader &reader, Frame &frame)
+    {
+      bool accepted = false;
+      T &object = *static_cast<T *>(frame.target);
+      ConfigReflection::visitField<T>(frame.fieldIndex, [&](const auto &field)
+                                      {
+        using Member = typename std::decay_t<decltype(field)>::MemberType;
+        if constexpr (ConfigReflection::IsConfigObject<Member>::value)
+        {
+          reader.push(&ObjectOps<Member>::kOps, &(object.*(field.member)), field.key);
+          accepted = true;
+        } });
+      return accepted;
+    }
+
+    static bool startArray(SaxReader &reader, Frame &frame)
+    {
+      bool accepted = false;
+      T &object = *static_cast<T *>(frame.target);
+      ConfigReflection::visitField<T>(frame.fieldIndex, [&](const auto &field)
+                                      {
+        using Member = typename std::decay_t<decltype(field)>::MemberType;
+        if constexpr (std::is_same<Member, std::vector<std::string>>::value)
+        {
+          (object.*(field.member)).clear();
+          reader.push(&StringListOps::kOps, &(object.*(field.member)), field.key);
+          accepted = true;
+        }
+        else if constexpr (ConfigReflection::IsVector<Member>::value)
+        {
+          using Element = typename Member::value_type;
+          (object.*(field.member)).clear();
+          reader.push(&ObjectListOps<Element>::kOps, &(object.*(field.member)), field.key);
+          accepted = true;
+        } });
+      return accepted;
+    }
+
+    static constexpr FrameOps kOps = {&findField, &fieldName, &scalar, &startObject, &startArray, nullptr};
+  };
+
+  /**
+   * 配置对象列表层 元素解析完成后校验 不合法的元素被丢弃
+   */
+  template <typename T>
+  struct ObjectListOps
+  {
+    static bool startObject(SaxReader &reader, Frame &frame)
+    {
+      auto &list = *static_cast<std::vector<T> *>(frame.target);
+      list.emplace_back();
+      reader.pushElement(&ObjectOps<T>::kOps, &list.back(), list.size() - 1);
+      return true;
+    }
+
+    static void elementEnd(SaxReader &reader, Frame &frame)
+    {
+      auto &list = *static_cast<std::vector<T> *>(frame.target);
+      if (!list.empty() && !acceptElement(list.back()))
+      {
+        const std::string elementPath = reader.currentPath() + "/" + std::to_string(list.size() - 1);
+        reader.discardUnknownFields(elementPath);
+        reader.warnDropped(elementPath, "缺少名称或进程列表");
+        list.pop_back();
+      }
+    }
+
+    static constexpr FrameOps kOps = {nullptr, nullptr, &noScalar, &startObject, &noContainer, &elementEnd};
+  };
+
+  /**
+   * 文件根对象层 只识别 appConfig
+   */
+  int findDocumentField(const std::string &key)
+  {
+    return key == kAppConfigKey ? 0 : -1;
+  }
+
+  const char *documentFieldName(int)
+  {
+    return kAppConfigKey;
+  }
+
+  bool startDocumentObject(SaxReader &reader, Frame &frame)
+  {
+    reader.markAppConfig();
+    reader.push(&ObjectOps<AppConfig>::kOps, frame.target, kAppConfigKey);
+    return true;
+  }
+
+  const FrameOps SaxReader::kDocumentOps = {&findDocumentField, &documentFieldName, &noScalar, &startDocumentObject, &noContainer, nullptr};
+
+  /**
+   * 按字段描述流式写出 JSON 格式与 nlohmann::json::dump(4) 一致
+   */
+  class ConfigWriter
+  {
+  public:
+    explicit ConfigWriter(const AppConfig &config)
+        : m_config(config), m_trackPath(!config.unknownFields.empty())
+    {
+    }
+
+    std::string write()
+    {
+      // 每个进程条目约 100 字节
+      const auto &processConfig = m_config.processConfig;
+      m_out.reserve(2048 + 128 * (processConfig.gameProcessList.size() +
+                                  processConfig.antiCheatProcessList.size() +
+                                  processConfig.backgroundProcessList.size()));
+      m_out += '{';
+      ++m_depth;
+      newline();
+      writeKey(kAppConfigKey);
+      pushPath(kAppConfigKey);
+      writeObject(m_config);
+      popPath();
+      bool first = false;
+      writeUnknownFields(first);
+      --m_depth;
+      newline();
+      m_out += '}';
+      return std::move(m_out);
+    }
+
+  private:
+    void newline()
+    {
+      m_out += '\n';
+      m_out.append(static_cast<size_t>(m_depth) * 4, ' ');
+    }
+
+    void writeString(const std::string &value)
+    {
+      static const char *kHex = "0123456789abcdef";
+      m_out += '"';
+      for (char c : value)
+      {
+        switch (c)
+        {
+        case '"':
+          m_out += "\\\"";
+          break;
+        case '\\':
+          m_out += "\\\\";
+          break;
+        case '\b':
+          m_out += "\\b";
+          break;
+        case '\f':
+          m_out += "\\f";
+          break;
+        case '\n':
+          m_out += "\\n";
+          break;
+        case '\r':
+          m_out += "\\r";
+          break;
+        case '\t':
+          m_out += "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+          {
+            m_out += "\\u00";
+            m_out += kHex[(c >> 4) & 0x0F];
+            m_out += kHex[c & 0x0F];
+          }
+          else
+          {
+            m_out += c;
+          }
+        }
+      }
+      m_out += '"';
+    }
+
+    void writeKey(const char *key)
+    {
+      writeString(key);
+      m_out += ": ";
+    }
+
+    void pushPath(const std::string &token)
+    {
+      if (m_trackPath)
+      {
+        m_pathLengths.push_back(m_path.size());
+        m_path += '/';
+        m_path += escapePointerToken(token);
+      }
+    }
+
+    void popPath()
+    {
+      if (m_trackPath)
+      {
+        m_path.resize(m_pathLengths.back());
+        m_pathLengths.pop_back();
+      }
+    }
+
+    void writeValue(bool value) { m_out += value ? "true" : "false"; }
+    void writeValue(int value) { m_out += std::to_string(value); }
+    void writeValue(const std::string &value) { writeString(value); }
+    void writeValue(IoPriority value) { writeString(ProcessInfo::ioPriorityToString(value)); }
+
+    template <typename T>
+    void writeValue(const std::vector<T> &list)
+    {
+      if (list.empty())
+      {
+        m_out += "[]";
+        return;
+      }
+      m_out += '[';
+      ++m_depth;
+      for (size_t i = 0; i < list.size(); ++i)
+      {
+        if (i > 0)
+        {
+          m_out += ',';
+        }
+        newline();
+        pushPath(m_trackPath ? std::to_string(i) : std::string());
+        writeValue(list[i]);
+        popPath();
+      }
+      --m_depth;
+      newline();
+      m_out += ']';
+    }
+
+    template <typename T, typename = std::enable_if_t<ConfigReflection::IsConfigObject<T>::value>>
+    void writeValue(const T &object)
+    {
+      writeObject(object);
+    }
+
+    template <typename T>
+    void writeObject(const T &object)
+    {
+      m_out += '{';
+      ++m_depth;
+      bool first = true;
+      ConfigReflection::forEachField<T>([&](const auto &field)
+                                        {
+        const auto &member = object.*(field.member);
+        if (ConfigReflection::isOmitted(member))
+        {
+          return;
+        }
+        if (!first)
+        {
+          m_out += ',';
+        }
+        first = false;
+        newline();
+        writeKey(field.key);
+        pushPath(field.key);
+        writeValue(member);
+        popPath(); });
+      writeUnknownFields(first);
+      --m_depth;
+      if (!first)
+      {
+        newline();
+      }
+      m_out += '}';
+    }
+
+    // 写回当前对象下未登记的键
+    void writeUnknownFields(bool &first)
+    {
+      if (!m_trackPath)
+      {
+        return;
+      }
+      const std::string prefix = m_path + "/";
+      const auto &unknownFields = m_config.unknownFields;
+      for (auto it = unknownFields.lower_bound(prefix);
+           it != unknownFields.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+      {
+        const std::string token = it->first.substr(prefix.size());
+        if (token.find('/') != std::string::npos)
+        {
+          // 属于更深层的对象
+          continue;
+        }
+        if (!first)
+        {
+          m_out += ',';
+        }
+        first = false;
+        newline();
+        writeString(unescapePointerToken(token));
+        m_out += ": ";
+        // 嵌套内容按当前缩进重新对齐 JSON 字符串中不会出现原始换行
+        const std::string dumped = it->second.dump(4);
+        const std::string indent(static_cast<size_t>(m_depth) * 4, ' ');
+        for (char c : dumped)
+        {
+          m_out += c;
+          if (c == '\n')
+          {
+            m_out += indent;
+          }
+        }
+      }
+    }
+
+    const AppConfig &m_config;
+    std::string m_out;
+    int m_depth = 0;
+    bool m_trackPath = false;
+    std::string m_path;
+    std::vector<size_t> m_pathLengths;
+  };
+} // namespace
+
+bool ConfigSerializer::read(std::istream &input, AppConfig &config, std::string &error)
+{
+  config.unknownFields.clear();
+  SaxReader reader(config);
+  bool parsed = false;
+  try
+  {
+    parsed = nlohmann::json::sax_parse(input, &reader);
+  }
+  catch (const std::exception &e)
+  {
+    error = e.what();
+    return false;
+  }
+
+  if (!parsed)
+  {
+    error = reader.error().empty() ? "配置文件解析失败" : reader.error();
+    return false;
+  }
+  if (!reader.hasAppConfig())
+  {
+    error = "appConfig not found in config";
+    return false;
+  }
+  return true;
+}
+
+std::string ConfigSerializer::write(const AppConfig &config)
+{
+  ConfigWriter writer(config);
+  return writer.write();
+}
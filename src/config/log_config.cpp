@@ -0,0 +1,135 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 16:59:40
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 16:59:40
+ * @FilePath: \GameOptimizerPro\src\config\log_config.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "config/log_config.h"
+#include "config/config_reflection.h"
+
+LogConfig::LogConfig()
+{
+  asyncLogging = true;
+  flushPolicy = "batch";
+  flushIntervalMs = 1000;
+  format = "text";
+  maxFileSizeMB = 10;
+  rotateIntervalHours = 24;
+  maxArchiveFiles = 10;
+  compressArchives = true;
+  rateLimitBurst = 10;
+  rateLimitWindowSeconds = 10;
+  flightRecorder = true;
+  levels.clear();
+}
+
+LogConfig::~LogConfig()
+{
+  clear();
+}
+
+void LogConfig::clear()
+{
+  asyncLogging = true;
+  flushPolicy = "batch";
+  flushIntervalMs = 1000;
+  format = "text";
+  maxFileSizeMB = 10;
+  rotateIntervalHours = 24;
+  maxArchiveFiles = 10;
+  compressArchives = true;
+  rateLimitBurst = 10;
+  rateLimitWindowSeconds = 10;
+  flightRecorder = true;
+  levels.clear();
+}
+
+LogConfig &LogConfig::operator=(const LogConfig &other)
+{
+  if (this != &other)
+  {
+    asyncLogging = other.asyncLogging;
+    flushPolicy = other.flushPolicy;
+    flushIntervalMs = other.flushIntervalMs;
+    format = other.format;
+    maxFileSizeMB = other.maxFileSizeMB;
+    rotateIntervalHours = other.rotateIntervalHours;
+    maxArchiveFiles = other.maxArchiveFiles;
+    compressArchives = other.compressArchives;
+    rateLimitBurst = other.rateLimitBurst;
+    rateLimitWindowSeconds = other.rateLimitWindowSeconds;
+    flightRecorder = other.flightRecorder;
+    levels = other.levels;
+  }
+  return *this;
+}
+
+LogConfig &LogConfig::operator=(LogConfig &&other) noexcept
+{
+  if (this != &other)
+  {
+    asyncLogging = std::move(other.asyncLogging);
+    flushPolicy = std::move(other.flushPolicy);
+    flushIntervalMs = std::move(other.flushIntervalMs);
+    format = std::move(other.format);
+    maxFileSizeMB = std::move(other.maxFileSizeMB);
+    rotateIntervalHours = std::move(other.rotateIntervalHours);
+    maxArchiveFiles = std::move(other.maxArchiveFiles);
+    compressArchives = std::move(other.compressArchives);
+    rateLimitBurst = std::move(other.rateLimitBurst);
+    rateLimitWindowSeconds = std::move(other.rateLimitWindowSeconds);
+    flightRecorder = std::move(other.flightRecorder);
+    levels = std::move(other.levels);
+  }
+  return *this;
+}
+
+bool LogConfig::operator==(const LogConfig &other) const
+{
+  return asyncLogging == other.asyncLogging &&
+         flushPolicy == other.flushPolicy &&
+         flushIntervalMs == other.flushIntervalMs &&
+         format == other.format &&
+         maxFileSizeMB == other.maxFileSizeMB &&
+         rotateIntervalHours == other.rotateIntervalHours &&
+         maxArchiveFiles == other.maxArchiveFiles &&
+         compressArchives == other.compressArchives &&
+         rateLimitBurst == other.rateLimitBurst &&
+         rateLimitWindowSeconds == other.rateLimitWindowSeconds &&
+         flightRecorder == other.flightRecorder &&
+         levels == other.levels;
+}
+
+bool LogConfig::operator!=(const LogConfig &other) const
+{
+  return !(*this == other);
+}
+
+std::string LogConfig::toString() const
+{
+  return "asyncLogging: " + std::to_string(asyncLogging) +
+         " flushPolicy: " + flushPolicy +
+         " flushIntervalMs: " + std::to_string(flushIntervalMs) +
+         " format: " + format +
+         " maxFileSizeMB: " + std::to_string(maxFileSizeMB) +
+         " rotateIntervalHours: " + std::to_string(rotateIntervalHours) +
+         " maxArchiveFiles: " + std::to_string(maxArchiveFiles) +
+         " compressArchives: " + std::to_string(compressArchives) +
+         " rateLimitBurst: " + std::to_string(rateLimitBurst) +
+         " rateLimitWindowSeconds: " + std::to_string(rateLimitWindowSeconds) +
+         " flightRecorder: " + std::to_string(flightRecorder) +
+         " levels: " + levels.toString();
+}
+
+void LogConfig::fromJson(const nlohmann::json &json)
+{
+  ConfigReflection::fromJson(json, *this);
+}
+
+nlohmann::ordered_json LogConfig::toJson() const
+{
+  return ConfigReflection::toJson(*this);
+}
@@ -0,0 +1,105 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 18:53:10
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 18:53:10
+ * @FilePath: \GameOptimizerPro\src\config\log_levels.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "config/log_levels.h"
+#include "config/config_reflection.h"
+
+LogLevels::LogLevels()
+{
+  defaultLevel = "info";
+  process.clear();
+  registry.clear();
+  power.clear();
+  service.clear();
+  config.clear();
+  ui.clear();
+}
+
+LogLevels::~LogLevels()
+{
+  clear();
+}
+
+void LogLevels::clear()
+{
+  defaultLevel = "info";
+  process.clear();
+  registry.clear();
+  power.clear();
+  service.clear();
+  config.clear();
+  ui.clear();
+}
+
+LogLevels &LogLevels::operator=(const LogLevels &other)
+{
+  if (this != &other)
+  {
+    defaultLevel = other.defaultLevel;
+    process = other.process;
+    registry = other.registry;
+    power = other.power;
+    service = other.service;
+    config = other.config;
+    ui = other.ui;
+  }
+  return *this;
+}
+
+LogLevels &LogLevels::operator=(LogLevels &&other) noexcept
+{
+  if (this != &other)
+  {
+    defaultLevel = std::move(other.defaultLevel);
+    process = std::move(other.process);
+    registry = std::move(other.registry);
+    power = std::move(other.power);
+    service = std::move(other.service);
+    config = std::move(other.config);
+    ui = std::move(other.ui);
+  }
+  return *this;
+}
+
+bool LogLevels::operator==(const LogLevels &other) const
+{
+  return defaultLevel == other.defaultLevel &&
+         process == other.process &&
+         registry == other.registry &&
+         power == other.power &&
+         service == other.service &&
+         config == other.config &&
+         ui == other.ui;
+}
+
+bool LogLevels::operator!=(const LogLevels &other) const
+{
+  return !(*this == other);
+}
+
+std::string LogLevels::toString() const
+{
+  return "default: " + defaultLevel +
+         " process: " + process +
+         " registry: " + registry +
+         " power: " + power +
+         " service: " + service +
+         " config: " + config +
+         " ui: " + ui;
+}
+
+void LogLevels::fromJson(const nlohmann::json &json)
+{
+  ConfigReflection::fromJson(json, *this);
+}
+
+nlohmann::ordered_json LogLevels::toJson() const
+{
+  return ConfigReflection::toJson(*this);
+}
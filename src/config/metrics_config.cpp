@@ -0,0 +1,87 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 21:06:12
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 21:06:12
+ * @FilePath: \GameOptimizerPro\src\config\metrics_config.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "config/metrics_config.h"
+#include "config/config_reflection.h"
+
+MetricsConfig::MetricsConfig()
+{
+  enabled = true;
+  filePath = "logs/metrics.prom";
+  exportIntervalSeconds = 15;
+  traceGameSession = false;
+}
+
+MetricsConfig::~MetricsConfig()
+{
+  clear();
+}
+
+void MetricsConfig::clear()
+{
+  enabled = true;
+  filePath = "logs/metrics.prom";
+  exportIntervalSeconds = 15;
+  traceGameSession = false;
+}
+
+MetricsConfig &MetricsConfig::operator=(const MetricsConfig &other)
+{
+  if (this != &other)
+  {
+    enabled = other.enabled;
+    filePath = other.filePath;
+    exportIntervalSeconds = other.exportIntervalSeconds;
+    traceGameSession = other.traceGameSession;
+  }
+  return *this;
+}
+
+MetricsConfig &MetricsConfig::operator=(MetricsConfig &&other) noexcept
+{
+  if (this != &other)
+  {
+    enabled = std::move(other.enabled);
+    filePath = std::move(other.filePath);
+    exportIntervalSeconds = std::move(other.exportIntervalSeconds);
+    traceGameSession = std::move(other.traceGameSession);
+  }
+  return *this;
+}
+
+bool MetricsConfig::operator==(const MetricsConfig &other) const
+{
+  return enabled == other.enabled &&
+         filePath == other.filePath &&
+         exportIntervalSeconds == other.exportIntervalSeconds &&
+         traceGameSession == other.traceGameSession;
+}
+
+bool MetricsConfig::operator!=(const MetricsConfig &other) const
+{
+  return !(*this == other);
+}
+
+std::string MetricsConfig::toString() const
+{
+  return "enabled: " + std::to_string(enabled) +
+         " filePath: " + filePath +
+         " exportIntervalSeconds: " + std::to_string(exportIntervalSeconds) +
+         " traceGameSession: " + std::to_string(traceGameSession);
+}
+
+void MetricsConfig::fromJson(const nlohmann::json &json)
+{
+  ConfigReflection::fromJson(json, *this);
+}
+
+nlohmann::ordered_json MetricsConfig::toJson() const
+{
+  return ConfigReflection::toJson(*this);
+}
@@ -9,6 +9,7 @@
  */
 
 #include "config/optimism_config.h"
+#include "config/config_reflection.h"
 
 // 构造函数
 OptimismConfig::OptimismConfig()
@@ -20,12 +21,16 @@ OptimismConfig::OptimismConfig()
   optimizeNetworkDelay = false;
   optimizeSystemScheduling = false;
   optimizeSystemService = false;
+  backgroundPolicy.clear();
+  gamePrefetch = false;
+  prefetchBudgetMB = 2048;
 }
 
 // 析构函数
 OptimismConfig::~OptimismConfig()
 {
   powerPlan.clear();
+  backgroundPolicy.clear();
 }
 
 // 清空配置
@@ -38,6 +43,9 @@ void OptimismConfig::clear()
   optimizeNetworkDelay = false;
   optimizeSystemScheduling = false;
   optimizeSystemService = false;
+  backgroundPolicy.clear();
+  gamePrefetch = false;
+  prefetchBudgetMB = 2048;
 }
 
 OptimismConfig &OptimismConfig::operator=(const OptimismConfig &other)
@@ -51,6 +59,9 @@ OptimismConfig &OptimismConfig::operator=(const OptimismConfig &other)
     optimizeNetworkDelay = other.optimizeNetworkDelay;
     optimizeSystemScheduling = other.optimizeSystemScheduling;
     optimizeSystemService = other.optimizeSystemService;
+    backgroundPolicy = other.backgroundPolicy;
+    gamePrefetch = other.gamePrefetch;
+    prefetchBudgetMB = other.prefetchBudgetMB;
   }
   return *this;
 }
@@ -66,6 +77,9 @@ OptimismConfig &OptimismConfig::operator=(OptimismConfig &&other) noexcept
     optimizeNetworkDelay = std::move(other.optimizeNetworkDelay);
     optimizeSystemScheduling = std::move(other.optimizeSystemScheduling);
     optimizeSystemService = std::move(other.optimizeSystemService);
+    backgroundPolicy = std::move(other.backgroundPolicy);
+    gamePrefetch = std::move(other.gamePrefetch);
+    prefetchBudgetMB = std::move(other.prefetchBudgetMB);
   }
   return *this;
 }
@@ -78,7 +92,10 @@ bool OptimismConfig::operator==(const OptimismConfig &other) const
          limitBackgroundActivity == other.limitBackgroundActivity &&
          optimizeNetworkDelay == other.optimizeNetworkDelay &&
          optimizeSystemScheduling == other.optimizeSystemScheduling &&
-         optimizeSystemService == other.optimizeSystemService;
+         optimizeSystemService == other.optimizeSystemService &&
+         backgroundPolicy == other.backgroundPolicy &&
+         gamePrefetch == other.gamePrefetch &&
+         prefetchBudgetMB == other.prefetchBudgetMB;
 }
 
 bool OptimismConfig::operator!=(const OptimismConfig &other) const
@@ -95,37 +112,19 @@ std::string OptimismConfig::toString() const
   result += "limitBackgroundActivity: " + std::to_string(limitBackgroundActivity) + "\n";
   result += "optimizeNetworkDelay: " + std::to_string(optimizeNetworkDelay) + "\n";
   result += "optimizeSystemScheduling: " + std::to_string(optimizeSystemScheduling) + "\n";
-  result += "optimizeSystemService: " + std::to_string(optimizeSystemService);
+  result += "optimizeSystemService: " + std::to_string(optimizeSystemService) + "\n";
+  result += "backgroundPolicy: " + backgroundPolicy.toString() + "\n";
+  result += "gamePrefetch: " + std::to_string(gamePrefetch) + "\n";
+  result += "prefetchBudgetMB: " + std::to_string(prefetchBudgetMB);
   return result;
 }
 
 void OptimismConfig::fromJson(const nlohmann::json &json)
 {
-  if (json.contains("autoStartUp"))
-    autoStartUp = json["autoStartUp"];
-  if (json.contains("autoLimitAntiCheat"))
-    autoLimitAntiCheat = json["autoLimitAntiCheat"];
-  if (json.contains("powerPlan"))
-    powerPlan.fromJson(json["powerPlan"]);
-  if (json.contains("limitBackgroundActivity"))
-    limitBackgroundActivity = json["limitBackgroundActivity"];
-  if (json.contains("optimizeNetworkDelay"))
-    optimizeNetworkDelay = json["optimizeNetworkDelay"];
-  if (json.contains("optimizeSystemScheduling"))
-    optimizeSystemScheduling = json["optimizeSystemScheduling"];
-  if (json.contains("optimizeSystemService"))
-    optimizeSystemService = json["optimizeSystemService"];
+  ConfigReflection::fromJson(json, *this);
 }
 
-nlohmann::json OptimismConfig::toJson() const
+nlohmann::ordered_json OptimismConfig::toJson() const
 {
-  nlohmann::json json;
-  json["autoStartUp"] = autoStartUp;
-  json["autoLimitAntiCheat"] = autoLimitAntiCheat;
-  json["powerPlan"] = powerPlan.toJson();
-  json["limitBackgroundActivity"] = limitBackgroundActivity;
-  json["optimizeNetworkDelay"] = optimizeNetworkDelay;
-  json["optimizeSystemScheduling"] = optimizeSystemScheduling;
-  json["optimizeSystemService"] = optimizeSystemService;
-  return json;
+  return ConfigReflection::toJson(*this);
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 #include "config/power_plan.h"
+#include "config/config_reflection.h"
 
 PowerPlan::PowerPlan()
 {
@@ -71,19 +72,10 @@ std::string PowerPlan::toString() const
 
 void PowerPlan::fromJson(const nlohmann::json &json)
 {
-  if (json.contains("optimizePowerPlan"))
-    optimizePowerPlan = json["optimizePowerPlan"];
-  if (json.contains("lockPowerPlan"))
-    lockPowerPlan = json["lockPowerPlan"];
-  if (json.contains("powerPlanGuid"))
-    powerPlanGuid = json["powerPlanGuid"];
+  ConfigReflection::fromJson(json, *this);
 }
 
-nlohmann::json PowerPlan::toJson() const
+nlohmann::ordered_json PowerPlan::toJson() const
 {
-  nlohmann::json json;
-  json["optimizePowerPlan"] = optimizePowerPlan;
-  json["lockPowerPlan"] = lockPowerPlan;
-  json["powerPlanGuid"] = powerPlanGuid;
-  return json;
+  return ConfigReflection::toJson(*this);
 }
@@ -9,17 +9,20 @@
  */
 
 #include "config/process_config.h"
+#include "config/config_reflection.h"
 
 ProcessConfig::ProcessConfig()
 {
   gameProcessList = {};
   antiCheatProcessList = {};
+  backgroundProcessList = {};
 }
 
 ProcessConfig::~ProcessConfig()
 {
   gameProcessList.clear();
   antiCheatProcessList.clear();
+  backgroundProcessList.clear();
 }
 
 ProcessConfig &ProcessConfig::operator=(const ProcessConfig &other)
@@ -28,6 +31,7 @@ ProcessConfig &ProcessConfig::operator=(const ProcessConfig &other)
   {
     gameProcessList = other.gameProcessList;
     antiCheatProcessList = other.antiCheatProcessList;
+    backgroundProcessList = other.backgroundProcessList;
   }
   return *this;
 }
@@ -38,13 +42,16 @@ ProcessConfig &ProcessConfig::operator=(ProcessConfig &&other) noexcept
   {
     gameProcessList = std::move(other.gameProcessList);
     antiCheatProcessList = std::move(other.antiCheatProcessList);
+    backgroundProcessList = std::move(other.backgroundProcessList);
   }
   return *this;
 }
 
 bool ProcessConfig::operator==(const ProcessConfig &other) const
 {
-  return gameProcessList == other.gameProcessList && antiCheatProcessList == other.antiCheatProcessList;
+  return gameProcessList == other.gameProcessList &&
+         antiCheatProcessList == other.antiCheatProcessList &&
+         backgroundProcessList == other.backgroundProcessList;
 }
 
 bool ProcessConfig::operator!=(const ProcessConfig &other) const
@@ -52,27 +59,15 @@ bool ProcessConfig::operator!=(const ProcessConfig &other) const
   return !(*this == other);
 }
 
-// TODO: ProcessConfig 转换为 JSON 对象
-// nlohmann::json ProcessConfig::toJson() const
-// {
-//   nlohmann::json json;
-//   json["gameProcessList"] = gameProcessList;
-//   json["antiCheatProcessList"] = antiCheatProcessList;
-//   return json;
-// }
+nlohmann::ordered_json ProcessConfig::toJson() const
+{
+  return ConfigReflection::toJson(*this);
+}
 
-// TODO: ProcessConfig 从json文件加载配置
-// void ProcessConfig::fromJson(const nlohmann::json &json)
-// {
-//   if (json.contains("gameProcessList"))
-//   {
-//     gameProcessList = json["gameProcessList"].get<std::vector<ProcessInfo>>();
-//   }
-//   if (json.contains("antiCheatProcessList"))
-//   {
-//     antiCheatProcessList = json["antiCheatProcessList"].get<std::vector<ProcessInfo>>();
-//   }
-// }
+void ProcessConfig::fromJson(const nlohmann::json &json)
+{
+  ConfigReflection::fromJson(json, *this);
+}
 
 std::string ProcessConfig::toString() const
 {
@@ -86,11 +81,44 @@ std::string ProcessConfig::toString() const
   {
     str += process.toString() + "\n";
   }
+  str += "Background Process List:\n";
+  for (const auto &process : backgroundProcessList)
+  {
+    str += process.toString() + "\n";
+  }
   return str;
 }
 
+std::vector<std::string> ProcessConfig::flatten(const std::vector<ProcessInfo> &processInfoList)
+{
+  std::vector<std::string> processNames;
+  for (const auto &processInfo : processInfoList)
+  {
+    processNames.insert(processNames.end(), processInfo.processList.begin(), processInfo.processList.end());
+  }
+  return processNames;
+}
+
+std::map<std::string, IoPriority> ProcessConfig::ioPriorityRules(const std::vector<ProcessInfo> &processInfoList)
+{
+  std::map<std::string, IoPriority> rules;
+  for (const auto &processInfo : processInfoList)
+  {
+    if (processInfo.ioPriority == IoPriority::UNCHANGED)
+    {
+      continue;
+    }
+    for (const auto &processName : processInfo.processList)
+    {
+      rules[processName] = processInfo.ioPriority;
+    }
+  }
+  return rules;
+}
+
 void ProcessConfig::clear()
 {
   gameProcessList.clear();
   antiCheatProcessList.clear();
+  backgroundProcessList.clear();
 }
@@ -8,12 +8,14 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 #include "config/process_info.h"
+#include "config/config_reflection.h"
 
 ProcessInfo::ProcessInfo()
 {
   name = "";
   status = false;
   processList = {};
+  ioPriority = IoPriority::UNCHANGED;
 }
 
 ProcessInfo::~ProcessInfo()
@@ -27,6 +29,7 @@ ProcessInfo &ProcessInfo::operator=(const ProcessInfo &other)
     name = other.name;
     status = other.status;
     processList = other.processList;
+    ioPriority = other.ioPriority;
   }
   return *this;
 }
@@ -38,6 +41,7 @@ ProcessInfo &ProcessInfo::operator=(ProcessInfo &&other) noexcept
     name = std::move(other.name);
     status = std::move(other.status);
     processList = std::move(other.processList);
+    ioPriority = other.ioPriority;
   }
   return *this;
 }
@@ -46,7 +50,8 @@ bool ProcessInfo::operator==(const ProcessInfo &other) const
 {
   return name == other.name &&
          processList == other.processList &&
-         status == other.status;
+         status == other.status &&
+         ioPriority == other.ioPriority;
 }
 
 // 转换为字符串
@@ -55,6 +60,7 @@ std::string ProcessInfo::toString() const
   std::string result;
   result += "name: " + name + "\n";
   result += "status: " + std::to_string(status) + "\n";
+  result += "ioPriority: " + ioPriorityToString(ioPriority) + "\n";
   result += "processList: [";
   for (const auto &process : processList)
   {
@@ -69,20 +75,14 @@ std::string ProcessInfo::toString() const
   return result;
 }
 
-nlohmann::json ProcessInfo::toJson() const
+nlohmann::ordered_json ProcessInfo::toJson() const
 {
-  nlohmann::json json;
-  json["name"] = name;
-  json["status"] = status;
-  json["processList"] = processList;
-  return json;
+  return ConfigReflection::toJson(*this);
 }
 
 void ProcessInfo::fromJson(const nlohmann::json &json)
 {
-  name = json["name"];
-  status = json["status"];
-  processList = json["processList"];
+  ConfigReflection::fromJson(json, *this);
 }
 
 void ProcessInfo::clear()
@@ -90,4 +90,35 @@ void ProcessInfo::clear()
   name = "";
   status = false;
   processList = {};
+  ioPriority = IoPriority::UNCHANGED;
+}
+
+std::string ProcessInfo::ioPriorityToString(IoPriority ioPriority)
+{
+  switch (ioPriority)
+  {
+  case IoPriority::VERY_LOW:
+    return "veryLow";
+  case IoPriority::LOW:
+    return "low";
+  case IoPriority::NORMAL:
+    return "normal";
+  case IoPriority::HIGH:
+    return "high";
+  default:
+    return "";
+  }
+}
+
+IoPriority ProcessInfo::ioPriorityFromString(const std::string &ioPriority)
+{
+  if (ioPriority == "veryLow")
+    return IoPriority::VERY_LOW;
+  if (ioPriority == "low")
+    return IoPriority::LOW;
+  if (ioPriority == "normal")
+    return IoPriority::NORMAL;
+  if (ioPriority == "high")
+    return IoPriority::HIGH;
+  return IoPriority::UNCHANGED;
 }
@@ -8,6 +8,7 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 #include "config/system_info.h"
+#include "config/config_reflection.h"
 
 // 构造函数
 SystemInfo::SystemInfo()
@@ -68,29 +69,12 @@ std::string SystemInfo::toString() const
 
 void SystemInfo::fromJson(const nlohmann::json &json)
 {
-  if (json.contains("os"))
-  {
-    os = json["os"];
-  }
-
-  if (json.contains("cpu"))
-  {
-    cpu = json["cpu"];
-  }
-
-  if (json.contains("arch"))
-  {
-    arch = json["arch"];
-  }
+  ConfigReflection::fromJson(json, *this);
 }
 
-nlohmann::json SystemInfo::toJson() const
+nlohmann::ordered_json SystemInfo::toJson() const
 {
-  nlohmann::json json;
-  json["os"] = os;
-  json["cpu"] = cpu;
-  json["arch"] = arch;
-  return json;
+  return ConfigReflection::toJson(*this);
 }
 
 void SystemInfo::clear()
@@ -10,6 +10,11 @@
 
 #include "core/application.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <QCoreApplication>
+
 Application::Application(const std::wstring &configPath, QSystemTrayIcon *trayIcon)
     : m_trayIcon(trayIcon)
 {
@@ -18,15 +23,58 @@ Application::Application(const std::wstring &configPath, QSystemTrayIcon *trayIc
   {
     m_optimizer = std::make_unique<Optimizer>(trayIcon);
     m_configManager = std::make_unique<ConfigManager>(configPath);
+    applyLogConfig(m_configManager->getSnapshot()->logConfig);
+    m_metricsExporter = std::make_unique<MetricsExporter>();
+    applyMetricsConfig(m_configManager->getSnapshot()->metricsConfig);
+
+    m_prefetchDirectory = (std::filesystem::path(configPath).parent_path() / L"prefetch").wstring();
+
+    // 游戏进程的实际优化状态变化时 转到主线程后同步到配置
+    m_optimizer->setOnGameProcessStatusChangedCallback(
+        [this]()
+        {
+          QMetaObject::invokeMethod(
+              QCoreApplication::instance(),
+              [this]()
+              {
+                syncGameProcessStatus();
+              },
+              Qt::QueuedConnection);
+        });
+
+    // 注册表撤销日志与配置文件放在同一目录
+    const auto config = m_configManager->getSnapshot();
+    m_optimizer->initRegistryOptimizations((std::filesystem::path(configPath).parent_path() / L"registry_journal.json").wstring(),
+                                           config->optimismConfig.limitBackgroundActivity,
+                                           config->optimismConfig.optimizeNetworkDelay,
+                                           config->optimismConfig.optimizeSystemScheduling);
 
-    m_currentConfig = m_configManager->getConfig();
+    // 游戏数据库为可选文件 由 GameDbCompiler 生成 与配置文件放在同一目录
+    const auto gameDatabasePath = std::filesystem::path(configPath).parent_path() / L"game_db.bin";
+    if (std::filesystem::exists(gameDatabasePath))
+    {
+      auto gameDatabase = std::make_shared<GameDatabase>();
+      if (gameDatabase->open(gameDatabasePath.wstring()))
+      {
+        m_optimizer->setGameDatabase(gameDatabase);
+      }
+    }
     LOG_INFO("Application初始化成功");
-    // 启动配置热更新监听
-    // m_configManager->StartConfigMonitor();
-    // m_configManager->RegisterConfigReloadCallback([this]() {
-    //     LOG_INFO(L"检测到配置更新，重新加载设置");
-    //     ReloadConfiguration();
-    // });
+    // 启动配置热更新监听 回调在监控线程中执行 转到主线程后再应用
+    m_configManager->setOnConfigChangedCallback(
+        [this](const ConfigDiff &diff, const std::shared_ptr<const AppConfig> &oldConfig,
+               const std::shared_ptr<const AppConfig> &newConfig)
+        {
+          // 快照不可变 只传递指针 不拷贝配置
+          QMetaObject::invokeMethod(
+              QCoreApplication::instance(),
+              [this, diff, oldConfig, newConfig]()
+              {
+                applyConfigChange(diff, oldConfig, newConfig);
+              },
+              Qt::QueuedConnection);
+        });
+    m_configManager->setConfigMonitor(true);
   }
   catch (const std::exception &e)
   {
@@ -36,19 +84,27 @@ Application::Application(const std::wstring &configPath, QSystemTrayIcon *trayIc
 
 Application::~Application()
 {
+  if (m_configManager)
+  {
+    m_configManager->setConfigMonitor(false);
+  }
+  if (m_metricsExporter)
+  {
+    m_metricsExporter->stop();
+  }
 }
 
-AppConfig Application::getCurrentConfig() const
+std::shared_ptr<const AppConfig> Application::getCurrentConfig() const
 {
-  return m_configManager->getConfig();
+  return m_configManager->getSnapshot();
 }
 
 bool Application::setAutoStartup(bool isAutoStartup)
 {
   if (m_optimizer->setAutoStartup(isAutoStartup))
   {
-    m_currentConfig.optimismConfig.autoStartUp = isAutoStartup;
-    m_configManager->setConfig(m_currentConfig);
+    m_configManager->updateConfig([isAutoStartup](AppConfig &appConfig)
+                                  { appConfig.optimismConfig.autoStartUp = isAutoStartup; });
     LOG_INFO("设置自动启动成功");
     return true;
   }
@@ -61,16 +117,36 @@ bool Application::setAutoStartup(bool isAutoStartup)
 
 bool Application::setOptimizeGameProcess(int gameIndex, bool isOptimize)
 {
-  // 根据 gameIndex 从 m_currentConfig 中获取进程名数组
-  ProcessInfo processInfo = m_currentConfig.processConfig.gameProcessList[gameIndex];
+  // 根据 gameIndex 从当前配置中获取进程名数组
+  const auto config = m_configManager->getSnapshot();
+  const auto &gameProcessList = config->processConfig.gameProcessList;
+  if (gameIndex < 0 || static_cast<size_t>(gameIndex) >= gameProcessList.size())
+  {
+    LOG_ERROR("游戏索引超出范围: " + std::to_string(gameIndex));
+    return false;
+  }
+  const ProcessInfo &processInfo = gameProcessList[gameIndex];
+
+  // 写注册表期间配置可能被替换 按游戏名称而不是索引更新状态
+  auto updateStatus = [this, &processInfo, isOptimize]()
+  {
+    m_configManager->updateConfig([name = processInfo.name, isOptimize](AppConfig &appConfig)
+                                  {
+                                    auto &games = appConfig.processConfig.gameProcessList;
+                                    auto it = std::find_if(games.begin(), games.end(), [&name](const ProcessInfo &game)
+                                                           { return game.name == name; });
+                                    if (it != games.end())
+                                    {
+                                      it->status = isOptimize;
+                                    } });
+  };
 
   if (isOptimize)
   {
     // 设置游戏优化
     if (m_optimizer->setGameProcessRegistry(processInfo.processList, isOptimize))
     {
-      m_currentConfig.processConfig.gameProcessList[gameIndex].status = isOptimize;
-      m_configManager->setConfig(m_currentConfig);
+      updateStatus();
       LOG_INFO("设置游戏优化成功: " + processInfo.name);
       return true;
     }
@@ -85,8 +161,7 @@ bool Application::setOptimizeGameProcess(int gameIndex, bool isOptimize)
     // 取消游戏优化
     if (m_optimizer->setGameProcessRegistry(processInfo.processList, isOptimize))
     {
-      m_currentConfig.processConfig.gameProcessList[gameIndex].status = isOptimize;
-      m_configManager->setConfig(m_currentConfig);
+      updateStatus();
       LOG_INFO("取消游戏优化成功: " + processInfo.name);
       return true;
     }
@@ -101,15 +176,16 @@ bool Application::setOptimizeGameProcess(int gameIndex, bool isOptimize)
 
 bool Application::setAutoLimitAntiCheat(bool checked, bool isQuit)
 {
-
-  if (m_optimizer->setAutoLimitAntiCheat(checked, m_currentConfig.processConfig.antiCheatProcessList[0].processList))
+  const auto config = m_configManager->getSnapshot();
+  if (m_optimizer->setAutoLimitAntiCheat(checked, config->processConfig.antiCheatProcessList[0].processList,
+                                         ProcessConfig::ioPriorityRules(config->processConfig.antiCheatProcessList)))
   {
     // 如果是退出状态，则不需要保存配置
     if (!isQuit)
     {
       // 更新配置
-      m_currentConfig.optimismConfig.autoLimitAntiCheat = checked;
-      m_configManager->setConfig(m_currentConfig);
+      m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                    { appConfig.optimismConfig.autoLimitAntiCheat = checked; });
     }
     LOG_INFO("设置自动限制反作弊成功");
     return true;
@@ -125,12 +201,11 @@ bool Application::setAutoLimitAntiCheat(bool checked, bool isQuit)
 
 bool Application::setGameOptimizePowerPlan(bool isOptimize)
 {
-  GUID PowerPlanGuid = StringToGuid(m_currentConfig.optimismConfig.powerPlan.powerPlanGuid);
+  GUID PowerPlanGuid = StringToGuid(m_configManager->getSnapshot()->optimismConfig.powerPlan.powerPlanGuid);
   if (isOptimize)
   {
     if (m_optimizer->setGameOptimizePowerPlan(&PowerPlanGuid, isOptimize))
     {
-      m_currentConfig.optimismConfig.powerPlan.optimizePowerPlan = true;
       LOG_INFO("开启高性能游戏电源计划成功");
     }
     else
@@ -143,7 +218,6 @@ bool Application::setGameOptimizePowerPlan(bool isOptimize)
   {
     if (m_optimizer->setGameOptimizePowerPlan(&PowerPlanGuid, isOptimize))
     {
-      m_currentConfig.optimismConfig.powerPlan.optimizePowerPlan = false;
       LOG_INFO("关闭高性能游戏电源计划成功");
     }
     else
@@ -152,8 +226,12 @@ bool Application::setGameOptimizePowerPlan(bool isOptimize)
       return false;
     }
   }
-  m_currentConfig.optimismConfig.powerPlan.powerPlanGuid = GuidToString(&PowerPlanGuid);
-  m_configManager->setConfig(m_currentConfig);
+  m_configManager->updateConfig(
+      [isOptimize, powerPlanGuid = GuidToString(&PowerPlanGuid)](AppConfig &appConfig)
+      {
+        appConfig.optimismConfig.powerPlan.optimizePowerPlan = isOptimize;
+        appConfig.optimismConfig.powerPlan.powerPlanGuid = powerPlanGuid;
+      });
   return true;
 }
 
@@ -168,8 +246,8 @@ bool Application::setBackgroundActivityLimit(bool checked)
 {
   if (m_optimizer->setBackgroundActivityLimit(checked))
   {
-    m_currentConfig.optimismConfig.limitBackgroundActivity = checked;
-    m_configManager->setConfig(m_currentConfig);
+    m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                  { appConfig.optimismConfig.limitBackgroundActivity = checked; });
     LOG_INFO("设置后台活动限制成功");
     return true;
   }
@@ -184,8 +262,8 @@ bool Application::setOptimizeNetworkDelay(bool checked)
 {
   if (m_optimizer->setOptimizeNetworkDelay(checked))
   {
-    m_currentConfig.optimismConfig.optimizeNetworkDelay = checked;
-    m_configManager->setConfig(m_currentConfig);
+    m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                  { appConfig.optimismConfig.optimizeNetworkDelay = checked; });
     LOG_INFO("设置优化网络延迟成功");
     return true;
   }
@@ -200,8 +278,8 @@ bool Application::setSystemSchedulerOptimization(bool checked)
 {
   if (m_optimizer->setSystemSchedulerOptimization(checked))
   {
-    m_currentConfig.optimismConfig.optimizeSystemScheduling = checked;
-    m_configManager->setConfig(m_currentConfig);
+    m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                  { appConfig.optimismConfig.optimizeSystemScheduling = checked; });
     LOG_INFO("设置系统调度优化成功");
     return true;
   }
@@ -240,4 +318,419 @@ bool Application::setSystemServiceOptimization(bool checked)
       return false;
     }
   }
-}
\ No newline at end of file
+}
+bool Application::setBackgroundEfficiencyMode(bool checked, bool isQuit)
+{
+  const auto config = m_configManager->getSnapshot();
+  const auto gameProcessNames = ProcessConfig::flatten(config->processConfig.gameProcessList);
+  const auto backgroundProcessNames = ProcessConfig::flatten(config->processConfig.backgroundProcessList);
+  const auto ioPriorityRules = ProcessConfig::ioPriorityRules(config->processConfig.backgroundProcessList);
+  const bool throttleAll = config->optimismConfig.backgroundPolicy.throttleAllBackground;
+
+  if (m_optimizer->setBackgroundEfficiencyMode(checked, gameProcessNames, backgroundProcessNames, throttleAll, ioPriorityRules))
+  {
+    // 如果是退出状态，则不需要保存配置
+    if (!isQuit)
+    {
+      m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                    { appConfig.optimismConfig.backgroundPolicy.efficiencyMode = checked; });
+    }
+    LOG_INFO("设置后台能效模式成功");
+    return true;
+  }
+  else
+  {
+    LOG_ERROR("设置后台能效模式失败");
+    return false;
+  }
+}
+
+bool Application::setWorkingSetTrim(bool checked, bool isQuit)
+{
+  const auto config = m_configManager->getSnapshot();
+  const auto gameProcessNames = ProcessConfig::flatten(config->processConfig.gameProcessList);
+  const auto &backgroundPolicy = config->optimismConfig.backgroundPolicy;
+
+  if (m_optimizer->setWorkingSetTrim(checked, gameProcessNames, backgroundPolicy.trimExclusionList, backgroundPolicy.trimBudgetMB))
+  {
+    // 如果是退出状态，则不需要保存配置
+    if (!isQuit)
+    {
+      m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                    { appConfig.optimismConfig.backgroundPolicy.trimWorkingSet = checked; });
+    }
+    LOG_INFO("设置游戏时回收内存成功");
+    return true;
+  }
+  else
+  {
+    LOG_ERROR("设置游戏时回收内存失败");
+    return false;
+  }
+}
+
+bool Application::setMemoryPressureResponse(bool checked, bool isQuit)
+{
+  const auto config = m_configManager->getSnapshot();
+  const auto gameProcessNames = ProcessConfig::flatten(config->processConfig.gameProcessList);
+  const auto &backgroundPolicy = config->optimismConfig.backgroundPolicy;
+
+  if (m_optimizer->setMemoryPressureResponse(checked, gameProcessNames, backgroundPolicy.trimExclusionList, backgroundPolicy.trimBudgetMB))
+  {
+    // 如果是退出状态，则不需要保存配置
+    if (!isQuit)
+    {
+      m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                    { appConfig.optimismConfig.backgroundPolicy.memoryPressureResponse = checked; });
+    }
+    LOG_INFO("设置内存压力响应成功");
+    return true;
+  }
+  else
+  {
+    LOG_ERROR("设置内存压力响应失败");
+    return false;
+  }
+}
+
+bool Application::setGamePrefetch(bool checked, bool isQuit)
+{
+  const auto config = m_configManager->getSnapshot();
+  const auto gameProcessNames = ProcessConfig::flatten(config->processConfig.gameProcessList);
+
+  if (m_optimizer->setGamePrefetch(checked, gameProcessNames, m_prefetchDirectory, config->optimismConfig.prefetchBudgetMB))
+  {
+    // 如果是退出状态，则不需要保存配置
+    if (!isQuit)
+    {
+      m_configManager->updateConfig([checked](AppConfig &appConfig)
+                                    { appConfig.optimismConfig.gamePrefetch = checked; });
+    }
+    LOG_INFO("设置游戏文件预读成功");
+    return true;
+  }
+  else
+  {
+    LOG_ERROR("设置游戏文件预读失败");
+    return false;
+  }
+}
+
+void Application::setOnConfigReloadedCallback(std::function<void()> callback)
+{
+  m_onConfigReloadedCallback = std::move(callback);
+}
+
+void Application::applyConfigChange(const ConfigDiff &diff,
+                                    const std::shared_ptr<const AppConfig> &oldConfig,
+                                    const std::shared_ptr<const AppConfig> &newConfig)
+{
+  LOG_INFO("检测到配置文件更新，应用发生变化的设置: " + diff.toString());
+  // 各设置函数读取的快照已经是新配置 这里的副本只用于记录应用失败后的实际状态
+  AppConfig config = *newConfig;
+  bool allApplied = true;
+
+  // 开关或参数变化时按新配置重新应用 参数变化且保持开启时先关闭再开启 使新参数立即生效
+  // 应用失败时把开关写回为实际状态
+  auto reapply = [&allApplied](bool wasEnabled, bool &isEnabled, const std::function<bool(bool)> &setter)
+  {
+    if (!wasEnabled && !isEnabled)
+    {
+      return;
+    }
+    if (wasEnabled && isEnabled && !setter(false))
+    {
+      allApplied = false;
+      return;
+    }
+    if (!setter(isEnabled))
+    {
+      isEnabled = !isEnabled;
+      allApplied = false;
+    }
+  };
+
+  auto &optimism = config.optimismConfig;
+  const auto &oldOptimism = oldConfig->optimismConfig;
+
+  if (diff.autoStartUp && !m_optimizer->setAutoStartup(optimism.autoStartUp))
+  {
+    optimism.autoStartUp = oldOptimism.autoStartUp;
+    allApplied = false;
+  }
+
+  // 只有开关或反作弊进程列表变化时才重新订阅进程事件
+  if (diff.autoLimitAntiCheat || diff.antiCheatProcessList)
+  {
+    reapply(oldOptimism.autoLimitAntiCheat, optimism.autoLimitAntiCheat, [this, &config](bool checked)
+            { return (!checked || !config.processConfig.antiCheatProcessList.empty()) &&
+                     setAutoLimitAntiCheat(checked, true); });
+  }
+
+  // 电源计划GUID由程序生成 只响应开关变化
+  if (diff.powerPlan && optimism.powerPlan.optimizePowerPlan != oldOptimism.powerPlan.optimizePowerPlan)
+  {
+    auto &powerPlan = optimism.powerPlan;
+    GUID powerPlanGuid = StringToGuid(powerPlan.optimizePowerPlan ? powerPlan.powerPlanGuid : oldOptimism.powerPlan.powerPlanGuid);
+    if (m_optimizer->setGameOptimizePowerPlan(&powerPlanGuid, powerPlan.optimizePowerPlan))
+    {
+      powerPlan.powerPlanGuid = GuidToString(&powerPlanGuid);
+    }
+    else
+    {
+      powerPlan = oldOptimism.powerPlan;
+      allApplied = false;
+    }
+  }
+
+  if (diff.limitBackgroundActivity && !m_optimizer->setBackgroundActivityLimit(optimism.limitBackgroundActivity))
+  {
+    optimism.limitBackgroundActivity = oldOptimism.limitBackgroundActivity;
+    allApplied = false;
+  }
+
+  if (diff.optimizeNetworkDelay && !m_optimizer->setOptimizeNetworkDelay(optimism.optimizeNetworkDelay))
+  {
+    optimism.optimizeNetworkDelay = oldOptimism.optimizeNetworkDelay;
+    allApplied = false;
+  }
+
+  if (diff.optimizeSystemScheduling && !m_optimizer->setSystemSchedulerOptimization(optimism.optimizeSystemScheduling))
+  {
+    optimism.optimizeSystemScheduling = oldOptimism.optimizeSystemScheduling;
+    allApplied = false;
+  }
+
+  if (diff.optimizeSystemService && !m_optimizer->setSystemServiceOptimization(optimism.optimizeSystemService))
+  {
+    optimism.optimizeSystemService = oldOptimism.optimizeSystemService;
+    allApplied = false;
+  }
+
+  if (diff.logging)
+  {
+    applyLogConfig(config.logConfig);
+  }
+
+  if (diff.metrics)
+  {
+    applyMetricsConfig(config.metricsConfig);
+  }
+
+  if (diff.gameProcessList)
+  {
+    if (!applyGameProcessListChange(oldConfig->processConfig.gameProcessList, config.processConfig.gameProcessList))
+    {
+      allApplied = false;
+    }
+
+    // 游戏进程名变化时才需要重新订阅游戏会话
+    const auto gameProcessNames = ProcessConfig::flatten(config.processConfig.gameProcessList);
+    if (gameProcessNames != ProcessConfig::flatten(oldConfig->processConfig.gameProcessList) &&
+        !m_optimizer->restartSessionMonitor(gameProcessNames))
+    {
+      allApplied = false;
+    }
+  }
+
+  auto &backgroundPolicy = optimism.backgroundPolicy;
+  const auto &oldBackgroundPolicy = oldOptimism.backgroundPolicy;
+
+  if (diff.backgroundEfficiency || diff.backgroundProcessList)
+  {
+    reapply(oldBackgroundPolicy.efficiencyMode, backgroundPolicy.efficiencyMode, [this](bool checked)
+            { return setBackgroundEfficiencyMode(checked, true); });
+  }
+
+  if (diff.workingSetTrim)
+  {
+    reapply(oldBackgroundPolicy.trimWorkingSet, backgroundPolicy.trimWorkingSet, [this](bool checked)
+            { return setWorkingSetTrim(checked, true); });
+  }
+
+  if (diff.memoryPressureResponse)
+  {
+    reapply(oldBackgroundPolicy.memoryPressureResponse, backgroundPolicy.memoryPressureResponse, [this](bool checked)
+            { return setMemoryPressureResponse(checked, true); });
+  }
+
+  if (diff.gamePrefetch)
+  {
+    reapply(oldOptimism.gamePrefetch, optimism.gamePrefetch, [this](bool checked)
+            { return setGamePrefetch(checked, true); });
+  }
+
+  // 应用失败的开关或新生成的电源计划GUID 按实际状态写回配置文件
+  if (config != *newConfig)
+  {
+    m_configManager->setConfig(config);
+  }
+
+  if (allApplied)
+  {
+    LOG_INFO("配置文件更新已应用");
+  }
+  else
+  {
+    LOG_ERROR("部分配置更新应用失败，已按实际状态写回配置文件");
+    if (m_trayIcon)
+    {
+      m_trayIcon->showMessage(
+          "鱼腥味的游戏优化工具箱",
+          "部分配置更新应用失败! 请查看日志并反馈!",
+          QSystemTrayIcon::Warning,
+          5000);
+    }
+  }
+
+  if (m_onConfigReloadedCallback)
+  {
+    m_onConfigReloadedCallback();
+  }
+}
+
+void Application::syncGameProcessStatus()
+{
+  const auto config = m_configManager->getSnapshot();
+  // key: 游戏名称 value: 注册表中的实际状态
+  std::map<std::string, bool> changes;
+  for (const auto &processInfo : config->processConfig.gameProcessList)
+  {
+    if (processInfo.processList.empty())
+    {
+      continue;
+    }
+    const bool isOptimized = m_optimizer->checkGameProcessRegistry(processInfo.processList);
+    if (isOptimized != processInfo.status)
+    {
+      LOG_INFO(std::string(isOptimized ? "游戏优化状态与注册表不一致，按注册表更新为已优化: " : "游戏优化状态与注册表不一致，按注册表更新为未优化: ") + processInfo.name);
+      changes[processInfo.name] = isOptimized;
+    }
+  }
+  if (changes.empty())
+  {
+    return;
+  }
+
+  m_configManager->updateConfig(
+      [&changes](AppConfig &appConfig)
+      {
+        for (auto &processInfo : appConfig.processConfig.gameProcessList)
+        {
+          auto it = changes.find(processInfo.name);
+          if (it != changes.end())
+          {
+            processInfo.status = it->second;
+          }
+        }
+      });
+  if (m_onConfigReloadedCallback)
+  {
+    m_onConfigReloadedCallback();
+  }
+}
+
+bool Application::applyGameProcessListChange(const std::vector<ProcessInfo> &oldList, std::vector<ProcessInfo> &newList)
+{
+  bool result = true;
+
+  // 按游戏名称匹配新旧条目
+  auto findByName = [](const std::vector<ProcessInfo> &list, const std::string &name) -> const ProcessInfo *
+  {
+    for (const auto &processInfo : list)
+    {
+      if (processInfo.name == name)
+      {
+        return &processInfo;
+      }
+    }
+    return nullptr;
+  };
+
+  // 被删除或进程列表改变的已优化游戏 先取消旧的优化
+  for (const auto &oldInfo : oldList)
+  {
+    const ProcessInfo *newInfo = findByName(newList, oldInfo.name);
+    if (oldInfo.status && (!newInfo || !newInfo->status || newInfo->processList != oldInfo.processList))
+    {
+      if (m_optimizer->setGameProcessRegistry(oldInfo.processList, false))
+      {
+        LOG_INFO("取消游戏优化成功: " + oldInfo.name);
+      }
+      else
+      {
+        LOG_ERROR("取消游戏优化失败: " + oldInfo.name);
+        result = false;
+      }
+    }
+  }
+
+  // 新增、重新开启或进程列表改变的游戏 按新配置设置优化
+  for (auto &newInfo : newList)
+  {
+    const ProcessInfo *oldInfo = findByName(oldList, newInfo.name);
+    if (newInfo.status && (!oldInfo || !oldInfo->status || oldInfo->processList != newInfo.processList))
+    {
+      if (m_optimizer->setGameProcessRegistry(newInfo.processList, true))
+      {
+        LOG_INFO("设置游戏优化成功: " + newInfo.name);
+      }
+      else
+      {
+        LOG_ERROR("设置游戏优化失败: " + newInfo.name);
+        newInfo.status = false;
+        result = false;
+      }
+    }
+  }
+  return result;
+}
+
+void Application::applyLogConfig(const LogConfig &logConfig)
+{
+  Logging::Options options;
+  options.async = logConfig.asyncLogging;
+  options.flushPolicy = Logging::flushPolicyFromString(logConfig.flushPolicy);
+  options.flushIntervalMs = logConfig.flushIntervalMs;
+  options.format = Logging::outputFormatFromString(logConfig.format);
+  options.maxFileBytes = static_cast<uint64_t>(logConfig.maxFileSizeMB) * 1024 * 1024;
+  options.rotateIntervalHours = logConfig.rotateIntervalHours;
+  options.maxArchives = logConfig.maxArchiveFiles;
+  options.compressArchives = logConfig.compressArchives;
+  options.rateLimitBurst = logConfig.rateLimitBurst;
+  options.rateLimitWindowSeconds = logConfig.rateLimitWindowSeconds;
+  options.flightRecorder = logConfig.flightRecorder;
+
+  const LogLevels &levels = logConfig.levels;
+  auto moduleLevel = [&options, &levels](Logging::Module module, const std::string &level)
+  {
+    options.moduleLevels[static_cast<size_t>(module)] = Logging::levelFromString(level.empty() ? levels.defaultLevel : level);
+  };
+  moduleLevel(Logging::Module::General, levels.defaultLevel);
+  moduleLevel(Logging::Module::Process, levels.process);
+  moduleLevel(Logging::Module::Registry, levels.registry);
+  moduleLevel(Logging::Module::Power, levels.power);
+  moduleLevel(Logging::Module::Service, levels.service);
+  moduleLevel(Logging::Module::Config, levels.config);
+  moduleLevel(Logging::Module::Ui, levels.ui);
+  Logging::configure(options);
+  LOG_INFO_FMT("日志写入方式: {} 刷盘策略: {} 输出格式: {}",
+               logConfig.asyncLogging ? "异步" : "同步", logConfig.flushPolicy, logConfig.format);
+  LOG_INFO_FMT("日志轮换: 大小上限 {} MB 间隔 {} 小时 保留 {} 个分段 压缩: {}",
+               logConfig.maxFileSizeMB, logConfig.rotateIntervalHours, logConfig.maxArchiveFiles, logConfig.compressArchives);
+  LOG_INFO_FMT("日志限流: 每 {} 秒 {} 条 飞行记录器: {}",
+               logConfig.rateLimitWindowSeconds, logConfig.rateLimitBurst, logConfig.flightRecorder);
+  LOG_INFO_FMT("日志级别: {}", levels.toString());
+}
+
+void Application::applyMetricsConfig(const MetricsConfig &metricsConfig)
+{
+  m_optimizer->setSessionTracing(metricsConfig.traceGameSession);
+  if (!metricsConfig.enabled)
+  {
+    m_metricsExporter->stop();
+    LOG_INFO("指标导出已关闭");
+    return;
+  }
+  m_metricsExporter->start(MultiByteToWide(metricsConfig.filePath), metricsConfig.exportIntervalSeconds);
+}
@@ -0,0 +1,270 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 11:03:12
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 11:03:12
+ * @FilePath: \GameOptimizerPro\src\core\background_manager.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#define LOG_MODULE Logging::Module::Process
+
+#include "core/background_manager.h"
+
+BackgroundManager::BackgroundManager()
+{
+}
+
+BackgroundManager::~BackgroundManager()
+{
+  revertEfficiencyMode();
+}
+
+bool BackgroundManager::applyEfficiencyMode(const std::vector<std::string> &processNames,
+                                            const std::vector<DWORD> &gameProcessIds,
+                                            bool throttleAll,
+                                            const std::map<std::string, IoPriority> &ioPriorityRules)
+{
+  if (!throttleAll && processNames.empty())
+  {
+    LOG_ERROR("后台进程列表为空，无需启用能效模式");
+    return false;
+  }
+
+  std::vector<std::wstring> processNamesWs;
+  for (const auto &processName : processNames)
+  {
+    processNamesWs.push_back(MultiByteToWide(processName));
+  }
+
+  std::vector<std::pair<std::wstring, IoPriority>> ioPriorityRulesWs;
+  for (const auto &rule : ioPriorityRules)
+  {
+    ioPriorityRulesWs.emplace_back(MultiByteToWide(rule.first), rule.second);
+  }
+
+  const auto snapshot = getProcessSnapshot();
+  const auto gameProcessTree = collectProcessTree(snapshot, gameProcessIds);
+  const DWORD currentProcessId = GetCurrentProcessId();
+  DWORD currentSessionId = 0;
+  ProcessIdToSessionId(currentProcessId, &currentSessionId);
+
+  int throttledCount = 0;
+  for (const auto &processEntry : snapshot)
+  {
+    // 跳过自身、游戏进程树和系统关键进程
+    if (processEntry.processId == currentProcessId ||
+        gameProcessTree.count(processEntry.processId) ||
+        isCriticalSystemProcess(processEntry.exeName))
+    {
+      continue;
+    }
+
+    // 只限制当前用户会话中的进程 会话0为系统服务 命名列表中的服务进程也不限制
+    DWORD sessionId = 0;
+    if (!ProcessIdToSessionId(processEntry.processId, &sessionId) ||
+        sessionId == 0 || sessionId != currentSessionId)
+    {
+      continue;
+    }
+
+    if (!throttleAll)
+    {
+      bool matched = false;
+      for (const auto &processName : processNamesWs)
+      {
+        if (_wcsicmp(processEntry.exeName.c_str(), processName.c_str()) == 0)
+        {
+          matched = true;
+          break;
+        }
+      }
+      if (!matched)
+      {
+        continue;
+      }
+    }
+
+    IoPriority ioPriority = IoPriority::UNCHANGED;
+    for (const auto &rule : ioPriorityRulesWs)
+    {
+      if (_wcsicmp(processEntry.exeName.c_str(), rule.first.c_str()) == 0)
+      {
+        ioPriority = rule.second;
+        break;
+      }
+    }
+
+    if (throttleProcess(processEntry, ioPriority))
+    {
+      ++throttledCount;
+    }
+  }
+
+  LOG_INFO("后台能效模式已启用，限制进程数: " + std::to_string(throttledCount));
+  return throttledCount > 0;
+}
+
+bool BackgroundManager::revertEfficiencyMode()
+{
+  std::vector<ThrottledProcess> throttledProcesses;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    throttledProcesses.swap(m_throttledProcesses);
+  }
+
+  if (throttledProcesses.empty())
+  {
+    return true;
+  }
+
+  bool success = true;
+  for (const auto &throttledProcess : throttledProcesses)
+  {
+    if (!restoreProcess(throttledProcess))
+    {
+      success = false;
+    }
+  }
+
+  LOG_INFO("后台能效模式已还原，还原进程数: " + std::to_string(throttledProcesses.size()));
+  return success;
+}
+
+bool BackgroundManager::isEfficiencyModeApplied() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return !m_throttledProcesses.empty();
+}
+
+bool BackgroundManager::throttleProcess(const ProcessEntry &processEntry, IoPriority ioPriority)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &throttledProcess : m_throttledProcesses)
+    {
+      if (throttledProcess.processId == processEntry.processId)
+      {
+        return false;
+      }
+    }
+  }
+
+  HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processEntry.processId);
+  if (hProcess == NULL)
+  {
+    // 权限不足或进程已退出 忽略
+    return false;
+  }
+
+  ThrottledProcess throttledProcess;
+  throttledProcess.processId = processEntry.processId;
+  throttledProcess.exeName = processEntry.exeName;
+
+  FILETIME exitTime, kernelTime, userTime;
+  if (!GetProcessTimes(hProcess, &throttledProcess.creationTime, &exitTime, &kernelTime, &userTime))
+  {
+    CloseHandle(hProcess);
+    return false;
+  }
+
+  throttledProcess.originalState.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+  throttledProcess.hasOriginalState = GetProcessInformation(hProcess, ProcessPowerThrottling,
+                                                            &throttledProcess.originalState,
+                                                            sizeof(throttledProcess.originalState)) != FALSE;
+
+  // 进程已自行启用能效模式时 无需处理也无需还原
+  bool alreadyThrottled = throttledProcess.hasOriginalState &&
+                          (throttledProcess.originalState.ControlMask & PROCESS_POWER_THROTTLING_EXECUTION_SPEED) &&
+                          (throttledProcess.originalState.StateMask & PROCESS_POWER_THROTTLING_EXECUTION_SPEED);
+  if (!alreadyThrottled)
+  {
+    PROCESS_POWER_THROTTLING_STATE throttlingState{};
+    throttlingState.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+    throttlingState.ControlMask = PROCESS_POWER_THROTTLING_EXECUTION_SPEED;
+    throttlingState.StateMask = PROCESS_POWER_THROTTLING_EXECUTION_SPEED;
+
+    if (SetProcessInformation(hProcess, ProcessPowerThrottling, &throttlingState, sizeof(throttlingState)))
+    {
+      throttledProcess.throttled = true;
+    }
+    else
+    {
+      LOG_HRESULT(L"启用能效模式失败: " + processEntry.exeName, HRESULT_FROM_WIN32(GetLastError()));
+    }
+  }
+
+  // 设置 I/O 优先级 记录原始值用于还原
+  if (ioPriority != IoPriority::UNCHANGED &&
+      getProcessIoPriority(hProcess, throttledProcess.originalIoPriority) &&
+      throttledProcess.originalIoPriority != static_cast<ULONG>(ioPriority))
+  {
+    if (setProcessIoPriority(hProcess, static_cast<ULONG>(ioPriority)))
+    {
+      throttledProcess.ioPriorityChanged = true;
+    }
+    else
+    {
+      LOG_ERROR(L"设置 I/O 优先级失败: " + processEntry.exeName);
+    }
+  }
+  CloseHandle(hProcess);
+
+  if (!throttledProcess.throttled && !throttledProcess.ioPriorityChanged)
+  {
+    return false;
+  }
+
+  LOG_DEBUG_FMT("已限制后台进程: {} PID: {} 能效模式: {} I/O 优先级: {}", processEntry.exeName, processEntry.processId,
+                throttledProcess.throttled, throttledProcess.ioPriorityChanged ? static_cast<int>(ioPriority) : -1);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_throttledProcesses.push_back(std::move(throttledProcess));
+  return true;
+}
+
+bool BackgroundManager::restoreProcess(const ThrottledProcess &throttledProcess)
+{
+  HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, throttledProcess.processId);
+  if (hProcess == NULL)
+  {
+    // 进程已退出
+    return true;
+  }
+
+  // 校验创建时间 防止 PID 被新进程复用
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (!GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime) ||
+      CompareFileTime(&creationTime, &throttledProcess.creationTime) != 0)
+  {
+    CloseHandle(hProcess);
+    return true;
+  }
+
+  bool success = true;
+  if (throttledProcess.throttled)
+  {
+    PROCESS_POWER_THROTTLING_STATE throttlingState{};
+    if (throttledProcess.hasOriginalState)
+    {
+      throttlingState = throttledProcess.originalState;
+    }
+    // 没有原始状态时 ControlMask 为 0 表示交由系统自行管理
+    throttlingState.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+
+    if (!SetProcessInformation(hProcess, ProcessPowerThrottling, &throttlingState, sizeof(throttlingState)))
+    {
+      LOG_HRESULT(L"还原能效模式失败: " + throttledProcess.exeName, HRESULT_FROM_WIN32(GetLastError()));
+      success = false;
+    }
+  }
+
+  if (throttledProcess.ioPriorityChanged && !setProcessIoPriority(hProcess, throttledProcess.originalIoPriority))
+  {
+    LOG_ERROR(L"还原 I/O 优先级失败: " + throttledProcess.exeName);
+    success = false;
+  }
+
+  CloseHandle(hProcess);
+  return success;
+}
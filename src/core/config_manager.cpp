@@ -7,8 +7,15 @@
  * @Description:
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
+#define LOG_MODULE Logging::Module::Config
+
 #include "core/config_manager.h"
 
+#include <algorithm>
+
+#include "metrics/metrics.h"
+#include "metrics/tracing.h"
+
 // 构造函数：初始化路径等
 ConfigManager::ConfigManager(const std::wstring &configPath)
 {
@@ -16,11 +23,27 @@ ConfigManager::ConfigManager(const std::wstring &configPath)
   m_configPath = configPath.empty() ? getConfigPath() : configPath;
   LOG_INFO(L"配置管理器初始化，配置文件路径: " + m_configPath);
   loadConfig(m_configPath);
+  m_persistThread = std::thread(&ConfigManager::runPersistLoop, this);
 }
 
 ConfigManager::~ConfigManager()
 {
-  saveConfig(m_configPath);
+  setConfigMonitor(false);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopPersist = true;
+  }
+  m_persistCv.notify_one();
+  if (m_persistThread.joinable())
+  {
+    m_persistThread.join();
+  }
+  saveConfig();
+  if (m_monitorStopEvent)
+  {
+    CloseHandle(m_monitorStopEvent);
+    m_monitorStopEvent = nullptr;
+  }
 }
 
 // 从环境变量或命令行参数读取配置路径
@@ -85,378 +108,552 @@ bool ConfigManager::validateConfig(const AppConfig &config) const
     }
   }
 
+  for (const auto &process : config.processConfig.backgroundProcessList)
+  {
+    for (const auto &processName : process.processList)
+    {
+      if (!isValidProcessName(processName))
+      {
+        LOG_ERROR(L"无效的进程名: " + MultiByteToWide(processName, CP_ACP));
+        return false;
+      }
+    }
+  }
+
   return true;
 }
 
-bool ConfigManager::loadConfig(const std::wstring &configPath)
+bool ConfigManager::parseConfigFile(const std::wstring &configPath, AppConfig &config) const
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-  // 如果传入了配置路径，则使用传入的路径
-  std::wstring pathToLoad = configPath.empty() ? m_configPath : configPath;
-
   try
   {
     // 以二进制模式打开文件
-    std::ifstream configFile(pathToLoad, std::ios::binary);
+    std::ifstream configFile(configPath, std::ios::binary);
     if (!configFile.is_open())
     {
-      LOG_ERROR(L"无法打开配置文件: " + pathToLoad);
-      // 加载默认配置
-      m_appConfig = DefaultConfig::Get();
-      LOG_INFO(L"加载默认配置");
+      LOG_ERROR(L"无法打开配置文件: " + configPath);
       return false;
     }
 
-    // 直接从二进制文件流解析 JSON
+    // 单次遍历解析 未出现的字段保留默认值
+    AppConfig tempConfig = DefaultConfig::Get();
+    std::string error;
+    if (!ConfigSerializer::read(configFile, tempConfig, error))
+    {
+      LOG_ERROR_FMT("配置文件解析错误: {}", error);
+      return false;
+    }
+    configFile.close();
 
-    nlohmann::json configJson;
-    try
+    // 验证新配置
+    if (validateConfig(tempConfig))
     {
-      configJson = nlohmann::json::parse(configFile);
+      config = std::move(tempConfig);
+      return true;
     }
-    catch (const nlohmann::json::parse_error &e)
+    else
     {
-      LOG_ERROR(L"配置文件解析错误: " + MultiByteToWide(e.what(), CP_ACP) +
-                L" at byte " + std::to_wstring(e.byte));
-      m_appConfig = DefaultConfig::Get();
+      LOG_ERROR(L"配置文件验证失败");
       return false;
     }
-    configFile.close();
+  }
+  catch (const std::exception &e)
+  {
+    LOG_ERROR(L"配置文件加载异常: " + MultiByteToWide(e.what(), CP_ACP));
+    return false;
+  }
+}
 
-    // 检查appConfig是否存在
-    if (!configJson.contains("appConfig"))
+bool ConfigManager::loadConfig(const std::wstring &configPath)
+{
+  static MetricOperation metric("gop_config_operations", "配置文件操作", "load");
+  MetricOperationScope scope(metric);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // 如果传入了配置路径，则使用传入的路径
+  std::wstring pathToLoad = configPath.empty() ? m_configPath : configPath;
+
+  AppConfig tempConfig;
+  if (parseConfigFile(pathToLoad, tempConfig))
+  {
+    publishConfig(std::make_shared<const AppConfig>(std::move(tempConfig)));
+    m_persistedGeneration = m_generation.load();
+    if (!configPath.empty())
     {
-      LOG_ERROR(L"appConfig not found in config");
-      m_appConfig = DefaultConfig::Get();
-      return false;
+      m_configPath = configPath;
+    }
+    // 记录与文件一致的内容哈希 未修改时退出不再重写
+    try
+    {
+      m_persistedHash = std::hash<std::string>{}(serializeConfig(*m_snapshot));
     }
+    catch (const std::exception &)
+    {
+      m_persistedHash = 0;
+    }
+    LOG_INFO(L"配置文件加载成功: " + pathToLoad);
+    return scope.finish(true);
+  }
 
-    auto appConfigJson = configJson["appConfig"];
-    AppConfig tempConfig = DefaultConfig::Get();
+  // 加载默认配置
+  // 内容哈希为空 退出时会写入默认配置
+  publishConfig(std::make_shared<const AppConfig>(DefaultConfig::Get()));
+  m_persistedGeneration = m_generation.load();
+  LOG_INFO(L"加载默认配置");
+  return false;
+}
+
+std::string ConfigManager::serializeConfig(const AppConfig &config) const
+{
+  return ConfigSerializer::write(config);
+}
+
+bool ConfigManager::saveConfig(const std::wstring &configPath)
+{
+  static MetricOperation metric("gop_config_operations", "配置文件操作", "save");
+  MetricOperationScope scope(metric);
+  std::lock_guard<std::mutex> saveLock(m_saveMutex);
+
+  // 取配置快照后在锁外序列化和写文件 不阻塞界面线程的修改
+  std::shared_ptr<const AppConfig> snapshot;
+  std::wstring pathToSave;
+  size_t persistedHash = 0;
+  uint64_t generation = 0;
+  bool isMainConfig = true;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snapshot = m_snapshot;
+    // 快照和代数一起读取 写入成功后该代数之前的修改都已保存
+    generation = m_generation.load();
+    pathToSave = configPath.empty() ? m_configPath : configPath;
+    // 导出到其他路径时不影响主配置文件的保存状态
+    isMainConfig = pathToSave == m_configPath;
+    persistedHash = m_persistedHash;
+  }
 
-    // 加载版本信息
-    if (appConfigJson.contains("version"))
+  try
+  {
+    const std::string content = serializeConfig(*snapshot);
+    const size_t contentHash = std::hash<std::string>{}(content);
+    if (contentHash == persistedHash && isMainConfig)
     {
-      tempConfig.version = appConfigJson["version"].get<std::string>();
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_persistedGeneration = (std::max)(m_persistedGeneration, generation);
+      LOG_DEBUG(L"Configuration file unchanged, skip saving: " + pathToSave);
+      return scope.finish(true);
     }
 
-    // 加载系统信息
-    if (appConfigJson.contains("systemInfo"))
+    // 创建目录（如果不存在） / create directories if not exist
+    auto dirPath = std::filesystem::path(pathToSave).parent_path();
+    if (!dirPath.empty() && !std::filesystem::exists(dirPath))
     {
-      auto &systemInfoJson = appConfigJson["systemInfo"];
-      if (systemInfoJson.contains("os"))
-      {
-        tempConfig.systemInfo.os = systemInfoJson["os"].get<std::string>();
-      }
-      if (systemInfoJson.contains("arch"))
-      {
-        tempConfig.systemInfo.arch = systemInfoJson["arch"].get<std::string>();
-      }
-      if (systemInfoJson.contains("cpu"))
+      std::filesystem::create_directories(dirPath);
+    }
+
+    // 内容确实变化时才轮换备份 / rotate backups only on real content changes
+    // 同一内容写入失败后重试时不再轮换 否则每次重试都会用当前文件覆盖一份更早的备份
+    if (std::filesystem::exists(pathToSave) && (!isMainConfig || contentHash != m_rotatedHash))
+    {
+      rotateBackups(pathToSave);
+      if (isMainConfig)
       {
-        tempConfig.systemInfo.cpu = systemInfoJson["cpu"].get<std::string>();
+        m_rotatedHash = contentHash;
       }
     }
 
-    // 加载优化配置
-    if (appConfigJson.contains("optimismConfig"))
+    if (!writeConfigFile(pathToSave, content))
     {
-      auto &optimismConfigJson = appConfigJson["optimismConfig"];
+      return false;
+    }
 
-      // 使用模板函数安全获取值
-      auto safeGetBool = [](const nlohmann::json &j, const std::string &key, bool defaultValue)
-      {
-        return j.contains(key) ? j[key].get<bool>() : defaultValue;
-      };
+    if (isMainConfig)
+    {
+      // 写入成功后才标记为已保存 失败时由保存线程重试
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_persistedHash = contentHash;
+      m_persistedGeneration = (std::max)(m_persistedGeneration, generation);
+    }
 
-      tempConfig.optimismConfig.autoStartUp = safeGetBool(optimismConfigJson, "autoStartUp", false);
-      tempConfig.optimismConfig.autoLimitAntiCheat = safeGetBool(optimismConfigJson, "autoLimitAntiCheat", false);
+    LOG_INFO(L"Configuration file saving successfully: " + pathToSave);
+    return scope.finish(true);
+  }
+  catch (const std::exception &e)
+  {
+    LOG_ERROR(L"Configuration file saving failed: " + MultiByteToWide(e.what(), CP_ACP));
+    return false;
+  }
+}
 
-      // 电源计划配置
-      if (optimismConfigJson.contains("powerPlan"))
-      {
-        auto &powerPlanJson = optimismConfigJson["powerPlan"];
-        tempConfig.optimismConfig.powerPlan.optimizePowerPlan = safeGetBool(powerPlanJson, "optimizePowerPlan", false);
-        tempConfig.optimismConfig.powerPlan.lockPowerPlan = safeGetBool(powerPlanJson, "lockPowerPlan", false);
+bool ConfigManager::writeConfigFile(const std::wstring &configPath, const std::string &content) const
+{
+  // 写临时文件并刷盘后替换 保证任何时刻配置文件都是完整的
+  if (!writeFileAtomically(configPath, content))
+  {
+    LOG_ERROR(L"写入配置文件失败: " + configPath);
+    return false;
+  }
+  return true;
+}
 
-        if (powerPlanJson.contains("powerPlanGuid"))
-        {
-          auto guid = powerPlanJson["powerPlanGuid"].get<std::string>();
-          // 简单验证GUID格式
-          if (!guid.empty() && guid.front() == '{' && guid.back() == '}')
-          {
-            tempConfig.optimismConfig.powerPlan.powerPlanGuid = guid;
-          }
-        }
+void ConfigManager::rotateBackups(const std::wstring &configPath) const
+{
+  // 保留的备份数量
+  constexpr int kBackupCount = 3;
+
+  auto backupPath = [&configPath](int index)
+  {
+    return index == 0 ? configPath + L".bak" : configPath + L".bak." + std::to_wstring(index);
+  };
+
+  std::error_code ec;
+  for (int index = kBackupCount - 1; index > 0; --index)
+  {
+    if (std::filesystem::exists(backupPath(index - 1), ec))
+    {
+      std::filesystem::rename(backupPath(index - 1), backupPath(index), ec);
+      if (ec)
+      {
+        LOG_WARN(L"Configuration backup rotation failed: " + backupPath(index) + L". ErrorMessage: " +
+                 MultiByteToWide(ec.message(), CP_ACP));
       }
+    }
+  }
 
-      tempConfig.optimismConfig.limitBackgroundActivity = safeGetBool(optimismConfigJson, "limitBackgroundActivity", false);
-      tempConfig.optimismConfig.optimizeNetworkDelay = safeGetBool(optimismConfigJson, "optimizeNetworkDelay", false);
-      tempConfig.optimismConfig.optimizeSystemScheduling = safeGetBool(optimismConfigJson, "optimizeSystemScheduling", false);
-      tempConfig.optimismConfig.optimizeSystemService = safeGetBool(optimismConfigJson, "optimizeSystemService", false);
+  std::filesystem::copy_file(configPath, backupPath(0), std::filesystem::copy_options::overwrite_existing, ec);
+  if (ec)
+  {
+    LOG_WARN(L"Configuration file backup failed: " + backupPath(0) + L". ErrorMessage: " +
+             MultiByteToWide(ec.message(), CP_ACP));
+  }
+  else
+  {
+    LOG_INFO(L"Backup configuration file successfully: " + backupPath(0));
+  }
+}
+
+void ConfigManager::runPersistLoop()
+{
+  // 最后一次修改后等待的安静期 连续切换开关只写入一次
+  constexpr auto kPersistDelay = std::chrono::milliseconds(1000);
+  // 写入失败后重试的间隔
+  constexpr auto kPersistRetryDelay = std::chrono::seconds(5);
+  Tracing::setThreadName("config_persist");
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_persistCv.wait(lock, [this]()
+                     { return m_stopPersist || m_generation.load() != m_persistedGeneration; });
+    if (m_stopPersist)
+    {
+      // 退出时由析构函数写入
+      break;
+    }
+
+    // 安静期内的新修改会重新计时
+    while (!m_stopPersist && std::chrono::steady_clock::now() < m_lastChangeTime + kPersistDelay)
+    {
+      m_persistCv.wait_until(lock, m_lastChangeTime + kPersistDelay);
+    }
+    if (m_stopPersist)
+    {
+      break;
     }
 
-    // 加载进程配置
-    if (appConfigJson.contains("processConfig"))
+    lock.unlock();
+    const bool saved = saveConfig();
+    lock.lock();
+    if (!saved)
     {
-      auto &processConfigJson = appConfigJson["processConfig"];
+      // 写入失败时修改仍未保存 等待一段时间后重试 避免反复写入失败的文件
+      m_persistCv.wait_for(lock, kPersistRetryDelay, [this]()
+                           { return m_stopPersist; });
+    }
+  }
+}
 
-      // 加载游戏进程
-      if (processConfigJson.contains("gameProcessList"))
-      {
-        tempConfig.processConfig.gameProcessList.clear();
-        for (const auto &processInfoJson : processConfigJson["gameProcessList"])
-        {
-          ProcessInfo processInfo;
-          if (processInfoJson.contains("name"))
-          {
-            processInfo.name = processInfoJson["name"].get<std::string>();
-          }
-          processInfo.status = processInfoJson.value("status", false);
-
-          if (processInfoJson.contains("processList"))
-          {
-            for (const auto &process : processInfoJson["processList"])
-            {
-              if (isValidProcessName(process.get<std::string>()))
-              {
-                processInfo.processList.push_back(process.get<std::string>());
-              }
-            }
-          }
-
-          if (!processInfo.name.empty() && !processInfo.processList.empty())
-          {
-            tempConfig.processConfig.gameProcessList.push_back(processInfo);
-          }
-        }
-      }
+// 重新加载配置文件
+void ConfigManager::reloadConfig()
+{
+  static MetricOperation metric("gop_config_operations", "配置文件操作", "reload");
+  MetricOperationScope scope(metric);
+  try
+  {
+    // 文件可能正在被编辑器写入 解析失败时保留当前配置 等待下一次变化
+    AppConfig newConfig;
+    if (!parseConfigFile(m_configPath, newConfig))
+    {
+      LOG_WARN(L"配置文件重新加载失败，保留当前配置: " + m_configPath);
+      return;
+    }
+    scope.finish(true);
 
-      // 加载反作弊进程
-      if (processConfigJson.contains("antiCheatProcessList"))
+    const size_t newHash = std::hash<std::string>{}(serializeConfig(newConfig));
+    auto newSnapshot = std::make_shared<const AppConfig>(std::move(newConfig));
+    std::shared_ptr<const AppConfig> oldSnapshot;
+    ConfigDiff diff;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      // 程序自身保存配置也会触发文件变化 此时内容与上次写入的一致
+      // 写入后界面可能又有新的修改尚未保存 不能用旧文件覆盖
+      if (newHash == m_persistedHash || *newSnapshot == *m_snapshot)
       {
-        tempConfig.processConfig.antiCheatProcessList.clear();
-        for (const auto &processInfoJson : processConfigJson["antiCheatProcessList"])
-        {
-          ProcessInfo processInfo;
-          if (processInfoJson.contains("name"))
-          {
-            processInfo.name = processInfoJson["name"].get<std::string>();
-          }
-          processInfo.status = processInfoJson.value("status", false);
-
-          if (processInfoJson.contains("processList"))
-          {
-            for (const auto &process : processInfoJson["processList"])
-            {
-              if (isValidProcessName(process.get<std::string>()))
-              {
-                processInfo.processList.push_back(process.get<std::string>());
-              }
-            }
-          }
-
-          if (!processInfo.name.empty() && !processInfo.processList.empty())
-          {
-            tempConfig.processConfig.antiCheatProcessList.push_back(processInfo);
-          }
-        }
+        return;
       }
+      oldSnapshot = m_snapshot;
+      diff = ConfigDiff::compute(*oldSnapshot, *newSnapshot);
+      publishConfig(newSnapshot);
+      // 文件已经是最新内容 无需再写入
+      m_persistedHash = newHash;
+      m_persistedGeneration = m_generation.load();
     }
 
-    // 验证并应用新配置
-    if (validateConfig(tempConfig))
+    if (diff.empty())
     {
-      m_appConfig = std::move(tempConfig);
-      if (!configPath.empty())
-      {
-        m_configPath = configPath;
-      }
-      LOG_INFO(L"配置文件加载成功: " + pathToLoad);
-      return true;
+      LOG_INFO(L"配置文件已重新加载，没有需要应用的设置变化");
+      return;
     }
-    else
+
+    LOG_INFO("配置文件已重新加载，发生变化的设置: " + diff.toString());
+    if (m_onConfigChangedCallback)
     {
-      LOG_ERROR(L"配置文件验证失败");
-      m_appConfig = DefaultConfig::Get();
-      return false;
+      m_onConfigChangedCallback(diff, oldSnapshot, newSnapshot);
     }
   }
   catch (const std::exception &e)
   {
-    LOG_ERROR(L"配置文件加载异常: " + MultiByteToWide(e.what(), CP_ACP));
-    m_appConfig = DefaultConfig::Get();
-    return false;
+    LOG_ERROR(L"配置文件重新加载异常: " + MultiByteToWide(e.what(), CP_ACP));
   }
 }
 
-bool ConfigManager::saveConfig(const std::wstring &configPath)
+bool ConfigManager::setConfigMonitor(bool enable)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-  std::wstring pathToSave = configPath.empty() ? m_configPath : configPath;
-
-  try
+  if (enable)
   {
-    // 创建目录（如果不存在） / create directories if not exist
-    auto dirPath = std::filesystem::path(pathToSave).parent_path();
-    if (!dirPath.empty() && !std::filesystem::exists(dirPath))
+    if (m_isMonitoring.load())
     {
-      std::filesystem::create_directories(dirPath);
+      return true;
     }
 
-    // 备份旧文件（如果存在） / backup old file if exists
-    if (std::filesystem::exists(pathToSave))
+    if (!m_monitorStopEvent)
     {
-      std::wstring backupPath = pathToSave + L".bak";
-      try
+      m_monitorStopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+      if (!m_monitorStopEvent)
       {
-        std::filesystem::copy_file(pathToSave, backupPath,
-                                   std::filesystem::copy_options::overwrite_existing);
-        LOG_INFO(L"Backup configuration file successfully: " + backupPath);
-      }
-      catch (const std::exception &e)
-      {
-        LOG_WARN(L"Configuration file backup failed: " + backupPath + L". ErrorMessage: " +
-                 MultiByteToWide(e.what(), CP_ACP));
+        LOG_ERROR("创建配置文件监控停止事件失败: " + std::to_string(GetLastError()));
+        return false;
       }
     }
 
-    // 使用 ordered_json 保存配置
-    nlohmann::ordered_json appConfigJson;
-    nlohmann::ordered_json tmpConfigJson;
-
-    // 保存 version
-    tmpConfigJson["version"] = m_appConfig.version;
-
-    // 保存系统信息
-    nlohmann::json systemInfoJson;
-    systemInfoJson["os"] = m_appConfig.systemInfo.os;
-    systemInfoJson["arch"] = m_appConfig.systemInfo.arch;
-    systemInfoJson["cpu"] = m_appConfig.systemInfo.cpu;
-    tmpConfigJson["systemInfo"] = systemInfoJson;
-
-    // 保存优化配置
-    nlohmann::json optimismConfigJson;
-    optimismConfigJson["autoStartUp"] = m_appConfig.optimismConfig.autoStartUp;
-    optimismConfigJson["autoLimitAntiCheat"] = m_appConfig.optimismConfig.autoLimitAntiCheat;
-    // 保存电源计划
-    nlohmann::json powerPlanJson;
-    powerPlanJson["optimizePowerPlan"] = m_appConfig.optimismConfig.powerPlan.optimizePowerPlan;
-    powerPlanJson["lockPowerPlan"] = m_appConfig.optimismConfig.powerPlan.lockPowerPlan;
-    powerPlanJson["powerPlanGuid"] = m_appConfig.optimismConfig.powerPlan.powerPlanGuid;
-    optimismConfigJson["powerPlan"] = powerPlanJson;
-
-    optimismConfigJson["limitBackgroundActivity"] = m_appConfig.optimismConfig.limitBackgroundActivity;
-    optimismConfigJson["optimizeNetworkDelay"] = m_appConfig.optimismConfig.optimizeNetworkDelay;
-    optimismConfigJson["optimizeSystemScheduling"] = m_appConfig.optimismConfig.optimizeSystemScheduling;
-    optimismConfigJson["optimizeSystemService"] = m_appConfig.optimismConfig.optimizeSystemService;
-    tmpConfigJson["optimismConfig"] = optimismConfigJson;
-
-    // 保存进程配置
-    nlohmann::ordered_json processConfigJson;
-
-    // 保存游戏进程
-    nlohmann::ordered_json gameProcessListJson = nlohmann::ordered_json::array();
-    for (const auto &processInfo : m_appConfig.processConfig.gameProcessList)
-    {
-      nlohmann::json processInfoJson;
-      processInfoJson["name"] = processInfo.name;
-      processInfoJson["status"] = processInfo.status;
-      nlohmann::json processListJson = nlohmann::json::array();
-      for (const auto &process : processInfo.processList)
-      {
-        processListJson.push_back(process);
-      }
-      processInfoJson["processList"] = processListJson;
-      gameProcessListJson.push_back(processInfoJson);
+    // 上一次监控线程可能因为错误已经退出
+    if (m_monitorThread.joinable())
+    {
+      m_monitorThread.join();
     }
-    processConfigJson["gameProcessList"] = gameProcessListJson;
 
-    // 保存反作弊进程
-    nlohmann::ordered_json antiCheatProcessListJson = nlohmann::ordered_json::array();
-    for (const auto &processInfo : m_appConfig.processConfig.antiCheatProcessList)
+    ResetEvent(m_monitorStopEvent);
+    m_isMonitoring = true;
+    m_monitorThread = std::thread(&ConfigManager::runMonitorLoop, this);
+    LOG_INFO(L"开始监控配置文件: " + m_configPath);
+    return true;
+  }
+  else
+  {
+    if (!m_monitorThread.joinable())
     {
-      nlohmann::json processInfoJson;
-      processInfoJson["name"] = processInfo.name;
-      processInfoJson["status"] = processInfo.status;
-      nlohmann::json processListJson = nlohmann::json::array();
-      for (const auto &process : processInfo.processList)
-      {
-        processListJson.push_back(process);
-      }
-      processInfoJson["processList"] = processListJson;
-      antiCheatProcessListJson.push_back(processInfoJson);
+      return true;
     }
-    processConfigJson["antiCheatProcessList"] = antiCheatProcessListJson;
 
-    tmpConfigJson["processConfig"] = processConfigJson;
+    SetEvent(m_monitorStopEvent);
+    m_monitorThread.join();
+    m_isMonitoring = false;
+    LOG_INFO(L"停止监控配置文件: " + m_configPath);
+    return true;
+  }
+}
 
-    // 将 appConfig 嵌套在外层 JSON 中
-    appConfigJson["appConfig"] = tmpConfigJson;
+void ConfigManager::setOnConfigChangedCallback(ConfigChangedCallback callback)
+{
+  m_onConfigChangedCallback = std::move(callback);
+}
 
-    // 保存 appConfig
+void ConfigManager::runMonitorLoop()
+{
+  // 编辑器保存时通常会连续写入多次或先写临时文件再重命名 等待文件稳定后再加载
+  constexpr ULONGLONG kDebounceMs = 500;
+  Tracing::setThreadName("config_monitor");
 
-    // 以二进制模式打开文件以进行写入
-    std::ofstream configFile(pathToSave, std::ios::binary);
-    if (!configFile.is_open())
+  std::filesystem::path configFilePath(m_configPath);
+  std::filesystem::path directoryPath = configFilePath.parent_path();
+  if (directoryPath.empty())
+  {
+    directoryPath = L".";
+  }
+  const std::wstring configFileName = configFilePath.filename().wstring();
+
+  HANDLE hDirectory = CreateFileW(directoryPath.c_str(), FILE_LIST_DIRECTORY,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+  if (hDirectory == INVALID_HANDLE_VALUE)
+  {
+    LOG_ERROR(L"打开配置文件目录失败: " + directoryPath.wstring() + L" 错误码: " + std::to_wstring(GetLastError()));
+    m_isMonitoring = false;
+    return;
+  }
+
+  HANDLE hChangeEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+  if (!hChangeEvent)
+  {
+    LOG_ERROR("创建配置文件变化事件失败: " + std::to_string(GetLastError()));
+    CloseHandle(hDirectory);
+    m_isMonitoring = false;
+    return;
+  }
+
+  OVERLAPPED overlapped = {};
+  overlapped.hEvent = hChangeEvent;
+  alignas(DWORD) BYTE buffer[16 * 1024];
+  bool readPending = false;
+  bool reloadPending = false;
+  ULONGLONG reloadDeadline = 0;
+
+  while (true)
+  {
+    if (!readPending)
     {
-      LOG_ERROR(L"无法打开配置文件以保存: " + pathToSave);
-      return false;
+      ResetEvent(hChangeEvent);
+      if (!ReadDirectoryChangesW(hDirectory, buffer, sizeof(buffer), FALSE,
+                                 FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+                                 nullptr, &overlapped, nullptr))
+      {
+        LOG_ERROR("监听配置文件目录变化失败: " + std::to_string(GetLastError()));
+        break;
+      }
+      readPending = true;
     }
 
-    // 向文件中写入 UTF-8 编码的 JSON 数据
-    configFile << appConfigJson.dump(4);
-    configFile.close();
+    DWORD timeout = INFINITE;
+    if (reloadPending)
+    {
+      ULONGLONG now = GetTickCount64();
+      timeout = now >= reloadDeadline ? 0 : static_cast<DWORD>(reloadDeadline - now);
+    }
 
-    if (!configPath.empty())
+    HANDLE waitHandles[] = {m_monitorStopEvent, hChangeEvent};
+    DWORD waitResult = WaitForMultipleObjects(2, waitHandles, FALSE, timeout);
+    if (waitResult == WAIT_OBJECT_0)
     {
-      m_configPath = configPath;
+      break;
     }
+    else if (waitResult == WAIT_OBJECT_0 + 1)
+    {
+      readPending = false;
+      DWORD bytesTransferred = 0;
+      if (!GetOverlappedResult(hDirectory, &overlapped, &bytesTransferred, FALSE))
+      {
+        LOG_ERROR("获取配置文件目录变化失败: " + std::to_string(GetLastError()));
+        break;
+      }
 
-    LOG_INFO(L"Configuration file saving successfully: " + pathToSave);
-    return true;
+      // 缓冲区溢出时无法得知具体文件 按配置文件已变化处理
+      bool configChanged = bytesTransferred == 0;
+      for (BYTE *entry = buffer; !configChanged && bytesTransferred != 0;)
+      {
+        auto *info = reinterpret_cast<FILE_NOTIFY_INFORMATION *>(entry);
+        std::wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+        if (_wcsicmp(fileName.c_str(), configFileName.c_str()) == 0 && info->Action != FILE_ACTION_REMOVED)
+        {
+          configChanged = true;
+        }
+        if (info->NextEntryOffset == 0)
+        {
+          break;
+        }
+        entry += info->NextEntryOffset;
+      }
+
+      if (configChanged)
+      {
+        // 每次变化都重新计时
+        reloadPending = true;
+        reloadDeadline = GetTickCount64() + kDebounceMs;
+      }
+    }
+    else if (waitResult == WAIT_TIMEOUT)
+    {
+      reloadPending = false;
+      reloadConfig();
+    }
+    else
+    {
+      LOG_ERROR("等待配置文件变化失败: " + std::to_string(GetLastError()));
+      break;
+    }
   }
-  catch (const std::exception &e)
+
+  if (readPending)
   {
-    LOG_ERROR(L"Configuration file saving failed: " + MultiByteToWide(e.what(), CP_ACP));
-    return false;
+    DWORD bytesTransferred = 0;
+    CancelIoEx(hDirectory, &overlapped);
+    GetOverlappedResult(hDirectory, &overlapped, &bytesTransferred, TRUE);
   }
+  CloseHandle(hChangeEvent);
+  CloseHandle(hDirectory);
+  m_isMonitoring = false;
 }
 
-// 重新加载配置文件
-void ConfigManager::reloadConfig()
+std::shared_ptr<const AppConfig> ConfigManager::getSnapshot() const
+{
+  return std::atomic_load(&m_snapshot);
+}
+
+uint64_t ConfigManager::getGeneration() const
+{
+  return m_generation.load();
+}
+
+void ConfigManager::publishConfig(std::shared_ptr<const AppConfig> config)
+{
+  std::atomic_store(&m_snapshot, std::move(config));
+  // 先替换快照再增加代数 读到新代数的线程一定能读到新快照
+  m_generation.fetch_add(1);
+  m_lastChangeTime = std::chrono::steady_clock::now();
+}
+
+bool ConfigManager::setConfig(const AppConfig &config)
 {
-  try
-  {
-    loadConfig(m_configPath);
-  }
-  catch (const std::exception &e)
   {
-    LOG_ERROR(L"配置文件重新加载异常: " + MultiByteToWide(e.what(), CP_ACP));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    publishConfig(std::make_shared<const AppConfig>(config));
   }
+  // 由保存线程在安静期后写入
+  m_persistCv.notify_one();
+  LOG_INFO(L"配置已更新");
+  return true;
 }
 
-AppConfig ConfigManager::getConfig()
+bool ConfigManager::updateConfig(const std::function<void(AppConfig &)> &modifier)
 {
-  // 加锁保护 m_appConfig，取决于并发访问模式
-  std::lock_guard<std::mutex> lock(m_mutex);
-  // 返回配置的副本
-  return m_appConfig;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 写时复制 已发布的快照保持不变
+    auto nextConfig = std::make_shared<AppConfig>(*m_snapshot);
+    modifier(*nextConfig);
+    publishConfig(std::move(nextConfig));
+  }
+  m_persistCv.notify_one();
+  LOG_INFO(L"配置已更新");
+  return true;
 }
 
-bool ConfigManager::setConfig(const AppConfig &config)
+bool ConfigManager::flushConfig()
 {
-  // 加锁保护 m_appConfig，取决于并发访问模式
-  // std::lock_guard<std::mutex> lock(m_mutex);
-  m_appConfig = config;
-  if (saveConfig(m_configPath))
+  if (saveConfig())
   {
-    LOG_INFO(L"配置已更新");
     return true;
   }
   else
   {
-    LOG_ERROR(L"配置更新失败");
+    LOG_ERROR(L"配置保存失败");
     return false;
   }
 }
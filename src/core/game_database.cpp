@@ -0,0 +1,222 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:11:03
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:11:03
+ * @FilePath: \GameOptimizerPro\src\core\game_database.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#define LOG_MODULE Logging::Module::Config
+
+#include "core/game_database.h"
+
+#include <cstring>
+
+GameDatabase::GameDatabase()
+{
+}
+
+GameDatabase::~GameDatabase()
+{
+  close();
+}
+
+bool GameDatabase::open(const std::wstring &databasePath)
+{
+  close();
+
+  m_hFile = CreateFileW(databasePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (m_hFile == INVALID_HANDLE_VALUE)
+  {
+    LOG_WARN(L"无法打开游戏数据库: " + databasePath + L" 错误码: " + std::to_wstring(GetLastError()));
+    return false;
+  }
+
+  LARGE_INTEGER fileSize = {};
+  if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(GameDb::Header)) ||
+      fileSize.QuadPart > MAXDWORD)
+  {
+    LOG_ERROR(L"游戏数据库大小无效: " + databasePath);
+    close();
+    return false;
+  }
+
+  m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_hMapping)
+  {
+    LOG_ERROR(L"创建游戏数据库文件映射失败: " + databasePath + L" 错误码: " + std::to_wstring(GetLastError()));
+    close();
+    return false;
+  }
+
+  m_view = static_cast<const uint8_t *>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_view)
+  {
+    LOG_ERROR(L"映射游戏数据库失败: " + databasePath + L" 错误码: " + std::to_wstring(GetLastError()));
+    close();
+    return false;
+  }
+
+  m_header = reinterpret_cast<const GameDb::Header *>(m_view);
+  if (!validate(static_cast<size_t>(fileSize.QuadPart)))
+  {
+    LOG_ERROR(L"游戏数据库格式无效: " + databasePath);
+    close();
+    return false;
+  }
+
+  m_titles = reinterpret_cast<const GameDb::TitleRecord *>(m_view + m_header->titlesOffset);
+  m_buckets = reinterpret_cast<const uint32_t *>(m_view + m_header->bucketsOffset);
+  m_entries = reinterpret_cast<const GameDb::ExeEntry *>(m_view + m_header->entriesOffset);
+  m_strings = reinterpret_cast<const char *>(m_view + m_header->stringsOffset);
+
+  LOG_INFO(L"游戏数据库加载成功: " + databasePath + L" 条目数: " + std::to_wstring(m_header->titleCount) +
+           L" 可执行文件数: " + std::to_wstring(m_header->entryCount));
+  return true;
+}
+
+void GameDatabase::close()
+{
+  if (m_view)
+  {
+    UnmapViewOfFile(m_view);
+    m_view = nullptr;
+  }
+  if (m_hMapping)
+  {
+    CloseHandle(m_hMapping);
+    m_hMapping = nullptr;
+  }
+  if (m_hFile != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(m_hFile);
+    m_hFile = INVALID_HANDLE_VALUE;
+  }
+  m_header = nullptr;
+  m_titles = nullptr;
+  m_buckets = nullptr;
+  m_entries = nullptr;
+  m_strings = nullptr;
+}
+
+bool GameDatabase::isOpen() const
+{
+  return m_header != nullptr && m_titles != nullptr;
+}
+
+uint32_t GameDatabase::titleCount() const
+{
+  return isOpen() ? m_header->titleCount : 0;
+}
+
+bool GameDatabase::validate(size_t fileSize) const
+{
+  const GameDb::Header &header = *m_header;
+  if (std::memcmp(header.magic, GameDb::kMagic, sizeof(GameDb::kMagic)) != 0 || header.version != GameDb::kVersion)
+  {
+    return false;
+  }
+  if (header.fileSize != fileSize || header.bucketCount == 0 || (header.bucketCount & (header.bucketCount - 1)) != 0)
+  {
+    return false;
+  }
+
+  // 各段必须对齐且完整位于文件内 只检查段边界 不遍历记录
+  auto sectionValid = [fileSize](uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t alignment)
+  {
+    return offset % alignment == 0 && offset <= fileSize && count * elementSize <= fileSize - offset;
+  };
+  if (!sectionValid(header.titlesOffset, header.titleCount, sizeof(GameDb::TitleRecord), alignof(GameDb::TitleRecord)) ||
+      !sectionValid(header.bucketsOffset, static_cast<uint64_t>(header.bucketCount) + 1, sizeof(uint32_t), alignof(uint32_t)) ||
+      !sectionValid(header.entriesOffset, header.entryCount, sizeof(GameDb::ExeEntry), alignof(GameDb::ExeEntry)) ||
+      !sectionValid(header.stringsOffset, header.stringsSize, 1, 1))
+  {
+    return false;
+  }
+
+  // 字符串表必须以 '\0' 结尾 保证任意偏移读取都不会越界
+  if (header.stringsSize == 0 || m_view[header.stringsOffset + header.stringsSize - 1] != '\0')
+  {
+    return false;
+  }
+
+  // 最后一个桶的结束位置必须等于条目数
+  const auto *buckets = reinterpret_cast<const uint32_t *>(m_view + header.bucketsOffset);
+  return buckets[header.bucketCount] == header.entryCount;
+}
+
+std::string_view GameDatabase::stringAt(uint32_t offset) const
+{
+  if (offset >= m_header->stringsSize)
+  {
+    return {};
+  }
+  return std::string_view(m_strings + offset);
+}
+
+std::optional<GameTitle> GameDatabase::find(std::string_view exeName) const
+{
+  if (!isOpen() || exeName.empty() || exeName.size() > GameDb::kMaxExeNameLength)
+  {
+    return std::nullopt;
+  }
+
+  // 在栈上转小写 查找过程不分配内存
+  char lowerName[GameDb::kMaxExeNameLength];
+  for (size_t i = 0; i < exeName.size(); ++i)
+  {
+    lowerName[i] = GameDb::toLowerAscii(exeName[i]);
+  }
+  const std::string_view key(lowerName, exeName.size());
+  const uint64_t hash = GameDb::hashName(key);
+
+  const uint32_t bucket = static_cast<uint32_t>(hash & (m_header->bucketCount - 1));
+  const uint32_t begin = m_buckets[bucket];
+  const uint32_t end = m_buckets[bucket + 1];
+  if (begin > end || end > m_header->entryCount)
+  {
+    return std::nullopt;
+  }
+
+  for (uint32_t index = begin; index < end; ++index)
+  {
+    const GameDb::ExeEntry &entry = m_entries[index];
+    if (entry.hash != hash || entry.titleIndex >= m_header->titleCount || stringAt(entry.nameOffset) != key)
+    {
+      continue;
+    }
+
+    const GameDb::TitleRecord &record = m_titles[entry.titleIndex];
+    GameTitle title;
+    title.name = stringAt(record.nameOffset);
+    title.type = static_cast<GameDb::TitleType>(record.type);
+    title.ioPriority = record.ioPriority >= static_cast<int8_t>(IoPriority::VERY_LOW) &&
+                               record.ioPriority <= static_cast<int8_t>(IoPriority::HIGH)
+                           ? static_cast<IoPriority>(record.ioPriority)
+                           : IoPriority::UNCHANGED;
+    title.flags = record.flags;
+    return title;
+  }
+  return std::nullopt;
+}
+
+std::optional<GameTitle> GameDatabase::find(const std::wstring &exeName) const
+{
+  if (!isOpen() || exeName.empty() || exeName.size() > GameDb::kMaxExeNameLength)
+  {
+    return std::nullopt;
+  }
+
+  // UTF-8 最多为 UTF-16 的 3 倍长度
+  char utf8Name[GameDb::kMaxExeNameLength * 3];
+  int length = WideCharToMultiByte(CP_UTF8, 0, exeName.data(), static_cast<int>(exeName.size()),
+                                   utf8Name, static_cast<int>(sizeof(utf8Name)), nullptr, nullptr);
+  if (length <= 0)
+  {
+    return std::nullopt;
+  }
+  return find(std::string_view(utf8Name, static_cast<size_t>(length)));
+}
@@ -0,0 +1,279 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 13:21:30
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 13:21:30
+ * @FilePath: \GameOptimizerPro\src\core\memory_manager.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include "core/memory_manager.h"
+
+#include <algorithm>
+
+MemoryManager::MemoryManager()
+{
+}
+
+MemoryManager::~MemoryManager()
+{
+  restoreMemoryPriority();
+}
+
+TrimReport MemoryManager::trimBackgroundWorkingSets(const std::vector<DWORD> &gameProcessIds,
+                                                    const std::vector<std::string> &exclusionList,
+                                                    SIZE_T budgetBytes)
+{
+  TrimReport report;
+  const auto startTime = std::chrono::steady_clock::now();
+
+  // 收集候选进程
+  std::vector<TrimCandidate> candidates;
+  for (const auto &processEntry : collectBackgroundProcesses(gameProcessIds, exclusionList))
+  {
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processEntry.processId);
+    if (hProcess == NULL)
+    {
+      continue;
+    }
+    SIZE_T workingSetSize = getWorkingSetSize(hProcess);
+    CloseHandle(hProcess);
+
+    if (workingSetSize >= kMinWorkingSetSize)
+    {
+      candidates.push_back({processEntry.processId, processEntry.exeName, workingSetSize});
+    }
+  }
+
+  // 优先回收工作集最大的进程 尽快达到预算
+  std::sort(candidates.begin(), candidates.end(),
+            [](const TrimCandidate &a, const TrimCandidate &b)
+            {
+              return a.workingSetSize > b.workingSetSize;
+            });
+
+  for (const auto &candidate : candidates)
+  {
+    if (budgetBytes != 0 && report.bytesReclaimed >= budgetBytes)
+    {
+      report.budgetReached = true;
+      break;
+    }
+
+    SIZE_T bytesReclaimed = trimProcess(candidate);
+    if (bytesReclaimed > 0)
+    {
+      report.bytesReclaimed += bytesReclaimed;
+      ++report.processCount;
+    }
+  }
+
+  report.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+  LOG_INFO("回收后台进程工作集完成，进程数: " + std::to_string(report.processCount) +
+           " 回收: " + std::to_string(report.bytesReclaimed / (1024 * 1024)) + " MB" +
+           " 耗时: " + std::to_string(report.elapsedMs) + " ms");
+  return report;
+}
+
+SIZE_T MemoryManager::trimProcess(const TrimCandidate &candidate)
+{
+  HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_SET_QUOTA, FALSE, candidate.processId);
+  if (hProcess == NULL)
+  {
+    // 权限不足或进程已退出 忽略
+    return 0;
+  }
+
+  SIZE_T sizeBefore = getWorkingSetSize(hProcess);
+  if (!EmptyWorkingSet(hProcess))
+  {
+    LOG_HRESULT(L"回收工作集失败: " + candidate.exeName, HRESULT_FROM_WIN32(GetLastError()));
+    CloseHandle(hProcess);
+    return 0;
+  }
+  SIZE_T sizeAfter = getWorkingSetSize(hProcess);
+  CloseHandle(hProcess);
+
+  SIZE_T bytesReclaimed = sizeBefore > sizeAfter ? sizeBefore - sizeAfter : 0;
+  LOG_DEBUG_FMT("已回收工作集: {} PID: {} 回收: {} KB", candidate.exeName, candidate.processId, bytesReclaimed / 1024);
+  return bytesReclaimed;
+}
+
+SIZE_T MemoryManager::getWorkingSetSize(HANDLE hProcess)
+{
+  PROCESS_MEMORY_COUNTERS memoryCounters = {};
+  memoryCounters.cb = sizeof(memoryCounters);
+  if (!GetProcessMemoryInfo(hProcess, &memoryCounters, sizeof(memoryCounters)))
+  {
+    return 0;
+  }
+  return memoryCounters.WorkingSetSize;
+}
+
+size_t MemoryManager::lowerBackgroundMemoryPriority(const std::vector<DWORD> &gameProcessIds,
+                                                    const std::vector<std::string> &exclusionList)
+{
+  size_t loweredCount = 0;
+  for (const auto &processEntry : collectBackgroundProcesses(gameProcessIds, exclusionList))
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      bool alreadyLowered = false;
+      for (const auto &loweredProcess : m_loweredProcesses)
+      {
+        if (loweredProcess.processId == processEntry.processId)
+        {
+          alreadyLowered = true;
+          break;
+        }
+      }
+      if (alreadyLowered)
+      {
+        continue;
+      }
+    }
+
+    HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processEntry.processId);
+    if (hProcess == NULL)
+    {
+      continue;
+    }
+
+    LoweredProcess loweredProcess;
+    loweredProcess.processId = processEntry.processId;
+    loweredProcess.exeName = processEntry.exeName;
+
+    FILETIME exitTime, kernelTime, userTime;
+    MEMORY_PRIORITY_INFORMATION priorityInfo = {};
+    if (!GetProcessTimes(hProcess, &loweredProcess.creationTime, &exitTime, &kernelTime, &userTime) ||
+        !GetProcessInformation(hProcess, ProcessMemoryPriority, &priorityInfo, sizeof(priorityInfo)) ||
+        priorityInfo.MemoryPriority <= MEMORY_PRIORITY_VERY_LOW)
+    {
+      CloseHandle(hProcess);
+      continue;
+    }
+    loweredProcess.originalPriority = priorityInfo.MemoryPriority;
+
+    priorityInfo.MemoryPriority = MEMORY_PRIORITY_VERY_LOW;
+    if (!SetProcessInformation(hProcess, ProcessMemoryPriority, &priorityInfo, sizeof(priorityInfo)))
+    {
+      LOG_HRESULT(L"降低内存优先级失败: " + processEntry.exeName, HRESULT_FROM_WIN32(GetLastError()));
+      CloseHandle(hProcess);
+      continue;
+    }
+    CloseHandle(hProcess);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loweredProcesses.push_back(std::move(loweredProcess));
+    ++loweredCount;
+  }
+
+  LOG_INFO("降低后台进程内存优先级完成，进程数: " + std::to_string(loweredCount));
+  return loweredCount;
+}
+
+bool MemoryManager::restoreMemoryPriority()
+{
+  std::vector<LoweredProcess> loweredProcesses;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    loweredProcesses.swap(m_loweredProcesses);
+  }
+
+  if (loweredProcesses.empty())
+  {
+    return true;
+  }
+
+  bool success = true;
+  for (const auto &loweredProcess : loweredProcesses)
+  {
+    HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, loweredProcess.processId);
+    if (hProcess == NULL)
+    {
+      // 进程已退出
+      continue;
+    }
+
+    // 校验创建时间 防止 PID 被新进程复用
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime) ||
+        CompareFileTime(&creationTime, &loweredProcess.creationTime) != 0)
+    {
+      CloseHandle(hProcess);
+      continue;
+    }
+
+    MEMORY_PRIORITY_INFORMATION priorityInfo = {};
+    priorityInfo.MemoryPriority = loweredProcess.originalPriority;
+    if (!SetProcessInformation(hProcess, ProcessMemoryPriority, &priorityInfo, sizeof(priorityInfo)))
+    {
+      LOG_HRESULT(L"还原内存优先级失败: " + loweredProcess.exeName, HRESULT_FROM_WIN32(GetLastError()));
+      success = false;
+    }
+    CloseHandle(hProcess);
+  }
+
+  LOG_INFO("后台进程内存优先级已还原，还原进程数: " + std::to_string(loweredProcesses.size()));
+  return success;
+}
+
+std::vector<ProcessEntry> MemoryManager::collectBackgroundProcesses(const std::vector<DWORD> &gameProcessIds,
+                                                                    const std::vector<std::string> &exclusionList)
+{
+  std::vector<std::wstring> exclusionListWs;
+  for (const auto &processName : exclusionList)
+  {
+    exclusionListWs.push_back(MultiByteToWide(processName));
+  }
+
+  const auto snapshot = getProcessSnapshot();
+  const auto gameProcessTree = collectProcessTree(snapshot, gameProcessIds);
+  const DWORD currentProcessId = GetCurrentProcessId();
+  DWORD currentSessionId = 0;
+  ProcessIdToSessionId(currentProcessId, &currentSessionId);
+
+  // 前台窗口所属进程视为正在使用
+  DWORD foregroundProcessId = 0;
+  HWND hForeground = GetForegroundWindow();
+  if (hForeground != NULL)
+  {
+    GetWindowThreadProcessId(hForeground, &foregroundProcessId);
+  }
+
+  std::vector<ProcessEntry> backgroundProcesses;
+  for (const auto &processEntry : snapshot)
+  {
+    if (processEntry.processId == currentProcessId ||
+        processEntry.processId == foregroundProcessId ||
+        gameProcessTree.count(processEntry.processId) ||
+        isCriticalSystemProcess(processEntry.exeName))
+    {
+      continue;
+    }
+
+    // 只处理当前用户会话中的进程 会话0为系统服务
+    DWORD sessionId = 0;
+    if (!ProcessIdToSessionId(processEntry.processId, &sessionId) ||
+        sessionId == 0 || sessionId != currentSessionId)
+    {
+      continue;
+    }
+
+    bool excluded = false;
+    for (const auto &processName : exclusionListWs)
+    {
+      if (_wcsicmp(processEntry.exeName.c_str(), processName.c_str()) == 0)
+      {
+        excluded = true;
+        break;
+      }
+    }
+    if (!excluded)
+    {
+      backgroundProcesses.push_back(processEntry);
+    }
+  }
+  return backgroundProcesses;
+}
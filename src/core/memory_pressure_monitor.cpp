@@ -0,0 +1,183 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 14:06:02
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 14:06:02
+ * @FilePath: \GameOptimizerPro\src\core\memory_pressure_monitor.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include "core/memory_pressure_monitor.h"
+
+#include "metrics/tracing.h"
+
+MemoryPressureMonitor::MemoryPressureMonitor()
+{
+  // Manual-reset, initially non-signaled
+  m_stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  if (m_stopEvent == nullptr)
+  {
+    LOG_HRESULT(L"创建内存监视停止事件失败", HRESULT_FROM_WIN32(GetLastError()));
+  }
+
+  m_lowMemoryEvent = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+  if (m_lowMemoryEvent == nullptr)
+  {
+    LOG_HRESULT(L"订阅内存不足通知失败", HRESULT_FROM_WIN32(GetLastError()));
+  }
+
+  m_highMemoryEvent = CreateMemoryResourceNotification(HighMemoryResourceNotification);
+  if (m_highMemoryEvent == nullptr)
+  {
+    LOG_HRESULT(L"订阅内存充足通知失败", HRESULT_FROM_WIN32(GetLastError()));
+  }
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor()
+{
+  stop();
+
+  for (HANDLE *handle : {&m_stopEvent, &m_lowMemoryEvent, &m_highMemoryEvent})
+  {
+    if (*handle)
+    {
+      CloseHandle(*handle);
+      *handle = nullptr;
+    }
+  }
+}
+
+bool MemoryPressureMonitor::start()
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (m_isRunning.load())
+  {
+    return true;
+  }
+
+  if (!m_stopEvent || !m_lowMemoryEvent || !m_highMemoryEvent)
+  {
+    LOG_ERROR("内存通知句柄无效，无法监视内存压力");
+    return false;
+  }
+
+  ResetEvent(m_stopEvent);
+  try
+  {
+    m_monitorThread = std::thread([this]()
+                                  { runMonitorLoop(); });
+  }
+  catch (const std::system_error &e)
+  {
+    LOG_ERROR("启动内存监视线程失败: " + std::string(e.what()));
+    return false;
+  }
+
+  m_isRunning = true;
+  LOG_INFO("开始监视内存压力");
+  return true;
+}
+
+void MemoryPressureMonitor::stop()
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (!m_isRunning.load())
+  {
+    return;
+  }
+
+  SetEvent(m_stopEvent);
+  if (m_monitorThread.joinable())
+  {
+    try
+    {
+      m_monitorThread.join();
+    }
+    catch (const std::system_error &e)
+    {
+      LOG_ERROR("等待内存监视线程结束失败: " + std::string(e.what()));
+    }
+  }
+
+  m_isRunning = false;
+  LOG_INFO("停止监视内存压力");
+}
+
+bool MemoryPressureMonitor::isRunning() const
+{
+  return m_isRunning.load();
+}
+
+void MemoryPressureMonitor::setOnPressureCallback(PressureCallback callback)
+{
+  m_onPressureCallback = std::move(callback);
+}
+
+void MemoryPressureMonitor::runMonitorLoop()
+{
+  Tracing::setThreadName("memory_pressure_monitor");
+  int level = static_cast<int>(PressureLevel::None);
+
+  while (true)
+  {
+    DWORD waitResult = WAIT_FAILED;
+    if (level == static_cast<int>(PressureLevel::None))
+    {
+      // 空闲状态 无限期等待内存不足通知
+      HANDLE handles[] = {m_stopEvent, m_lowMemoryEvent};
+      waitResult = WaitForMultipleObjects(ARRAYSIZE(handles), handles, FALSE, INFINITE);
+      if (waitResult == WAIT_OBJECT_0 + 1)
+      {
+        level = static_cast<int>(PressureLevel::TrimBackground);
+        LOG_WARN("检测到内存不足，压力级别: " + std::to_string(level));
+        if (m_onPressureCallback)
+        {
+          m_onPressureCallback(static_cast<PressureLevel>(level));
+        }
+        continue;
+      }
+    }
+    else
+    {
+      // 压力状态 等待内存恢复 超时后检查是否需要升级
+      HANDLE handles[] = {m_stopEvent, m_highMemoryEvent};
+      waitResult = WaitForMultipleObjects(ARRAYSIZE(handles), handles, FALSE, kEscalationIntervalMs);
+      if (waitResult == WAIT_OBJECT_0 + 1)
+      {
+        LOG_INFO("内存已恢复充足");
+        level = static_cast<int>(PressureLevel::None);
+        continue;
+      }
+      if (waitResult == WAIT_TIMEOUT)
+      {
+        BOOL isLowMemory = FALSE;
+        if (!QueryMemoryResourceNotification(m_lowMemoryEvent, &isLowMemory) || !isLowMemory)
+        {
+          // 已离开内存不足区间 回到空闲等待
+          level = static_cast<int>(PressureLevel::None);
+          continue;
+        }
+        if (level < static_cast<int>(PressureLevel::Alert))
+        {
+          ++level;
+          LOG_WARN("内存持续不足，压力级别: " + std::to_string(level));
+          if (m_onPressureCallback)
+          {
+            m_onPressureCallback(static_cast<PressureLevel>(level));
+          }
+        }
+        continue;
+      }
+    }
+
+    if (waitResult == WAIT_OBJECT_0)
+    {
+      // 收到停止信号
+      break;
+    }
+
+    LOG_HRESULT(L"等待内存通知失败", HRESULT_FROM_WIN32(GetLastError()));
+    break;
+  }
+}
@@ -0,0 +1,284 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 22:58:47
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 22:58:47
+ * @FilePath: \GameOptimizerPro\src\core\memory_registry_backend.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "core/registry_backend.h"
+
+#include <cstdio>
+
+namespace
+{
+  // 根键的路径前缀 例如 HKEY_LOCAL_MACHINE -> 80000002
+  std::string rootPrefix(HKEY hKey)
+  {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%llx", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(hKey)));
+    return buffer;
+  }
+
+  bool isPredefinedRoot(HKEY hKey)
+  {
+    return hKey == HKEY_CLASSES_ROOT || hKey == HKEY_CURRENT_USER || hKey == HKEY_LOCAL_MACHINE ||
+           hKey == HKEY_USERS || hKey == HKEY_CURRENT_CONFIG;
+  }
+
+  // 值名称可以包含反斜杠 只忽略大小写
+  std::string valueKey(const std::string &valueName)
+  {
+    std::string key = valueName;
+    for (char &c : key)
+    {
+      if (c >= 'A' && c <= 'Z')
+      {
+        c = static_cast<char>(c - 'A' + 'a');
+      }
+    }
+    return key;
+  }
+
+  // 原始大小写的最后一段名称
+  std::string lastComponent(const std::string &subKey)
+  {
+    std::string trimmed = subKey;
+    while (!trimmed.empty() && trimmed.back() == '\\')
+    {
+      trimmed.pop_back();
+    }
+    const size_t pos = trimmed.find_last_of('\\');
+    return pos == std::string::npos ? trimmed : trimmed.substr(pos + 1);
+  }
+} // namespace
+
+bool MemoryRegistryBackend::resolve(HKEY hKey, const std::string &subKey, std::string &path) const
+{
+  if (isPredefinedRoot(hKey))
+  {
+    path = rootPrefix(hKey);
+  }
+  else
+  {
+    auto it = m_handles.find(reinterpret_cast<uintptr_t>(hKey));
+    if (it == m_handles.end())
+    {
+      return false;
+    }
+    path = it->second;
+  }
+  const std::string normalized = normalizeRegistryPath(subKey);
+  if (!normalized.empty())
+  {
+    path += '\\';
+    path += normalized;
+  }
+  return true;
+}
+
+MemoryRegistryBackend::Key *MemoryRegistryBackend::findKey(HKEY hKey, LONG &result)
+{
+  std::string path;
+  if (!resolve(hKey, "", path))
+  {
+    result = ERROR_INVALID_HANDLE;
+    return nullptr;
+  }
+  // 根键总是存在
+  if (isPredefinedRoot(hKey))
+  {
+    result = ERROR_SUCCESS;
+    return &m_keys[path];
+  }
+  auto it = m_keys.find(path);
+  if (it == m_keys.end())
+  {
+    result = ERROR_KEY_DELETED;
+    return nullptr;
+  }
+  result = ERROR_SUCCESS;
+  return &it->second;
+}
+
+HKEY MemoryRegistryBackend::allocateHandle(const std::string &path)
+{
+  const uintptr_t handle = m_nextHandle;
+  m_nextHandle += 4;
+  m_handles.emplace(handle, path);
+  m_openCount.fetch_add(1, std::memory_order_relaxed);
+  return reinterpret_cast<HKEY>(handle);
+}
+
+LONG MemoryRegistryBackend::openKey(HKEY hKey, const std::string &subKey, REGSAM, HKEY &result)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string path;
+  if (!resolve(hKey, subKey, path))
+  {
+    return ERROR_INVALID_HANDLE;
+  }
+  if (path.find('\\') != std::string::npos && m_keys.find(path) == m_keys.end())
+  {
+    return ERROR_FILE_NOT_FOUND;
+  }
+  result = allocateHandle(path);
+  return ERROR_SUCCESS;
+}
+
+LONG MemoryRegistryBackend::createKey(HKEY hKey, const std::string &subKey, REGSAM, HKEY &result)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string path;
+  if (!resolve(hKey, subKey, path))
+  {
+    return ERROR_INVALID_HANDLE;
+  }
+
+  // 逐级创建不存在的项 中间项只知道规范化后的名称
+  size_t pos = path.find('\\');
+  while (pos != std::string::npos)
+  {
+    const size_t next = path.find('\\', pos + 1);
+    const std::string prefix = path.substr(0, next);
+    auto inserted = m_keys.try_emplace(prefix);
+    if (inserted.second)
+    {
+      // 目标项保留调用方的大小写
+      inserted.first->second.name = next == std::string::npos ? lastComponent(subKey) : prefix.substr(pos + 1);
+    }
+    pos = next;
+  }
+  result = allocateHandle(path);
+  return ERROR_SUCCESS;
+}
+
+LONG MemoryRegistryBackend::closeKey(HKEY hKey)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_handles.erase(reinterpret_cast<uintptr_t>(hKey)) > 0 ? ERROR_SUCCESS : ERROR_INVALID_HANDLE;
+}
+
+LONG MemoryRegistryBackend::queryValue(HKEY hKey, const std::string &valueName, DWORD &type, std::vector<BYTE> &data)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  LONG result = ERROR_SUCCESS;
+  Key *key = findKey(hKey, result);
+  if (!key)
+  {
+    return result;
+  }
+  auto it = key->values.find(valueKey(valueName));
+  if (it == key->values.end())
+  {
+    return ERROR_FILE_NOT_FOUND;
+  }
+  type = it->second.type;
+  data = it->second.data;
+  return ERROR_SUCCESS;
+}
+
+LONG MemoryRegistryBackend::setValue(HKEY hKey, const std::string &valueName, DWORD type, const BYTE *data, DWORD size)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  LONG result = ERROR_SUCCESS;
+  Key *key = findKey(hKey, result);
+  if (!key)
+  {
+    return result;
+  }
+  Value &value = key->values[valueKey(valueName)];
+  value.type = type;
+  value.data.assign(data, data + size);
+  return ERROR_SUCCESS;
+}
+
+LONG MemoryRegistryBackend::deleteValue(HKEY hKey, const std::string &valueName)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  LONG result = ERROR_SUCCESS;
+  Key *key = findKey(hKey, result);
+  if (!key)
+  {
+    return result;
+  }
+  return key->values.erase(valueKey(valueName)) > 0 ? ERROR_SUCCESS : ERROR_FILE_NOT_FOUND;
+}
+
+LONG MemoryRegistryBackend::deleteTree(HKEY hKey, const std::string &subKey)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string path;
+  if (!resolve(hKey, subKey, path))
+  {
+    return ERROR_INVALID_HANDLE;
+  }
+  auto it = m_keys.find(path);
+  if (it == m_keys.end())
+  {
+    return ERROR_FILE_NOT_FOUND;
+  }
+  // 子项的路径以 path\ 开头 在有序表中连续排列
+  // 但不一定紧跟在 path 之后 例如 a-b 排在 a 和 a\b 之间
+  const std::string childPrefix = path + '\\';
+  auto begin = m_keys.lower_bound(childPrefix);
+  auto end = begin;
+  while (end != m_keys.end() && end->first.compare(0, childPrefix.size(), childPrefix) == 0)
+  {
+    ++end;
+  }
+  m_keys.erase(begin, end);
+  m_keys.erase(it);
+  return ERROR_SUCCESS;
+}
+
+LONG MemoryRegistryBackend::enumSubKey(HKEY hKey, DWORD index, std::string &name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string path;
+  if (!resolve(hKey, "", path))
+  {
+    return ERROR_INVALID_HANDLE;
+  }
+  const std::string childPrefix = path + '\\';
+  DWORD current = 0;
+  for (auto it = m_keys.lower_bound(childPrefix); it != m_keys.end() && it->first.compare(0, childPrefix.size(), childPrefix) == 0; ++it)
+  {
+    // 只枚举直接子项
+    if (it->first.find('\\', childPrefix.size()) != std::string::npos)
+    {
+      continue;
+    }
+    if (current++ == index)
+    {
+      name = it->second.name;
+      return ERROR_SUCCESS;
+    }
+  }
+  return ERROR_NO_MORE_ITEMS;
+}
+
+LONG MemoryRegistryBackend::queryKeyInfo(HKEY hKey)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  LONG result = ERROR_SUCCESS;
+  findKey(hKey, result);
+  return result;
+}
+
+LONG MemoryRegistryBackend::saveKey(HKEY, const std::string &)
+{
+  return ERROR_NOT_SUPPORTED;
+}
+
+LONG MemoryRegistryBackend::restoreKey(HKEY, const std::string &)
+{
+  return ERROR_NOT_SUPPORTED;
+}
+
+size_t MemoryRegistryBackend::openHandleCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_handles.size();
+}
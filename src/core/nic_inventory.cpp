@@ -0,0 +1,239 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:59:10
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:59:10
+ * @FilePath: \GameOptimizerPro\src\core\nic_inventory.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#define LOG_MODULE Logging::Module::Registry
+
+// winsock2.h 必须先于 windows.h 包含 否则与 windows.h 中的 winsock.h 冲突
+#include <winsock2.h>
+#include <ws2ipdef.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#include <objbase.h>
+
+#include "core/nic_inventory.h"
+
+#include "metrics/tracing.h"
+
+namespace
+{
+  void CALLBACK onIpInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW /*row*/, MIB_NOTIFICATION_TYPE notificationType)
+  {
+    // 只关心网卡的添加和移除 参数变化 (例如 MTU) 不影响网卡清单
+    if (context == nullptr || (notificationType != MibAddInstance && notificationType != MibDeleteInstance))
+    {
+      return;
+    }
+    LOG_DEBUG(notificationType == MibAddInstance ? "检测到网络接口添加" : "检测到网络接口移除");
+    static_cast<NicInventory *>(context)->invalidate();
+  }
+
+  void CALLBACK onRouteChange(PVOID context, PMIB_IPFORWARD_ROW2 row, MIB_NOTIFICATION_TYPE notificationType)
+  {
+    // 只关心默认路由 其他路由的变化很频繁且不影响实际联网的网卡
+    if (context == nullptr || notificationType == MibInitialNotification || row == nullptr ||
+        row->DestinationPrefix.PrefixLength != 0)
+    {
+      return;
+    }
+    LOG_DEBUG("检测到默认路由变化");
+    static_cast<NicInventory *>(context)->invalidate();
+  }
+} // namespace
+
+NicInventory::NicInventory(RegistryManager *registryManager, const RegistryKey &classKey, const RegistryKey &interfacesKey)
+    : m_registryManager(registryManager), m_classKey(classKey), m_interfacesKey(interfacesKey)
+{
+}
+
+NicInventory::~NicInventory()
+{
+  stop();
+}
+
+bool NicInventory::start()
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (m_isSubscribed)
+  {
+    return true;
+  }
+
+  DWORD result = NotifyIpInterfaceChange(AF_UNSPEC, onIpInterfaceChange, this, FALSE, &m_interfaceNotification);
+  if (result != NO_ERROR)
+  {
+    LOG_HRESULT(L"订阅网络接口变化通知失败", HRESULT_FROM_WIN32(result));
+    m_interfaceNotification = nullptr;
+    return false;
+  }
+
+  result = NotifyRouteChange2(AF_UNSPEC, onRouteChange, this, FALSE, &m_routeNotification);
+  if (result != NO_ERROR)
+  {
+    LOG_HRESULT(L"订阅路由变化通知失败", HRESULT_FROM_WIN32(result));
+    CancelMibChangeNotify2(m_interfaceNotification);
+    m_interfaceNotification = nullptr;
+    m_routeNotification = nullptr;
+    return false;
+  }
+
+  // 订阅之前的变化没有通知 重新枚举一次
+  m_generation++;
+  m_isSubscribed = true;
+  LOG_INFO("已订阅网络接口和默认路由变化通知");
+  return true;
+}
+
+void NicInventory::stop()
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (!m_isSubscribed)
+  {
+    return;
+  }
+  m_isSubscribed = false;
+
+  // 等待正在执行的通知回调结束后返回
+  CancelMibChangeNotify2(m_routeNotification);
+  CancelMibChangeNotify2(m_interfaceNotification);
+  m_routeNotification = nullptr;
+  m_interfaceNotification = nullptr;
+  LOG_INFO("已取消网络接口和默认路由变化通知");
+}
+
+void NicInventory::invalidate()
+{
+  m_generation++;
+  // 在系统通知线程中调用 与设置回调互斥
+  std::lock_guard<std::mutex> lock(m_callbackMutex);
+  if (m_onChangedCallback)
+  {
+    m_onChangedCallback();
+  }
+}
+
+bool NicInventory::getInterfaces(std::vector<NicInfo> &interfaces)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // 先读取版本再枚举 枚举期间发生的变化会在下一次获取时重新枚举
+  const unsigned long long generation = m_generation.load();
+  if (!m_isSubscribed || m_builtGeneration != generation)
+  {
+    std::vector<NicInfo> scanned;
+    if (!scanInterfaces(scanned))
+    {
+      m_builtGeneration = 0;
+      return false;
+    }
+    m_interfaces = std::move(scanned);
+    m_builtGeneration = generation;
+  }
+
+  interfaces = m_interfaces;
+  return !interfaces.empty();
+}
+
+void NicInventory::setOnChangedCallback(ChangedCallback callback)
+{
+  std::lock_guard<std::mutex> lock(m_callbackMutex);
+  m_onChangedCallback = std::move(callback);
+}
+
+bool NicInventory::scanInterfaces(std::vector<NicInfo> &interfaces)
+{
+  TRACE_SCOPE("registry", "scan_network_interfaces");
+  // 先获取所有网络接口卡ID
+  std::vector<std::string> nicIds;
+  if (!m_registryManager->GetNetworkInterfaceCardIds(m_classKey.hRoot, m_classKey.subKey, m_classKey.keyValueList[0].key, nicIds))
+  {
+    LOG_ERROR("获取网络接口卡ID失败");
+    return false;
+  }
+
+  // 过滤掉没有 Tcpip 接口项的ID
+  if (!m_registryManager->filterInvalidNetworkInterfaceCardIds(m_interfacesKey.hRoot, m_interfacesKey.subKey, nicIds))
+  {
+    LOG_ERROR("没有有效的网络接口卡ID");
+    return false;
+  }
+
+  // 读取路由表失败时不标记默认路由 调用方按全部网卡处理
+  std::unordered_set<std::string> defaultRouteIds;
+  getDefaultRouteInterfaceIds(defaultRouteIds);
+
+  size_t defaultRouteCount = 0;
+  for (const auto &nicId : nicIds)
+  {
+    NicInfo nic;
+    nic.interfaceId = nicId;
+    std::string lowerId = nicId;
+    for (char &c : lowerId)
+    {
+      if (c >= 'A' && c <= 'Z')
+      {
+        c = static_cast<char>(c - 'A' + 'a');
+      }
+    }
+    nic.hasDefaultRoute = defaultRouteIds.count(lowerId) > 0;
+    if (nic.hasDefaultRoute)
+    {
+      defaultRouteCount++;
+    }
+    interfaces.push_back(std::move(nic));
+  }
+
+  LOG_INFO_FMT("网卡清单已更新: 网卡 {} 个 其中承载默认路由 {} 个", interfaces.size(), defaultRouteCount);
+  return true;
+}
+
+bool NicInventory::getDefaultRouteInterfaceIds(std::unordered_set<std::string> &interfaceIds)
+{
+  PMIB_IPFORWARD_TABLE2 table = nullptr;
+  DWORD result = GetIpForwardTable2(AF_UNSPEC, &table);
+  if (result != NO_ERROR)
+  {
+    LOG_HRESULT(L"读取路由表失败", HRESULT_FROM_WIN32(result));
+    return false;
+  }
+
+  for (ULONG i = 0; i < table->NumEntries; ++i)
+  {
+    const MIB_IPFORWARD_ROW2 &row = table->Table[i];
+    if (row.DestinationPrefix.PrefixLength != 0)
+    {
+      continue;
+    }
+
+    GUID interfaceGuid;
+    if (ConvertInterfaceLuidToGuid(&row.InterfaceLuid, &interfaceGuid) != NO_ERROR)
+    {
+      continue;
+    }
+    wchar_t buffer[64];
+    if (StringFromGUID2(interfaceGuid, buffer, ARRAYSIZE(buffer)) == 0)
+    {
+      continue;
+    }
+
+    // GUID 字符串只含 ASCII 字符 转为小写后与注册表中的ID比较
+    std::string interfaceId;
+    for (const wchar_t *p = buffer; *p != L'\0'; ++p)
+    {
+      wchar_t c = *p;
+      if (c >= L'A' && c <= L'Z')
+      {
+        c = static_cast<wchar_t>(c - L'A' + L'a');
+      }
+      interfaceId.push_back(static_cast<char>(c));
+    }
+    interfaceIds.insert(std::move(interfaceId));
+  }
+
+  FreeMibTable(table);
+  return true;
+}
@@ -10,6 +10,38 @@
 
 #include "core/optimizer.h"
 
+#include <algorithm>
+#include <cwctype>
+#include <set>
+#include <QCoreApplication>
+#include <QPointer>
+
+#include "metrics/metrics.h"
+#include "metrics/tracing.h"
+
+namespace
+{
+  // 注册表项名称不区分大小写 统一转为小写后比较
+  std::string toLowerAscii(std::string str)
+  {
+    for (char &c : str)
+    {
+      if (c >= 'A' && c <= 'Z')
+      {
+        c = static_cast<char>(c - 'A' + 'a');
+      }
+    }
+    return str;
+  }
+
+  std::wstring toLowerWide(std::wstring str)
+  {
+    std::transform(str.begin(), str.end(), str.begin(), [](wchar_t c)
+                   { return static_cast<wchar_t>(std::towlower(c)); });
+    return str;
+  }
+} // namespace
+
 Optimizer::Optimizer(QSystemTrayIcon *trayIcon)
     : m_trayIcon(trayIcon)
 {
@@ -21,6 +53,22 @@ Optimizer::Optimizer(QSystemTrayIcon *trayIcon)
     m_registryManager = std::make_unique<RegistryManager>();
     m_powerManager = std::make_unique<PowerManager>();
     m_serviceManager = std::make_unique<ServiceManager>();
+    m_sessionManager = std::make_unique<SessionManager>();
+    m_backgroundManager = std::make_unique<BackgroundManager>();
+    m_memoryManager = std::make_unique<MemoryManager>();
+    m_memoryPressureMonitor = std::make_unique<MemoryPressureMonitor>();
+    m_prefetchManager = std::make_unique<PrefetchManager>();
+    m_registryWatcher = std::make_unique<RegistryWatcher>();
+    m_nicInventory = std::make_unique<NicInventory>(m_registryManager.get(),
+                                                    m_registryKeys.at("NetworkInterfaceCardIds"),
+                                                    m_registryKeys.at("OptimizeNetWorkDelay"));
+    setListenerCallback();
+    setSessionCallback();
+    setMemoryPressureCallback();
+    setPrefetchCallback();
+    setRegistryWatcherCallback();
+    setNicInventoryCallback();
+    m_nicInventory->start();
   }
   catch (const std::exception &e)
   {
@@ -30,11 +78,32 @@ Optimizer::Optimizer(QSystemTrayIcon *trayIcon)
 
 Optimizer::~Optimizer()
 {
+  // 网卡变化回调会通知监视器 先于监视器停止
+  m_nicInventory.reset();
+  // 监视回调会写入注册表 先于其他管理器停止
+  m_registryWatcher.reset();
+  // 进程事件会转发给会话管理器 先停止订阅
+  if (m_processManager && m_processManager->isListening())
+  {
+    m_processManager->stopListening();
+  }
+  // 先停止会话监听 确保会话期间的修改被还原
+  if (m_sessionManager)
+  {
+    m_sessionManager->stopMonitoring();
+  }
+  m_memoryPressureMonitor.reset();
+  m_prefetchManager.reset();
+  m_sessionManager.reset();
+  m_backgroundManager.reset();
+  m_memoryManager.reset();
   m_Module.Term();
 }
 
 bool Optimizer::setAutoStartup(bool isAutoStartup)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "auto_startup");
+  MetricOperationScope scope(metric);
   char path[MAX_PATH];
   if (!GetModuleFileNameA(NULL, path, MAX_PATH))
   {
@@ -73,27 +142,54 @@ bool Optimizer::setAutoStartup(bool isAutoStartup)
       }
     }
   }
-  return true;
+  return scope.finish(true);
 }
 
-bool Optimizer::setAutoLimitAntiCheat(bool isAutoLimit, const std::vector<std::string> &processNames)
+bool Optimizer::setAutoLimitAntiCheat(bool isAutoLimit, const std::vector<std::string> &processNames,
+                                      const std::map<std::string, IoPriority> &ioPriorityRules)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "auto_limit_anti_cheat");
+  MetricOperationScope scope(metric);
   if (isAutoLimit)
   {
+    {
+      // 设置时转换为小写宽字符串 每个进程事件只查找一次
+      std::lock_guard<std::mutex> lock(m_sessionMutex);
+      m_antiCheatProcesses.clear();
+      for (const auto &processName : processNames)
+      {
+        m_antiCheatProcesses.emplace(toLowerWide(MultiByteToWide(processName)), IoPriority::UNCHANGED);
+      }
+      // 配置的 I/O 优先级优先于进程列表
+      for (const auto &[processName, ioPriority] : ioPriorityRules)
+      {
+        m_antiCheatProcesses[toLowerWide(MultiByteToWide(processName))] = ioPriority;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_listenerMutex);
+      m_antiCheatListenNames = processNames;
+      for (const auto &rule : ioPriorityRules)
+      {
+        m_antiCheatListenNames.push_back(rule.first);
+      }
+      m_autoLimitAntiCheat = true;
+    }
     try
     {
-      // 设置回调函数
-      setListenerCallback();
-      if (m_processManager->startListening(processNames))
+      // 与游戏会话共用一个订阅 数据库中的反作弊进程无法逐个订阅 改为监听所有进程后在回调中过滤
+      if (updateProcessListener())
       {
         std::cout << "Listening started successfully. Open/close monitored processes." << std::endl;
         LOG_INFO("监听进程创建和销毁事件成功");
-        return true;
+        return scope.finish(true);
       }
       else
       {
         std::cerr << "Failed to start listening." << std::endl;
         LOG_ERROR("监听进程创建和销毁事件失败");
+        m_autoLimitAntiCheat = false;
+        updateProcessListener();
         return false;
       }
     }
@@ -116,13 +212,15 @@ bool Optimizer::setAutoLimitAntiCheat(bool isAutoLimit, const std::vector<std::s
   }
   else
   {
+    m_autoLimitAntiCheat = false;
     try
     {
-      if (m_processManager->stopListening())
+      // 游戏会话仍需要时保留订阅 只去掉反作弊进程名
+      if (updateProcessListener())
       {
         std::cout << "Listener stopped successfully." << std::endl;
         LOG_INFO("停止监听进程创建和销毁事件成功");
-        return true;
+        return scope.finish(true);
       }
       else
       {
@@ -155,9 +253,16 @@ void Optimizer::setListenerCallback()
   m_processManager->setOnProcessCreatedCallback(
       [this](const std::wstring &processName, DWORD processId)
       {
-    LOG_INFO(L"[Callback] Process Started: '" + processName + L" PID: " + std::to_wstring(processId) + L" 启动");
+    // 游戏会话和自动限制反作弊共用一个订阅 每个事件分发给两者
+    m_sessionManager->onProcessCreated(processName, processId);
+    IoPriority ioPriority = IoPriority::UNCHANGED;
+    if (!m_autoLimitAntiCheat || !isAntiCheatProcess(processName, ioPriority))
+    {
+      return;
+    }
+    LOG_INFO_FMT("[Callback] Process Started: '{} PID: {} 启动", processName, processId);
 
-    std::thread([this, processName, processId]()
+    std::thread([this, processName, processId, ioPriority]()
                 {
                       std::this_thread::sleep_for(std::chrono::seconds(5));
                       if (!m_processManager->restrictAntiCheatProcessPS(processName, processId))
@@ -165,29 +270,61 @@ void Optimizer::setListenerCallback()
                         LOG_ERROR(L"限制进程 " + processName + L" 失败");
                         return;
                       }
-                      m_trayIcon->showMessage(
-                        "鱼腥味的游戏优化工具箱",
-                        "限制进程 " + QString::fromStdWString(processName) + " 成功",
-                        QSystemTrayIcon::Information,
-                        5000
-                      );})
+                      // 降低 I/O 优先级 减少扫描时与游戏加载资源的磁盘争用
+                      if (ioPriority != IoPriority::UNCHANGED &&
+                          !m_processManager->restrictProcessIoPriority(processName, processId, static_cast<ULONG>(ioPriority)))
+                      {
+                        LOG_ERROR(L"限制进程 " + processName + L" I/O 优先级失败");
+                      }
+                      showTrayMessage("限制进程 " + QString::fromStdWString(processName) + " 成功");})
             .detach(); });
 
   m_processManager->setOnProcessDestroyedCallback(
       [this](const std::wstring &processName, DWORD processId)
       {
-        LOG_INFO(L"[Callback] Process Destroyed: '" + processName + L" PID: " + std::to_wstring(processId) + L" 销毁");
+        m_sessionManager->onProcessDestroyed(processName, processId);
+        IoPriority ioPriority = IoPriority::UNCHANGED;
+        if (!m_autoLimitAntiCheat || !isAntiCheatProcess(processName, ioPriority))
+        {
+          return;
+        }
+        LOG_INFO_FMT("[Callback] Process Destroyed: '{} PID: {} 销毁", processName, processId);
       });
 
   m_processManager->setOnErrorCallback(
       [this](long errorCode)
       {
-        LOG_HRESULT(L"WMI Failure.", errorCode);
+        LOG_HRESULT_LIMITED(L"WMI Failure.", errorCode);
       });
 }
 
+bool Optimizer::isAntiCheatProcess(const std::wstring &processName, IoPriority &ioPriority)
+{
+  const std::wstring lowerProcessName = toLowerWide(processName);
+  std::lock_guard<std::mutex> lock(m_sessionMutex);
+  auto it = m_antiCheatProcesses.find(lowerProcessName);
+  if (it != m_antiCheatProcesses.end())
+  {
+    ioPriority = it->second;
+    return true;
+  }
+
+  if (m_gameDatabase)
+  {
+    auto title = m_gameDatabase->find(processName);
+    if (title && title->type == GameDb::TitleType::AntiCheat)
+    {
+      ioPriority = title->ioPriority;
+      return true;
+    }
+  }
+  return false;
+}
+
 bool Optimizer::setGameOptimizePowerPlan(GUID *PowerPlanGuid, bool isOptimize)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "game_power_plan");
+  MetricOperationScope scope(metric);
   bool result = false;
   if (isOptimize)
   {
@@ -209,7 +346,7 @@ bool Optimizer::setGameOptimizePowerPlan(GUID *PowerPlanGuid, bool isOptimize)
       LOG_ERROR("设置高性能游戏电源计划为活动电源计划失败");
       return result;
     }
-    return true;
+    return scope.finish(true);
   }
   else
   {
@@ -219,7 +356,7 @@ bool Optimizer::setGameOptimizePowerPlan(GUID *PowerPlanGuid, bool isOptimize)
       LOG_ERROR("删除高性能游戏电源计划失败");
       return result;
     }
-    return true;
+    return scope.finish(true);
   }
 }
 
@@ -231,6 +368,8 @@ bool Optimizer::setPowerPlanLock(bool isLock)
 
 bool Optimizer::setBackgroundActivityLimit(bool isLimit)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "background_activity_limit");
+  MetricOperationScope scope(metric);
   //  // 假设 key 是一个 RegistryKey 对象
   //   if (std::holds_alternative<DWORD>(key.value)) {
   //       DWORD dwordValue = std::get<DWORD>(key.value);
@@ -242,169 +381,181 @@ bool Optimizer::setBackgroundActivityLimit(bool isLimit)
   // 设置注册表路径：HKEY_LOCAL_MACHINE\SOFTWARE\Microsoft\Windows NT\CurrentVersion\Multimedia\SystemProfile
   // 设置值：NetworkThrottlingIndex 优化前为十六进制 0xffffffff 十进制 4294967295，优化后为十六进制 0xffffffff 十进制 4294967295
   // 设置值：WSystemResponsiveness 优化前为十六进制 0x00000014 十进制 20，优化后为十六进制 0x00000005 十进制 5
-  HKEY hRoot = m_registryKeys["OptimizeBackgroundActivity"].hRoot;
-  std::string subKey = m_registryKeys["OptimizeBackgroundActivity"].subKey;
-
-  if (isLimit)
+  const std::string changeSetName = "OptimizeBackgroundActivity";
+  if (!isLimit)
+  {
+    // 先停止监视 避免还原后被重新写入
+    m_registryWatcher->unwatch(changeSetName);
+  }
+  bool result = false;
+  std::string values;
+  RegistryApplyReport report;
+  if (!isLimit && m_registryManager->hasChangeSet(changeSetName))
   {
-    for (const auto &valueKey : m_registryKeys["OptimizeBackgroundActivity"].keyValueList)
+    // 还原为开启前记录的原始值
+    result = m_registryManager->revertChangeSet(changeSetName, &report);
+    values = " 已还原为原始值";
+  }
+  else
+  {
+    // 同一注册表项的值只打开一次
+    RegistryBatch batch;
+    buildRegistryOptimization(changeSetName, isLimit, batch);
+    for (const auto &valueKey : m_registryKeys.at(changeSetName).keyValueList)
     {
-      std::string valueName = valueKey.key;
-      DWORD value = std::get<DWORD>(valueKey.optimizeValue);
-      if (m_registryManager->setRegistryDWORDValue(hRoot, subKey, valueName, value))
-      {
-        LOG_INFO("设置后台活动限制成功，" + valueName + ": " + std::to_string(value));
-      }
-      else
-      {
-        LOG_ERROR("设置后台活动限制失败，" + valueName + ": " + std::to_string(value));
-        return false;
-      }
+      values += " " + valueKey.key + ": " + std::to_string(std::get<DWORD>(isLimit ? valueKey.optimizeValue : valueKey.originValue));
+    }
+    if (isLimit)
+    {
+      result = m_registryManager->applyChangeSet(changeSetName, batch, &report);
+    }
+    else
+    {
+      // 没有原始值记录 例如在记录撤销日志之前开启的限制 使用默认的原始值
+      LOG_WARN("没有后台活动限制的原始值记录，使用默认值还原");
+      result = m_registryManager->applyBatch(batch, &report);
     }
   }
-  else
+  if (!result)
   {
-    for (const auto &valueKey : m_registryKeys["OptimizeBackgroundActivity"].keyValueList)
+    LOG_ERROR((isLimit ? "设置后台活动限制失败，" : "取消后台活动限制失败，") + report.toString() + values);
+    if (!isLimit)
     {
-      std::string valueName = valueKey.key;
-      DWORD value = std::get<DWORD>(valueKey.originValue);
-      if (m_registryManager->setRegistryDWORDValue(hRoot, subKey, valueName, value))
-      {
-        LOG_INFO("取消后台活动限制成功，" + valueName + ": " + std::to_string(value));
-      }
-      else
-      {
-        LOG_ERROR("取消后台活动限制失败，" + valueName + ": " + std::to_string(value));
-        return false;
-      }
+      // 限制仍然开启 恢复监视
+      watchRegistryOptimization(changeSetName);
     }
+    return false;
   }
-  return true;
+  LOG_INFO((isLimit ? "设置后台活动限制成功，" : "取消后台活动限制成功，") + report.toString() + values);
+  if (isLimit)
+  {
+    watchRegistryOptimization(changeSetName);
+  }
+  return scope.finish(true);
 }
 
 bool Optimizer::setOptimizeNetworkDelay(bool isOptimize)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "network_delay");
+  MetricOperationScope scope(metric);
   // 设置注册表路径：HKEY_LOCAL_MACHINE\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\Interfaces\{NIC-id}
   // 设置值：TcpAckFrequency 优化前无该值，直接删除即可，优化后为十六进制 0x00000001 十进制 1
   // 设置值：TCPNoDelay 优化前无该值，直接删除即可，优化后为十六进制 0x00000001 十进制 1
   // 设置值：TcpDelAckTicks 优化前无该值，直接删除即可，优化后为十六进制 0x00000000 十进制 0
 
-  // 先获取所有网络接口卡ID
-  std::vector<std::string> nicIds;
-  HKEY hRoot = m_registryKeys["NetworkInterfaceCardIds"].hRoot;
-  std::string subKey = m_registryKeys["NetworkInterfaceCardIds"].subKey;
-  std::string valueName = m_registryKeys["NetworkInterfaceCardIds"].keyValueList[0].key;
-
-  if (!m_registryManager->GetNetworkInterfaceCardIds(hRoot, subKey, valueName, nicIds))
-  {
-    LOG_ERROR("获取网络接口卡ID失败");
-    return false;
-  }
-
-  hRoot = m_registryKeys["OptimizeNetWorkDelay"].hRoot;
-  subKey = m_registryKeys["OptimizeNetWorkDelay"].subKey;
-
-  // 过滤掉无效的ID
-  if (!m_registryManager->filterInvalidNetworkInterfaceCardIds(hRoot, subKey, nicIds))
+  const std::string changeSetName = "OptimizeNetWorkDelay";
+  if (!isOptimize)
   {
-    LOG_ERROR("过滤无效的网络接口卡ID失败");
-    return false;
+    // 先停止监视 避免还原后被重新写入
+    m_registryWatcher->unwatch(changeSetName);
   }
-
-  if (nicIds.empty())
+  bool result = false;
+  std::string values;
+  RegistryApplyReport report;
+  if (!isOptimize && m_registryManager->hasChangeSet(changeSetName))
   {
-    LOG_ERROR("没有有效的网络接口卡ID");
-    return false;
+    // 按记录的原始值还原 包括之后被移除的网卡 不需要重新获取网卡
+    result = m_registryManager->revertChangeSet(changeSetName, &report);
+    values = "已还原为原始值，";
   }
-
-  if (isOptimize)
+  else
   {
-    // 设置注册表项
-    for (const auto &nicId : nicIds)
+    // 每个网卡的注册表项只打开一次 写入或删除全部值
+    RegistryBatch batch;
+    if (buildRegistryOptimization(changeSetName, isOptimize, batch))
     {
-      std::string keyPath = subKey + nicId;
-      for (const auto &valueKey : m_registryKeys["OptimizeNetWorkDelay"].keyValueList)
-      {
-        DWORD value = std::get<DWORD>(valueKey.optimizeValue);
-        if (!m_registryManager->setRegistryDWORDValue(hRoot, keyPath, valueKey.key, value))
-        {
-          LOG_ERROR("设置网络延迟优化失败，" + keyPath + ": " + std::to_string(value));
-          return false;
-        }
-      }
+      values = "网卡数: " + std::to_string(batch.keys().size()) + "，";
+      result = isOptimize ? m_registryManager->applyChangeSet(changeSetName, batch, &report)
+                          : m_registryManager->applyBatch(batch, &report);
     }
   }
-  else
+  if (!result)
   {
-    // 删除注册表项
-    for (const auto &nicId : nicIds)
+    LOG_ERROR((isOptimize ? "设置网络延迟优化失败，" : "删除网络延迟优化失败，") + report.toString());
+    if (!isOptimize)
     {
-      std::string keyPath = subKey + nicId;
-      for (const auto &valueKey : m_registryKeys["OptimizeNetWorkDelay"].keyValueList)
-      {
-        if (!m_registryManager->deleteRegistryValue(hRoot, keyPath, valueKey.key))
-        {
-          LOG_ERROR("删除网络延迟优化失败，" + keyPath + ": " + valueKey.key);
-          return false;
-        }
-      }
+      // 优化仍然开启 恢复监视
+      watchRegistryOptimization(changeSetName);
     }
+    return false;
   }
-
-  return true;
+  LOG_INFO((isOptimize ? "设置网络延迟优化成功，" : "删除网络延迟优化成功，") + values + report.toString());
+  if (isOptimize)
+  {
+    watchRegistryOptimization(changeSetName);
+  }
+  return scope.finish(true);
 }
 
 bool Optimizer::setSystemSchedulerOptimization(bool isOptimize)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "system_scheduler");
+  MetricOperationScope scope(metric);
   // 设置注册表路径：HKEY_LOCAL_MACHINE\SYSTEM\CurrentControlSet\Control\PriorityControl
   // 设置值：Win32PrioritySeparation 优化前为十六进制 0x00000026 十进制 38，优化后为十六进制 0x00000028 十进制 40
-  HKEY hRoot = m_registryKeys["OptimizeSystemScheduler"].hRoot;
-  std::string subKey = m_registryKeys["OptimizeSystemScheduler"].subKey;
-
-  if (isOptimize)
+  const std::string changeSetName = "OptimizeSystemScheduler";
+  if (!isOptimize)
+  {
+    // 先停止监视 避免还原后被重新写入
+    m_registryWatcher->unwatch(changeSetName);
+  }
+  bool result = false;
+  std::string values;
+  RegistryApplyReport report;
+  if (!isOptimize && m_registryManager->hasChangeSet(changeSetName))
   {
-    for (const auto &valueKey : m_registryKeys["OptimizeSystemScheduler"].keyValueList)
+    // 还原为开启前记录的原始值
+    result = m_registryManager->revertChangeSet(changeSetName, &report);
+    values = " 已还原为原始值";
+  }
+  else
+  {
+    // 同一注册表项的值只打开一次
+    RegistryBatch batch;
+    buildRegistryOptimization(changeSetName, isOptimize, batch);
+    for (const auto &valueKey : m_registryKeys.at(changeSetName).keyValueList)
     {
-      std::string valueName = valueKey.key;
-      DWORD value = std::get<DWORD>(valueKey.optimizeValue);
-      if (m_registryManager->setRegistryDWORDValue(hRoot, subKey, valueName, value))
-      {
-        LOG_INFO("设置系统调度优化成功，" + valueName + ": " + std::to_string(value));
-      }
-      else
-      {
-        LOG_ERROR("设置系统调度优化失败，" + valueName + ": " + std::to_string(value));
-        return false;
-      }
+      values += " " + valueKey.key + ": " + std::to_string(std::get<DWORD>(isOptimize ? valueKey.optimizeValue : valueKey.originValue));
+    }
+    if (isOptimize)
+    {
+      result = m_registryManager->applyChangeSet(changeSetName, batch, &report);
+    }
+    else
+    {
+      // 没有原始值记录 例如在记录撤销日志之前开启的优化 使用默认的原始值
+      LOG_WARN("没有系统调度优化的原始值记录，使用默认值还原");
+      result = m_registryManager->applyBatch(batch, &report);
     }
   }
-  else
+  if (!result)
   {
-    for (const auto &valueKey : m_registryKeys["OptimizeSystemScheduler"].keyValueList)
+    LOG_ERROR((isOptimize ? "设置系统调度优化失败，" : "取消系统调度优化失败，") + report.toString() + values);
+    if (!isOptimize)
     {
-      std::string valueName = valueKey.key;
-      DWORD value = std::get<DWORD>(valueKey.originValue);
-      if (m_registryManager->setRegistryDWORDValue(hRoot, subKey, valueName, value))
-      {
-        LOG_INFO("取消系统调度优化成功，" + valueName + ": " + std::to_string(value));
-      }
-      else
-      {
-        LOG_ERROR("取消系统调度优化失败，" + valueName + ": " + std::to_string(value));
-        return false;
-      }
+      // 优化仍然开启 恢复监视
+      watchRegistryOptimization(changeSetName);
     }
+    return false;
   }
-  return true;
+  LOG_INFO((isOptimize ? "设置系统调度优化成功，" : "取消系统调度优化成功，") + report.toString() + values);
+  if (isOptimize)
+  {
+    watchRegistryOptimization(changeSetName);
+  }
+  return scope.finish(true);
 }
 
 bool Optimizer::setSystemServiceOptimization(bool isOptimize)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "system_service");
+  MetricOperationScope scope(metric);
   if (isOptimize)
   {
     // 遍历需要优化的服务列表
     for (const auto &service : m_serviceList)
     {
+      TRACE_SCOPE_DETAIL("optimizer", "system_service_item", service.first);
       // 先检查当前服务是否正在运行
       bool status = false;
       DWORD startType = 4;
@@ -436,11 +587,26 @@ bool Optimizer::setSystemServiceOptimization(bool isOptimize)
   {
   }
 
-  return true;
+  return scope.finish(true);
 }
 
 bool Optimizer::checkGameProcessRegistry(const std::vector<std::string> &processNames)
 {
+  {
+    std::lock_guard<std::mutex> lock(m_perfOptionsMutex);
+    if (m_perfOptionsLoaded)
+    {
+      for (const auto &processName : processNames)
+      {
+        if (m_perfOptionsProcesses.find(toLowerAscii(processName)) == m_perfOptionsProcesses.end())
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+
   for (const auto &processName : processNames)
   {
     if (!m_registryManager->checkRegistryKey(m_registryKeys["GameProcessRegistry"].hRoot, m_registryKeys["GameProcessRegistry"].subKey, processName))
@@ -454,66 +620,53 @@ bool Optimizer::checkGameProcessRegistry(const std::vector<std::string> &process
 
 bool Optimizer::setGameProcessRegistry(const std::vector<std::string> &processNames, bool isOptimize)
 {
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "game_process_registry");
+  MetricOperationScope scope(metric);
   bool result = false;
 
   if (isOptimize)
   {
-    // 设置游戏进程注册表
+    // 设置游戏进程注册表 全部进程的 PerfOptions 合并为一个批次
     try
     {
+      HKEY hRoot = m_registryKeys["GameProcessRegistry"].hRoot;
+      const std::string &regPath = m_registryKeys["GameProcessRegistry"].subKey;
+      // 设置CPU\IO\Memory为高优先级
+      const DWORD cpuPriorityValue = 3;
+      const DWORD ioPriorityValue = 3;
+      const DWORD memoryPriorityValue = 3;
+
+      RegistryBatch batch;
       for (const auto &processName : processNames)
       {
-        HKEY hRoot = m_registryKeys["GameProcessRegistry"].hRoot;
-        // 创建 processName 键
-        std::string regPath = m_registryKeys["GameProcessRegistry"].subKey;
-        result = m_registryManager->createRegistryKey(hRoot, regPath, processName);
-        if (!result)
-        {
-          LOG_ERROR("注册表键创建失败: " + regPath + processName);
-        }
-
-        // 创建PerfOptions键
-        regPath += processName;
-        result = m_registryManager->createRegistryKey(hRoot, regPath, "PerfOptions");
-        if (!result)
-        {
-          LOG_ERROR("注册表键创建失败: " + regPath + "\\PerfOptions");
-        }
-
-        // 设置CPU\IO\Memory为高优先级
-        DWORD cpuPriorityValue = 3;
-        DWORD ioPriorityValue = 3;
-        DWORD memoryPriorityValue = 3;
-
-        // 设置CpuPriorityClass
-        regPath += "\\PerfOptions";
-        result = m_registryManager->setRegistryDWORDValue(hRoot, regPath, "CpuPriorityClass", cpuPriorityValue);
-        if (!result)
-        {
-          // 不一定是致命错误，继续尝试设置 IO
-          LOG_ERROR("注册表值设置失败: " + regPath + "\\CpuPriorityClass");
-        }
-
-        // 设置IoPriority
-        result = m_registryManager->setRegistryDWORDValue(hRoot, regPath, "IoPriority", ioPriorityValue);
-        if (!result)
-        {
-          // 不一定是致命错误
-          LOG_ERROR("注册表值设置失败: " + regPath + "\\IoPriority");
-        }
+        const std::string perfOptionsPath = regPath + processName + "\\PerfOptions";
+        batch.createKey(hRoot, perfOptionsPath);
+        batch.setDWORD(hRoot, perfOptionsPath, "CpuPriorityClass", cpuPriorityValue);
+        batch.setDWORD(hRoot, perfOptionsPath, "IoPriority", ioPriorityValue);
+        batch.setDWORD(hRoot, perfOptionsPath, "MemoryPriority", memoryPriorityValue);
+      }
 
-        // 设置MemoryPriority
-        result = m_registryManager->setRegistryDWORDValue(hRoot, regPath, "MemoryPriority", memoryPriorityValue);
-        if (!result)
+      RegistryApplyReport report;
+      result = m_registryManager->applyBatch(batch, &report);
+      if (!result)
+      {
+        LOG_ERROR("注册表性能选项设置失败: " + regPath + " " + report.toString());
+        return false;
+      }
+      {
+        // 不等待注册表变更通知 立即更新枚举结果
+        std::lock_guard<std::mutex> lock(m_perfOptionsMutex);
+        for (const auto &processName : processNames)
         {
-          // 不一定是致命错误
-          LOG_ERROR("注册表值设置失败: " + regPath + "\\MemoryPriority");
+          m_perfOptionsProcesses.insert(toLowerAscii(processName));
         }
-
-        // 提示设置成功 至少部分成功
+      }
+      for (const auto &processName : processNames)
+      {
         LOG_INFO("注册表性能选项设置成功: " + processName);
-        return true;
       }
+      LOG_DEBUG("注册表性能选项: " + report.toString());
+      return scope.finish(true);
     }
     catch (const std::exception &e)
     {
@@ -528,25 +681,43 @@ bool Optimizer::setGameProcessRegistry(const std::vector<std::string> &processNa
   }
   else
   {
-    // 删除游戏进程注册表
+    // 删除游戏进程注册表 全部进程合并为一个批次 项不存在时视为已删除
     try
     {
       HKEY hRoot = m_registryKeys["GameProcessRegistry"].hRoot;
-      std::string regPath = m_registryKeys["GameProcessRegistry"].subKey;
+      const std::string &regPath = m_registryKeys["GameProcessRegistry"].subKey;
+      RegistryBatch batch;
       for (const auto &processName : processNames)
       {
-        if (m_registryManager->checkRegistryKey(hRoot, regPath, processName))
+        batch.deleteKey(hRoot, regPath + processName);
+      }
+
+      RegistryApplyReport report;
+      result = m_registryManager->applyBatch(batch, &report);
+      {
+        // 每个进程对应一个报告条目 只保留删除失败的进程
+        std::lock_guard<std::mutex> lock(m_perfOptionsMutex);
+        for (size_t i = 0; i < processNames.size() && i < report.entries.size(); ++i)
         {
-          result = m_registryManager->deleteRegistryKey(hRoot, regPath, processName);
-          if (!result)
+          if (report.entries[i].status != RegistryApplyReport::Status::Failed)
           {
-            LOG_ERROR("注册表性能选项删除失败: " + processName);
-            return false;
+            m_perfOptionsProcesses.erase(toLowerAscii(processNames[i]));
           }
-          LOG_INFO("注册表性能选项删除成功: " + processName);
-          return true;
         }
       }
+      for (size_t i = 0; i < processNames.size() && i < report.entries.size(); ++i)
+      {
+        if (report.entries[i].status == RegistryApplyReport::Status::Failed)
+        {
+          LOG_ERROR("注册表性能选项删除失败: " + processNames[i]);
+        }
+        else
+        {
+          LOG_INFO("注册表性能选项删除成功: " + processNames[i]);
+        }
+      }
+      LOG_DEBUG("注册表性能选项: " + report.toString());
+      return result ? scope.finish(true) : false;
     }
     catch (const std::exception &e)
     {
@@ -562,3 +733,693 @@ bool Optimizer::setGameProcessRegistry(const std::vector<std::string> &processNa
 
   return false;
 }
+
+bool Optimizer::setBackgroundEfficiencyMode(bool isEnable,
+                                            const std::vector<std::string> &gameProcessNames,
+                                            const std::vector<std::string> &backgroundProcessNames,
+                                            bool throttleAll,
+                                            const std::map<std::string, IoPriority> &ioPriorityRules)
+{
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "background_efficiency");
+  MetricOperationScope scope(metric);
+  if (isEnable && !throttleAll && backgroundProcessNames.empty())
+  {
+    LOG_ERROR("后台进程列表为空，无法开启后台能效模式");
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    m_backgroundProcessNames = backgroundProcessNames;
+    m_throttleAllBackground = throttleAll;
+    m_backgroundIoPriorityRules = ioPriorityRules;
+  }
+  m_backgroundEfficiency = isEnable;
+
+  if (!updateSessionMonitor(gameProcessNames))
+  {
+    m_backgroundEfficiency = false;
+    return false;
+  }
+
+  if (isEnable)
+  {
+    // 监听开启前游戏已在运行
+    if (m_sessionManager->isSessionActive() && !m_backgroundManager->isEfficiencyModeApplied())
+    {
+      m_backgroundManager->applyEfficiencyMode(backgroundProcessNames, m_sessionManager->getGameProcessIds(), throttleAll, ioPriorityRules);
+    }
+    LOG_INFO("开启后台能效模式成功");
+  }
+  else
+  {
+    m_backgroundManager->revertEfficiencyMode();
+    LOG_INFO("关闭后台能效模式成功");
+  }
+  return scope.finish(true);
+}
+
+void Optimizer::setSessionCallback()
+{
+  m_sessionManager->setOnSessionStartedCallback(
+      [this](const std::wstring &processName, DWORD processId)
+      {
+        // 手动开启的追踪不重新开始 会话结束时一并导出
+        if (m_sessionTracing && !Tracing::isEnabled())
+        {
+          Tracing::start();
+        }
+        TRACE_SCOPE_DETAIL("session", "session_started", processName);
+        LOG_INFO_FMT("游戏会话开始，应用会话优化: {} PID: {}", processName, processId);
+        // 预读最先开始 尽早与游戏的首次加载并行
+        if (m_gamePrefetch)
+        {
+          ULONGLONG budgetBytes = 0;
+          std::shared_ptr<const GameDatabase> gameDatabase;
+          {
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            budgetBytes = m_prefetchBudgetBytes;
+            gameDatabase = m_gameDatabase;
+          }
+          // 数据库中标记为不预读的游戏
+          auto title = gameDatabase ? gameDatabase->find(processName) : std::nullopt;
+          if (title && (title->flags & GameDb::FlagSkipPrefetch))
+          {
+            LOG_INFO(L"游戏数据库标记为不预读，跳过预读: " + processName);
+          }
+          else
+          {
+            m_prefetchManager->startSession(processName, processId, budgetBytes);
+          }
+        }
+        if (m_backgroundEfficiency)
+        {
+          std::vector<std::string> backgroundProcessNames;
+          std::map<std::string, IoPriority> ioPriorityRules;
+          bool throttleAll = false;
+          {
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            backgroundProcessNames = m_backgroundProcessNames;
+            ioPriorityRules = m_backgroundIoPriorityRules;
+            throttleAll = m_throttleAllBackground;
+          }
+          m_backgroundManager->applyEfficiencyMode(backgroundProcessNames, m_sessionManager->getGameProcessIds(), throttleAll, ioPriorityRules);
+        }
+        if (m_trimWorkingSet)
+        {
+          trimBackgroundMemory();
+        }
+        if (m_memoryPressureResponse)
+        {
+          m_memoryPressureMonitor->start();
+        }
+      });
+
+  m_sessionManager->setOnSessionEndedCallback(
+      [this](const std::wstring &processName, DWORD)
+      {
+        {
+          TRACE_SCOPE_DETAIL("session", "session_ended", processName);
+          LOG_INFO(L"游戏会话结束，还原会话优化: " + processName);
+          m_memoryPressureMonitor->stop();
+          m_prefetchManager->stopSession();
+          m_backgroundManager->revertEfficiencyMode();
+          m_memoryManager->restoreMemoryPriority();
+        }
+        std::wstring traceFilePath;
+        if (m_sessionTracing && Tracing::isEnabled() && Tracing::stopAndExport(traceFilePath))
+        {
+          showTrayMessage("游戏会话追踪已导出到 " + QString::fromStdWString(traceFilePath));
+        }
+      });
+}
+
+bool Optimizer::updateSessionMonitor(const std::vector<std::string> &gameProcessNames)
+{
+  bool needMonitor = m_backgroundEfficiency || m_trimWorkingSet || m_memoryPressureResponse || m_gamePrefetch;
+  if (needMonitor)
+  {
+    if (m_sessionManager->isMonitoring())
+    {
+      return true;
+    }
+    if (!m_sessionManager->startMonitoring(gameProcessNames))
+    {
+      LOG_ERROR("开启游戏会话监听失败");
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_listenerMutex);
+      m_sessionListening = true;
+      m_sessionListenNames = gameProcessNames;
+    }
+    if (!updateProcessListener())
+    {
+      LOG_ERROR("监听游戏进程失败");
+      m_sessionManager->stopMonitoring();
+      {
+        std::lock_guard<std::mutex> lock(m_listenerMutex);
+        m_sessionListening = false;
+      }
+      updateProcessListener();
+      return false;
+    }
+    // 游戏可能先于监听启动
+    m_sessionManager->scanRunningGameProcesses();
+  }
+  else if (m_sessionManager->isMonitoring())
+  {
+    if (!m_sessionManager->stopMonitoring())
+    {
+      LOG_ERROR("停止游戏会话监听失败");
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_listenerMutex);
+      m_sessionListening = false;
+    }
+    // 自动限制反作弊仍需要时保留订阅
+    if (!updateProcessListener())
+    {
+      LOG_ERROR("更新进程事件订阅失败");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Optimizer::updateProcessListener()
+{
+  std::lock_guard<std::mutex> lock(m_listenerMutex);
+  const bool autoLimitAntiCheat = m_autoLimitAntiCheat;
+  if (!autoLimitAntiCheat && !m_sessionListening)
+  {
+    m_listenerProcessNames.clear();
+    if (m_processManager->isListening() && !m_processManager->stopListening())
+    {
+      LOG_ERROR("停止监听进程创建和销毁事件失败");
+      return false;
+    }
+    return true;
+  }
+
+  bool hasDatabase = false;
+  {
+    std::lock_guard<std::mutex> sessionLock(m_sessionMutex);
+    hasDatabase = m_gameDatabase && m_gameDatabase->titleCount() > 0;
+  }
+
+  // 数据库中的进程无法逐个订阅 任一方没有指定进程名时也需要所有进程 此时只订阅一个不过滤进程名的查询
+  const bool allProcesses = hasDatabase ||
+                            (autoLimitAntiCheat && m_antiCheatListenNames.empty()) ||
+                            (m_sessionListening && m_sessionListenNames.empty());
+  std::vector<std::string> processNames;
+  if (!allProcesses)
+  {
+    // 进程名不区分大小写 合并两者的进程名并去重
+    std::set<std::string> mergedNames;
+    if (autoLimitAntiCheat)
+    {
+      for (const auto &processName : m_antiCheatListenNames)
+      {
+        mergedNames.insert(toLowerAscii(processName));
+      }
+    }
+    if (m_sessionListening)
+    {
+      for (const auto &processName : m_sessionListenNames)
+      {
+        mergedNames.insert(toLowerAscii(processName));
+      }
+    }
+    processNames.assign(mergedNames.begin(), mergedNames.end());
+  }
+
+  if (m_processManager->isListening())
+  {
+    if (processNames == m_listenerProcessNames)
+    {
+      return true;
+    }
+    // 订阅的进程变化时重新订阅
+    if (!m_processManager->stopListening())
+    {
+      LOG_ERROR("停止监听进程创建和销毁事件失败");
+      return false;
+    }
+  }
+
+  if (!m_processManager->startListening(processNames))
+  {
+    m_listenerProcessNames.clear();
+    return false;
+  }
+  m_listenerProcessNames = std::move(processNames);
+  LOG_INFO_FMT("进程事件订阅已更新: {}",
+               m_listenerProcessNames.empty() ? std::string("所有进程")
+                                              : std::to_string(m_listenerProcessNames.size()) + " 个进程");
+  return true;
+}
+
+bool Optimizer::restartSessionMonitor(const std::vector<std::string> &gameProcessNames)
+{
+  if (!m_sessionManager->isMonitoring())
+  {
+    return true;
+  }
+
+  if (!m_sessionManager->stopMonitoring())
+  {
+    LOG_ERROR("停止游戏会话监听失败");
+    return false;
+  }
+  {
+    // 由 updateSessionMonitor 按新的进程名重新订阅 进程名不变时保留原订阅
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    m_sessionListening = false;
+  }
+  if (!updateSessionMonitor(gameProcessNames))
+  {
+    return false;
+  }
+  // 不再需要会话监听时只保留反作弊的订阅
+  return m_sessionManager->isMonitoring() || updateProcessListener();
+}
+
+void Optimizer::setGameDatabase(std::shared_ptr<const GameDatabase> gameDatabase)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    m_gameDatabase = gameDatabase;
+  }
+  m_sessionManager->setGameDatabase(std::move(gameDatabase));
+}
+
+void Optimizer::initRegistryOptimizations(const std::wstring &journalPath,
+                                          bool limitBackgroundActivity,
+                                          bool optimizeNetworkDelay,
+                                          bool optimizeSystemScheduling)
+{
+  // 日志损坏时已重命名为 .bad 并以空日志继续 监视和游戏进程状态不受影响
+  const bool journalLoaded = m_registryManager->setJournalPath(journalPath);
+  if (!journalLoaded)
+  {
+    LOG_ERROR(L"加载注册表撤销日志失败，使用空日志: " + journalPath);
+  }
+
+  const std::pair<const char *, bool> optimizations[] = {
+      {"OptimizeBackgroundActivity", limitBackgroundActivity},
+      {"OptimizeNetWorkDelay", optimizeNetworkDelay},
+      {"OptimizeSystemScheduler", optimizeSystemScheduling}};
+  for (const auto &[name, isEnable] : optimizations)
+  {
+    if (isEnable)
+    {
+      // 添加监视时先检查一次 上次运行以来被改回的值会重新写入
+      watchRegistryOptimization(name);
+      continue;
+    }
+    if (!journalLoaded || !m_registryManager->hasChangeSet(name))
+    {
+      continue;
+    }
+    // 写入注册表后、保存配置前崩溃时 配置中的开关仍为关闭而日志中留有记录 按记录还原
+    if (m_registryManager->revertChangeSet(name))
+    {
+      LOG_INFO("已还原未完成的注册表修改: " + std::string(name));
+    }
+    else
+    {
+      LOG_ERROR("还原未完成的注册表修改失败: " + std::string(name));
+    }
+  }
+
+  // 游戏进程的实际优化状态 添加监视时枚举一次 之后在子项创建或删除时重新枚举
+  const RegistryKey &gameProcessKey = m_registryKeys.at("GameProcessRegistry");
+  m_registryWatcher->watch(
+      "GameProcessRegistry", {{gameProcessKey.hRoot, gameProcessKey.subKey}},
+      [this](RegistryWatcher::DriftAction)
+      {
+        refreshGameProcessStatus();
+        // 只读取 不计入重新写入次数
+        return false;
+      },
+      true);
+}
+
+void Optimizer::setOnGameProcessStatusChangedCallback(std::function<void()> callback)
+{
+  m_onGameProcessStatusChangedCallback = std::move(callback);
+}
+
+void Optimizer::setSessionTracing(bool isEnable)
+{
+  m_sessionTracing = isEnable;
+  LOG_INFO(isEnable ? "开启游戏会话追踪" : "关闭游戏会话追踪");
+}
+
+bool Optimizer::setWorkingSetTrim(bool isEnable,
+                                  const std::vector<std::string> &gameProcessNames,
+                                  const std::vector<std::string> &exclusionList,
+                                  int budgetMB)
+{
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "working_set_trim");
+  MetricOperationScope scope(metric);
+  {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    m_trimExclusionList = exclusionList;
+    m_trimBudgetBytes = budgetMB > 0 ? static_cast<SIZE_T>(budgetMB) * 1024 * 1024 : 0;
+  }
+  m_trimWorkingSet = isEnable;
+
+  if (!updateSessionMonitor(gameProcessNames))
+  {
+    m_trimWorkingSet = false;
+    return false;
+  }
+
+  LOG_INFO(isEnable ? "开启游戏时回收内存成功" : "关闭游戏时回收内存成功");
+  return scope.finish(true);
+}
+
+bool Optimizer::setMemoryPressureResponse(bool isEnable,
+                                          const std::vector<std::string> &gameProcessNames,
+                                          const std::vector<std::string> &exclusionList,
+                                          int budgetMB)
+{
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "memory_pressure_response");
+  MetricOperationScope scope(metric);
+  {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    m_trimExclusionList = exclusionList;
+    m_trimBudgetBytes = budgetMB > 0 ? static_cast<SIZE_T>(budgetMB) * 1024 * 1024 : 0;
+  }
+  m_memoryPressureResponse = isEnable;
+
+  if (!updateSessionMonitor(gameProcessNames))
+  {
+    m_memoryPressureResponse = false;
+    return false;
+  }
+
+  if (isEnable)
+  {
+    // 监听开启前游戏已在运行
+    if (m_sessionManager->isSessionActive())
+    {
+      m_memoryPressureMonitor->start();
+    }
+    LOG_INFO("开启内存压力响应成功");
+  }
+  else
+  {
+    m_memoryPressureMonitor->stop();
+    m_memoryManager->restoreMemoryPriority();
+    LOG_INFO("关闭内存压力响应成功");
+  }
+  return scope.finish(true);
+}
+
+void Optimizer::setMemoryPressureCallback()
+{
+  m_memoryPressureMonitor->setOnPressureCallback(
+      [this](MemoryPressureMonitor::PressureLevel level)
+      {
+        TRACE_SCOPE("memory", "pressure_response");
+        switch (level)
+        {
+        case MemoryPressureMonitor::PressureLevel::TrimBackground:
+          trimBackgroundMemory();
+          break;
+        case MemoryPressureMonitor::PressureLevel::LowerPriority:
+        {
+          std::vector<std::string> exclusionList;
+          {
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            exclusionList = m_trimExclusionList;
+          }
+          m_memoryManager->lowerBackgroundMemoryPriority(m_sessionManager->getGameProcessIds(), exclusionList);
+          break;
+        }
+        case MemoryPressureMonitor::PressureLevel::Alert:
+          showTrayMessage("系统内存持续不足，建议关闭不需要的后台程序", QSystemTrayIcon::Warning);
+          break;
+        default:
+          break;
+        }
+      });
+}
+
+void Optimizer::trimBackgroundMemory()
+{
+  TRACE_SCOPE("memory", "trim_background");
+  std::vector<std::string> exclusionList;
+  SIZE_T budgetBytes = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    exclusionList = m_trimExclusionList;
+    budgetBytes = m_trimBudgetBytes;
+  }
+
+  TrimReport report = m_memoryManager->trimBackgroundWorkingSets(m_sessionManager->getGameProcessIds(), exclusionList, budgetBytes);
+  if (report.processCount > 0)
+  {
+    // 在游戏会话或内存压力线程中调用
+    showTrayMessage("已回收后台进程内存 " + QString::number(report.bytesReclaimed / (1024 * 1024)) + " MB，耗时 " +
+                    QString::number(report.elapsedMs, 'f', 0) + " ms");
+  }
+}
+
+void Optimizer::showTrayMessage(const QString &message, QSystemTrayIcon::MessageIcon icon)
+{
+  if (!m_trayIcon)
+  {
+    return;
+  }
+  // 托盘图标可能在通知执行前销毁 执行时再检查
+  QPointer<QSystemTrayIcon> trayIcon(m_trayIcon);
+  QMetaObject::invokeMethod(
+      QCoreApplication::instance(),
+      [trayIcon, message, icon]()
+      {
+        if (trayIcon)
+        {
+          trayIcon->showMessage("鱼腥味的游戏优化工具箱", message, icon, 5000);
+        }
+      },
+      Qt::QueuedConnection);
+}
+
+bool Optimizer::setGamePrefetch(bool isEnable,
+                                const std::vector<std::string> &gameProcessNames,
+                                const std::wstring &manifestDirectory,
+                                int budgetMB)
+{
+  static MetricOperation metric("gop_optimizer_operations", "优化开关操作", "game_prefetch");
+  MetricOperationScope scope(metric);
+  if (isEnable && manifestDirectory.empty())
+  {
+    LOG_ERROR("预读清单目录为空，无法开启游戏文件预读");
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    m_prefetchBudgetBytes = budgetMB > 0 ? static_cast<ULONGLONG>(budgetMB) * 1024 * 1024 : 0;
+  }
+  m_prefetchManager->setManifestDirectory(manifestDirectory);
+  m_gamePrefetch = isEnable;
+
+  if (!updateSessionMonitor(gameProcessNames))
+  {
+    m_gamePrefetch = false;
+    return false;
+  }
+
+  if (!isEnable)
+  {
+    m_prefetchManager->stopSession();
+  }
+  LOG_INFO(isEnable ? "开启游戏文件预读成功" : "关闭游戏文件预读成功");
+  return scope.finish(true);
+}
+
+void Optimizer::setPrefetchCallback()
+{
+  m_prefetchManager->setOnReportCallback(
+      [this](const PrefetchReport &report)
+      {
+        if (report.prefetchedFiles > 0)
+        {
+          showTrayMessage("已预读 " + QString::fromStdWString(report.gameName) + " 文件 " +
+                          QString::number(report.prefetchedBytes / (1024 * 1024)) + " MB，命中率 " +
+                          QString::number(static_cast<int>(report.hitRate * 100)) + "%");
+        }
+      });
+}
+
+bool Optimizer::buildRegistryOptimization(const std::string &name, bool isOptimize, RegistryBatch &batch)
+{
+  const RegistryKey &registryKey = m_registryKeys.at(name);
+  if (name != "OptimizeNetWorkDelay")
+  {
+    for (const auto &valueKey : registryKey.keyValueList)
+    {
+      batch.setDWORD(registryKey.hRoot, registryKey.subKey, valueKey.key,
+                     std::get<DWORD>(isOptimize ? valueKey.optimizeValue : valueKey.originValue));
+    }
+    return true;
+  }
+
+  // 网卡清单在网卡或默认路由变化前一直有效 不需要每次重新枚举
+  std::vector<NicInfo> interfaces;
+  if (!m_nicInventory->getInterfaces(interfaces))
+  {
+    LOG_ERROR("没有有效的网络接口卡ID");
+    return false;
+  }
+
+  // 优化时只写入实际联网的网卡 断网等没有默认路由的情况下写入全部网卡
+  // 删除时处理全部网卡 不遗漏之前联网的网卡
+  const bool hasDefaultRoute = std::any_of(interfaces.begin(), interfaces.end(),
+                                           [](const NicInfo &nic)
+                                           { return nic.hasDefaultRoute; });
+  std::vector<std::string> nicIds;
+  for (const auto &nic : interfaces)
+  {
+    if (isOptimize && hasDefaultRoute && !nic.hasDefaultRoute)
+    {
+      continue;
+    }
+    nicIds.push_back(nic.interfaceId);
+  }
+
+  for (const auto &nicId : nicIds)
+  {
+    std::string keyPath = registryKey.subKey + nicId;
+    for (const auto &valueKey : registryKey.keyValueList)
+    {
+      if (isOptimize)
+      {
+        batch.setDWORD(registryKey.hRoot, keyPath, valueKey.key, std::get<DWORD>(valueKey.optimizeValue));
+      }
+      else
+      {
+        // 没有原始值记录 按优化前没有这些值处理 删除即可
+        batch.deleteValue(registryKey.hRoot, keyPath, valueKey.key);
+      }
+    }
+  }
+  return true;
+}
+
+void Optimizer::watchRegistryOptimization(const std::string &name)
+{
+  RegistryBatch batch;
+  if (!buildRegistryOptimization(name, true, batch))
+  {
+    LOG_WARN("无法监视注册表优化: " + name);
+    return;
+  }
+
+  m_registryWatcher->watch(
+      name, batch.keys(),
+      [this, name](RegistryWatcher::DriftAction action)
+      {
+        // 每次检查重新生成 网络延迟优化会覆盖新增或开始联网的网卡
+        RegistryBatch batch;
+        if (!buildRegistryOptimization(name, true, batch))
+        {
+          return false;
+        }
+        // 网卡变化后改为监视新的网卡注册表项 没有变化时不重新注册
+        const bool keysChanged = m_registryWatcher->updateKeys(name, batch.keys());
+
+        RegistryApplyReport report;
+        if (action == RegistryWatcher::DriftAction::Report && !keysChanged)
+        {
+          if (m_registryManager->compareBatch(batch, report))
+          {
+            return false;
+          }
+          LOG_WARN_FMT("注册表优化已被改回 {} 项，暂不重新写入: {}",
+                       report.count(RegistryApplyReport::Status::Changed), name);
+          return true;
+        }
+
+        // 已是目标状态时不写入 也不打开写句柄
+        // 只有用户开启时才记录原始值 没有记录时 (例如旧版本开启的优化) 直接写入
+        // 否则会把已经优化过的值记录为原始值 关闭时无法还原
+        const bool result = m_registryManager->hasChangeSet(name)
+                                ? m_registryManager->applyChangeSet(name, batch, &report)
+                                : m_registryManager->applyBatch(batch, &report);
+        if (report.count(RegistryApplyReport::Status::Unchanged) == report.entries.size())
+        {
+          return false;
+        }
+        if (!result)
+        {
+          LOG_ERROR("重新写入被改回的注册表优化失败: " + name + "，" + report.toString());
+          return true;
+        }
+        if (keysChanged)
+        {
+          // 写入新联网的网卡不是偏离 不计入重新写入次数
+          LOG_INFO("网卡变化，已写入注册表优化: " + name + "，" + report.toString());
+          return false;
+        }
+        LOG_WARN("注册表优化已被改回，已重新写入: " + name + "，" + report.toString());
+        return true;
+      });
+}
+
+void Optimizer::setRegistryWatcherCallback()
+{
+  m_registryWatcher->setOnThrottledCallback(
+      [this](const std::string &name)
+      {
+        // 在注册表监视线程中调用
+        const QString optimization = name == "OptimizeBackgroundActivity" ? "后台活动限制"
+                                     : name == "OptimizeNetWorkDelay"     ? "网络延迟优化"
+                                                                          : "系统调度优化";
+        showTrayMessage(optimization + "被其他程序反复改回，已暂停自动恢复", QSystemTrayIcon::Warning);
+      });
+}
+
+void Optimizer::setNicInventoryCallback()
+{
+  m_nicInventory->setOnChangedCallback(
+      [this]()
+      {
+        // 未开启网络延迟优化时忽略 检查时从失效的清单重新枚举网卡
+        m_registryWatcher->check("OptimizeNetWorkDelay");
+      });
+}
+
+bool Optimizer::refreshGameProcessStatus()
+{
+  TRACE_SCOPE("optimizer", "refresh_game_process_status");
+  const RegistryKey &registryKey = m_registryKeys.at("GameProcessRegistry");
+  std::unordered_set<std::string> processNames;
+  if (!m_registryManager->getSubKeysWithChild(registryKey.hRoot, registryKey.subKey, "PerfOptions", processNames))
+  {
+    LOG_ERROR("枚举游戏进程注册表性能选项失败");
+    return false;
+  }
+
+  bool changed = false;
+  size_t count = processNames.size();
+  {
+    std::lock_guard<std::mutex> lock(m_perfOptionsMutex);
+    changed = !m_perfOptionsLoaded || processNames != m_perfOptionsProcesses;
+    m_perfOptionsProcesses = std::move(processNames);
+    m_perfOptionsLoaded = true;
+  }
+  LOG_DEBUG_FMT("已设置注册表性能选项的进程: {} 个", count);
+
+  if (changed && m_onGameProcessStatusChangedCallback)
+  {
+    m_onGameProcessStatusChangedCallback();
+  }
+  return true;
+}
@@ -7,8 +7,12 @@
  * @Description:
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
+#define LOG_MODULE Logging::Module::Power
+
 #include "core/power_manager.h"
 
+#include "metrics/metrics.h"
+
 PowerManager::PowerManager()
 {
 }
@@ -19,6 +23,8 @@ PowerManager::~PowerManager()
 
 bool PowerManager::createPowerPlan(GUID *newPowerPlanGuid, const TCHAR *planName, const TCHAR *planDescription)
 {
+  static MetricOperation metric("gop_power_operations", "电源计划操作", "create_plan");
+  MetricOperationScope scope(metric);
   // 复制Windows高性能电源计划作为基础
   if (PowerDuplicateScheme(NULL, &m_GUID_HIGH_PERFORMANCE, &newPowerPlanGuid) != ERROR_SUCCESS)
   {
@@ -40,22 +46,26 @@ bool PowerManager::createPowerPlan(GUID *newPowerPlanGuid, const TCHAR *planName
     PowerDeleteScheme(NULL, newPowerPlanGuid);
     return false;
   }
-  return true;
+  return scope.finish(true);
 }
 
 bool PowerManager::deletePowerPlan(GUID *powerPlanGuid)
 {
+  static MetricOperation metric("gop_power_operations", "电源计划操作", "delete_plan");
+  MetricOperationScope scope(metric);
   // 先将活动电源计划设置为平衡，再删除
   if (PowerSetActiveScheme(NULL, &m_GUID_BALANCE) != ERROR_SUCCESS)
   {
     LOG_ERROR("Failed to set active power scheme.");
     return false;
   }
-  return PowerDeleteScheme(NULL, powerPlanGuid) == ERROR_SUCCESS;
+  return scope.finish(PowerDeleteScheme(NULL, powerPlanGuid) == ERROR_SUCCESS);
 }
 
 bool PowerManager::optimizePowerPlan(GUID *powerPlanGuid)
 {
+  static MetricOperation metric("gop_power_operations", "电源计划操作", "optimize_plan");
+  MetricOperationScope scope(metric);
   for (auto &powerPlanSubGroup : m_powerPlanSubGroupArray)
   {
     for (auto &powerPlanSubGroupItem : powerPlanSubGroup.second)
@@ -75,11 +85,13 @@ bool PowerManager::optimizePowerPlan(GUID *powerPlanGuid)
       }
     }
   }
-  return true;
+  return scope.finish(true);
 }
 
 bool PowerManager::setPowerPlanActive(GUID *powerPlanGuid)
 {
+  static MetricOperation metric("gop_power_operations", "电源计划操作", "set_active");
+  MetricOperationScope scope(metric);
   // 设置活动电源计划
   DWORD result = PowerSetActiveScheme(NULL, powerPlanGuid);
   if (result != ERROR_SUCCESS)
@@ -87,5 +99,5 @@ bool PowerManager::setPowerPlanActive(GUID *powerPlanGuid)
     LOG_ERROR("Failed to set active power scheme.");
     return false;
   }
-  return true;
+  return scope.finish(true);
 }
\ No newline at end of file
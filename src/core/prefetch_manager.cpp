@@ -0,0 +1,531 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:33:41
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:33:41
+ * @FilePath: \GameOptimizerPro\src\core\prefetch_manager.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include "core/prefetch_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cwctype>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+#include "metrics/tracing.h"
+
+namespace
+{
+  // 清单文件头
+  constexpr const char *kManifestHeader = "GOPF 1";
+
+  std::wstring toLower(std::wstring str)
+  {
+    std::transform(str.begin(), str.end(), str.begin(), [](wchar_t c)
+                   { return static_cast<wchar_t>(std::towlower(c)); });
+    return str;
+  }
+
+  /**
+   * @brief 逐页读取映射视图 等待预读完成
+   * @note 文件在映射期间被截断时会触发 EXCEPTION_IN_PAGE_ERROR，此处吞掉异常并返回 false
+   */
+  bool touchPages(const volatile char *base, SIZE_T size, SIZE_T pageSize)
+  {
+    __try
+    {
+      for (SIZE_T offset = 0; offset < size; offset += pageSize)
+      {
+        (void)base[offset];
+      }
+      return true;
+    }
+    __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+    {
+      return false;
+    }
+  }
+}
+
+PrefetchManager::PrefetchManager(const std::wstring &manifestDirectory)
+    : m_manifestDirectory(manifestDirectory)
+{
+  // Manual-reset, initially non-signaled
+  m_stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  if (m_stopEvent == nullptr)
+  {
+    LOG_HRESULT(L"创建预读停止事件失败", HRESULT_FROM_WIN32(GetLastError()));
+  }
+}
+
+PrefetchManager::~PrefetchManager()
+{
+  stopSession();
+  if (m_stopEvent)
+  {
+    CloseHandle(m_stopEvent);
+    m_stopEvent = nullptr;
+  }
+}
+
+void PrefetchManager::setManifestDirectory(const std::wstring &manifestDirectory)
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  m_manifestDirectory = manifestDirectory;
+}
+
+bool PrefetchManager::startSession(const std::wstring &gameName, DWORD processId, ULONGLONG budgetBytes)
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (m_isRunning.load())
+  {
+    return true;
+  }
+
+  if (!m_stopEvent || m_manifestDirectory.empty())
+  {
+    LOG_ERROR("预读停止事件或清单目录无效，无法开始预读");
+    return false;
+  }
+
+  // 上一次会话的工作线程已自然结束
+  if (m_workerThread.joinable())
+  {
+    m_workerThread.join();
+  }
+
+  ResetEvent(m_stopEvent);
+  try
+  {
+    m_workerThread = std::thread([this, gameName, processId, budgetBytes]()
+                                 { runSession(gameName, processId, budgetBytes); });
+  }
+  catch (const std::system_error &e)
+  {
+    LOG_ERROR("启动预读线程失败: " + std::string(e.what()));
+    return false;
+  }
+
+  m_isRunning = true;
+  return true;
+}
+
+void PrefetchManager::stopSession()
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (m_stopEvent)
+  {
+    SetEvent(m_stopEvent);
+  }
+  if (m_workerThread.joinable())
+  {
+    try
+    {
+      m_workerThread.join();
+    }
+    catch (const std::system_error &e)
+    {
+      LOG_ERROR("等待预读线程结束失败: " + std::string(e.what()));
+    }
+  }
+  m_isRunning = false;
+}
+
+void PrefetchManager::setOnReportCallback(ReportCallback callback)
+{
+  m_onReportCallback = std::move(callback);
+}
+
+void PrefetchManager::runSession(std::wstring gameName, DWORD processId, ULONGLONG budgetBytes)
+{
+  Tracing::setThreadName("prefetch");
+  PrefetchReport report;
+  report.gameName = gameName;
+  const std::wstring manifestPath = getManifestPath(gameName);
+
+  // 1. 按上次记录的清单预读
+  std::vector<ManifestEntry> manifest;
+  std::map<std::wstring, ULONGLONG> prefetched;
+  if (loadManifest(manifestPath, manifest))
+  {
+    TRACE_SCOPE_DETAIL("prefetch", "prefetch_files", gameName);
+    prefetchFiles(manifest, budgetBytes, report, prefetched);
+    LOG_INFO(L"预读游戏文件完成: " + gameName + L" 文件数: " + std::to_wstring(report.prefetchedFiles) +
+             L" 预读: " + std::to_wstring(report.prefetchedBytes / (1024 * 1024)) + L" MB" +
+             L" 耗时: " + std::to_wstring(report.prefetchElapsedMs) + L" ms");
+  }
+  else
+  {
+    LOG_INFO(L"没有找到预读清单，本次仅学习: " + gameName);
+  }
+
+  // 2. 在学习窗口内采样游戏进程映射的文件
+  std::vector<ManifestEntry> learned;
+  HANDLE hProcess = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+  if (hProcess == NULL)
+  {
+    // 受保护的游戏进程可能拒绝访问 保留旧清单
+    LOG_HRESULT(L"无法打开游戏进程进行学习: " + gameName, HRESULT_FROM_WIN32(GetLastError()));
+  }
+  else
+  {
+    TRACE_SCOPE_DETAIL("prefetch", "learn_mapped_files", gameName);
+    const auto learnStart = std::chrono::steady_clock::now();
+    while (true)
+    {
+      collectMappedFiles(hProcess, learned);
+
+      auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - learnStart).count();
+      if (elapsedMs >= kLearningWindowMs || learned.size() >= kMaxManifestEntries)
+      {
+        break;
+      }
+
+      HANDLE handles[] = {m_stopEvent, hProcess};
+      DWORD waitResult = WaitForMultipleObjects(ARRAYSIZE(handles), handles, FALSE, kSampleIntervalMs);
+      if (waitResult != WAIT_TIMEOUT)
+      {
+        // 收到停止信号或游戏进程已退出
+        break;
+      }
+    }
+    CloseHandle(hProcess);
+  }
+
+  // 3. 计算命中率并写回清单
+  if (!learned.empty())
+  {
+    if (learned.size() > kMaxManifestEntries)
+    {
+      learned.resize(kMaxManifestEntries);
+    }
+
+    report.usedFiles = learned.size();
+    for (const auto &entry : learned)
+    {
+      report.usedBytes += entry.size;
+      auto it = prefetched.find(toLower(entry.path));
+      if (it != prefetched.end())
+      {
+        report.hitBytes += it->second;
+      }
+    }
+    report.hitRate = report.prefetchedBytes > 0 ? static_cast<double>(report.hitBytes) / report.prefetchedBytes : 0.0;
+    report.coverage = report.usedBytes > 0 ? static_cast<double>(report.hitBytes) / report.usedBytes : 0.0;
+
+    if (!saveManifest(manifestPath, learned))
+    {
+      LOG_ERROR(L"保存预读清单失败: " + manifestPath);
+    }
+  }
+
+  LOG_INFO(L"预读会话结束: " + gameName +
+           L" 命中率: " + std::to_wstring(static_cast<int>(report.hitRate * 100)) + L"%" +
+           L" 覆盖率: " + std::to_wstring(static_cast<int>(report.coverage * 100)) + L"%" +
+           L" 学习文件数: " + std::to_wstring(report.usedFiles));
+
+  if (m_onReportCallback)
+  {
+    m_onReportCallback(report);
+  }
+}
+
+void PrefetchManager::prefetchFiles(const std::vector<ManifestEntry> &manifest, ULONGLONG budgetBytes,
+                                    PrefetchReport &report, std::map<std::wstring, ULONGLONG> &prefetched)
+{
+  const auto startTime = std::chrono::steady_clock::now();
+
+  SYSTEM_INFO sysInfo;
+  GetSystemInfo(&sysInfo);
+  const SIZE_T pageSize = sysInfo.dwPageSize;
+
+  // 当前批次中已映射的视图
+  struct MappedView
+  {
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+    HANDLE hMapping = NULL;
+    void *view = nullptr;
+    SIZE_T size = 0;
+    std::wstring path;
+  };
+  std::vector<MappedView> batch;
+  ULONGLONG batchBytes = 0;
+
+  // 提交一批预读并等待完成
+  auto flushBatch = [&]()
+  {
+    if (batch.empty())
+    {
+      return;
+    }
+
+    std::vector<WIN32_MEMORY_RANGE_ENTRY> ranges;
+    for (const auto &mappedView : batch)
+    {
+      ranges.push_back({mappedView.view, mappedView.size});
+    }
+    if (!PrefetchVirtualMemory(GetCurrentProcess(), ranges.size(), ranges.data(), 0))
+    {
+      LOG_HRESULT(L"PrefetchVirtualMemory 失败", HRESULT_FROM_WIN32(GetLastError()));
+    }
+
+    for (auto &mappedView : batch)
+    {
+      if (touchPages(static_cast<const volatile char *>(mappedView.view), mappedView.size, pageSize))
+      {
+        prefetched[toLower(mappedView.path)] = mappedView.size;
+        report.prefetchedBytes += mappedView.size;
+        ++report.prefetchedFiles;
+      }
+      UnmapViewOfFile(mappedView.view);
+      CloseHandle(mappedView.hMapping);
+      CloseHandle(mappedView.hFile);
+    }
+    batch.clear();
+    batchBytes = 0;
+  };
+
+  ULONGLONG plannedBytes = 0;
+  for (const auto &entry : manifest)
+  {
+    if (WaitForSingleObject(m_stopEvent, 0) == WAIT_OBJECT_0)
+    {
+      break;
+    }
+    if (budgetBytes != 0 && plannedBytes >= budgetBytes)
+    {
+      report.budgetReached = true;
+      break;
+    }
+
+    MappedView mappedView;
+    mappedView.path = entry.path;
+    mappedView.hFile = CreateFileW(entry.path.c_str(), GENERIC_READ,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mappedView.hFile == INVALID_HANDLE_VALUE)
+    {
+      // 文件已被删除或移动 下次学习时会从清单中移除
+      continue;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mappedView.hFile, &fileSize) || fileSize.QuadPart == 0)
+    {
+      CloseHandle(mappedView.hFile);
+      continue;
+    }
+
+    ULONGLONG bytesToPrefetch = static_cast<ULONGLONG>(fileSize.QuadPart);
+    if (budgetBytes != 0)
+    {
+      bytesToPrefetch = (std::min)(bytesToPrefetch, budgetBytes - plannedBytes);
+    }
+
+    mappedView.hMapping = CreateFileMappingW(mappedView.hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mappedView.hMapping == NULL)
+    {
+      CloseHandle(mappedView.hFile);
+      continue;
+    }
+
+    mappedView.size = static_cast<SIZE_T>(bytesToPrefetch);
+    mappedView.view = MapViewOfFile(mappedView.hMapping, FILE_MAP_READ, 0, 0, mappedView.size);
+    if (mappedView.view == nullptr)
+    {
+      CloseHandle(mappedView.hMapping);
+      CloseHandle(mappedView.hFile);
+      continue;
+    }
+
+    plannedBytes += bytesToPrefetch;
+    batchBytes += bytesToPrefetch;
+    batch.push_back(std::move(mappedView));
+
+    // 控制在途 I/O 的总量
+    if (batchBytes >= kBatchBytes)
+    {
+      flushBatch();
+    }
+  }
+  flushBatch();
+
+  report.prefetchElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void PrefetchManager::collectMappedFiles(HANDLE hProcess, std::vector<ManifestEntry> &files)
+{
+  const auto dosDevices = getDosDevices();
+
+  wchar_t windowsDirectory[MAX_PATH] = {};
+  GetWindowsDirectoryW(windowsDirectory, MAX_PATH);
+  const std::wstring windowsDirectoryLower = toLower(windowsDirectory);
+
+  std::unordered_set<std::wstring> knownFiles;
+  for (const auto &entry : files)
+  {
+    knownFiles.insert(toLower(entry.path));
+  }
+
+  MEMORY_BASIC_INFORMATION mbi;
+  const char *address = nullptr;
+  const void *lastAllocationBase = nullptr;
+  while (VirtualQueryEx(hProcess, address, &mbi, sizeof(mbi)) == sizeof(mbi))
+  {
+    address = static_cast<const char *>(mbi.BaseAddress) + mbi.RegionSize;
+
+    // 只关心映射的镜像和数据文件 同一分配只处理一次
+    if (mbi.State != MEM_COMMIT || (mbi.Type != MEM_IMAGE && mbi.Type != MEM_MAPPED) ||
+        mbi.AllocationBase == lastAllocationBase)
+    {
+      continue;
+    }
+    lastAllocationBase = mbi.AllocationBase;
+
+    wchar_t devicePath[MAX_PATH * 2] = {};
+    if (GetMappedFileNameW(hProcess, mbi.BaseAddress, devicePath, ARRAYSIZE(devicePath)) == 0)
+    {
+      continue;
+    }
+
+    std::wstring dosPath = devicePathToDosPath(devicePath, dosDevices);
+    if (dosPath.empty())
+    {
+      continue;
+    }
+
+    // 系统文件常驻缓存 无需记录
+    std::wstring dosPathLower = toLower(dosPath);
+    if (dosPathLower.rfind(windowsDirectoryLower, 0) == 0 || knownFiles.count(dosPathLower))
+    {
+      continue;
+    }
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(dosPath.c_str(), GetFileExInfoStandard, &attributes))
+    {
+      continue;
+    }
+
+    ManifestEntry entry;
+    entry.path = dosPath;
+    entry.size = (static_cast<ULONGLONG>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    files.push_back(std::move(entry));
+    knownFiles.insert(std::move(dosPathLower));
+  }
+}
+
+std::wstring PrefetchManager::devicePathToDosPath(const std::wstring &devicePath,
+                                                  const std::vector<std::pair<std::wstring, std::wstring>> &dosDevices)
+{
+  for (const auto &dosDevice : dosDevices)
+  {
+    const std::wstring &deviceName = dosDevice.second;
+    if (devicePath.size() > deviceName.size() &&
+        _wcsnicmp(devicePath.c_str(), deviceName.c_str(), deviceName.size()) == 0 &&
+        devicePath[deviceName.size()] == L'\\')
+    {
+      return dosDevice.first + devicePath.substr(deviceName.size());
+    }
+  }
+  return L"";
+}
+
+std::vector<std::pair<std::wstring, std::wstring>> PrefetchManager::getDosDevices()
+{
+  std::vector<std::pair<std::wstring, std::wstring>> dosDevices;
+
+  wchar_t drives[512] = {};
+  DWORD length = GetLogicalDriveStringsW(ARRAYSIZE(drives) - 1, drives);
+  if (length == 0 || length >= ARRAYSIZE(drives))
+  {
+    LOG_HRESULT(L"获取逻辑驱动器失败", HRESULT_FROM_WIN32(GetLastError()));
+    return dosDevices;
+  }
+
+  for (const wchar_t *drive = drives; *drive; drive += wcslen(drive) + 1)
+  {
+    // "C:\" -> "C:"
+    std::wstring driveName(drive, 2);
+    wchar_t deviceName[MAX_PATH] = {};
+    if (QueryDosDeviceW(driveName.c_str(), deviceName, MAX_PATH) > 0)
+    {
+      dosDevices.emplace_back(driveName, deviceName);
+    }
+  }
+  return dosDevices;
+}
+
+std::wstring PrefetchManager::getManifestPath(const std::wstring &gameName) const
+{
+  return (std::filesystem::path(m_manifestDirectory) / (toLower(gameName) + L".manifest")).wstring();
+}
+
+bool PrefetchManager::loadManifest(const std::wstring &manifestPath, std::vector<ManifestEntry> &manifest)
+{
+  std::ifstream file(std::filesystem::path(manifestPath), std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kManifestHeader)
+  {
+    LOG_ERROR(L"预读清单格式无效: " + manifestPath);
+    return false;
+  }
+
+  // 每行格式: 文件大小<TAB>UTF-8 路径
+  while (std::getline(file, line))
+  {
+    size_t tab = line.find('\t');
+    if (tab == std::string::npos)
+    {
+      continue;
+    }
+    ManifestEntry entry;
+    entry.size = std::strtoull(line.substr(0, tab).c_str(), nullptr, 10);
+    entry.path = MultiByteToWide(line.substr(tab + 1));
+    if (!entry.path.empty())
+    {
+      manifest.push_back(std::move(entry));
+    }
+  }
+  return !manifest.empty();
+}
+
+bool PrefetchManager::saveManifest(const std::wstring &manifestPath, const std::vector<ManifestEntry> &manifest)
+{
+  try
+  {
+    auto dirPath = std::filesystem::path(manifestPath).parent_path();
+    if (!dirPath.empty() && !std::filesystem::exists(dirPath))
+    {
+      std::filesystem::create_directories(dirPath);
+    }
+  }
+  catch (const std::filesystem::filesystem_error &e)
+  {
+    LOG_ERROR("创建预读清单目录失败: " + std::string(e.what()));
+    return false;
+  }
+
+  std::ofstream file(std::filesystem::path(manifestPath), std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  file << kManifestHeader << "\n";
+  for (const auto &entry : manifest)
+  {
+    file << entry.size << "\t" << WideToMultiByte(entry.path) << "\n";
+  }
+  return file.good();
+}
@@ -8,8 +8,13 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 
+#define LOG_MODULE Logging::Module::Process
+
 #include "core/process_manager.h"
 
+#include "metrics/metrics.h"
+#include "metrics/tracing.h"
+
 ProcessManager::ProcessManager()
     : m_pLoc(nullptr),
       m_pSvc(nullptr),
@@ -351,6 +356,8 @@ bool ProcessManager::registerForEvents(const std::vector<std::string> &processNa
   // 通用查询语言
   _bstr_t bstrQueryLanguage = L"WQL";
 
+  // 每个进程名对应一个过滤条件 列表为空时不加过滤 监听所有进程
+  std::vector<std::wstring> procNamesWs;
   for (const auto &procName : processNames)
   {
     std::wstring procNameWs = MultiByteToWide(procName);
@@ -360,10 +367,21 @@ bool ProcessManager::registerForEvents(const std::vector<std::string> &processNa
       allRegistered = false;
       continue;
     }
+    procNamesWs.push_back(procNameWs);
+  }
+  if (processNames.empty())
+  {
+    procNamesWs.push_back(L"");
+  }
+
+  for (const auto &procNameWs : procNamesWs)
+  {
+    const std::wstring nameFilter = procNameWs.empty() ? L"" : L" AND TargetInstance.Name='" + procNameWs + L"'";
+    const std::wstring procLabel = procNameWs.empty() ? L"<all processes>" : procNameWs;
 
     // 1. 注册进程创建事件
     std::wstringstream wssCreate;
-    wssCreate << L"SELECT * FROM __InstanceCreationEvent WITHIN 1 WHERE TargetInstance ISA 'Win32_Process' AND TargetInstance.Name='" << procNameWs << L"'";
+    wssCreate << L"SELECT * FROM __InstanceCreationEvent WITHIN 1 WHERE TargetInstance ISA 'Win32_Process'" << nameFilter;
     _bstr_t bstrCreateQuery = wssCreate.str().c_str();
 
     hr = m_pSvc->ExecNotificationQueryAsync(
@@ -375,18 +393,18 @@ bool ProcessManager::registerForEvents(const std::vector<std::string> &processNa
     );
     if (FAILED(hr))
     {
-      handleError(hr, L"ExecNotificationQueryAsync for process creation failed for: " + procNameWs);
+      handleError(hr, L"ExecNotificationQueryAsync for process creation failed for: " + procLabel);
       LOG_HRESULT(L"ProcessManager: ExecNotificationQueryAsync for process creation failed in listener thread", hr);
       allRegistered = false;
     }
     else
     {
-      LOG_INFO(L"Successfully registered for CREATION events for: " + procNameWs);
+      LOG_INFO(L"Successfully registered for CREATION events for: " + procLabel);
     }
 
     // 2. 注册进程销毁事件
     std::wstringstream wssDelete;
-    wssDelete << L"SELECT * FROM __InstanceDeletionEvent WITHIN 1 WHERE TargetInstance ISA 'Win32_Process' AND TargetInstance.Name='" << procNameWs << L"'";
+    wssDelete << L"SELECT * FROM __InstanceDeletionEvent WITHIN 1 WHERE TargetInstance ISA 'Win32_Process'" << nameFilter;
     _bstr_t bstrDeleteQuery = wssDelete.str().c_str();
 
     hr = m_pSvc->ExecNotificationQueryAsync(
@@ -397,13 +415,13 @@ bool ProcessManager::registerForEvents(const std::vector<std::string> &processNa
         m_pStubSink);
     if (FAILED(hr))
     {
-      handleError(hr, L"ExecNotificationQueryAsync for process deletion failed for: " + procNameWs);
+      handleError(hr, L"ExecNotificationQueryAsync for process deletion failed for: " + procLabel);
       LOG_HRESULT(L"ProcessManager: ExecNotificationQueryAsync for process deletion failed in listener thread", hr);
       allRegistered = false;
     }
     else
     {
-      LOG_INFO(L"Successfully registered for DELETION events for: " + procNameWs);
+      LOG_INFO(L"Successfully registered for DELETION events for: " + procLabel);
     }
   }
   return allRegistered;
@@ -411,7 +429,7 @@ bool ProcessManager::registerForEvents(const std::vector<std::string> &processNa
 
 void ProcessManager::runListenerLoop(std::vector<std::string> processNames)
 {
-
+  Tracing::setThreadName("wmi_listener");
   bool comInitializedInThisThread = false;
 
   // 初始化COM (MTA), WMI, EventSink
@@ -741,7 +759,7 @@ void ProcessManager::handleError(HRESULT errorCode, const std::wstring &errorMes
   // and the error is RPC_E_DISCONNECTED, it's likely due to the shutdown process.
   if (errorCode == RPC_E_DISCONNECTED && m_stopGlobalRequested.load())
   {
-    LOG_WARN("WMI Disconnected (RPC_E_DISCONNECTED) during shutdown process. This is likely expected.");
+    LOG_WARN_LIMITED("WMI Disconnected (RPC_E_DISCONNECTED) during shutdown process. This is likely expected.", errorCode);
     // Optionally, call the user's error callback anyway, or just log and return.
     // For now, just log and return to avoid redundant error spam during shutdown.
     if (m_onErrorCallback)
@@ -752,8 +770,16 @@ void ProcessManager::handleError(HRESULT errorCode, const std::wstring &errorMes
     return;
   }
 
+  static MetricCounter &errors = MetricsRegistry::instance().counter("gop_process_wmi_errors", "WMI 监听错误数", {{"source", "wmi_call"}});
+  errors.inc();
+
   _com_error err(errorCode);
-  LOG_HRESULT(L"ErrorMessage: " + errorMessage + L"WMI Error", errorCode);
+  // WMI 故障时同一错误会连续出现 限流避免日志风暴
+  LOG_HRESULT_FMT_LIMITED(errorCode, "ErrorMessage: {} WMI Error", errorMessage);
+  // 保留出错前的调试日志 转储有最小间隔
+  char detail[64];
+  snprintf(detail, sizeof(detail), "WMI error 0x%08X", static_cast<unsigned int>(errorCode));
+  Logging::dumpFlightRecorder(Logging::DumpTrigger::Error, detail);
 
   // 如果用户设置了错误回调则触发 / Trigger the user's error callback if set
   // 加锁以保护回调调用，如果回调可能来自不同线程（虽然这里主要在监听线程内）/ Protect callback access
@@ -820,6 +846,12 @@ bool ProcessManager::isListening() const
 
 void ProcessManager::triggerProcessCreatedCallback(const std::wstring &processName, DWORD processId)
 {
+  static MetricCounter &events = MetricsRegistry::instance().counter("gop_process_events", "收到的 WMI 进程事件数", {{"event", "created"}});
+  static MetricHistogram &duration = MetricsRegistry::instance().histogram("gop_process_event_handling_duration_seconds", "进程事件回调耗时 秒", {{"event", "created"}});
+  events.inc();
+  MetricTimer timer(duration);
+  TRACE_SCOPE_DETAIL("process", "process_created", processName);
+
   // 保护回调
   std::lock_guard<std::mutex> lock(m_callbackMutex);
   if (m_onProcessCreatedCallback)
@@ -847,6 +879,12 @@ void ProcessManager::triggerProcessCreatedCallback(const std::wstring &processNa
 
 void ProcessManager::triggerProcessDestroyedCallback(const std::wstring &processName, DWORD processId)
 {
+  static MetricCounter &events = MetricsRegistry::instance().counter("gop_process_events", "收到的 WMI 进程事件数", {{"event", "destroyed"}});
+  static MetricHistogram &duration = MetricsRegistry::instance().histogram("gop_process_event_handling_duration_seconds", "进程事件回调耗时 秒", {{"event", "destroyed"}});
+  events.inc();
+  MetricTimer timer(duration);
+  TRACE_SCOPE_DETAIL("process", "process_destroyed", processName);
+
   // 保护回调
   std::lock_guard<std::mutex> lock(m_callbackMutex);
   if (m_onProcessDestroyedCallback)
@@ -872,6 +910,9 @@ void ProcessManager::triggerProcessDestroyedCallback(const std::wstring &process
 
 void ProcessManager::triggerErrorCallback(long errorCode)
 {
+  static MetricCounter &errors = MetricsRegistry::instance().counter("gop_process_wmi_errors", "WMI 监听错误数", {{"source", "listener"}});
+  errors.inc();
+
   // 保护回调
   std::lock_guard<std::mutex> lock(m_callbackMutex);
   if (m_onErrorCallback)
@@ -893,13 +934,14 @@ void ProcessManager::triggerErrorCallback(long errorCode)
   {
     // 默认错误处理
     _com_error err(errorCode);
-    LOG_ERROR(L"[Default ERROR] WMI Error: HRESULT=0x" + std::to_wstring(errorCode) +
-              L", Message: " + std::wstring(err.ErrorMessage()));
+    LOG_HRESULT_FMT_LIMITED(errorCode, "[Default ERROR] WMI Error, Message: {}", err.ErrorMessage());
   }
 }
 
 bool ProcessManager::restrictAntiCheatProcess(const std::wstring &processName, DWORD processId)
 {
+  static MetricOperation metric("gop_process_restrictions", "反作弊进程限制", "priority_affinity");
+  MetricOperationScope scope(metric);
   // 检查PID是否为0
   if (processId == 0)
   {
@@ -955,7 +997,7 @@ bool ProcessManager::restrictAntiCheatProcess(const std::wstring &processName, D
 
       CloseHandle(hProcess);
       // 两个都设置成功才返回 true
-      return prioritySet && affinitySet;
+      return scope.finish(prioritySet && affinitySet);
     }
     else
     {
@@ -1020,4 +1062,36 @@ bool ProcessManager::restrictAntiCheatProcessPS(const std::wstring &processName,
   }
 
   return false;
-}
\ No newline at end of file
+}
+
+bool ProcessManager::restrictProcessIoPriority(const std::wstring &processName, DWORD processId, ULONG ioPriority)
+{
+  static MetricOperation metric("gop_process_restrictions", "反作弊进程限制", "io_priority");
+  MetricOperationScope scope(metric);
+  // 检查PID是否为0
+  if (processId == 0)
+  {
+    LOG_ERROR(L"进程ID无效: " + processName);
+    return false;
+  }
+
+  HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+  if (hProcess == NULL)
+  {
+    LOG_HRESULT(L"无法打开进程 " + processName + L" PID: " + std::to_wstring(processId) + L" 设置 I/O 优先级", GetLastError());
+    return false;
+  }
+
+  bool result = setProcessIoPriority(hProcess, ioPriority);
+  CloseHandle(hProcess);
+
+  if (result)
+  {
+    LOG_INFO(L"设置进程 " + processName + L" PID: " + std::to_wstring(processId) + L" I/O 优先级为: " + std::to_wstring(ioPriority));
+  }
+  else
+  {
+    LOG_ERROR(L"设置进程 " + processName + L" PID: " + std::to_wstring(processId) + L" I/O 优先级失败");
+  }
+  return scope.finish(result);
+}
@@ -0,0 +1,166 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 22:44:05
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 22:44:05
+ * @FilePath: \GameOptimizerPro\src\core\registry_backend.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "core/registry_backend.h"
+
+#include <ktmw32.h>
+
+namespace
+{
+  // 事务超时 超时后未提交的事务由系统回滚
+  constexpr DWORD kTransactionTimeoutMs = 30000;
+} // namespace
+
+std::string normalizeRegistryPath(const std::string &path)
+{
+  std::string normalized;
+  normalized.reserve(path.size());
+  for (char c : path)
+  {
+    if (c == '\\')
+    {
+      // 去掉开头和重复的分隔符
+      if (!normalized.empty() && normalized.back() != '\\')
+      {
+        normalized += '\\';
+      }
+      continue;
+    }
+    // 注册表路径只按 ASCII 忽略大小写
+    normalized += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+  if (!normalized.empty() && normalized.back() == '\\')
+  {
+    normalized.pop_back();
+  }
+  return normalized;
+}
+
+LONG Win32RegistryBackend::openKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result)
+{
+  return RegOpenKeyExA(hKey, subKey.c_str(), 0, access, &result);
+}
+
+LONG Win32RegistryBackend::createKey(HKEY hKey, const std::string &subKey, REGSAM access, HKEY &result)
+{
+  return RegCreateKeyExA(hKey, subKey.c_str(), 0, NULL, REG_OPTION_NON_VOLATILE, access, NULL, &result, NULL);
+}
+
+LONG Win32RegistryBackend::closeKey(HKEY hKey)
+{
+  return RegCloseKey(hKey);
+}
+
+LONG Win32RegistryBackend::queryValue(HKEY hKey, const std::string &valueName, DWORD &type, std::vector<BYTE> &data)
+{
+  DWORD size = 0;
+  LONG result = RegQueryValueExA(hKey, valueName.c_str(), nullptr, &type, nullptr, &size);
+  // 两次调用之间值可能被其他程序改大
+  while (result == ERROR_SUCCESS || result == ERROR_MORE_DATA)
+  {
+    data.resize(size);
+    result = RegQueryValueExA(hKey, valueName.c_str(), nullptr, &type, data.empty() ? nullptr : data.data(), &size);
+    if (result == ERROR_SUCCESS)
+    {
+      data.resize(size);
+      break;
+    }
+  }
+  return result;
+}
+
+LONG Win32RegistryBackend::setValue(HKEY hKey, const std::string &valueName, DWORD type, const BYTE *data, DWORD size)
+{
+  return RegSetValueExA(hKey, valueName.c_str(), 0, type, data, size);
+}
+
+LONG Win32RegistryBackend::deleteValue(HKEY hKey, const std::string &valueName)
+{
+  return RegDeleteValueA(hKey, valueName.c_str());
+}
+
+LONG Win32RegistryBackend::deleteTree(HKEY hKey, const std::string &subKey)
+{
+  HKEY hTargetKey;
+  LONG result = RegOpenKeyExA(hKey, subKey.c_str(), 0, KEY_ALL_ACCESS, &hTargetKey);
+  if (result != ERROR_SUCCESS)
+  {
+    return result;
+  }
+
+  // 递归删除子项（兼容旧版Windows）
+  result = RegDeleteTreeA(hTargetKey, nullptr);
+  RegCloseKey(hTargetKey);
+  if (result != ERROR_SUCCESS)
+  {
+    return result;
+  }
+
+  // 删除目标项自身
+  return RegDeleteKeyExA(hKey, subKey.c_str(), KEY_WOW64_64KEY, 0);
+}
+
+LONG Win32RegistryBackend::enumSubKey(HKEY hKey, DWORD index, std::string &name)
+{
+  // 注册表项名称最长 255 个字符
+  CHAR buffer[256];
+  DWORD length = ARRAYSIZE(buffer);
+  LONG result = RegEnumKeyExA(hKey, index, buffer, &length, nullptr, nullptr, nullptr, nullptr);
+  if (result == ERROR_SUCCESS)
+  {
+    name.assign(buffer, length);
+  }
+  return result;
+}
+
+LONG Win32RegistryBackend::queryKeyInfo(HKEY hKey)
+{
+  return RegQueryInfoKeyA(hKey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+}
+
+LONG Win32RegistryBackend::saveKey(HKEY hKey, const std::string &filePath)
+{
+  return RegSaveKeyA(hKey, filePath.c_str(), NULL);
+}
+
+LONG Win32RegistryBackend::restoreKey(HKEY hKey, const std::string &filePath)
+{
+  return RegRestoreKeyA(hKey, filePath.c_str(), 0);
+}
+
+HANDLE Win32RegistryBackend::beginTransaction()
+{
+  wchar_t description[] = L"GameOptimizerPro registry change set";
+  HANDLE transaction = CreateTransaction(nullptr, nullptr, 0, 0, 0, kTransactionTimeoutMs, description);
+  return transaction == INVALID_HANDLE_VALUE ? nullptr : transaction;
+}
+
+LONG Win32RegistryBackend::commitTransaction(HANDLE transaction)
+{
+  LONG result = CommitTransaction(transaction) ? ERROR_SUCCESS : static_cast<LONG>(GetLastError());
+  CloseHandle(transaction);
+  return result;
+}
+
+LONG Win32RegistryBackend::rollbackTransaction(HANDLE transaction)
+{
+  LONG result = RollbackTransaction(transaction) ? ERROR_SUCCESS : static_cast<LONG>(GetLastError());
+  CloseHandle(transaction);
+  return result;
+}
+
+LONG Win32RegistryBackend::createKeyTransacted(HKEY hKey, const std::string &subKey, REGSAM access, HANDLE transaction, HKEY &result)
+{
+  return RegCreateKeyTransactedA(hKey, subKey.c_str(), 0, NULL, REG_OPTION_NON_VOLATILE, access, NULL, &result, NULL, transaction, nullptr);
+}
+
+LONG Win32RegistryBackend::openKeyTransacted(HKEY hKey, const std::string &subKey, REGSAM access, HANDLE transaction, HKEY &result)
+{
+  return RegOpenKeyTransactedA(hKey, subKey.c_str(), 0, access, &result, transaction, nullptr);
+}
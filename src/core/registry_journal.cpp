@@ -0,0 +1,257 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:52:31
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:52:31
+ * @FilePath: \GameOptimizerPro\src\core\registry_journal.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#define LOG_MODULE Logging::Module::Registry
+
+#include "core/registry_journal.h"
+
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include "log/logging.h"
+#include "utils/system_utils.h"
+
+namespace
+{
+  constexpr int kJournalVersion = 1;
+
+  const std::pair<HKEY, const char *> kRootNames[] = {
+      {HKEY_CLASSES_ROOT, "HKEY_CLASSES_ROOT"},
+      {HKEY_CURRENT_USER, "HKEY_CURRENT_USER"},
+      {HKEY_LOCAL_MACHINE, "HKEY_LOCAL_MACHINE"},
+      {HKEY_USERS, "HKEY_USERS"},
+      {HKEY_CURRENT_CONFIG, "HKEY_CURRENT_CONFIG"}};
+
+  const char *rootToName(HKEY hRoot)
+  {
+    for (const auto &root : kRootNames)
+    {
+      if (root.first == hRoot)
+      {
+        return root.second;
+      }
+    }
+    return nullptr;
+  }
+
+  HKEY nameToRoot(const std::string &name)
+  {
+    for (const auto &root : kRootNames)
+    {
+      if (name == root.second)
+      {
+        return root.first;
+      }
+    }
+    return nullptr;
+  }
+
+  std::string bytesToHex(const std::vector<BYTE> &data)
+  {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(data.size() * 2);
+    for (BYTE byte : data)
+    {
+      hex += digits[byte >> 4];
+      hex += digits[byte & 0x0f];
+    }
+    return hex;
+  }
+
+  bool hexToBytes(const std::string &hex, std::vector<BYTE> &data)
+  {
+    auto nibble = [](char c) -> int
+    {
+      if (c >= '0' && c <= '9')
+        return c - '0';
+      if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+      return -1;
+    };
+    if (hex.size() % 2 != 0)
+    {
+      return false;
+    }
+    data.clear();
+    data.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2)
+    {
+      const int high = nibble(hex[i]);
+      const int low = nibble(hex[i + 1]);
+      if (high < 0 || low < 0)
+      {
+        return false;
+      }
+      data.push_back(static_cast<BYTE>((high << 4) | low));
+    }
+    return true;
+  }
+} // namespace
+
+bool RegistryJournal::load(const std::wstring &filePath)
+{
+  m_filePath = filePath;
+  m_changeSets.clear();
+
+  bool result = true;
+  {
+    std::ifstream file(std::filesystem::path(filePath), std::ios::binary);
+    if (!file.is_open())
+    {
+      // 还没有写入过变更集
+      return true;
+    }
+
+    try
+    {
+      const nlohmann::json json = nlohmann::json::parse(file);
+      if (json.value("version", 0) != kJournalVersion)
+      {
+        LOG_ERROR_FMT("注册表撤销日志版本不受支持: {}", json.value("version", 0));
+        result = false;
+      }
+      std::map<std::string, std::vector<RegistryValueSnapshot>> changeSets;
+      for (const auto &[name, entries] : json.at("changeSets").items())
+      {
+        if (!result)
+        {
+          break;
+        }
+        std::vector<RegistryValueSnapshot> &snapshots = changeSets[name];
+        for (const auto &entry : entries)
+        {
+          RegistryValueSnapshot snapshot;
+          snapshot.hRoot = nameToRoot(entry.at("root").get<std::string>());
+          snapshot.subKey = entry.at("subKey").get<std::string>();
+          snapshot.valueName = entry.at("valueName").get<std::string>();
+          snapshot.existed = entry.at("existed").get<bool>();
+          snapshot.type = entry.value("type", static_cast<DWORD>(REG_NONE));
+          if (!snapshot.hRoot || !hexToBytes(entry.value("data", std::string()), snapshot.data))
+          {
+            LOG_ERROR("注册表撤销日志记录无效: " + name + " " + snapshot.subKey + "\\" + snapshot.valueName);
+            result = false;
+            break;
+          }
+          snapshots.push_back(std::move(snapshot));
+        }
+      }
+      if (result)
+      {
+        m_changeSets = std::move(changeSets);
+      }
+    }
+    catch (const std::exception &e)
+    {
+      LOG_ERROR("解析注册表撤销日志失败: " + std::string(e.what()));
+      result = false;
+    }
+  }
+
+  if (!result)
+  {
+    // 保留无法解析的文件供手动还原 之后的记录写入新文件
+    const std::wstring badPath = filePath + L".bad";
+    if (MoveFileExW(filePath.c_str(), badPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+      LOG_WARN(L"无法解析的注册表撤销日志已重命名为: " + badPath);
+    }
+    return false;
+  }
+
+  LOG_INFO_FMT("已加载注册表撤销日志: {} 个变更集", m_changeSets.size());
+  return true;
+}
+
+const std::vector<RegistryValueSnapshot> *RegistryJournal::find(const std::string &name) const
+{
+  auto it = m_changeSets.find(name);
+  return it == m_changeSets.end() ? nullptr : &it->second;
+}
+
+bool RegistryJournal::put(const std::string &name, const std::vector<RegistryValueSnapshot> &snapshots)
+{
+  auto changeSets = m_changeSets;
+  changeSets[name] = snapshots;
+  if (!save(changeSets))
+  {
+    return false;
+  }
+  m_changeSets = std::move(changeSets);
+  return true;
+}
+
+bool RegistryJournal::erase(const std::string &name)
+{
+  if (m_changeSets.find(name) == m_changeSets.end())
+  {
+    return true;
+  }
+  auto changeSets = m_changeSets;
+  changeSets.erase(name);
+  if (!save(changeSets))
+  {
+    return false;
+  }
+  m_changeSets = std::move(changeSets);
+  return true;
+}
+
+bool RegistryJournal::save(const std::map<std::string, std::vector<RegistryValueSnapshot>> &changeSets) const
+{
+  if (m_filePath.empty())
+  {
+    return true;
+  }
+
+  std::string content;
+  try
+  {
+    nlohmann::json json;
+    json["version"] = kJournalVersion;
+    json["changeSets"] = nlohmann::json::object();
+    for (const auto &[name, snapshots] : changeSets)
+    {
+      nlohmann::json entries = nlohmann::json::array();
+      for (const auto &snapshot : snapshots)
+      {
+        const char *root = rootToName(snapshot.hRoot);
+        if (!root)
+        {
+          LOG_ERROR("注册表撤销日志不支持该根键: " + snapshot.subKey);
+          return false;
+        }
+        entries.push_back({{"root", root},
+                           {"subKey", snapshot.subKey},
+                           {"valueName", snapshot.valueName},
+                           {"existed", snapshot.existed},
+                           {"type", snapshot.type},
+                           {"data", bytesToHex(snapshot.data)}});
+      }
+      json["changeSets"][name] = std::move(entries);
+    }
+    content = json.dump(2);
+  }
+  catch (const std::exception &e)
+  {
+    LOG_ERROR("序列化注册表撤销日志失败: " + std::string(e.what()));
+    return false;
+  }
+
+  // 写临时文件并刷盘后替换 任何时刻日志文件都是完整的
+  if (!writeFileAtomically(m_filePath, content))
+  {
+    LOG_ERROR(L"写入注册表撤销日志失败: " + m_filePath);
+    return false;
+  }
+  return true;
+}
@@ -7,28 +7,133 @@
  * @Description:
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
+#define LOG_MODULE Logging::Module::Registry
+
 #include "core/registry_manager.h"
 
-RegistryManager::RegistryManager()
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_set>
+
+#include "metrics/metrics.h"
+
+namespace
+{
+  // 缓存和分组使用的键 根键数值加规范化的路径
+  std::string registryKeyId(HKEY hRoot, const std::string &subKey)
+  {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%llx\\", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(hRoot)));
+    return buffer + normalizeRegistryPath(subKey);
+  }
+
+  // 值的标识 值名称不区分大小写 可以包含反斜杠 用换行分隔
+  std::string registryValueId(HKEY hRoot, const std::string &subKey, const std::string &valueName)
+  {
+    std::string id = registryKeyId(hRoot, subKey) + '\n';
+    for (char c : valueName)
+    {
+      id += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    return id;
+  }
+} // namespace
+
+// ---- RegistryBatch ----
+
+void RegistryBatch::createKey(HKEY hRoot, const std::string &subKey)
+{
+  m_operations.push_back(Operation{OperationType::CreateKey, hRoot, subKey, std::string(), REG_NONE, {}});
+}
+
+void RegistryBatch::setDWORD(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD value)
+{
+  const BYTE *bytes = reinterpret_cast<const BYTE *>(&value);
+  setValue(hRoot, subKey, valueName, REG_DWORD, std::vector<BYTE>(bytes, bytes + sizeof(value)));
+}
+
+void RegistryBatch::setString(HKEY hRoot, const std::string &subKey, const std::string &valueName, const std::string &value)
+{
+  // REG_SZ 的数据包含结尾的空字符
+  std::vector<BYTE> data(value.begin(), value.end());
+  data.push_back(0);
+  setValue(hRoot, subKey, valueName, REG_SZ, std::move(data));
+}
+
+void RegistryBatch::setValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD type, std::vector<BYTE> data)
+{
+  m_operations.push_back(Operation{OperationType::SetValue, hRoot, subKey, valueName, type, std::move(data)});
+}
+
+void RegistryBatch::deleteValue(HKEY hRoot, const std::string &subKey, const std::string &valueName)
+{
+  m_operations.push_back(Operation{OperationType::DeleteValue, hRoot, subKey, valueName, REG_NONE, {}});
+}
+
+void RegistryBatch::deleteKey(HKEY hRoot, const std::string &subKey)
+{
+  m_operations.push_back(Operation{OperationType::DeleteKey, hRoot, subKey, std::string(), REG_NONE, {}});
+}
+
+std::vector<std::pair<HKEY, std::string>> RegistryBatch::keys() const
+{
+  std::vector<std::pair<HKEY, std::string>> result;
+  std::unordered_set<std::string> seen;
+  for (const auto &operation : m_operations)
+  {
+    if (seen.insert(registryKeyId(operation.hRoot, operation.subKey)).second)
+    {
+      result.emplace_back(operation.hRoot, operation.subKey);
+    }
+  }
+  return result;
+}
+
+// ---- RegistryApplyReport ----
+
+size_t RegistryApplyReport::count(Status status) const
+{
+  return static_cast<size_t>(std::count_if(entries.begin(), entries.end(), [status](const Entry &entry)
+                                           { return entry.status == status; }));
+}
+
+std::string RegistryApplyReport::toString() const
+{
+  return "修改 " + std::to_string(count(Status::Changed)) + " 项，未变 " + std::to_string(count(Status::Unchanged)) +
+         " 项，失败 " + std::to_string(count(Status::Failed)) + " 项";
+}
+
+// ---- RegistryManager ----
+
+RegistryManager::RegistryManager(std::unique_ptr<RegistryBackend> backend)
+    : m_backend(backend ? std::move(backend) : std::make_unique<Win32RegistryBackend>())
 {
 }
 
 RegistryManager::~RegistryManager()
 {
+  std::lock_guard<std::mutex> lock(m_keyCacheMutex);
+  for (const auto &cached : m_keyCache)
+  {
+    m_backend->closeKey(cached.hKey);
+  }
+  m_keyCache.clear();
+  m_keyCacheIndex.clear();
 }
 
 bool RegistryManager::backupRegistryKey(HKEY hRoot, const std::string &subKey, const std::string &backupFile)
 {
   HKEY hKey;
-  LONG result = RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_READ, &hKey);
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_READ, hKey);
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("打开注册表项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
 
-  result = RegSaveKeyA(hKey, backupFile.c_str(), NULL);
-  RegCloseKey(hKey);
+  result = m_backend->saveKey(hKey, backupFile);
+  m_backend->closeKey(hKey);
 
   if (result != ERROR_SUCCESS)
   {
@@ -41,15 +146,15 @@ bool RegistryManager::backupRegistryKey(HKEY hRoot, const std::string &subKey, c
 bool RegistryManager::restoreRegistryKey(HKEY hRoot, const std::string &subKey, const std::string &backupFile)
 {
   HKEY hKey;
-  LONG result = RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_WRITE, &hKey);
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_WRITE, hKey);
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("打开注册表项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
 
-  result = RegRestoreKeyA(hKey, backupFile.c_str(), 0);
-  RegCloseKey(hKey);
+  result = m_backend->restoreKey(hKey, backupFile);
+  m_backend->closeKey(hKey);
 
   if (result != ERROR_SUCCESS)
   {
@@ -61,172 +166,771 @@ bool RegistryManager::restoreRegistryKey(HKEY hRoot, const std::string &subKey,
 
 bool RegistryManager::createRegistryKey(HKEY hRoot, const std::string &subKey, const std::string &keyName)
 {
-  HKEY hKey;
-  LONG result = RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_WRITE, &hKey);
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "create_key");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, subKey + "\\" + keyName);
+  // 父项必须已经存在 在父项句柄下创建子项
+  HKEY hParentKey;
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_WRITE, hParentKey);
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("打开父项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
-  std::string keyPath = subKey + "\\" + keyName;
-  result = RegCreateKeyExA(hRoot, keyPath.c_str(), 0, NULL, REG_OPTION_NON_VOLATILE, KEY_WRITE, NULL, &hKey, NULL);
-  RegCloseKey(hKey);
+  HKEY hKey;
+  result = m_backend->createKey(hParentKey, keyName, KEY_WRITE, hKey);
+  m_backend->closeKey(hParentKey);
   if (result != ERROR_SUCCESS)
   {
-    LOG_HRESULT("创建注册表项失败: " + keyPath + " 错误: ", HRESULT_FROM_WIN32(result));
+    LOG_HRESULT("创建注册表项失败: " + subKey + "\\" + keyName + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
-  return true;
+  m_backend->closeKey(hKey);
+  return scope.finish(true);
 }
 
 bool RegistryManager::setRegistryDWORDValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD value)
 {
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "set_dword");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, subKey + "\\" + valueName);
   HKEY hKey;
-  LONG result = RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_WRITE, &hKey);
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_WRITE, hKey);
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("打开注册表项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
 
-  result = RegSetValueExA(hKey, valueName.c_str(), 0, REG_DWORD, reinterpret_cast<const BYTE *>(&value), sizeof(value));
-  RegCloseKey(hKey);
+  result = m_backend->setValue(hKey, valueName, REG_DWORD, reinterpret_cast<const BYTE *>(&value), sizeof(value));
+  m_backend->closeKey(hKey);
 
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("设置注册表值失败: " + valueName + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
-  return true;
+  return scope.finish(true);
 }
 
 bool RegistryManager::setRegistryStringValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, const std::string &value)
 {
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "set_string");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, subKey + "\\" + valueName);
   HKEY hKey;
-  LONG result = RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_WRITE, &hKey);
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_WRITE, hKey);
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("打开注册表项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
 
-  result = RegSetValueExA(hKey, valueName.c_str(), 0, REG_SZ, reinterpret_cast<const BYTE *>(value.c_str()), static_cast<DWORD>(value.size()));
-  RegCloseKey(hKey);
+  // REG_SZ 的数据长度包含结尾的空字符
+  result = m_backend->setValue(hKey, valueName, REG_SZ, reinterpret_cast<const BYTE *>(value.c_str()), static_cast<DWORD>(value.size() + 1));
+  m_backend->closeKey(hKey);
 
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("设置注册表值失败: " + valueName + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
-  return true;
+  return scope.finish(true);
 }
 
 bool RegistryManager::deleteRegistryKey(HKEY hRoot, const std::string &subKey, const std::string &keyName)
 {
-  // 打开父注册表项
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "delete_key");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, subKey + keyName);
   std::string keyPath = subKey + keyName;
-  HKEY hParentKey;
-  LONG result = RegOpenKeyExA(
-      hRoot,
-      keyPath.c_str(),
-      0,
-      KEY_ALL_ACCESS,
-      &hParentKey);
-
-  if (result != ERROR_SUCCESS)
   {
-    LOG_HRESULT("打开注册表项失败: " + keyPath + " 错误: ", HRESULT_FROM_WIN32(result));
-    return false;
+    // 释放被删除项的缓存句柄
+    std::lock_guard<std::mutex> lock(m_keyCacheMutex);
+    evictCachedKeys(hRoot, keyPath);
   }
 
-  // 递归删除子项（兼容旧版Windows）
-  result = RegDeleteTreeA(hParentKey, nullptr);
+  LONG result = m_backend->deleteTree(hRoot, keyPath);
   if (result != ERROR_SUCCESS)
   {
-    RegCloseKey(hParentKey);
-    LOG_HRESULT("删除注册表项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
+    LOG_HRESULT("删除注册表项失败: " + keyPath + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
-
-  RegCloseKey(hParentKey);
-
-  // 删除目标项自身
-  result = RegDeleteKeyExA(
-      hRoot,
-      keyPath.c_str(),
-      KEY_WOW64_64KEY, // 显式指定64位视图
-      0);
-
-  return (result == ERROR_SUCCESS);
+  return scope.finish(true);
 }
 
 bool RegistryManager::deleteRegistryValue(HKEY hRoot, const std::string &subKey, const std::string &valueName)
 {
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "delete_value");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, subKey + "\\" + valueName);
   HKEY hKey;
-  LONG result = RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_WRITE, &hKey);
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_WRITE, hKey);
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("打开注册表项失败: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
 
-  result = RegDeleteValueA(hKey, valueName.c_str());
-  RegCloseKey(hKey);
+  result = m_backend->deleteValue(hKey, valueName);
+  m_backend->closeKey(hKey);
 
   if (result != ERROR_SUCCESS)
   {
     LOG_HRESULT("删除注册表值失败: " + valueName + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
-  return true;
+  return scope.finish(true);
 }
 
 bool RegistryManager::checkRegistryKey(HKEY hRoot, const std::string &subKey, const std::string &keyName)
 {
-  HKEY hKey;
   std::string keyPath = subKey + keyName;
-  LONG result = RegOpenKeyExA(hRoot, keyPath.c_str(), 0, KEY_READ, &hKey);
-  RegCloseKey(hKey);
+  LONG result = readWithCachedKey(hRoot, keyPath, [this](HKEY hKey)
+                                  { return m_backend->queryKeyInfo(hKey); });
+  return result == ERROR_SUCCESS;
+}
+
+bool RegistryManager::getRegistryDWORDValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, DWORD &value)
+{
+  DWORD type = REG_NONE;
+  std::vector<BYTE> data;
+  LONG result = readWithCachedKey(hRoot, subKey, [&](HKEY hKey)
+                                  { return m_backend->queryValue(hKey, valueName, type, data); });
+  if (result != ERROR_SUCCESS || type != REG_DWORD || data.size() != sizeof(DWORD))
+  {
+    return false;
+  }
+  std::copy(data.begin(), data.end(), reinterpret_cast<BYTE *>(&value));
+  return true;
+}
+
+bool RegistryManager::getRegistryStringValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, std::string &value)
+{
+  DWORD type = REG_NONE;
+  std::vector<BYTE> data;
+  LONG result = readWithCachedKey(hRoot, subKey, [&](HKEY hKey)
+                                  { return m_backend->queryValue(hKey, valueName, type, data); });
+  if (result != ERROR_SUCCESS || (type != REG_SZ && type != REG_EXPAND_SZ))
+  {
+    return false;
+  }
+  // 数据不一定以空字符结尾
+  value.assign(data.begin(), data.end());
+  while (!value.empty() && value.back() == '\0')
+  {
+    value.pop_back();
+  }
+  return true;
+}
+
+bool RegistryManager::applyBatch(const RegistryBatch &batch, RegistryApplyReport *report)
+{
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "apply_batch");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, std::to_string(batch.size()) + " operations");
+
+  RegistryApplyReport localReport;
+  RegistryApplyReport &result = report ? *report : localReport;
+  result.entries.clear();
+
+  RegistryBatch pending;
+  std::vector<size_t> entryIndex;
+  planBatch(batch, pending, entryIndex, result, nullptr);
+  if (pending.empty())
+  {
+    return scope.finish(true);
+  }
+
+  std::vector<bool> failed;
+  const bool allApplied = writeBatch(pending, nullptr, false, &failed);
+  markFailed(entryIndex, failed, result);
+  return scope.finish(allApplied);
+}
+
+bool RegistryManager::compareBatch(const RegistryBatch &batch, RegistryApplyReport &report)
+{
+  report.entries.clear();
+  RegistryBatch pending;
+  std::vector<size_t> entryIndex;
+  planBatch(batch, pending, entryIndex, report, nullptr);
+  return report.count(RegistryApplyReport::Status::Changed) == 0;
+}
+
+bool RegistryManager::setJournalPath(const std::wstring &filePath)
+{
+  std::lock_guard<std::mutex> lock(m_changeSetMutex);
+  return m_journal.load(filePath);
+}
+
+bool RegistryManager::applyChangeSet(const std::string &name, const RegistryBatch &batch, RegistryApplyReport *report)
+{
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "apply_change_set");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, name);
+  std::lock_guard<std::mutex> lock(m_changeSetMutex);
+
+  RegistryApplyReport localReport;
+  RegistryApplyReport &result = report ? *report : localReport;
+  result.entries.clear();
+
+  // 读取写入前的值 同时去掉已经是目标状态的操作 写入前的值在失败时用于补偿
+  RegistryBatch pending;
+  std::vector<size_t> entryIndex;
+  std::vector<RegistryValueSnapshot> before;
+  if (!planBatch(batch, pending, entryIndex, result, &before))
+  {
+    LOG_ERROR("读取原始值失败，未修改注册表: " + name);
+    return false;
+  }
+
+  // 已有记录时保留最早的原始值 例如重复开启或网卡增加 只补充新出现的值
+  const std::vector<RegistryValueSnapshot> *recordedSnapshots = m_journal.find(name);
+  const bool hadRecord = recordedSnapshots != nullptr;
+  std::vector<RegistryValueSnapshot> original = hadRecord ? *recordedSnapshots : std::vector<RegistryValueSnapshot>();
+  const size_t recordedCount = original.size();
+  std::unordered_set<std::string> recordedIds;
+  for (const auto &snapshot : original)
+  {
+    recordedIds.insert(registryValueId(snapshot.hRoot, snapshot.subKey, snapshot.valueName));
+  }
+  for (const auto &snapshot : before)
+  {
+    if (recordedIds.insert(registryValueId(snapshot.hRoot, snapshot.subKey, snapshot.valueName)).second)
+    {
+      original.push_back(snapshot);
+    }
+  }
+
+  // 先写日志再写注册表 写入中途崩溃时日志里已有原始值
+  if ((!hadRecord || original.size() != recordedCount) && !m_journal.put(name, original))
+  {
+    LOG_ERROR("写入注册表撤销日志失败，未修改注册表: " + name);
+    for (auto &entry : result.entries)
+    {
+      if (entry.status == RegistryApplyReport::Status::Changed)
+      {
+        entry.status = RegistryApplyReport::Status::Failed;
+      }
+    }
+    return false;
+  }
+
+  if (pending.empty())
+  {
+    LOG_DEBUG("注册表变更集已是目标状态: " + name);
+    return scope.finish(true);
+  }
+
+  std::vector<bool> failed;
+  if (!writeAtomically(pending, &before, &failed))
+  {
+    markFailed(entryIndex, failed, result);
+    LOG_ERROR("注册表变更集写入失败，已还原为写入前的值: " + name);
+    // 撤销日志回到写入前的记录
+    original.resize(recordedCount);
+    if (!(hadRecord ? m_journal.put(name, original) : m_journal.erase(name)))
+    {
+      LOG_WARN("恢复注册表撤销日志失败: " + name);
+    }
+    return false;
+  }
+
+  LOG_DEBUG_FMT("注册表变更集写入成功: {} 记录原始值 {} 个 {}", name, original.size(), result.toString());
+  return scope.finish(true);
+}
+
+bool RegistryManager::revertChangeSet(const std::string &name, RegistryApplyReport *report)
+{
+  static MetricOperation metric("gop_registry_operations", "注册表写操作", "revert_change_set");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, name);
+  std::lock_guard<std::mutex> lock(m_changeSetMutex);
+
+  RegistryApplyReport localReport;
+  RegistryApplyReport &result = report ? *report : localReport;
+  result.entries.clear();
+
+  const std::vector<RegistryValueSnapshot> *original = m_journal.find(name);
+  if (!original)
+  {
+    LOG_WARN("没有注册表变更集的原始值记录: " + name);
+    return false;
+  }
+
+  // 按记录的逆序还原
+  RegistryBatch batch;
+  for (auto it = original->rbegin(); it != original->rend(); ++it)
+  {
+    if (it->existed)
+    {
+      batch.setValue(it->hRoot, it->subKey, it->valueName, it->type, it->data);
+    }
+    else
+    {
+      batch.deleteValue(it->hRoot, it->subKey, it->valueName);
+    }
+  }
+
+  RegistryBatch pending;
+  std::vector<size_t> entryIndex;
+  planBatch(batch, pending, entryIndex, result, nullptr);
+
+  // 还原失败时保留记录 再次撤销即可 不需要补偿
+  std::vector<bool> failed;
+  if (!pending.empty() && !writeAtomically(pending, nullptr, &failed))
+  {
+    markFailed(entryIndex, failed, result);
+    LOG_ERROR("还原注册表变更集失败: " + name);
+    return false;
+  }
+  if (!m_journal.erase(name))
+  {
+    // 注册表已经还原 记录残留只会导致再次写入相同的原始值
+    LOG_WARN("删除注册表撤销日志记录失败: " + name);
+  }
+  LOG_DEBUG_FMT("注册表变更集已还原: {} {}", name, result.toString());
+  return scope.finish(true);
+}
+
+bool RegistryManager::hasChangeSet(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(m_changeSetMutex);
+  return m_journal.find(name) != nullptr;
+}
+
+bool RegistryManager::planBatch(const RegistryBatch &batch, RegistryBatch &pending, std::vector<size_t> &entryIndex,
+                                RegistryApplyReport &report, std::vector<RegistryValueSnapshot> *before)
+{
+  using OperationType = RegistryBatch::OperationType;
+
+  struct ValueState
+  {
+    RegistryValueSnapshot snapshot;
+    // 读取出错时状态未知 总是写入
+    bool known = true;
+  };
+  // key: 值的标识 value: 执行完前面的操作后该值的状态
+  std::unordered_map<std::string, ValueState> states;
+
+  for (const auto &operation : batch.m_operations)
+  {
+    if (operation.type == OperationType::CreateKey)
+    {
+      // 项已存在时不需要创建 同一项的写入操作通过打开的句柄执行
+      LONG result = readWithCachedKey(operation.hRoot, operation.subKey, [](HKEY)
+                                      { return static_cast<LONG>(ERROR_SUCCESS); });
+      if (result != ERROR_SUCCESS)
+      {
+        pending.m_operations.push_back(operation);
+        entryIndex.push_back(SIZE_MAX);
+      }
+      continue;
+    }
+
+    if (operation.type == OperationType::DeleteKey)
+    {
+      // 撤销日志只记录值 无法还原整棵子树
+      if (before)
+      {
+        LOG_ERROR("变更集不支持删除注册表项: " + operation.subKey);
+        return false;
+      }
+      LONG result = readWithCachedKey(operation.hRoot, operation.subKey, [](HKEY)
+                                      { return static_cast<LONG>(ERROR_SUCCESS); });
+      const bool unchanged = result == ERROR_FILE_NOT_FOUND;
+      report.entries.push_back(RegistryApplyReport::Entry{operation.hRoot, operation.subKey, std::string(),
+                                                          unchanged ? RegistryApplyReport::Status::Unchanged : RegistryApplyReport::Status::Changed});
+      if (!unchanged)
+      {
+        pending.m_operations.push_back(operation);
+        entryIndex.push_back(report.entries.size() - 1);
+      }
+      continue;
+    }
+
+    const std::string id = registryValueId(operation.hRoot, operation.subKey, operation.valueName);
+    auto it = states.find(id);
+    if (it == states.end())
+    {
+      ValueState state;
+      if (!captureValue(operation.hRoot, operation.subKey, operation.valueName, state.snapshot))
+      {
+        if (before)
+        {
+          return false;
+        }
+        state.known = false;
+      }
+      if (before)
+      {
+        before->push_back(state.snapshot);
+      }
+      it = states.emplace(id, std::move(state)).first;
+    }
+
+    ValueState &state = it->second;
+    const bool unchanged = state.known &&
+                           (operation.type == OperationType::DeleteValue
+                                ? !state.snapshot.existed
+                                : state.snapshot.existed && state.snapshot.type == operation.valueType && state.snapshot.data == operation.data);
+    report.entries.push_back(RegistryApplyReport::Entry{operation.hRoot, operation.subKey, operation.valueName,
+                                                        unchanged ? RegistryApplyReport::Status::Unchanged : RegistryApplyReport::Status::Changed});
+    if (unchanged)
+    {
+      continue;
+    }
+    pending.m_operations.push_back(operation);
+    entryIndex.push_back(report.entries.size() - 1);
+
+    // 同一批次中之后对该值的操作与本次写入后的状态比较
+    state.known = true;
+    state.snapshot.existed = operation.type != OperationType::DeleteValue;
+    state.snapshot.type = state.snapshot.existed ? operation.valueType : REG_NONE;
+    state.snapshot.data = state.snapshot.existed ? operation.data : std::vector<BYTE>();
+  }
+  return true;
+}
+
+void RegistryManager::markFailed(const std::vector<size_t> &entryIndex, const std::vector<bool> &failed, RegistryApplyReport &report)
+{
+  for (size_t i = 0; i < entryIndex.size() && i < failed.size(); ++i)
+  {
+    if (failed[i] && entryIndex[i] != SIZE_MAX)
+    {
+      report.entries[entryIndex[i]].status = RegistryApplyReport::Status::Failed;
+    }
+  }
+}
+
+bool RegistryManager::writeBatch(const RegistryBatch &batch, HANDLE transaction, bool stopOnError, std::vector<bool> *failed)
+{
+  using Operation = RegistryBatch::Operation;
+  using OperationType = RegistryBatch::OperationType;
+
+  if (failed)
+  {
+    failed->assign(batch.m_operations.size(), false);
+  }
+  auto markOperation = [&](const Operation *operation)
+  {
+    if (failed)
+    {
+      (*failed)[static_cast<size_t>(operation - batch.m_operations.data())] = true;
+    }
+  };
+
+  // 按注册表项分组 保持各项第一次出现的顺序和项内操作的顺序
+  std::vector<std::vector<const Operation *>> groups;
+  std::unordered_map<std::string, size_t> groupIndex;
+  for (const Operation &operation : batch.m_operations)
+  {
+    // 删除项单独成组 之后对同一项的操作另起一组 在删除之后执行
+    if (operation.type == OperationType::DeleteKey)
+    {
+      groupIndex.erase(registryKeyId(operation.hRoot, operation.subKey));
+      groups.emplace_back(1, &operation);
+      continue;
+    }
+    auto inserted = groupIndex.emplace(registryKeyId(operation.hRoot, operation.subKey), groups.size());
+    if (inserted.second)
+    {
+      groups.emplace_back();
+    }
+    groups[inserted.first->second].push_back(&operation);
+  }
+
+  bool allApplied = true;
+  for (const auto &group : groups)
+  {
+    const Operation &first = *group.front();
+    if (first.type == OperationType::DeleteKey)
+    {
+      // 后端没有事务版本的删除 planBatch 已拒绝变更集中的删除项
+      LONG result = ERROR_INVALID_FUNCTION;
+      if (!transaction)
+      {
+        {
+          std::lock_guard<std::mutex> lock(m_keyCacheMutex);
+          evictCachedKeys(first.hRoot, first.subKey);
+        }
+        result = m_backend->deleteTree(first.hRoot, first.subKey);
+      }
+      if (result != ERROR_SUCCESS && result != ERROR_FILE_NOT_FOUND)
+      {
+        LOG_HRESULT("删除注册表项失败: " + first.subKey + " 错误: ", HRESULT_FROM_WIN32(result));
+        markOperation(&first);
+        allApplied = false;
+        if (stopOnError)
+        {
+          break;
+        }
+      }
+      continue;
+    }
+    const bool createKey = std::any_of(group.begin(), group.end(), [](const Operation *operation)
+                                       { return operation->type == OperationType::CreateKey; });
+    HKEY hKey;
+    LONG result;
+    if (transaction)
+    {
+      result = createKey ? m_backend->createKeyTransacted(first.hRoot, first.subKey, KEY_WRITE, transaction, hKey)
+                         : m_backend->openKeyTransacted(first.hRoot, first.subKey, KEY_WRITE, transaction, hKey);
+    }
+    else
+    {
+      result = createKey ? m_backend->createKey(first.hRoot, first.subKey, KEY_WRITE, hKey)
+                         : m_backend->openKey(first.hRoot, first.subKey, KEY_WRITE, hKey);
+    }
+    if (result != ERROR_SUCCESS)
+    {
+      // 项不存在时其中的值也不存在 只有删除值的操作视为成功
+      const bool onlyDeletes = std::all_of(group.begin(), group.end(), [](const Operation *operation)
+                                           { return operation->type == OperationType::DeleteValue; });
+      if (result == ERROR_FILE_NOT_FOUND && onlyDeletes)
+      {
+        continue;
+      }
+      LOG_HRESULT("打开注册表项失败: " + first.subKey + " 错误: ", HRESULT_FROM_WIN32(result));
+      std::for_each(group.begin(), group.end(), markOperation);
+      allApplied = false;
+      if (stopOnError)
+      {
+        break;
+      }
+      continue;
+    }
+
+    for (const Operation *operation : group)
+    {
+      switch (operation->type)
+      {
+      case OperationType::SetValue:
+        result = m_backend->setValue(hKey, operation->valueName, operation->valueType,
+                                     operation->data.empty() ? nullptr : operation->data.data(),
+                                     static_cast<DWORD>(operation->data.size()));
+        break;
+      case OperationType::DeleteValue:
+        result = m_backend->deleteValue(hKey, operation->valueName);
+        if (result == ERROR_FILE_NOT_FOUND)
+        {
+          result = ERROR_SUCCESS;
+        }
+        break;
+      default:
+        result = ERROR_SUCCESS;
+        break;
+      }
+      if (result != ERROR_SUCCESS)
+      {
+        LOG_HRESULT("写入注册表值失败: " + operation->subKey + "\\" + operation->valueName + " 错误: ", HRESULT_FROM_WIN32(result));
+        markOperation(operation);
+        allApplied = false;
+        if (stopOnError)
+        {
+          break;
+        }
+      }
+    }
+    m_backend->closeKey(hKey);
+    if (!allApplied && stopOnError)
+    {
+      break;
+    }
+  }
+
+  LOG_DEBUG_FMT("批量写入注册表: {} 个操作 {} 个注册表项", batch.size(), groups.size());
+  return allApplied;
+}
+
+bool RegistryManager::writeAtomically(const RegistryBatch &batch, const std::vector<RegistryValueSnapshot> *before, std::vector<bool> *failed)
+{
+  // 回滚或补偿后全部操作都没有生效
+  auto markAll = [&]()
+  {
+    if (failed)
+    {
+      failed->assign(batch.size(), true);
+    }
+  };
+
+  HANDLE transaction = m_backend->beginTransaction();
+  if (transaction)
+  {
+    if (!writeBatch(batch, transaction, true, nullptr))
+    {
+      m_backend->rollbackTransaction(transaction);
+      markAll();
+      return false;
+    }
+    LONG result = m_backend->commitTransaction(transaction);
+    if (result != ERROR_SUCCESS)
+    {
+      LOG_HRESULT("提交注册表事务失败 错误: ", HRESULT_FROM_WIN32(result));
+      markAll();
+      return false;
+    }
+    return true;
+  }
+
+  // 后端不支持事务 按撤销日志的方式补偿
+  if (!before)
+  {
+    return writeBatch(batch, nullptr, false, failed);
+  }
+  if (writeBatch(batch, nullptr, true, nullptr))
+  {
+    return true;
+  }
+  markAll();
+  RegistryBatch compensation;
+  for (auto it = before->rbegin(); it != before->rend(); ++it)
+  {
+    if (it->existed)
+    {
+      compensation.setValue(it->hRoot, it->subKey, it->valueName, it->type, it->data);
+    }
+    else
+    {
+      compensation.deleteValue(it->hRoot, it->subKey, it->valueName);
+    }
+  }
+  if (!writeBatch(compensation, nullptr, false, nullptr))
+  {
+    LOG_ERROR("补偿注册表写入失败，部分值可能保持为新值");
+  }
+  return false;
+}
+
+bool RegistryManager::captureValue(HKEY hRoot, const std::string &subKey, const std::string &valueName, RegistryValueSnapshot &snapshot)
+{
+  snapshot.hRoot = hRoot;
+  snapshot.subKey = subKey;
+  snapshot.valueName = valueName;
+  snapshot.type = REG_NONE;
+  snapshot.data.clear();
+  LONG result = readWithCachedKey(hRoot, subKey, [&](HKEY hKey)
+                                  { return m_backend->queryValue(hKey, valueName, snapshot.type, snapshot.data); });
+  if (result == ERROR_FILE_NOT_FOUND)
+  {
+    // 项或值不存在 撤销时删除该值
+    snapshot.existed = false;
+    snapshot.type = REG_NONE;
+    snapshot.data.clear();
+    return true;
+  }
   if (result != ERROR_SUCCESS)
   {
-    // LOG_HRESULT("打开注册表项失败: " + keyPath + " 错误: ", HRESULT_FROM_WIN32(result));
+    LOG_HRESULT("读取注册表值失败: " + subKey + "\\" + valueName + " 错误: ", HRESULT_FROM_WIN32(result));
     return false;
   }
+  snapshot.existed = true;
   return true;
 }
 
+LONG RegistryManager::readWithCachedKey(HKEY hRoot, const std::string &subKey, const std::function<LONG(HKEY)> &read)
+{
+  std::lock_guard<std::mutex> lock(m_keyCacheMutex);
+  HKEY hKey;
+  LONG result = acquireCachedKey(hRoot, subKey, hKey);
+  if (result != ERROR_SUCCESS)
+  {
+    return result;
+  }
+  result = read(hKey);
+  if (result == ERROR_KEY_DELETED)
+  {
+    // 项在缓存期间被删除 可能已经重新创建
+    evictCachedKeys(hRoot, subKey);
+    result = acquireCachedKey(hRoot, subKey, hKey);
+    if (result == ERROR_SUCCESS)
+    {
+      result = read(hKey);
+    }
+  }
+  return result;
+}
+
+LONG RegistryManager::acquireCachedKey(HKEY hRoot, const std::string &subKey, HKEY &hKey)
+{
+  static MetricCounter &hits = MetricsRegistry::instance().counter("gop_registry_key_cache", "注册表只读句柄缓存的查找次数", {{"result", "hit"}});
+  static MetricCounter &misses = MetricsRegistry::instance().counter("gop_registry_key_cache", "注册表只读句柄缓存的查找次数", {{"result", "miss"}});
+
+  std::string cacheKey = registryKeyId(hRoot, subKey);
+  auto it = m_keyCacheIndex.find(cacheKey);
+  if (it != m_keyCacheIndex.end())
+  {
+    hits.inc();
+    m_keyCache.splice(m_keyCache.begin(), m_keyCache, it->second);
+    hKey = it->second->hKey;
+    return ERROR_SUCCESS;
+  }
+
+  misses.inc();
+  // 不存在的项不缓存 下次查询重新打开
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_READ, hKey);
+  if (result != ERROR_SUCCESS)
+  {
+    return result;
+  }
+  if (m_keyCache.size() >= kKeyCacheCapacity)
+  {
+    m_backend->closeKey(m_keyCache.back().hKey);
+    m_keyCacheIndex.erase(m_keyCache.back().cacheKey);
+    m_keyCache.pop_back();
+  }
+  m_keyCache.push_front(CachedKey{cacheKey, hKey});
+  m_keyCacheIndex.emplace(std::move(cacheKey), m_keyCache.begin());
+  return ERROR_SUCCESS;
+}
+
+void RegistryManager::evictCachedKeys(HKEY hRoot, const std::string &subKey)
+{
+  const std::string cacheKey = registryKeyId(hRoot, subKey);
+  const std::string childPrefix = cacheKey + '\\';
+  for (auto it = m_keyCache.begin(); it != m_keyCache.end();)
+  {
+    if (it->cacheKey == cacheKey || it->cacheKey.compare(0, childPrefix.size(), childPrefix) == 0)
+    {
+      m_backend->closeKey(it->hKey);
+      m_keyCacheIndex.erase(it->cacheKey);
+      it = m_keyCache.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
 bool RegistryManager::GetNetworkInterfaceCardIds(HKEY hRoot, const std::string &subKey, const std::string &valueName, std::vector<std::string> &nicIds)
 {
   HKEY hKey;
 
-  if (RegOpenKeyExA(hRoot, subKey.c_str(), 0, KEY_READ, &hKey) != ERROR_SUCCESS)
+  if (m_backend->openKey(hRoot, subKey, KEY_READ, hKey) != ERROR_SUCCESS)
   {
     LOG_ERROR("无法打开注册表项: " + subKey);
     return false;
   }
 
-  DWORD index = 0;
-  DWORD dataType;
-  CHAR subKeyName[MAX_PATH];
+  // 先枚举再读取 读取时不持有父项句柄
+  std::vector<std::string> subKeyNames;
+  std::string subKeyName;
+  for (DWORD index = 0; m_backend->enumSubKey(hKey, index, subKeyName) == ERROR_SUCCESS; ++index)
+  {
+    subKeyNames.push_back(subKeyName);
+  }
+  m_backend->closeKey(hKey);
 
-  while (RegEnumKeyA(hKey, index++, subKeyName, MAX_PATH) == ERROR_SUCCESS)
+  for (const auto &name : subKeyNames)
   {
-    HKEY hSubKey;
-    std::string fullSubKeyPath = subKey + "\\" + subKeyName;
-    if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, fullSubKeyPath.c_str(), 0, KEY_READ, &hSubKey) == ERROR_SUCCESS)
+    std::string nicId;
+    if (getRegistryStringValue(hRoot, subKey + "\\" + name, valueName, nicId))
     {
-      CHAR valueData[MAX_PATH];
-      DWORD dataSize = sizeof(valueData);
-      if (RegQueryValueExA(hSubKey, valueName.c_str(), nullptr, &dataType, reinterpret_cast<LPBYTE>(valueData), &dataSize) == ERROR_SUCCESS)
-      {
-        nicIds.push_back(valueData);
-      }
-      RegCloseKey(hSubKey);
+      nicIds.push_back(nicId);
     }
   }
 
-  RegCloseKey(hKey);
-
   if (nicIds.empty())
   {
     LOG_ERROR("未找到有效的网络接口ID");
@@ -249,3 +953,32 @@ bool RegistryManager::filterInvalidNetworkInterfaceCardIds(HKEY hRoot, const std
   nicIds = std::move(validNicIds);
   return !nicIds.empty();
 }
+
+bool RegistryManager::getSubKeysWithChild(HKEY hRoot, const std::string &subKey, const std::string &childName, std::unordered_set<std::string> &names)
+{
+  HKEY hKey;
+  LONG result = m_backend->openKey(hRoot, subKey, KEY_READ, hKey);
+  if (result != ERROR_SUCCESS)
+  {
+    LOG_HRESULT("无法打开注册表项: " + subKey + " 错误: ", HRESULT_FROM_WIN32(result));
+    return false;
+  }
+
+  std::string subKeyName;
+  for (DWORD index = 0; m_backend->enumSubKey(hKey, index, subKeyName) == ERROR_SUCCESS; ++index)
+  {
+    // 相对父项句柄打开 不需要从根键重新解析整个路径
+    HKEY hChild;
+    if (m_backend->openKey(hKey, subKeyName + "\\" + childName, KEY_QUERY_VALUE, hChild) != ERROR_SUCCESS)
+    {
+      continue;
+    }
+    m_backend->closeKey(hChild);
+    // 注册表项名称不区分大小写
+    std::transform(subKeyName.begin(), subKeyName.end(), subKeyName.begin(), [](char c)
+                   { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; });
+    names.insert(subKeyName);
+  }
+  m_backend->closeKey(hKey);
+  return true;
+}
@@ -0,0 +1,462 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:57:40
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:57:40
+ * @FilePath: \GameOptimizerPro\src\core\registry_watcher.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#define LOG_MODULE Logging::Module::Registry
+
+#include "core/registry_watcher.h"
+
+#include <algorithm>
+
+#include "metrics/tracing.h"
+
+RegistryWatcher::RegistryWatcher()
+{
+  // Manual-reset, initially non-signaled
+  m_stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  if (m_stopEvent == nullptr)
+  {
+    LOG_HRESULT(L"创建注册表监视停止事件失败", HRESULT_FROM_WIN32(GetLastError()));
+  }
+
+  // Auto-reset 监视线程每次醒来都重新读取监视集合
+  m_wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+  if (m_wakeEvent == nullptr)
+  {
+    LOG_HRESULT(L"创建注册表监视唤醒事件失败", HRESULT_FROM_WIN32(GetLastError()));
+  }
+}
+
+RegistryWatcher::~RegistryWatcher()
+{
+  stop();
+
+  for (HANDLE *handle : {&m_stopEvent, &m_wakeEvent})
+  {
+    if (*handle)
+    {
+      CloseHandle(*handle);
+      *handle = nullptr;
+    }
+  }
+}
+
+bool RegistryWatcher::watch(const std::string &name, const std::vector<std::pair<HKEY, std::string>> &keys, CheckCallback callback,
+                            bool watchSubtree)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_setMutex);
+    if (!startLocked())
+    {
+      return false;
+    }
+  }
+
+  {
+    // 等待同名监视正在执行的检查结束
+    std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    Watch &watch = m_watches[name];
+    watch = Watch();
+    watch.keys = keys;
+    watch.callback = std::move(callback);
+    watch.watchSubtree = watchSubtree;
+    // 添加后立即检查一次 发现上次运行以来的偏离
+    watch.dueTick = GetTickCount64();
+    m_watchesChanged = true;
+  }
+  SetEvent(m_wakeEvent);
+  LOG_INFO_FMT("开始监视注册表变更: {} 注册表项 {} 个", name, keys.size());
+  return true;
+}
+
+void RegistryWatcher::unwatch(const std::string &name)
+{
+  {
+    std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    if (m_watches.erase(name) == 0)
+    {
+      return;
+    }
+    m_watchesChanged = true;
+  }
+  SetEvent(m_wakeEvent);
+  LOG_INFO("停止监视注册表变更: " + name);
+}
+
+void RegistryWatcher::check(const std::string &name)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    auto it = m_watches.find(name);
+    if (it == m_watches.end())
+    {
+      return;
+    }
+    scheduleCheckLocked(it->second);
+  }
+  // 唤醒监视线程按新的计划时间等待
+  SetEvent(m_wakeEvent);
+}
+
+bool RegistryWatcher::updateKeys(const std::string &name, const std::vector<std::pair<HKEY, std::string>> &keys)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    auto it = m_watches.find(name);
+    if (it == m_watches.end() || it->second.keys == keys)
+    {
+      return false;
+    }
+    it->second.keys = keys;
+    m_watchesChanged = true;
+  }
+  SetEvent(m_wakeEvent);
+  LOG_INFO_FMT("更新监视的注册表项: {} 注册表项 {} 个", name, keys.size());
+  return true;
+}
+
+void RegistryWatcher::stop()
+{
+  std::lock_guard<std::mutex> lock(m_setMutex);
+  if (!m_isRunning.load())
+  {
+    return;
+  }
+
+  SetEvent(m_stopEvent);
+  if (m_watchThread.joinable())
+  {
+    try
+    {
+      m_watchThread.join();
+    }
+    catch (const std::system_error &e)
+    {
+      LOG_ERROR("等待注册表监视线程结束失败: " + std::string(e.what()));
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> watchLock(m_watchMutex);
+    m_watches.clear();
+    m_watchesChanged = false;
+  }
+  m_isRunning = false;
+  LOG_INFO("停止监视注册表变更");
+}
+
+void RegistryWatcher::setOnThrottledCallback(ThrottledCallback callback)
+{
+  m_onThrottledCallback = std::move(callback);
+}
+
+bool RegistryWatcher::startLocked()
+{
+  if (m_isRunning.load())
+  {
+    return true;
+  }
+
+  if (!m_stopEvent || !m_wakeEvent)
+  {
+    LOG_ERROR("注册表监视事件句柄无效，无法监视注册表变更");
+    return false;
+  }
+
+  ResetEvent(m_stopEvent);
+  try
+  {
+    m_watchThread = std::thread([this]()
+                                { runWatchLoop(); });
+  }
+  catch (const std::system_error &e)
+  {
+    LOG_ERROR("启动注册表监视线程失败: " + std::string(e.what()));
+    return false;
+  }
+
+  m_isRunning = true;
+  return true;
+}
+
+void RegistryWatcher::runWatchLoop()
+{
+  Tracing::setThreadName("registry_watcher");
+  std::vector<WatchedKey> watchedKeys;
+  size_t missingKeys = 0;
+  bool rebuild = false;
+
+  while (true)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_watchMutex);
+      rebuild = rebuild || m_watchesChanged;
+      m_watchesChanged = false;
+    }
+    if (rebuild)
+    {
+      missingKeys = rebuildWatchedKeys(watchedKeys);
+      rebuild = false;
+    }
+
+    bool checked = false;
+    const DWORD timeout = runDueChecks(checked);
+    if (checked && missingKeys > 0)
+    {
+      // 重新写入可能重新创建了被删除的项 下一轮重新打开
+      rebuild = true;
+      continue;
+    }
+
+    std::vector<HANDLE> handles = {m_stopEvent, m_wakeEvent};
+    for (const auto &watchedKey : watchedKeys)
+    {
+      handles.push_back(watchedKey.event);
+    }
+
+    // 没有计划中的检查时无限期等待 只有注册表变化或监视集合变化才会唤醒
+    const DWORD waitResult = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, timeout);
+    if (waitResult == WAIT_OBJECT_0)
+    {
+      // 收到停止信号
+      break;
+    }
+    if (waitResult == WAIT_OBJECT_0 + 1 || waitResult == WAIT_TIMEOUT)
+    {
+      continue;
+    }
+    if (waitResult > WAIT_OBJECT_0 + 1 && waitResult < WAIT_OBJECT_0 + handles.size())
+    {
+      const WatchedKey &watchedKey = watchedKeys[waitResult - WAIT_OBJECT_0 - 2];
+      // 先重新注册再检查 检查期间的变化不会丢失
+      if (!armWatchedKey(watchedKey))
+      {
+        rebuild = true;
+      }
+
+      std::lock_guard<std::mutex> lock(m_watchMutex);
+      auto it = m_watches.find(watchedKey.name);
+      if (it != m_watches.end())
+      {
+        scheduleCheckLocked(it->second);
+        LOG_DEBUG("检测到注册表变更: " + watchedKey.name);
+      }
+      continue;
+    }
+
+    LOG_HRESULT(L"等待注册表变更通知失败", HRESULT_FROM_WIN32(GetLastError()));
+    break;
+  }
+
+  closeWatchedKeys(watchedKeys);
+}
+
+size_t RegistryWatcher::rebuildWatchedKeys(std::vector<WatchedKey> &watchedKeys)
+{
+  closeWatchedKeys(watchedKeys);
+
+  struct Target
+  {
+    std::string name;
+    HKEY hRoot;
+    std::string subKey;
+    bool watchSubtree;
+  };
+  std::vector<Target> targets;
+  {
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    for (const auto &[name, watch] : m_watches)
+    {
+      for (const auto &key : watch.keys)
+      {
+        targets.push_back(Target{name, key.first, key.second, watch.watchSubtree});
+      }
+    }
+  }
+
+  size_t missingKeys = 0;
+  for (const auto &target : targets)
+  {
+    if (watchedKeys.size() >= kMaxWatchedKeys)
+    {
+      LOG_WARN_FMT("注册表监视项超出上限 {}，其余 {} 项不再监视", kMaxWatchedKeys, targets.size() - watchedKeys.size() - missingKeys);
+      break;
+    }
+
+    WatchedKey watchedKey;
+    watchedKey.name = target.name;
+    watchedKey.watchSubtree = target.watchSubtree;
+    LONG result = RegOpenKeyExA(target.hRoot, target.subKey.c_str(), 0, KEY_NOTIFY, &watchedKey.hKey);
+    if (result != ERROR_SUCCESS)
+    {
+      LOG_WARN_LIMITED("打开监视的注册表项失败: " + target.subKey + " 错误: ", HRESULT_FROM_WIN32(result));
+      ++missingKeys;
+      continue;
+    }
+
+    // Auto-reset 每次触发后重新注册
+    watchedKey.event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (watchedKey.event == nullptr)
+    {
+      LOG_HRESULT(L"创建注册表变更事件失败", HRESULT_FROM_WIN32(GetLastError()));
+      RegCloseKey(watchedKey.hKey);
+      continue;
+    }
+
+    if (!armWatchedKey(watchedKey))
+    {
+      CloseHandle(watchedKey.event);
+      RegCloseKey(watchedKey.hKey);
+      ++missingKeys;
+      continue;
+    }
+    watchedKeys.push_back(watchedKey);
+  }
+
+  LOG_DEBUG_FMT("监视的注册表项: {} 个 无法打开: {} 个", watchedKeys.size(), missingKeys);
+  return missingKeys;
+}
+
+bool RegistryWatcher::armWatchedKey(const WatchedKey &watchedKey)
+{
+  // 默认只监视值的写入和删除 监视子树时还包括子项的创建和删除
+  const DWORD filter = watchedKey.watchSubtree ? (REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET) : REG_NOTIFY_CHANGE_LAST_SET;
+  LONG result = RegNotifyChangeKeyValue(watchedKey.hKey, watchedKey.watchSubtree ? TRUE : FALSE, filter, watchedKey.event, TRUE);
+  if (result != ERROR_SUCCESS)
+  {
+    // 项被删除时返回 ERROR_KEY_DELETED
+    LOG_WARN_LIMITED("注册注册表变更通知失败: " + watchedKey.name + " 错误: ", HRESULT_FROM_WIN32(result));
+    return false;
+  }
+  return true;
+}
+
+void RegistryWatcher::closeWatchedKeys(std::vector<WatchedKey> &watchedKeys)
+{
+  for (auto &watchedKey : watchedKeys)
+  {
+    // 关闭项句柄会取消未触发的通知
+    RegCloseKey(watchedKey.hKey);
+    CloseHandle(watchedKey.event);
+  }
+  watchedKeys.clear();
+}
+
+void RegistryWatcher::scheduleCheckLocked(Watch &watch)
+{
+  if (watch.dueTick != 0)
+  {
+    return;
+  }
+  // 合并短时间内的多次变化 并保证同一监视两次检查之间的最小间隔
+  const ULONGLONG now = GetTickCount64();
+  watch.dueTick = (std::max)(now + kDebounceMs, watch.lastCheckTick + kMinCheckIntervalMs);
+}
+
+DWORD RegistryWatcher::runDueChecks(bool &checked)
+{
+  const ULONGLONG now = GetTickCount64();
+  std::vector<std::string> dueNames;
+  ULONGLONG nextDueTick = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    for (const auto &[name, watch] : m_watches)
+    {
+      if (watch.dueTick == 0)
+      {
+        continue;
+      }
+      if (watch.dueTick <= now)
+      {
+        dueNames.push_back(name);
+      }
+      else if (nextDueTick == 0 || watch.dueTick < nextDueTick)
+      {
+        nextDueTick = watch.dueTick;
+      }
+    }
+  }
+
+  for (const auto &name : dueNames)
+  {
+    std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+    CheckCallback callback;
+    DriftAction action = DriftAction::Reapply;
+    {
+      std::lock_guard<std::mutex> lock(m_watchMutex);
+      auto it = m_watches.find(name);
+      if (it == m_watches.end())
+      {
+        // 已停止监视
+        continue;
+      }
+      Watch &watch = it->second;
+      watch.dueTick = 0;
+      watch.lastCheckTick = now;
+      while (!watch.reapplyTicks.empty() && now - watch.reapplyTicks.front() >= kReapplyWindowMs)
+      {
+        watch.reapplyTicks.pop_front();
+      }
+      if (watch.reapplyTicks.size() >= kMaxReappliesPerWindow)
+      {
+        action = DriftAction::Report;
+      }
+      else if (watch.throttled)
+      {
+        watch.throttled = false;
+        LOG_INFO("恢复自动重新写入注册表优化: " + name);
+      }
+      callback = watch.callback;
+    }
+
+    checked = true;
+    TRACE_SCOPE_DETAIL("registry", "drift_check", name);
+    if (!callback || !callback(action))
+    {
+      continue;
+    }
+
+    bool isThrottled = false;
+    {
+      std::lock_guard<std::mutex> lock(m_watchMutex);
+      auto it = m_watches.find(name);
+      if (it == m_watches.end())
+      {
+        continue;
+      }
+      if (action == DriftAction::Reapply)
+      {
+        it->second.reapplyTicks.push_back(now);
+      }
+      else if (!it->second.throttled)
+      {
+        it->second.throttled = true;
+        isThrottled = true;
+      }
+    }
+    if (isThrottled)
+    {
+      LOG_WARN_FMT("注册表优化被反复改回，{} 分钟内已重新写入 {} 次，暂停自动重新写入: {}",
+                   kReapplyWindowMs / 60000, kMaxReappliesPerWindow, name);
+      if (m_onThrottledCallback)
+      {
+        m_onThrottledCallback(name);
+      }
+    }
+  }
+
+  if (nextDueTick == 0)
+  {
+    return INFINITE;
+  }
+  // 扣除执行检查花费的时间
+  const ULONGLONG current = GetTickCount64();
+  return nextDueTick <= current ? 0 : static_cast<DWORD>(nextDueTick - current);
+}
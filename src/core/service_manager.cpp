@@ -8,10 +8,17 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 
+#define LOG_MODULE Logging::Module::Service
+
 #include "core/service_manager.h"
 
+#include "metrics/metrics.h"
+
 bool ServiceManager::startService(const std::wstring &serviceName)
 {
+  static MetricOperation metric("gop_service_operations", "服务控制操作", "start");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, serviceName);
   SC_HANDLE scm = OpenSCManagerW(
       nullptr,
       nullptr,
@@ -65,11 +72,14 @@ bool ServiceManager::startService(const std::wstring &serviceName)
 
   CloseServiceHandle(service);
   CloseServiceHandle(scm);
-  return true;
+  return scope.finish(true);
 }
 
 bool ServiceManager::stopService(const std::wstring &serviceName)
 {
+  static MetricOperation metric("gop_service_operations", "服务控制操作", "stop");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, serviceName);
   SC_HANDLE scm = OpenSCManagerW(
       nullptr,              // 本地计算机
       nullptr,              // 默认数据库
@@ -114,7 +124,7 @@ bool ServiceManager::stopService(const std::wstring &serviceName)
   LOG_INFO(L"服务停止成功: " + serviceName);
   CloseServiceHandle(service);
   CloseServiceHandle(scm);
-  return true;
+  return scope.finish(true);
 }
 
 bool ServiceManager::SetServiceSecurityWrapper(SC_HANDLE service)
@@ -189,6 +199,9 @@ bool ServiceManager::SetServiceSecurityWrapper(SC_HANDLE service)
 
 bool ServiceManager::setServiceStartType(const std::wstring &serviceName, DWORD dwStartType)
 {
+  static MetricOperation metric("gop_service_operations", "服务控制操作", "set_start_type");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, serviceName);
   // 检查启动类型是否合法
   if (dwStartType < 0 || dwStartType > 3)
   {
@@ -344,11 +357,14 @@ bool ServiceManager::setServiceStartType(const std::wstring &serviceName, DWORD
   LOG_INFO(L"服务启动类型设置成功: " + serviceName + L"-" + m_startTypeList[dwStartType].second);
   CloseServiceHandle(service);
   CloseServiceHandle(scm);
-  return true;
+  return scope.finish(true);
 }
 
 bool ServiceManager::queryServiceStatus(const std::wstring &serviceName, bool &currentStatus, DWORD &startType)
 {
+  static MetricOperation metric("gop_service_operations", "服务控制操作", "query_status");
+  MetricOperationScope scope(metric);
+  METRIC_TRACE_DETAIL(scope, serviceName);
   // 打开服务控制管理器
   // SC_MANAGER_CONNECT 连接到服务控制管理器
   SC_HANDLE scm = OpenSCManagerW(
@@ -420,5 +436,5 @@ bool ServiceManager::queryServiceStatus(const std::wstring &serviceName, bool &c
   LocalFree(config);
   CloseServiceHandle(service);
   CloseServiceHandle(scm);
-  return true;
+  return scope.finish(true);
 }
@@ -0,0 +1,196 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 10:41:05
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 10:41:05
+ * @FilePath: \GameOptimizerPro\src\core\session_manager.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include "core/session_manager.h"
+
+SessionManager::SessionManager()
+{
+}
+
+SessionManager::~SessionManager()
+{
+  stopMonitoring();
+}
+
+void SessionManager::setGameDatabase(std::shared_ptr<const GameDatabase> gameDatabase)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_gameDatabase = std::move(gameDatabase);
+}
+
+bool SessionManager::startMonitoring(const std::vector<std::string> &gameProcessNames)
+{
+  bool hasDatabase = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    hasDatabase = m_gameDatabase && m_gameDatabase->titleCount() > 0;
+  }
+
+  if (gameProcessNames.empty() && !hasDatabase)
+  {
+    LOG_ERROR("游戏进程列表为空，无法监听游戏会话");
+    return false;
+  }
+
+  if (m_isMonitoring)
+  {
+    return true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_gameProcessNames.clear();
+    for (const auto &gameProcessName : gameProcessNames)
+    {
+      m_gameProcessNames.push_back(MultiByteToWide(gameProcessName));
+    }
+    m_isMonitoring = true;
+  }
+
+  LOG_INFO("开始监听游戏会话");
+  return true;
+}
+
+bool SessionManager::stopMonitoring()
+{
+  // 会话仍在进行时 通知各项操作还原
+  std::wstring lastProcessName;
+  DWORD lastProcessId = 0;
+  bool wasActive = false;
+  {
+    // 与事件处理在同一把锁内修改 停止后到达的事件不会再开始会话
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isMonitoring)
+    {
+      return true;
+    }
+    m_isMonitoring = false;
+    if (!m_gameProcesses.empty())
+    {
+      wasActive = true;
+      lastProcessId = m_gameProcesses.begin()->first;
+      lastProcessName = m_gameProcesses.begin()->second;
+      m_gameProcesses.clear();
+    }
+  }
+
+  if (wasActive && m_onSessionEndedCallback)
+  {
+    LOG_INFO(L"停止监听，结束游戏会话: " + lastProcessName);
+    m_onSessionEndedCallback(lastProcessName, lastProcessId);
+  }
+  return true;
+}
+
+bool SessionManager::isMonitoring() const
+{
+  return m_isMonitoring;
+}
+
+bool SessionManager::isSessionActive() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return !m_gameProcesses.empty();
+}
+
+std::vector<DWORD> SessionManager::getGameProcessIds() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<DWORD> processIds;
+  for (const auto &gameProcess : m_gameProcesses)
+  {
+    processIds.push_back(gameProcess.first);
+  }
+  return processIds;
+}
+
+void SessionManager::setOnSessionStartedCallback(SessionCallback callback)
+{
+  m_onSessionStartedCallback = std::move(callback);
+}
+
+void SessionManager::setOnSessionEndedCallback(SessionCallback callback)
+{
+  m_onSessionEndedCallback = std::move(callback);
+}
+
+void SessionManager::onProcessCreated(const std::wstring &processName, DWORD processId)
+{
+  if (!m_isMonitoring || !isGameProcess(processName))
+  {
+    return;
+  }
+
+  bool sessionStarted = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isMonitoring)
+    {
+      return;
+    }
+    sessionStarted = m_gameProcesses.empty();
+    m_gameProcesses[processId] = processName;
+  }
+
+  LOG_INFO_FMT("游戏进程启动: {} PID: {}", processName, processId);
+  if (sessionStarted && m_onSessionStartedCallback)
+  {
+    LOG_INFO_FMT("游戏会话开始: {}", processName);
+    m_onSessionStartedCallback(processName, processId);
+  }
+}
+
+void SessionManager::onProcessDestroyed(const std::wstring &processName, DWORD processId)
+{
+  bool sessionEnded = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_gameProcesses.erase(processId) == 0)
+    {
+      // 不是会话中记录的游戏进程
+      return;
+    }
+    sessionEnded = m_gameProcesses.empty();
+  }
+
+  LOG_INFO_FMT("游戏进程退出: {} PID: {}", processName, processId);
+  if (sessionEnded && m_onSessionEndedCallback)
+  {
+    LOG_INFO_FMT("游戏会话结束: {}", processName);
+    m_onSessionEndedCallback(processName, processId);
+  }
+}
+
+void SessionManager::scanRunningGameProcesses()
+{
+  for (const auto &processEntry : getProcessSnapshot())
+  {
+    onProcessCreated(processEntry.exeName, processEntry.processId);
+  }
+}
+
+bool SessionManager::isGameProcess(const std::wstring &processName) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto &gameProcessName : m_gameProcessNames)
+  {
+    if (_wcsicmp(processName.c_str(), gameProcessName.c_str()) == 0)
+    {
+      return true;
+    }
+  }
+
+  if (m_gameDatabase)
+  {
+    auto title = m_gameDatabase->find(processName);
+    return title && title->type == GameDb::TitleType::Game;
+  }
+  return false;
+}
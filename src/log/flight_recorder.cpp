@@ -0,0 +1,116 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 19:53:27
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 19:53:27
+ * @FilePath: \GameOptimizerPro\src\log\flight_recorder.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "log/flight_recorder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "log/binlog_format.h"
+
+namespace
+{
+  size_t roundUpToPowerOfTwo(size_t value)
+  {
+    size_t result = 1;
+    while (result < value)
+    {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  /**
+   * @brief 参数区被截断时 把跨过末尾的字符串参数改为截断后的长度
+   * @note 跨过末尾的数值参数和之后的参数在解码时丢弃
+   */
+  void truncateArgs(char *args, size_t bytes)
+  {
+    char *cursor = args;
+    char *end = args + bytes;
+    while (cursor < end)
+    {
+      const auto type = static_cast<BinLog::ArgType>(*cursor);
+      if (type != BinLog::ArgType::Utf8 && type != BinLog::ArgType::Utf16)
+      {
+        BinLog::Arg arg;
+        const char *next = cursor;
+        if (!BinLog::readArg(next, end, arg))
+        {
+          return;
+        }
+        cursor = const_cast<char *>(next);
+        continue;
+      }
+      if (end - cursor < 1 + 4)
+      {
+        return;
+      }
+
+      uint32_t length = 0;
+      std::memcpy(&length, cursor + 1, sizeof(length));
+      const size_t available = static_cast<size_t>(end - cursor) - 1 - 4;
+      if (length > available)
+      {
+        length = static_cast<uint32_t>(type == BinLog::ArgType::Utf16 ? available & ~static_cast<size_t>(1) : available);
+        std::memcpy(cursor + 1, &length, sizeof(length));
+        return;
+      }
+      cursor += 1 + 4 + length;
+    }
+  }
+} // namespace
+
+FlightRecorder::FlightRecorder(size_t slotCount)
+    : m_slots(std::make_unique<Slot[]>(roundUpToPowerOfTwo(std::max<size_t>(slotCount, 2)))),
+      m_mask(roundUpToPowerOfTwo(std::max<size_t>(slotCount, 2)) - 1)
+{
+}
+
+FlightRecorder::~FlightRecorder() = default;
+
+void FlightRecorder::record(const LogRecordHeader &header, const void *args)
+{
+  const uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+  Slot &slot = m_slots[index & m_mask];
+
+  // 顺序锁 先标记为写入中再写数据 只有序号分配用到原子读改写
+  const uint64_t writing = 2 * index + 1;
+  slot.sequence.store(writing, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const uint32_t argsBytes = std::min<uint32_t>(header.argsBytes, static_cast<uint32_t>(kSlotArgsBytes));
+  slot.header = header;
+  slot.header.argsBytes = argsBytes;
+  std::memcpy(slot.args, args, argsBytes);
+  if (argsBytes < header.argsBytes)
+  {
+    truncateArgs(slot.args, argsBytes);
+  }
+  slot.sequence.store(writing + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::read(uint64_t index, LogRecordHeader &header, char *args) const
+{
+  const Slot &slot = m_slots[index & m_mask];
+  const uint64_t expected = 2 * index + 2;
+  if (slot.sequence.load(std::memory_order_acquire) != expected)
+  {
+    return false;
+  }
+
+  header = slot.header;
+  const uint32_t argsBytes = std::min<uint32_t>(header.argsBytes, static_cast<uint32_t>(kSlotArgsBytes));
+  std::memcpy(args, slot.args, argsBytes);
+  header.argsBytes = argsBytes;
+
+  // 复制期间被覆盖则丢弃
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
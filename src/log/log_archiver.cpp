@@ -0,0 +1,341 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 18:24:12
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 18:24:12
+ * @FilePath: \GameOptimizerPro\src\log\log_archiver.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "log/log_archiver.h"
+
+#include <QByteArray>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "log/logging.h"
+#include "metrics/tracing.h"
+
+namespace
+{
+  // 分段按块压缩 每块写成一个 gzip 成员 避免一次读入整个文件
+  constexpr size_t kCompressChunkBytes = 4 * 1024 * 1024;
+  // 分段文件名中时间戳的长度 YYYYMMDD-HHMMSS-mmm
+  constexpr size_t kTimestampLength = 19;
+  constexpr const wchar_t *kArchiveExtension = L".gz";
+
+  constexpr std::array<uint32_t, 256> makeCrcTable()
+  {
+    std::array<uint32_t, 256> table = {};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit)
+      {
+        crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }
+
+  constexpr std::array<uint32_t, 256> kCrcTable = makeCrcTable();
+
+  uint32_t crc32(const char *data, size_t bytes)
+  {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+      crc = kCrcTable[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+  }
+
+  void appendLittleEndian(std::string &output, uint32_t value)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      output += static_cast<char>((value >> (i * 8)) & 0xFF);
+    }
+  }
+
+  /**
+   * @brief 把一块数据压缩为一个 gzip 成员 (RFC 1952)
+   * @note qCompress 输出 4 字节原始长度加 zlib 流，去掉 2 字节 zlib 头和 4 字节 Adler-32 校验即为 deflate 数据
+   */
+  bool appendGzipMember(std::string &output, const char *data, size_t bytes)
+  {
+    const QByteArray compressed = qCompress(reinterpret_cast<const uchar *>(data), static_cast<qsizetype>(bytes));
+    if (compressed.size() < 4 + 2 + 4)
+    {
+      return false;
+    }
+
+    static const char header[10] = {'\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\xff'};
+    output.append(header, sizeof(header));
+    output.append(compressed.constData() + 6, static_cast<size_t>(compressed.size()) - 6 - 4);
+    appendLittleEndian(output, crc32(data, bytes));
+    appendLittleEndian(output, static_cast<uint32_t>(bytes));
+    return true;
+  }
+
+  // 判断文件名是否为指定日志文件的分段 stem.YYYYMMDD-HHMMSS-mmm.ext[.gz]
+  bool isSegmentOf(const std::wstring &fileName, const std::wstring &stem, const std::wstring &extension, bool &compressed)
+  {
+    const std::wstring prefix = stem + L".";
+    if (fileName.size() < prefix.size() + kTimestampLength + extension.size() ||
+        fileName.compare(0, prefix.size(), prefix) != 0)
+    {
+      return false;
+    }
+
+    std::wstring rest = fileName.substr(prefix.size() + kTimestampLength);
+    compressed = rest == extension + kArchiveExtension;
+    if (rest != extension && !compressed)
+    {
+      return false;
+    }
+
+    const std::wstring timestamp = fileName.substr(prefix.size(), kTimestampLength);
+    for (size_t i = 0; i < timestamp.size(); ++i)
+    {
+      const bool separator = i == 8 || i == 15;
+      if (separator ? timestamp[i] != L'-' : !iswdigit(timestamp[i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+} // namespace
+
+LogArchiver::LogArchiver()
+{
+  m_thread = std::thread(&LogArchiver::workerLoop, this);
+}
+
+LogArchiver::~LogArchiver()
+{
+  stop();
+}
+
+void LogArchiver::configure(int maxArchives, bool compress)
+{
+  m_maxArchives.store(maxArchives, std::memory_order_relaxed);
+  m_compress.store(compress, std::memory_order_relaxed);
+}
+
+void LogArchiver::submit(const std::wstring &logFilePath)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stop || std::find(m_pending.begin(), m_pending.end(), logFilePath) != m_pending.end())
+    {
+      return;
+    }
+    m_pending.push_back(logFilePath);
+  }
+  m_condition.notify_one();
+}
+
+void LogArchiver::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_pending.clear();
+  }
+  m_abort.store(true, std::memory_order_relaxed);
+  m_condition.notify_one();
+  if (m_thread.joinable())
+  {
+    m_thread.join();
+  }
+}
+
+std::wstring LogArchiver::segmentPath(const std::wstring &logFilePath, const SYSTEMTIME &localTime)
+{
+  const std::filesystem::path path(logFilePath);
+  wchar_t timestamp[32];
+  swprintf_s(timestamp, L"%04d%02d%02d-%02d%02d%02d-%03d",
+             localTime.wYear, localTime.wMonth, localTime.wDay,
+             localTime.wHour, localTime.wMinute, localTime.wSecond, localTime.wMilliseconds);
+  return (path.parent_path() / (path.stem().wstring() + L"." + timestamp + path.extension().wstring())).wstring();
+}
+
+void LogArchiver::workerLoop()
+{
+  Tracing::setThreadName("log_archiver");
+  for (;;)
+  {
+    std::wstring logFilePath;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]
+                       { return m_stop || !m_pending.empty(); });
+      if (m_stop)
+      {
+        return;
+      }
+      logFilePath = std::move(m_pending.front());
+      m_pending.pop_front();
+    }
+
+    // 不持有 m_mutex 整理期间可以继续提交请求
+    TRACE_SCOPE("log", "archive_segments");
+    maintain(logFilePath);
+  }
+}
+
+void LogArchiver::maintain(const std::wstring &logFilePath)
+{
+  const std::filesystem::path path(logFilePath);
+  const std::filesystem::path directory = path.parent_path().empty() ? std::filesystem::path(L".") : path.parent_path();
+  const std::wstring stem = path.stem().wstring();
+  const std::wstring extension = path.extension().wstring();
+
+  // 先列出分段再压缩 压缩过程中新建的文件不影响枚举
+  std::vector<std::wstring> found;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(directory, ec))
+  {
+    if (entry.is_regular_file(ec))
+    {
+      found.push_back(entry.path().filename().wstring());
+    }
+  }
+  if (ec)
+  {
+    LOG_WARN_FMT("枚举日志分段失败: {} 错误: {}", directory.wstring(), ec.message());
+    return;
+  }
+
+  // 分段名（不含 .gz）-> 是否存在未压缩的文件 同一分段可能因压缩中断同时存在两种文件
+  std::map<std::wstring, bool> segments;
+  for (const std::wstring &fileName : found)
+  {
+    bool compressed = false;
+    if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, L".tmp") == 0)
+    {
+      // 上次压缩中断留下的临时文件
+      if (isSegmentOf(fileName.substr(0, fileName.size() - 4), stem, extension, compressed) && compressed)
+      {
+        std::filesystem::remove(directory / fileName, ec);
+      }
+      continue;
+    }
+    if (isSegmentOf(fileName, stem, extension, compressed))
+    {
+      const std::wstring name = compressed ? fileName.substr(0, fileName.size() - wcslen(kArchiveExtension)) : fileName;
+      segments[name] = segments[name] || !compressed;
+    }
+  }
+
+  // 文件名中的时间戳按字典序即为时间顺序 先删除最旧的分段 再压缩保留下来的分段
+  const size_t maxArchives = static_cast<size_t>(std::max(0, m_maxArchives.load(std::memory_order_relaxed)));
+  while (maxArchives > 0 && segments.size() > maxArchives)
+  {
+    const std::wstring &name = segments.begin()->first;
+    for (const std::wstring &fileName : {name, name + kArchiveExtension})
+    {
+      std::filesystem::remove(directory / fileName, ec);
+      if (ec)
+      {
+        LOG_WARN_FMT("删除旧日志分段失败: {} 错误: {}", fileName, ec.message());
+      }
+    }
+    segments.erase(segments.begin());
+  }
+
+  if (!m_compress.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+  for (const auto &[name, uncompressed] : segments)
+  {
+    if (m_abort.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+    if (uncompressed)
+    {
+      compressSegment((directory / name).wstring());
+    }
+  }
+}
+
+bool LogArchiver::compressSegment(const std::wstring &segment)
+{
+  const std::wstring archive = segment + kArchiveExtension;
+  const std::wstring tempArchive = archive + L".tmp";
+
+  std::ifstream input(std::filesystem::path(segment), std::ios::binary);
+  std::ofstream output(std::filesystem::path(tempArchive), std::ios::binary | std::ios::trunc);
+  if (!input || !output)
+  {
+    LOG_WARN_FMT("无法打开日志分段进行压缩: {}", segment);
+    return false;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<char> chunk(kCompressChunkBytes);
+  std::string member;
+  uint64_t inputBytes = 0;
+  uint64_t outputBytes = 0;
+  bool success = true;
+  while (success && input)
+  {
+    input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    const size_t bytes = static_cast<size_t>(input.gcount());
+    if (bytes == 0)
+    {
+      break;
+    }
+
+    member.clear();
+    success = !m_abort.load(std::memory_order_relaxed) && appendGzipMember(member, chunk.data(), bytes);
+    if (success)
+    {
+      output.write(member.data(), static_cast<std::streamsize>(member.size()));
+      success = static_cast<bool>(output);
+      inputBytes += bytes;
+      outputBytes += member.size();
+    }
+  }
+  success = success && !input.bad();
+  input.close();
+  output.close();
+  success = success && static_cast<bool>(output);
+
+  std::error_code ec;
+  if (!success)
+  {
+    std::filesystem::remove(tempArchive, ec);
+    if (!m_abort.load(std::memory_order_relaxed))
+    {
+      LOG_WARN_FMT("压缩日志分段失败: {}", segment);
+    }
+    return false;
+  }
+
+  // 压缩文件完整写入后再替换 异常退出时只会留下临时文件和未压缩的分段
+  std::filesystem::rename(tempArchive, archive, ec);
+  if (ec)
+  {
+    LOG_WARN_FMT("重命名日志归档失败: {} 错误: {}", archive, ec.message());
+    std::filesystem::remove(tempArchive, ec);
+    return false;
+  }
+  std::filesystem::remove(segment, ec);
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  LOG_DEBUG_FMT("日志分段已压缩: {} {} -> {} 字节 耗时 {} ms", archive, inputBytes, outputBytes, elapsed.count());
+  return true;
+}
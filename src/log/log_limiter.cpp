@@ -0,0 +1,199 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 19:16:03
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 19:16:03
+ * @FilePath: \GameOptimizerPro\src\log\log_limiter.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "log/log_limiter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
+#include <thread>
+
+#include "log/logging.h"
+
+namespace
+{
+  // 令牌的计数单位 补充令牌时按毫秒折算
+  constexpr uint64_t kTokenScale = 1000;
+
+  // 汇总记录的日志点
+  LogSite summarySite(Logging::LogLevel::LOG_WARNING, __FILE__, "LogLimiter", __LINE__,
+                      "{}:{} 的日志在 {} 秒内重复 {} 次，已合并 (HRESULT: {})");
+} // namespace
+
+std::atomic<LogLimiter *> LogLimiter::s_head{nullptr};
+std::atomic<int> LogLimiter::s_burst{10};
+std::atomic<int> LogLimiter::s_windowMs{10000};
+
+bool LogLimiter::allow(const LogSite &site, HRESULT hr)
+{
+  const int burst = s_burst.load(std::memory_order_relaxed);
+  if (burst <= 0)
+  {
+    return true;
+  }
+  registerOnce(site);
+
+  const uint64_t windowMs = static_cast<uint64_t>(std::max(1, s_windowMs.load(std::memory_order_relaxed)));
+  const uint64_t capacity = static_cast<uint64_t>(burst) * kTokenScale;
+
+  // 替换错误码和本次记录各可能产生一条汇总
+  Summary summaries[2];
+  size_t summaryCount = 0;
+  bool allowed = false;
+
+  lock();
+  // 在锁内取时间 保证同一槽中的时间单调
+  const uint64_t now = GetTickCount64();
+  Slot *slot = nullptr;
+  for (Slot &candidate : m_slots)
+  {
+    if (candidate.used && candidate.hr == hr)
+    {
+      slot = &candidate;
+      break;
+    }
+  }
+  if (!slot)
+  {
+    // 优先使用空槽 否则替换最久未出现的错误码 并写出它的汇总
+    slot = &m_slots[0];
+    for (Slot &candidate : m_slots)
+    {
+      if (!candidate.used)
+      {
+        slot = &candidate;
+        break;
+      }
+      if (candidate.lastSeenMs < slot->lastSeenMs)
+      {
+        slot = &candidate;
+      }
+    }
+    if (slot->used && takeSummary(*slot, now, summaries[summaryCount]))
+    {
+      ++summaryCount;
+    }
+    *slot = Slot();
+    slot->hr = hr;
+    slot->used = true;
+    slot->tokens = capacity;
+    slot->lastRefillMs = now;
+  }
+
+  // 按经过的时间补充令牌 一个窗口补满
+  const uint64_t elapsed = std::min(now - slot->lastRefillMs, windowMs);
+  slot->tokens = std::min(capacity, slot->tokens + elapsed * capacity / windowMs);
+  slot->lastRefillMs = now;
+  slot->lastSeenMs = now;
+
+  allowed = slot->tokens >= kTokenScale;
+  if (allowed)
+  {
+    slot->tokens -= kTokenScale;
+  }
+  else
+  {
+    if (slot->suppressed == 0)
+    {
+      slot->suppressedSinceMs = now;
+    }
+    ++slot->suppressed;
+  }
+  // 持续重复时每个窗口最多写出一次汇总 重复停止后剩余的数量在下次出现或关闭日志时写出
+  if (now - slot->suppressedSinceMs >= windowMs && takeSummary(*slot, now, summaries[summaryCount]))
+  {
+    ++summaryCount;
+  }
+  unlock();
+
+  for (size_t i = 0; i < summaryCount; ++i)
+  {
+    writeSummary(site, summaries[i]);
+  }
+  return allowed;
+}
+
+void LogLimiter::configure(int burst, int windowSeconds)
+{
+  s_burst.store(std::max(0, burst), std::memory_order_relaxed);
+  s_windowMs.store(std::max(1, windowSeconds) * 1000, std::memory_order_relaxed);
+}
+
+void LogLimiter::flushAll()
+{
+  const uint64_t now = GetTickCount64();
+  for (LogLimiter *limiter = s_head.load(std::memory_order_acquire); limiter; limiter = limiter->m_next)
+  {
+    Summary summaries[kSlots];
+    size_t summaryCount = 0;
+    limiter->lock();
+    for (Slot &slot : limiter->m_slots)
+    {
+      if (slot.used && takeSummary(slot, now, summaries[summaryCount]))
+      {
+        ++summaryCount;
+      }
+    }
+    limiter->unlock();
+
+    for (size_t i = 0; i < summaryCount; ++i)
+    {
+      writeSummary(*limiter->m_site, summaries[i]);
+    }
+  }
+}
+
+void LogLimiter::lock()
+{
+  // 临界区只有几十条指令 自旋等待即可
+  while (m_lock.test_and_set(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+}
+
+void LogLimiter::unlock()
+{
+  m_lock.clear(std::memory_order_release);
+}
+
+bool LogLimiter::takeSummary(Slot &slot, uint64_t now, Summary &summary)
+{
+  if (slot.suppressed == 0)
+  {
+    return false;
+  }
+  summary.hr = slot.hr;
+  summary.count = slot.suppressed;
+  summary.elapsedMs = now - slot.suppressedSinceMs;
+  slot.suppressed = 0;
+  return true;
+}
+
+void LogLimiter::writeSummary(const LogSite &site, const Summary &summary)
+{
+  char hrText[16];
+  std::snprintf(hrText, sizeof(hrText), "0x%08X", static_cast<unsigned int>(summary.hr));
+  const double seconds = static_cast<double>(std::max<uint64_t>(summary.elapsedMs, 1)) / 1000.0;
+  Logging::write(summarySite, S_OK, true, site.function, site.line, seconds, summary.count, std::string_view(hrText));
+}
+
+void LogLimiter::registerOnce(const LogSite &site)
+{
+  if (m_registered.load(std::memory_order_acquire) || m_registered.exchange(true, std::memory_order_acq_rel))
+  {
+    return;
+  }
+  m_site = &site;
+  LogLimiter *head = s_head.load(std::memory_order_relaxed);
+  do
+  {
+    m_next = head;
+  } while (!s_head.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+}
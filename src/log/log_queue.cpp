@@ -0,0 +1,151 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 16:43:02
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 16:43:02
+ * @FilePath: \GameOptimizerPro\src\log\log_queue.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "log/log_queue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+LogQueue::LogQueue(size_t slotCount)
+{
+  // 至少能容纳两条最长的记录
+  size_t capacity = kMaxRecordSlots * 2;
+  while (capacity < slotCount)
+  {
+    capacity <<= 1;
+  }
+
+  m_slots = std::make_unique<Slot[]>(capacity);
+  m_mask = capacity - 1;
+  for (size_t i = 0; i < capacity; ++i)
+  {
+    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+LogQueue::~LogQueue() = default;
+
+bool LogQueue::push(const LogRecordHeader &header, const void *args, bool waitIfFull)
+{
+  const size_t totalBytes = sizeof(LogRecordHeader) + std::min<size_t>(header.argsBytes, kMaxArgsBytes);
+  const size_t slotCount = (totalBytes + kSlotPayload - 1) / kSlotPayload;
+
+  // 消费者按顺序归还槽位 最后一个槽空闲说明前面的槽都已空闲
+  uint64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    const uint64_t lastPosition = position + slotCount - 1;
+    const uint64_t sequence = m_slots[lastPosition & m_mask].sequence.load(std::memory_order_acquire);
+    const int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(lastPosition);
+    if (difference == 0)
+    {
+      if (m_enqueuePosition.compare_exchange_weak(position, position + slotCount, std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (difference < 0)
+    {
+      // 队列已满
+      if (!waitIfFull)
+      {
+        return false;
+      }
+      std::this_thread::yield();
+      position = m_enqueuePosition.load(std::memory_order_relaxed);
+    }
+    else
+    {
+      // 被其他生产者抢先认领
+      position = m_enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+
+  writeBytes(position, 0, &header, sizeof(LogRecordHeader));
+  writeBytes(position, sizeof(LogRecordHeader), args, totalBytes - sizeof(LogRecordHeader));
+
+  // 倒序发布 消费者看到首个槽发布时整条记录都已可读
+  for (size_t i = slotCount; i-- > 0;)
+  {
+    m_slots[(position + i) & m_mask].sequence.store(position + i + 1, std::memory_order_release);
+  }
+  return true;
+}
+
+bool LogQueue::pop(std::vector<char> &record)
+{
+  const uint64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+  if (m_slots[position & m_mask].sequence.load(std::memory_order_acquire) != position + 1)
+  {
+    return false;
+  }
+
+  LogRecordHeader header;
+  readBytes(position, 0, &header, sizeof(LogRecordHeader));
+  const size_t totalBytes = sizeof(LogRecordHeader) + std::min<size_t>(header.argsBytes, kMaxArgsBytes);
+  const size_t slotCount = (totalBytes + kSlotPayload - 1) / kSlotPayload;
+
+  record.resize(totalBytes);
+  readBytes(position, 0, record.data(), totalBytes);
+
+  const uint64_t capacity = m_mask + 1;
+  for (size_t i = 0; i < slotCount; ++i)
+  {
+    m_slots[(position + i) & m_mask].sequence.store(position + i + capacity, std::memory_order_release);
+  }
+  m_dequeuePosition.store(position + slotCount, std::memory_order_release);
+  return true;
+}
+
+bool LogQueue::hasPending() const
+{
+  const uint64_t position = m_dequeuePosition.load(std::memory_order_acquire);
+  return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) == position + 1;
+}
+
+size_t LogQueue::pendingSlots() const
+{
+  const uint64_t dequeuePosition = m_dequeuePosition.load(std::memory_order_relaxed);
+  const uint64_t enqueuePosition = m_enqueuePosition.load(std::memory_order_relaxed);
+  return enqueuePosition > dequeuePosition ? static_cast<size_t>(enqueuePosition - dequeuePosition) : 0;
+}
+
+size_t LogQueue::capacity() const
+{
+  return m_mask + 1;
+}
+
+void LogQueue::writeBytes(uint64_t position, size_t offset, const void *data, size_t bytes)
+{
+  const char *source = static_cast<const char *>(data);
+  while (bytes > 0)
+  {
+    const size_t slotOffset = offset % kSlotPayload;
+    const size_t chunk = std::min(bytes, kSlotPayload - slotOffset);
+    std::memcpy(m_slots[(position + offset / kSlotPayload) & m_mask].payload + slotOffset, source, chunk);
+    source += chunk;
+    offset += chunk;
+    bytes -= chunk;
+  }
+}
+
+void LogQueue::readBytes(uint64_t position, size_t offset, void *data, size_t bytes) const
+{
+  char *target = static_cast<char *>(data);
+  while (bytes > 0)
+  {
+    const size_t slotOffset = offset % kSlotPayload;
+    const size_t chunk = std::min(bytes, kSlotPayload - slotOffset);
+    std::memcpy(target, m_slots[(position + offset / kSlotPayload) & m_mask].payload + slotOffset, chunk);
+    target += chunk;
+    offset += chunk;
+    bytes -= chunk;
+  }
+}
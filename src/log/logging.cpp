@@ -9,12 +9,107 @@
  */
 #include "log/logging.h"
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <exception>
+
+#include "log/flight_recorder.h"
+#include "log/log_archiver.h"
+
+namespace
+{
+  // 异步队列的槽数 每槽 128 字节
+  constexpr size_t kQueueSlots = 8192;
+  // 写线程没有被唤醒时的轮询间隔
+  constexpr auto kWriterPollInterval = std::chrono::milliseconds(100);
+  // 单批最多取出的记录数 避免长时间持有文件锁
+  constexpr size_t kMaxBatchRecords = 4096;
+
+  // 队列已满时写线程补记的日志点
+  LogSite droppedSite(Logging::LogLevel::LOG_WARNING, __FILE__, "Logging::drainQueue", __LINE__,
+                      "日志队列已满，丢弃了 {} 条 INFO/DEBUG 日志");
+
+  // 飞行记录器的槽数 每槽 256 字节
+  constexpr size_t kFlightRecorderSlots = 4096;
+  // 严重错误触发转储的最小间隔 毫秒
+  constexpr uint64_t kErrorDumpIntervalMs = 60 * 1000;
+
+  // 每小时的 FILETIME 计数（100 纳秒）
+  constexpr uint64_t kTicksPerHour = 36000000000ULL;
+
+  uint64_t toTicks(const FILETIME &fileTime)
+  {
+    return (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+  }
+
+  FILETIME toFileTime(uint64_t ticks)
+  {
+    FILETIME fileTime;
+    fileTime.dwLowDateTime = static_cast<DWORD>(ticks & 0xFFFFFFFF);
+    fileTime.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+    return fileTime;
+  }
+
+  uint64_t currentFileTime()
+  {
+    FILETIME fileTime;
+    GetSystemTimeAsFileTime(&fileTime);
+    return toTicks(fileTime);
+  }
+
+  // 按本地时间对齐的轮换周期序号 间隔为 24 小时时每天零点换一个周期
+  uint64_t rotationPeriod(uint64_t utcTicks, int intervalHours)
+  {
+    const FILETIME utcTime = toFileTime(utcTicks);
+    FILETIME localTime;
+    if (!FileTimeToLocalFileTime(&utcTime, &localTime))
+    {
+      localTime = utcTime;
+    }
+    return toTicks(localTime) / (kTicksPerHour * static_cast<uint64_t>(intervalHours));
+  }
+} // namespace
+
 // 定义静态变量
 std::mutex Logging::m_mutex;
-std::wofstream Logging::m_logFileStream;
-bool Logging::m_isInitialized = false;
+std::ofstream Logging::m_logFileStream;
+std::atomic<bool> Logging::m_isInitialized{false};
 std::wstring Logging::m_logFilePath;
 
+std::atomic<int> Logging::m_outputFormat{static_cast<int>(Logging::OutputFormat::Text)};
+std::ofstream Logging::m_binaryFileStream;
+std::wstring Logging::m_binaryFilePath;
+std::vector<bool> Logging::m_writtenSites;
+uint32_t Logging::m_nextSiteId = 0;
+
+std::atomic<bool> Logging::m_async{false};
+std::unique_ptr<LogQueue> Logging::m_queue;
+std::thread Logging::m_writerThread;
+std::mutex Logging::m_writerMutex;
+std::condition_variable Logging::m_writerCondition;
+std::atomic<bool> Logging::m_stopWriter{false};
+std::atomic<bool> Logging::m_wakeWriter{false};
+std::atomic<int> Logging::m_flushPolicy{static_cast<int>(Logging::FlushPolicy::EveryBatch)};
+std::atomic<int> Logging::m_flushIntervalMs{1000};
+std::atomic<uint64_t> Logging::m_droppedCount{0};
+std::mutex Logging::m_configureMutex;
+
+std::atomic<uint64_t> Logging::m_maxFileBytes{0};
+std::atomic<int> Logging::m_rotateIntervalHours{0};
+uint64_t Logging::m_textFileBytes = 0;
+uint64_t Logging::m_textSegmentStart = 0;
+uint64_t Logging::m_binaryFileBytes = 0;
+uint64_t Logging::m_binarySegmentStart = 0;
+std::unique_ptr<LogArchiver> Logging::m_archiver;
+
+std::atomic<int> Logging::m_moduleLevels[Logging::kModuleCount] = {};
+
+std::unique_ptr<FlightRecorder> Logging::m_flightRecorder;
+std::atomic<bool> Logging::m_recording{false};
+std::atomic<bool> Logging::m_dumping{false};
+std::atomic<uint64_t> Logging::m_lastErrorDumpMs{0};
+
 // 初始化日志系统
 bool Logging::initialize(const std::wstring &logFilePath)
 {
@@ -44,12 +139,12 @@ bool Logging::initialize(const std::wstring &logFilePath)
       }
     }
 
-    // 设置日志文件路径
+    // 设置日志文件路径 二进制日志与文本日志同名 扩展名为 .binlog
     m_logFilePath = logFilePath;
+    m_binaryFilePath = std::filesystem::path(logFilePath).replace_extension(L".binlog").wstring();
 
-    // 直接使用 wstring 路径打开 (需要转换为窄字符)
-
-    m_logFileStream.open(m_logFilePath.c_str(), std::ios::app | std::ios::out);
+    // 日志内容已经是 UTF-8 以二进制方式打开 直接写入字节
+    m_logFileStream.open(m_logFilePath.c_str(), std::ios::binary | std::ios::app | std::ios::out);
 
     if (!m_logFileStream.is_open())
     {
@@ -59,21 +154,13 @@ bool Logging::initialize(const std::wstring &logFilePath)
       return false;
     }
 
-    try
-    {
-      m_logFileStream.imbue(std::locale(""));
-    }
-    catch (const std::runtime_error &e)
-    {
-      // 如果设置locale失败，记录一个警告，但继续执行
-      // 可以考虑回退到经典 "C" locale
-      std::wcerr << L"Warning: Failed to set locale for log file. Error: "
-                 << MultiByteToWide(e.what()) // 使用辅助函数转换异常消息
-                 << L". Using default C locale." << std::endl;
-      m_logFileStream.imbue(std::locale::classic());
-    }
+    beginSegment(m_logFilePath, m_textFileBytes, m_textSegmentStart);
 
+    m_queue = std::make_unique<LogQueue>(kQueueSlots);
+    m_archiver = std::make_unique<LogArchiver>();
+    m_flightRecorder = std::make_unique<FlightRecorder>(kFlightRecorderSlots);
     m_isInitialized = true;
+    configure(Options());
     LOG_INFO(L"Logging system initialized successfully. Log file: " + m_logFilePath);
     return true;
   }
@@ -100,8 +187,660 @@ void Logging::shutdown()
   if (m_isInitialized && m_logFileStream.is_open())
   {
     LOG_INFO(L"Shutting down logging system.");
-    m_logFileStream.close();
+    // 写出限流日志点尚未写出的汇总
+    LogLimiter::flushAll();
+    {
+      std::lock_guard<std::mutex> configureLock(m_configureMutex);
+      // 归档线程会写日志 先于写线程停止
+      m_archiver->stop();
+      stopWriter();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 停止写线程时仍在写入的记录
+    std::string textBatch;
+    std::string binaryBatch;
+    while (m_queue->hasPending())
+    {
+      drainQueue(textBatch, binaryBatch);
+    }
+    writeToFile(textBatch, binaryBatch, true);
     m_isInitialized = false;
+    m_logFileStream.close();
+    if (m_binaryFileStream.is_open())
+    {
+      m_binaryFileStream.close();
+    }
+  }
+}
+
+void Logging::configure(const Options &options)
+{
+  std::lock_guard<std::mutex> configureLock(m_configureMutex);
+  m_flushPolicy.store(static_cast<int>(options.flushPolicy), std::memory_order_relaxed);
+  m_flushIntervalMs.store(options.flushIntervalMs > 0 ? options.flushIntervalMs : 1000, std::memory_order_relaxed);
+  {
+    // 队列中的记录按取出时的格式写入
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outputFormat.store(static_cast<int>(options.format), std::memory_order_relaxed);
+  }
+
+  // 模块级别立即生效 已进入队列的记录仍会写出
+  for (size_t i = 0; i < kModuleCount; ++i)
+  {
+    m_moduleLevels[i].store(options.moduleLevels[i], std::memory_order_relaxed);
+  }
+
+  LogLimiter::configure(options.rateLimitBurst, options.rateLimitWindowSeconds);
+  m_recording.store(options.flightRecorder && m_flightRecorder, std::memory_order_relaxed);
+
+  // 轮换参数在下一批记录写入前生效 归档参数变化后立即整理一次已有的分段
+  m_maxFileBytes.store(options.maxFileBytes, std::memory_order_relaxed);
+  m_rotateIntervalHours.store(std::max(0, options.rotateIntervalHours), std::memory_order_relaxed);
+  m_archiver->configure(options.maxArchives, options.compressArchives);
+  if (options.maxArchives > 0 || options.compressArchives)
+  {
+    m_archiver->submit(m_logFilePath);
+    m_archiver->submit(m_binaryFilePath);
+  }
+
+  if (options.async && !m_writerThread.joinable())
+  {
+    startWriter();
+  }
+  else if (!options.async && m_writerThread.joinable())
+  {
+    stopWriter();
+  }
+}
+
+Logging::FlushPolicy Logging::flushPolicyFromString(const std::string &flushPolicy)
+{
+  if (flushPolicy == "interval")
+  {
+    return FlushPolicy::Interval;
+  }
+  if (flushPolicy == "error")
+  {
+    return FlushPolicy::OnError;
+  }
+  return FlushPolicy::EveryBatch;
+}
+
+std::string Logging::flushPolicyToString(FlushPolicy flushPolicy)
+{
+  switch (flushPolicy)
+  {
+  case FlushPolicy::Interval:
+    return "interval";
+  case FlushPolicy::OnError:
+    return "error";
+  default:
+    return "batch";
+  }
+}
+
+Logging::OutputFormat Logging::outputFormatFromString(const std::string &format)
+{
+  return format == "binary" ? OutputFormat::Binary : OutputFormat::Text;
+}
+
+int Logging::levelFromString(const std::string &level)
+{
+  if (level == "debug")
+  {
+    return LOG_LEVEL_DEBUG;
+  }
+  if (level == "warn")
+  {
+    return LOG_LEVEL_WARN;
+  }
+  if (level == "error")
+  {
+    return LOG_LEVEL_ERROR;
+  }
+  if (level == "off")
+  {
+    return LOG_LEVEL_OFF;
+  }
+  return LOG_LEVEL_INFO;
+}
+
+std::string &Logging::getArgsBuffer()
+{
+  thread_local std::string argsBuffer;
+  return argsBuffer;
+}
+
+void Logging::appendArg(std::string &buffer, BinLog::ArgType type, const void *value, size_t bytes)
+{
+  if (buffer.size() + 1 + bytes > LogQueue::kMaxArgsBytes)
+  {
+    return;
+  }
+  buffer.push_back(static_cast<char>(type));
+  buffer.append(static_cast<const char *>(value), bytes);
+}
+
+void Logging::appendStringArg(std::string &buffer, BinLog::ArgType type, const void *data, size_t bytes)
+{
+  constexpr size_t headerBytes = 1 + sizeof(uint32_t);
+  if (buffer.size() + headerBytes > LogQueue::kMaxArgsBytes)
+  {
+    return;
+  }
+
+  // 超长的字符串截断 UTF-16 保持按字符截断
+  size_t length = std::min(bytes, LogQueue::kMaxArgsBytes - buffer.size() - headerBytes);
+  if (type == BinLog::ArgType::Utf16)
+  {
+    length &= ~static_cast<size_t>(1);
+  }
+
+  const uint32_t length32 = static_cast<uint32_t>(length);
+  buffer.push_back(static_cast<char>(type));
+  buffer.append(reinterpret_cast<const char *>(&length32), sizeof(length32));
+  buffer.append(static_cast<const char *>(data), length);
+}
+
+bool Logging::enqueue(const LogRecordHeader &header, const void *args)
+{
+  const bool important = header.site->level == LOG_ERROR || header.site->level == LOG_WARNING;
+  if (!m_queue->push(header, args, important))
+  {
+    m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // 写线程按轮询间隔批量取出 只有错误或积压过半时立即唤醒
+  if (important || m_queue->pendingSlots() > m_queue->capacity() / 2)
+  {
+    m_wakeWriter.store(true, std::memory_order_release);
+    m_writerCondition.notify_one();
+  }
+  return true;
+}
+
+void Logging::writeSync(const LogRecordHeader &header, const void *args)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_isInitialized)
+  {
+    return;
+  }
+
+  // 从异步模式切换过来时 队列中可能还有残留的记录 先按顺序写出
+  std::string textBatch;
+  std::string binaryBatch;
+  rotateFilesIfNeeded();
+  if (m_queue && m_queue->hasPending())
+  {
+    drainQueue(textBatch, binaryBatch);
+  }
+  appendRecord(header, static_cast<const char *>(args), header.argsBytes, textBatch, binaryBatch);
+  writeToFile(textBatch, binaryBatch, true);
+}
+
+namespace
+{
+  /**
+   * @brief 时间戳文本缓存 [YYYY-MM-DD HH:MM:SS.mmm]
+   * @note 同一毫秒的记录直接复用，同一秒内只改写毫秒部分
+   * @note 每个线程一份 转储飞行记录器时不需要持有日志文件锁
+   */
+  struct TimestampCache
+  {
+    uint64_t millisecond = UINT64_MAX;
+    uint64_t second = UINT64_MAX;
+    char text[32] = {};
+    size_t length = 0;
+  };
+
+  thread_local TimestampCache timestampCache;
+
+  void appendTimestamp(std::string &output, uint64_t utcTicks)
+  {
+    TimestampCache &cache = timestampCache;
+    const uint64_t millisecond = utcTicks / 10000;
+    if (millisecond != cache.millisecond)
+    {
+      const uint64_t second = millisecond / 1000;
+      const unsigned milliseconds = static_cast<unsigned>(millisecond % 1000);
+      if (second != cache.second)
+      {
+        // 记录中保存的是 UTC 时间 转为本地时间输出
+        const FILETIME utcTime = toFileTime(utcTicks);
+        FILETIME localTime;
+        SYSTEMTIME st = {};
+        FileTimeToLocalFileTime(&utcTime, &localTime);
+        FileTimeToSystemTime(&localTime, &st);
+        const int length = snprintf(cache.text, sizeof(cache.text), "[%04d-%02d-%02d %02d:%02d:%02d.%03u]",
+                                    st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, milliseconds);
+        cache.length = length > 0 ? static_cast<size_t>(length) : 0;
+        cache.second = second;
+      }
+      else if (cache.length >= 5)
+      {
+        // 毫秒位于 "]" 之前的 3 个字符
+        char *digits = cache.text + cache.length - 4;
+        digits[0] = static_cast<char>('0' + milliseconds / 100);
+        digits[1] = static_cast<char>('0' + milliseconds / 10 % 10);
+        digits[2] = static_cast<char>('0' + milliseconds % 10);
+      }
+      cache.millisecond = millisecond;
+    }
+    output.append(cache.text, cache.length);
+  }
+
+  template <typename T>
+  void appendBinary(std::string &output, const T &value)
+  {
+    output.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+} // namespace
+
+void Logging::appendRecord(const LogRecordHeader &header, const char *args, size_t argsBytes,
+                           std::string &textBatch, std::string &binaryBatch)
+{
+  if (static_cast<OutputFormat>(m_outputFormat.load(std::memory_order_relaxed)) == OutputFormat::Binary)
+  {
+    encodeRecord(header, args, argsBytes, binaryBatch);
+  }
+  else
+  {
+    formatRecord(header, args, argsBytes, textBatch);
+  }
+}
+
+void Logging::formatRecord(const LogRecordHeader &header, const char *args, size_t argsBytes, std::string &output)
+{
+  // 确定日志级别字符串
+  const LogSite &site = *header.site;
+  const char *levelStr = "UNKNOWN";
+  switch (site.level)
+  {
+  case LogLevel::LOG_INFO:
+    levelStr = "INFO";
+    break;
+  case LogLevel::LOG_WARNING:
+    levelStr = "WARN";
+    break;
+  case LogLevel::LOG_ERROR:
+    levelStr = "ERROR";
+    break;
+  case LogLevel::LOG_DEBUG:
+    levelStr = "DEBUG";
+    break;
+  }
+
+  // [YYYY-MM-DD HH:MM:SS.ms][LEVEL][Function:Line] Message (HRESULT: 0x...)
+  // 格式串和窄字符参数已经是 UTF-8 直接追加 宽字符参数在这里转换一次
+  appendTimestamp(output, header.timestamp);
+  output += '[';
+  output += levelStr;
+  output += "][";
+  output += site.function;
+  output += ':';
+  BinLog::appendNumber(output, site.line);
+  output += "] ";
+  BinLog::render(
+      site.format, args, argsBytes,
+      [&output](const char *text, size_t length)
+      { output.append(text, length); },
+      [&output](const BinLog::Arg &arg)
+      { BinLog::appendArgText(output, arg); });
+
+  // 如果它是错误代码，附加 HRESULT 和描述
+  const HRESULT hr = static_cast<HRESULT>(header.hr);
+  if (FAILED(hr))
+  {
+    char hrBuf[20];
+    snprintf(hrBuf, sizeof(hrBuf), "0x%08X", static_cast<unsigned int>(hr));
+    _com_error err(hr);
+    const wchar_t *description = err.ErrorMessage();
+    output += " (HRESULT: ";
+    output += hrBuf;
+    output += ", Description: ";
+    BinLog::appendUtf16(output, reinterpret_cast<const char *>(description), wcslen(description) * sizeof(wchar_t));
+    output += ")";
+  }
+  output += "\n";
+}
+
+void Logging::encodeRecord(const LogRecordHeader &header, const char *args, size_t argsBytes, std::string &output)
+{
+  // 日志点编号在第一次写入二进制日志时分配
+  LogSite &site = *header.site;
+  if (site.id == 0)
+  {
+    site.id = ++m_nextSiteId;
+  }
+
+  if (site.id >= m_writtenSites.size())
+  {
+    m_writtenSites.resize(site.id + 1, false);
+  }
+  if (!m_writtenSites[site.id])
+  {
+    m_writtenSites[site.id] = true;
+    const uint16_t functionBytes = static_cast<uint16_t>(std::min<size_t>(strlen(site.function), UINT16_MAX));
+    const uint16_t fileBytes = static_cast<uint16_t>(std::min<size_t>(strlen(site.file), UINT16_MAX));
+    const uint32_t formatBytes = static_cast<uint32_t>(strlen(site.format));
+    appendBinary(output, BinLog::RecordType::Site);
+    appendBinary(output, site.id);
+    appendBinary(output, static_cast<uint8_t>(site.level));
+    appendBinary(output, static_cast<int32_t>(site.line));
+    appendBinary(output, functionBytes);
+    output.append(site.function, functionBytes);
+    appendBinary(output, fileBytes);
+    output.append(site.file, fileBytes);
+    appendBinary(output, formatBytes);
+    output.append(site.format, formatBytes);
+  }
+
+  appendBinary(output, BinLog::RecordType::Event);
+  appendBinary(output, site.id);
+  appendBinary(output, header.timestamp);
+  appendBinary(output, header.hr);
+  appendBinary(output, static_cast<uint32_t>(argsBytes));
+  output.append(args, argsBytes);
+}
+
+bool Logging::drainQueue(std::string &textBatch, std::string &binaryBatch)
+{
+  // 写线程私有的缓冲 重复使用避免每条记录分配
+  static std::vector<char> record;
+  bool important = false;
+
+  const uint64_t dropped = m_droppedCount.exchange(0, std::memory_order_relaxed);
+  size_t count = 0;
+  while (count < kMaxBatchRecords && m_queue->pop(record))
+  {
+    LogRecordHeader header;
+    std::memcpy(&header, record.data(), sizeof(LogRecordHeader));
+    appendRecord(header, record.data() + sizeof(LogRecordHeader), record.size() - sizeof(LogRecordHeader),
+                 textBatch, binaryBatch);
+    important = important || header.site->level == LOG_ERROR || header.site->level == LOG_WARNING;
+    ++count;
+  }
+
+  if (dropped > 0)
+  {
+    std::string args;
+    encodeArg(args, dropped);
+
+    LogRecordHeader header;
+    header.timestamp = currentFileTime();
+    header.site = &droppedSite;
+    header.argsBytes = static_cast<uint32_t>(args.size());
+    appendRecord(header, args.data(), args.size(), textBatch, binaryBatch);
+  }
+  return important;
+}
+
+bool Logging::openBinaryFile()
+{
+  if (m_binaryFileStream.is_open() && !m_binaryFileStream.fail())
+  {
+    return true;
+  }
+
+  m_binaryFileStream.close();
+  m_binaryFileStream.clear();
+  m_binaryFileStream.open(m_binaryFilePath, std::ios::binary | std::ios::app | std::ios::out);
+  if (!m_binaryFileStream.is_open())
+  {
+    std::wcerr << L"Failed to open binary log file: " << m_binaryFilePath << std::endl;
+    return false;
+  }
+
+  // 追加写入时日志点定义只在本进程写入的部分中有效 每次打开都重新写入定义
+  std::fill(m_writtenSites.begin(), m_writtenSites.end(), false);
+  m_binaryFileStream.seekp(0, std::ios::end);
+  if (m_binaryFileStream.tellp() == std::streampos(0))
+  {
+    BinLog::FileHeader fileHeader = {};
+    std::memcpy(fileHeader.magic, BinLog::kMagic, sizeof(fileHeader.magic));
+    fileHeader.version = BinLog::kVersion;
+    m_binaryFileStream.write(reinterpret_cast<const char *>(&fileHeader), sizeof(fileHeader));
+  }
+  beginSegment(m_binaryFilePath, m_binaryFileBytes, m_binarySegmentStart);
+  return true;
+}
+
+void Logging::rotateFilesIfNeeded()
+{
+  try
+  {
+    const uint64_t now = currentFileTime();
+
+    if (m_logFileStream.is_open() && shouldRotate(m_textFileBytes, m_textSegmentStart, now))
+    {
+      m_logFileStream.close();
+      const bool archived = archiveFile(m_logFilePath, now);
+      if (ReopenLogFile() && !archived)
+      {
+        // 重命名失败（例如文件被其他程序独占）时继续写入原文件 推迟到下一个周期再尝试
+        m_textFileBytes = 0;
+        m_textSegmentStart = now;
+      }
+    }
+
+    // 编码前轮换 新文件打开时会清空已写入的日志点定义
+    if (static_cast<OutputFormat>(m_outputFormat.load(std::memory_order_relaxed)) == OutputFormat::Binary)
+    {
+      if (m_binaryFileStream.is_open() && shouldRotate(m_binaryFileBytes, m_binarySegmentStart, now))
+      {
+        m_binaryFileStream.close();
+        const bool archived = archiveFile(m_binaryFilePath, now);
+        if (openBinaryFile() && !archived)
+        {
+          m_binaryFileBytes = 0;
+          m_binarySegmentStart = now;
+        }
+      }
+      else
+      {
+        openBinaryFile();
+      }
+    }
+  }
+  catch (...)
+  {
+    // 与 writeToFile 相同 写线程中抛出的异常会终止程序
+    std::cerr << "Exception while rotating log file." << std::endl;
+  }
+}
+
+bool Logging::shouldRotate(uint64_t fileBytes, uint64_t segmentStart, uint64_t now)
+{
+  const uint64_t maxFileBytes = m_maxFileBytes.load(std::memory_order_relaxed);
+  if (maxFileBytes > 0 && fileBytes >= maxFileBytes)
+  {
+    return true;
+  }
+
+  // 空文件不按时间轮换 二进制日志只有文件头时也视为空文件
+  const int intervalHours = m_rotateIntervalHours.load(std::memory_order_relaxed);
+  return intervalHours > 0 && fileBytes > sizeof(BinLog::FileHeader) &&
+         rotationPeriod(segmentStart, intervalHours) != rotationPeriod(now, intervalHours);
+}
+
+bool Logging::archiveFile(const std::wstring &filePath, uint64_t now)
+{
+  const FILETIME utcTime = toFileTime(now);
+  FILETIME localTime;
+  SYSTEMTIME st = {};
+  FileTimeToLocalFileTime(&utcTime, &localTime);
+  FileTimeToSystemTime(&localTime, &st);
+
+  // 只重命名 压缩和清理交给归档线程
+  const std::wstring segment = LogArchiver::segmentPath(filePath, st);
+  if (!MoveFileExW(filePath.c_str(), segment.c_str(), 0))
+  {
+    std::wcerr << L"Failed to rotate log file: " << filePath << L" error: " << GetLastError() << std::endl;
+    return false;
+  }
+  m_archiver->submit(filePath);
+  return true;
+}
+
+void Logging::beginSegment(const std::wstring &filePath, uint64_t &fileBytes, uint64_t &segmentStart)
+{
+  WIN32_FILE_ATTRIBUTE_DATA attributes;
+  if (GetFileAttributesExW(filePath.c_str(), GetFileExInfoStandard, &attributes) &&
+      (attributes.nFileSizeHigh != 0 || attributes.nFileSizeLow != 0))
+  {
+    fileBytes = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    segmentStart = toTicks(attributes.ftLastWriteTime);
+    return;
+  }
+  fileBytes = 0;
+  segmentStart = currentFileTime();
+}
+
+bool Logging::writeToFile(const std::string &textBatch, const std::string &binaryBatch, bool flush)
+{
+  bool result = true;
+  try
+  {
+    // 确保日志流已打开且准备就绪
+    if (!textBatch.empty() || flush)
+    {
+      if ((!m_logFileStream.is_open() || m_logFileStream.fail()) && !ReopenLogFile())
+      {
+        // 如果重新打开失败，无法记录日志。输出到标准错误流可能是一个选项。
+        std::wcerr << L"Cannot write to log file: " << m_logFilePath << std::endl;
+        result = false;
+      }
+      else
+      {
+        m_logFileStream.write(textBatch.data(), static_cast<std::streamsize>(textBatch.size()));
+        m_textFileBytes += textBatch.size();
+        if (flush)
+        {
+          m_logFileStream.flush();
+        }
+      }
+    }
+
+    if (!binaryBatch.empty())
+    {
+      if (!openBinaryFile())
+      {
+        result = false;
+      }
+      else
+      {
+        m_binaryFileStream.write(binaryBatch.data(), static_cast<std::streamsize>(binaryBatch.size()));
+        m_binaryFileBytes += binaryBatch.size();
+      }
+    }
+    if (flush && m_binaryFileStream.is_open())
+    {
+      m_binaryFileStream.flush();
+    }
+    return result;
+  }
+  catch (const std::ios_base::failure &e)
+  {
+    // 处理写入/刷新期间的潜在流错误
+    std::cerr << "Log stream I/O error: " << e.what() << std::endl;
+    // 考虑关闭流或标记日志记录器失败以防止循环
+    m_logFileStream.close();
+    return false;
+  }
+  catch (...)
+  {
+    // 写线程中抛出的异常会终止程序 这里全部拦截
+    std::cerr << "Unknown exception while writing log file." << std::endl;
+    return false;
+  }
+}
+
+void Logging::startWriter()
+{
+  m_stopWriter = false;
+  m_writerThread = std::thread(&Logging::writerLoop);
+  m_async.store(true, std::memory_order_release);
+}
+
+void Logging::stopWriter()
+{
+  if (!m_writerThread.joinable())
+  {
+    return;
+  }
+
+  // 先切回同步写入 再让写线程写完剩余记录后退出
+  m_async.store(false, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_stopWriter = true;
+  }
+  m_writerCondition.notify_one();
+  m_writerThread.join();
+}
+
+void Logging::writerLoop()
+{
+  std::string textBatch;
+  std::string binaryBatch;
+  auto lastFlush = std::chrono::steady_clock::now();
+  bool unflushed = false;
+
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_writerMutex);
+      m_writerCondition.wait_for(lock, kWriterPollInterval, []
+                                 { return m_stopWriter.load() || m_wakeWriter.load(); });
+    }
+    m_wakeWriter.store(false, std::memory_order_relaxed);
+    const bool stopping = m_stopWriter.load();
+
+    // 写线程中不能调用 LOG_* 队列满时会等待自己
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool important = false;
+    do
+    {
+      textBatch.clear();
+      binaryBatch.clear();
+      rotateFilesIfNeeded();
+      important = drainQueue(textBatch, binaryBatch) || important;
+      if (!textBatch.empty() || !binaryBatch.empty())
+      {
+        writeToFile(textBatch, binaryBatch, false);
+        unflushed = true;
+      }
+    } while (m_queue->hasPending());
+
+    bool flush = false;
+    const auto now = std::chrono::steady_clock::now();
+    switch (static_cast<FlushPolicy>(m_flushPolicy.load(std::memory_order_relaxed)))
+    {
+    case FlushPolicy::EveryBatch:
+      flush = unflushed;
+      break;
+    case FlushPolicy::Interval:
+      flush = unflushed && now - lastFlush >= std::chrono::milliseconds(m_flushIntervalMs.load(std::memory_order_relaxed));
+      break;
+    case FlushPolicy::OnError:
+      flush = important;
+      break;
+    }
+
+    if (flush || (stopping && unflushed))
+    {
+      writeToFile(std::string(), std::string(), true);
+      lastFlush = now;
+      unflushed = false;
+    }
+
+    if (stopping)
+    {
+      break;
+    }
   }
 }
 
@@ -113,24 +852,167 @@ bool Logging::ReopenLogFile()
   }
 
   m_logFileStream.close(); // 确保首先完全关闭
-  m_logFileStream.open(m_logFilePath, std::ios::app | std::ios::out);
+  m_logFileStream.open(m_logFilePath, std::ios::binary | std::ios::app | std::ios::out);
 
   if (!m_logFileStream.is_open())
   {
     std::wcerr << L"Failed to reopen log file: " << m_logFilePath << std::endl;
     return false;
   }
+  beginSegment(m_logFilePath, m_textFileBytes, m_textSegmentStart);
+  return true;
+}
+
+void Logging::recordFlight(const LogRecordHeader &header, const void *args)
+{
+  m_flightRecorder->record(header, args);
+}
+
+namespace
+{
+  LPTOP_LEVEL_EXCEPTION_FILTER previousExceptionFilter = nullptr;
+  std::terminate_handler previousTerminateHandler = nullptr;
+  // 崩溃时只转储一次 abort 会再触发 SIGABRT
+  std::atomic<bool> crashDumped{false};
+
+  const char *dumpTriggerName(Logging::DumpTrigger trigger)
+  {
+    switch (trigger)
+    {
+    case Logging::DumpTrigger::Manual:
+      return "manual";
+    case Logging::DumpTrigger::Error:
+      return "error";
+    default:
+      return "crash";
+    }
+  }
 
-  // 再次尝试设置区域设置
+  LONG WINAPI unhandledExceptionFilter(EXCEPTION_POINTERS *exceptionInfo)
+  {
+    const EXCEPTION_RECORD *record = exceptionInfo ? exceptionInfo->ExceptionRecord : nullptr;
+    char detail[96];
+    snprintf(detail, sizeof(detail), "unhandled exception 0x%08X at %p",
+             record ? static_cast<unsigned int>(record->ExceptionCode) : 0u, record ? record->ExceptionAddress : nullptr);
+    Logging::dumpFlightRecorder(Logging::DumpTrigger::Crash, detail);
+    return previousExceptionFilter ? previousExceptionFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+  }
+
+  void terminateHandler()
+  {
+    Logging::dumpFlightRecorder(Logging::DumpTrigger::Crash, "std::terminate");
+    if (previousTerminateHandler)
+    {
+      previousTerminateHandler();
+    }
+    std::abort();
+  }
+
+  void fatalSignalHandler(int signalNumber)
+  {
+    Logging::dumpFlightRecorder(Logging::DumpTrigger::Crash, "fatal signal " + std::to_string(signalNumber));
+    // 恢复默认处理 交给系统结束进程
+    std::signal(signalNumber, SIG_DFL);
+    std::raise(signalNumber);
+  }
+} // namespace
+
+bool Logging::dumpFlightRecorder(DumpTrigger trigger, const std::string &detail)
+{
+  if (!m_flightRecorder || !m_recording.load(std::memory_order_relaxed))
+  {
+    return false;
+  }
+  if (trigger == DumpTrigger::Crash && crashDumped.exchange(true))
+  {
+    return false;
+  }
+  if (trigger == DumpTrigger::Error)
+  {
+    // 错误连续出现时只转储第一次 之后的记录仍留在环形缓冲中
+    const uint64_t now = GetTickCount64();
+    uint64_t last = m_lastErrorDumpMs.load(std::memory_order_relaxed);
+    if ((last != 0 && now - last < kErrorDumpIntervalMs) ||
+        !m_lastErrorDumpMs.compare_exchange_strong(last, now, std::memory_order_relaxed))
+    {
+      return false;
+    }
+  }
+  if (m_dumping.exchange(true, std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  bool result = false;
+  size_t records = 0;
+  std::wstring dumpPath;
   try
   {
-    m_logFileStream.imbue(std::locale(""));
+    // 只读取环形缓冲 不持有日志文件锁 崩溃的线程可能正持有它
+    const uint64_t end = m_flightRecorder->end();
+    const uint64_t capacity = m_flightRecorder->capacity();
+    const uint64_t begin = end > capacity ? end - capacity : 0;
+
+    std::string text;
+    text.reserve(static_cast<size_t>(end - begin) * 128);
+    text += "# Flight recorder dump (";
+    text += dumpTriggerName(trigger);
+    text += "): ";
+    text += detail;
+    text += "\n";
+
+    LogRecordHeader header;
+    char args[FlightRecorder::kSlotArgsBytes];
+    for (uint64_t index = begin; index < end; ++index)
+    {
+      if (m_flightRecorder->read(index, header, args))
+      {
+        formatRecord(header, args, header.argsBytes, text);
+        ++records;
+      }
+    }
+
+    SYSTEMTIME localTime;
+    GetLocalTime(&localTime);
+    wchar_t suffix[48];
+    swprintf_s(suffix, L".flight-%04d%02d%02d-%02d%02d%02d-%03d.log",
+               localTime.wYear, localTime.wMonth, localTime.wDay,
+               localTime.wHour, localTime.wMinute, localTime.wSecond, localTime.wMilliseconds);
+    const std::filesystem::path logPath(m_logFilePath);
+    dumpPath = (logPath.parent_path() / (logPath.stem().wstring() + suffix)).wstring();
+
+    std::ofstream output(std::filesystem::path(dumpPath), std::ios::binary | std::ios::trunc);
+    output.write(text.data(), static_cast<std::streamsize>(text.size()));
+    output.close();
+    result = static_cast<bool>(output);
   }
-  catch (const std::runtime_error &)
+  catch (...)
   {
-    std::wcerr << L"Warning: Failed to set system locale on reopen. Using C locale." << std::endl;
-    // 回退
-    m_logFileStream.imbue(std::locale::classic());
+    result = false;
+  }
+  m_dumping.store(false, std::memory_order_release);
+
+  // 崩溃时不再写日志 日志文件锁可能被崩溃的线程持有
+  if (trigger != DumpTrigger::Crash)
+  {
+    if (result)
+    {
+      LOG_WARN_FMT("飞行记录已转储: {} 原因: {} {} 记录数: {}", dumpPath, dumpTriggerName(trigger), detail, records);
+    }
+    else
+    {
+      LOG_ERROR_FMT("飞行记录转储失败: {}", dumpPath);
+    }
+  }
+  return result;
+}
+
+void Logging::installCrashHandlers()
+{
+  previousExceptionFilter = SetUnhandledExceptionFilter(unhandledExceptionFilter);
+  previousTerminateHandler = std::set_terminate(terminateHandler);
+  for (int signalNumber : {SIGABRT, SIGSEGV, SIGILL, SIGFPE})
+  {
+    std::signal(signalNumber, fatalSignalHandler);
   }
-  return true;
 }
@@ -33,6 +33,8 @@ int main(int argc, char *argv[])
         MessageBoxW(NULL, L"日志系统初始化失败!", L"严重错误", MB_ICONERROR | MB_OK);
         return 2;
     }
+    // 崩溃时转储飞行记录器中最近的日志
+    Logging::installCrashHandlers();
     LOG_INFO(L"游戏优化工具箱启动");
 
     QApplication app(argc, argv);
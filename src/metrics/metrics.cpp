@@ -0,0 +1,378 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 20:38:42
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 20:38:42
+ * @FilePath: \GameOptimizerPro\src\metrics\metrics.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "metrics/metrics.h"
+
+#include <psapi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#pragma comment(lib, "psapi.lib")
+
+namespace
+{
+  // FILETIME 为 100 纳秒单位
+  constexpr double kFileTimeTicksPerSecond = 10000000.0;
+  // 1601-01-01 到 1970-01-01 的 100 纳秒数
+  constexpr uint64_t kUnixEpochFileTime = 116444736000000000ULL;
+
+  // gop_registry_operations -> registry
+  std::string traceCategoryOf(const std::string &name)
+  {
+    std::string category = name;
+    if (category.compare(0, 4, "gop_") == 0)
+    {
+      category.erase(0, 4);
+    }
+    const std::string suffix = "_operations";
+    if (category.size() > suffix.size() && category.compare(category.size() - suffix.size(), suffix.size(), suffix) == 0)
+    {
+      category.erase(category.size() - suffix.size());
+    }
+    return category;
+  }
+
+  uint64_t fileTimeToTicks(const FILETIME &fileTime)
+  {
+    return (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+  }
+
+  void appendDouble(std::string &out, double value)
+  {
+    if (std::isinf(value))
+    {
+      out += value > 0 ? "+Inf" : "-Inf";
+      return;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    out += buffer;
+  }
+
+  // 说明中的反斜杠和换行需要转义
+  void appendEscaped(std::string &out, const std::string &text, bool escapeQuote)
+  {
+    for (char c : text)
+    {
+      if (c == '\\')
+        out += "\\\\";
+      else if (c == '\n')
+        out += "\\n";
+      else if (c == '"' && escapeQuote)
+        out += "\\\"";
+      else
+        out += c;
+    }
+  }
+
+  std::string renderLabels(const MetricLabels &labels)
+  {
+    if (labels.empty())
+    {
+      return std::string();
+    }
+    std::string rendered = "{";
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+      if (i > 0)
+      {
+        rendered += ',';
+      }
+      rendered += labels[i].first;
+      rendered += "=\"";
+      appendEscaped(rendered, labels[i].second, true);
+      rendered += '"';
+    }
+    rendered += '}';
+    return rendered;
+  }
+
+  /**
+   * @brief 在已渲染的标签后追加 le 标签 用于直方图的桶
+   */
+  std::string labelsWithBound(const std::string &labels, double bound)
+  {
+    std::string le = "le=\"";
+    appendDouble(le, bound);
+    le += '"';
+    if (labels.empty())
+    {
+      return "{" + le + "}";
+    }
+    return labels.substr(0, labels.size() - 1) + "," + le + "}";
+  }
+} // namespace
+
+// ---- MetricCounter ----
+
+uint64_t MetricCounter::value() const
+{
+  uint64_t total = 0;
+  for (const Shard &shard : m_shards)
+  {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+// ---- MetricHistogram ----
+
+MetricHistogram::MetricHistogram(const std::vector<double> &bounds)
+    : m_bounds(bounds)
+{
+  std::sort(m_bounds.begin(), m_bounds.end());
+  m_bounds.erase(std::unique(m_bounds.begin(), m_bounds.end()), m_bounds.end());
+  m_boundsNanoseconds.reserve(m_bounds.size());
+  for (double bound : m_bounds)
+  {
+    m_boundsNanoseconds.push_back(static_cast<int64_t>(std::llround(bound * 1e9)));
+  }
+  // 最后一个为 +Inf 桶
+  m_buckets = std::make_unique<std::atomic<uint64_t>[]>(m_bounds.size() + 1);
+  for (size_t i = 0; i <= m_bounds.size(); ++i)
+  {
+    m_buckets[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void MetricHistogram::observe(std::chrono::nanoseconds duration)
+{
+  const int64_t nanoseconds = std::max<int64_t>(duration.count(), 0);
+  // 桶数量只有十几个 顺序查找比二分更快
+  size_t index = 0;
+  while (index < m_boundsNanoseconds.size() && nanoseconds > m_boundsNanoseconds[index])
+  {
+    ++index;
+  }
+  m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+  m_sumNanoseconds.fetch_add(static_cast<uint64_t>(nanoseconds), std::memory_order_relaxed);
+}
+
+void MetricHistogram::snapshot(std::vector<uint64_t> &buckets, uint64_t &sumNanoseconds) const
+{
+  buckets.resize(m_bounds.size() + 1);
+  for (size_t i = 0; i < buckets.size(); ++i)
+  {
+    buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+  }
+  sumNanoseconds = m_sumNanoseconds.load(std::memory_order_relaxed);
+}
+
+const std::vector<double> &MetricHistogram::defaultBounds()
+{
+  static const std::vector<double> bounds = {0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 30.0};
+  return bounds;
+}
+
+// ---- MetricOperation ----
+
+MetricOperation::MetricOperation(const std::string &name, const std::string &subject, const std::string &op)
+    : success(MetricsRegistry::instance().counter(name, subject + "次数 按结果区分", {{"op", op}, {"result", "success"}})),
+      failure(MetricsRegistry::instance().counter(name, subject + "次数 按结果区分", {{"op", op}, {"result", "failure"}})),
+      duration(MetricsRegistry::instance().histogram(name + "_duration_seconds", subject + "耗时 秒", {{"op", op}})),
+      traceCategory(traceCategoryOf(name)),
+      traceName(op)
+{
+}
+
+// ---- MetricsRegistry ----
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+  static MetricsRegistry registry;
+  return registry;
+}
+
+MetricsRegistry::MetricsRegistry()
+{
+  registerProcessMetrics();
+}
+
+MetricCounter &MetricsRegistry::counter(const std::string &name, const std::string &help, const MetricLabels &labels)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Series &series = findOrCreate(name, help, Type::Counter, labels);
+  if (!series.counter)
+  {
+    series.counter = std::make_unique<MetricCounter>();
+  }
+  return *series.counter;
+}
+
+MetricGauge &MetricsRegistry::gauge(const std::string &name, const std::string &help, const MetricLabels &labels)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Series &series = findOrCreate(name, help, Type::Gauge, labels);
+  if (!series.gauge)
+  {
+    series.gauge = std::make_unique<MetricGauge>();
+  }
+  return *series.gauge;
+}
+
+MetricHistogram &MetricsRegistry::histogram(const std::string &name, const std::string &help, const MetricLabels &labels,
+                                            const std::vector<double> &bounds)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Series &series = findOrCreate(name, help, Type::Histogram, labels);
+  if (!series.histogram)
+  {
+    series.histogram = std::make_unique<MetricHistogram>(bounds);
+  }
+  return *series.histogram;
+}
+
+void MetricsRegistry::callback(const std::string &name, const std::string &help, bool isCounter, std::function<double()> callback)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Series &series = findOrCreate(name, help, isCounter ? Type::Counter : Type::Gauge, {});
+  series.callback = std::move(callback);
+}
+
+MetricsRegistry::Series &MetricsRegistry::findOrCreate(const std::string &name, const std::string &help, Type type, const MetricLabels &labels)
+{
+  Family *family = nullptr;
+  for (const auto &candidate : m_families)
+  {
+    if (candidate->name == name)
+    {
+      family = candidate.get();
+      break;
+    }
+  }
+  if (!family)
+  {
+    m_families.push_back(std::make_unique<Family>());
+    family = m_families.back().get();
+    family->name = name;
+    family->help = help;
+    family->type = type;
+  }
+
+  const std::string rendered = renderLabels(labels);
+  for (const auto &series : family->series)
+  {
+    if (series->labels == rendered)
+    {
+      return *series;
+    }
+  }
+  family->series.push_back(std::make_unique<Series>());
+  family->series.back()->labels = rendered;
+  return *family->series.back();
+}
+
+std::string MetricsRegistry::toOpenMetrics() const
+{
+  std::string out;
+  out.reserve(8192);
+  std::vector<uint64_t> buckets;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto &family : m_families)
+  {
+    static const char *const typeNames[] = {"counter", "gauge", "histogram"};
+    out += "# TYPE " + family->name + " " + typeNames[static_cast<int>(family->type)] + "\n";
+    out += "# HELP " + family->name + " ";
+    appendEscaped(out, family->help, false);
+    out += '\n';
+
+    for (const auto &series : family->series)
+    {
+      if (series->histogram)
+      {
+        uint64_t sumNanoseconds = 0;
+        series->histogram->snapshot(buckets, sumNanoseconds);
+        const auto &bounds = series->histogram->bounds();
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+          cumulative += buckets[i];
+          const double bound = i < bounds.size() ? bounds[i] : INFINITY;
+          out += family->name + "_bucket" + labelsWithBound(series->labels, bound) + " " + std::to_string(cumulative) + "\n";
+        }
+        out += family->name + "_count" + series->labels + " " + std::to_string(cumulative) + "\n";
+        out += family->name + "_sum" + series->labels + " ";
+        appendDouble(out, static_cast<double>(sumNanoseconds) / 1e9);
+        out += '\n';
+        continue;
+      }
+
+      out += family->name;
+      if (family->type == Type::Counter)
+      {
+        out += "_total";
+      }
+      out += series->labels;
+      out += ' ';
+      if (series->callback)
+      {
+        appendDouble(out, series->callback());
+      }
+      else if (series->counter)
+      {
+        out += std::to_string(series->counter->value());
+      }
+      else if (series->gauge)
+      {
+        out += std::to_string(series->gauge->value());
+      }
+      else
+      {
+        out += '0';
+      }
+      out += '\n';
+    }
+  }
+  out += "# EOF\n";
+  return out;
+}
+
+void MetricsRegistry::registerProcessMetrics()
+{
+  // 注册发生在构造函数中 此时还没有其他线程持有注册表 直接调用 findOrCreate
+  auto registerCallback = [this](const char *name, const char *help, Type type, std::function<double()> callback)
+  {
+    findOrCreate(name, help, type, {}).callback = std::move(callback);
+  };
+
+  registerCallback("process_cpu_seconds", "本进程在用户态和内核态消耗的 CPU 时间 秒", Type::Counter, []()
+                   {
+                     FILETIME creationTime, exitTime, kernelTime, userTime;
+                     if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+                     {
+                       return 0.0;
+                     }
+                     return static_cast<double>(fileTimeToTicks(kernelTime) + fileTimeToTicks(userTime)) / kFileTimeTicksPerSecond; });
+
+  registerCallback("process_resident_memory_bytes", "本进程的工作集大小 字节", Type::Gauge, []()
+                   {
+                     PROCESS_MEMORY_COUNTERS memoryCounters = {};
+                     if (!GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+                     {
+                       return 0.0;
+                     }
+                     return static_cast<double>(memoryCounters.WorkingSetSize); });
+
+  registerCallback("process_open_handles", "本进程打开的句柄数", Type::Gauge, []()
+                   {
+                     DWORD handleCount = 0;
+                     GetProcessHandleCount(GetCurrentProcess(), &handleCount);
+                     return static_cast<double>(handleCount); });
+
+  registerCallback("process_start_time_seconds", "本进程的启动时间 Unix 时间戳 秒", Type::Gauge, []()
+                   {
+                     FILETIME creationTime, exitTime, kernelTime, userTime;
+                     if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+                     {
+                       return 0.0;
+                     }
+                     return static_cast<double>(fileTimeToTicks(creationTime) - kUnixEpochFileTime) / kFileTimeTicksPerSecond; });
+}
@@ -0,0 +1,124 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 20:57:33
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 20:57:33
+ * @FilePath: \GameOptimizerPro\src\metrics\metrics_exporter.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "metrics/metrics_exporter.h"
+
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "log/logging.h"
+#include "metrics/metrics.h"
+#include "metrics/tracing.h"
+
+MetricsExporter::MetricsExporter()
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+  stop();
+}
+
+bool MetricsExporter::start(const std::wstring &filePath, int intervalSeconds)
+{
+  if (filePath.empty())
+  {
+    LOG_ERROR("指标导出文件路径为空");
+    return false;
+  }
+  stop();
+
+  std::error_code error;
+  const auto dirPath = std::filesystem::path(filePath).parent_path();
+  if (!dirPath.empty() && !std::filesystem::exists(dirPath, error))
+  {
+    std::filesystem::create_directories(dirPath, error);
+  }
+
+  m_filePath = filePath;
+  m_intervalSeconds = std::max(1, intervalSeconds);
+  m_stopRequested = false;
+  try
+  {
+    m_exportThread = std::thread(&MetricsExporter::runExportLoop, this);
+  }
+  catch (const std::exception &e)
+  {
+    LOG_ERROR("指标导出线程启动失败: " + std::string(e.what()));
+    return false;
+  }
+  m_isRunning = true;
+  LOG_INFO_FMT("指标导出已启动: {} 间隔 {} 秒", filePath, m_intervalSeconds);
+  return true;
+}
+
+void MetricsExporter::stop()
+{
+  if (!m_exportThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopRequested = true;
+  }
+  m_condition.notify_all();
+  m_exportThread.join();
+  m_isRunning = false;
+  LOG_INFO("指标导出已停止");
+}
+
+bool MetricsExporter::isRunning() const
+{
+  return m_isRunning;
+}
+
+bool MetricsExporter::writeSnapshot(const std::wstring &filePath)
+{
+  TRACE_SCOPE("metrics", "write_snapshot");
+  const std::string content = MetricsRegistry::instance().toOpenMetrics();
+
+  // 写到临时文件后替换 采集方读到的总是完整的快照
+  const std::wstring tempPath = filePath + L".tmp";
+  {
+    std::ofstream file(std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(content.data(), static_cast<std::streamsize>(content.size())))
+    {
+      LOG_WARN_LIMITED(L"写入指标文件失败: " + tempPath, E_FAIL);
+      return false;
+    }
+  }
+  if (!MoveFileExW(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+  {
+    LOG_HRESULT_LIMITED(L"替换指标文件失败: " + filePath, HRESULT_FROM_WIN32(GetLastError()));
+    DeleteFileW(tempPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+void MetricsExporter::runExportLoop()
+{
+  Tracing::setThreadName("metrics_exporter");
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stopRequested)
+  {
+    lock.unlock();
+    writeSnapshot(m_filePath);
+    lock.lock();
+    m_condition.wait_for(lock, std::chrono::seconds(m_intervalSeconds), [this]()
+                         { return m_stopRequested; });
+  }
+  lock.unlock();
+  // 退出前写出最后一次快照
+  writeSnapshot(m_filePath);
+}
@@ -0,0 +1,247 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 21:51:38
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 21:51:38
+ * @FilePath: \GameOptimizerPro\src\metrics\tracing.cpp
+ * @Description:
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+#include "metrics/tracing.h"
+
+#include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "log/logging.h"
+#include "utils/system_utils.h"
+
+namespace
+{
+  struct TraceEvent
+  {
+    const char *category;
+    const char *name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    std::string detail;
+  };
+
+  /**
+   * @brief 单个线程的区间缓冲 线程退出后由全局列表继续持有 直到下次 start 时清理
+   */
+  struct ThreadBuffer
+  {
+    DWORD threadId = 0;
+    std::string threadName;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    uint64_t dropped = 0;
+  };
+
+  std::mutex g_buffersMutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+  // 本次追踪的开始时间 导出的时间戳以此为零点
+  std::atomic<uint64_t> g_epochNs{0};
+
+  ThreadBuffer &currentBuffer()
+  {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer)
+    {
+      buffer = std::make_shared<ThreadBuffer>();
+      buffer->threadId = GetCurrentThreadId();
+      std::lock_guard<std::mutex> lock(g_buffersMutex);
+      g_buffers.push_back(buffer);
+    }
+    return *buffer;
+  }
+
+  void appendJsonString(std::string &out, const char *text)
+  {
+    out += '"';
+    for (const char *cursor = text; *cursor; ++cursor)
+    {
+      const unsigned char c = static_cast<unsigned char>(*cursor);
+      if (c == '"' || c == '\\')
+      {
+        out += '\\';
+        out += static_cast<char>(c);
+      }
+      else if (c < 0x20)
+      {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out += escaped;
+      }
+      else
+      {
+        out += static_cast<char>(c);
+      }
+    }
+    out += '"';
+  }
+
+  // 时间戳以微秒为单位 保留到纳秒
+  void appendMicroseconds(std::string &out, uint64_t nanoseconds)
+  {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%llu.%03u",
+                  static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned int>(nanoseconds % 1000));
+    out += buffer;
+  }
+} // namespace
+
+std::atomic<bool> Tracing::s_enabled{false};
+
+void Tracing::start()
+{
+  std::lock_guard<std::mutex> lock(g_buffersMutex);
+  // 只剩列表持有的缓冲属于已退出的线程
+  g_buffers.erase(std::remove_if(g_buffers.begin(), g_buffers.end(),
+                                 [](const std::shared_ptr<ThreadBuffer> &buffer)
+                                 { return buffer.use_count() == 1; }),
+                  g_buffers.end());
+  for (const auto &buffer : g_buffers)
+  {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    buffer->events.clear();
+    buffer->dropped = 0;
+  }
+  g_epochNs.store(nowNs(), std::memory_order_relaxed);
+  s_enabled.store(true, std::memory_order_release);
+  LOG_INFO("性能追踪已开始");
+}
+
+void Tracing::stop()
+{
+  if (s_enabled.exchange(false, std::memory_order_acq_rel))
+  {
+    LOG_INFO("性能追踪已停止");
+  }
+}
+
+bool Tracing::stopAndExport(std::wstring &filePath)
+{
+  stop();
+
+  SYSTEMTIME localTime;
+  GetLocalTime(&localTime);
+  wchar_t suffix[48];
+  swprintf_s(suffix, L".trace-%04d%02d%02d-%02d%02d%02d-%03d.json",
+             localTime.wYear, localTime.wMonth, localTime.wDay,
+             localTime.wHour, localTime.wMinute, localTime.wSecond, localTime.wMilliseconds);
+  const std::filesystem::path logPath(Logging::getLogFilePath());
+  filePath = (logPath.parent_path() / (logPath.stem().wstring() + suffix)).wstring();
+
+  size_t eventCount = 0;
+  if (!exportChromeTrace(filePath, eventCount))
+  {
+    return false;
+  }
+  LOG_INFO_FMT("性能追踪已导出: {} 区间数: {}", filePath, eventCount);
+  return true;
+}
+
+bool Tracing::exportChromeTrace(const std::wstring &filePath, size_t &eventCount)
+{
+  const DWORD processId = GetCurrentProcessId();
+  const uint64_t epochNs = g_epochNs.load(std::memory_order_relaxed);
+  const std::string pid = std::to_string(processId);
+
+  std::string out;
+  out.reserve(1024 * 1024);
+  out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" + pid + ",\"tid\":0,\"args\":{\"name\":\"GameOptimizerPro\"}}";
+
+  eventCount = 0;
+  uint64_t dropped = 0;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+    buffers = g_buffers;
+  }
+  for (const auto &buffer : buffers)
+  {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    if (buffer->events.empty())
+    {
+      continue;
+    }
+    const std::string tid = std::to_string(buffer->threadId);
+    if (!buffer->threadName.empty())
+    {
+      out += ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+      appendJsonString(out, buffer->threadName.c_str());
+      out += "}}";
+    }
+    for (const TraceEvent &event : buffer->events)
+    {
+      out += ",\n{\"ph\":\"X\",\"cat\":";
+      appendJsonString(out, event.category);
+      out += ",\"name\":";
+      appendJsonString(out, event.name);
+      out += ",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":";
+      appendMicroseconds(out, event.startNs > epochNs ? event.startNs - epochNs : 0);
+      out += ",\"dur\":";
+      appendMicroseconds(out, event.durationNs);
+      if (!event.detail.empty())
+      {
+        out += ",\"args\":{\"detail\":";
+        appendJsonString(out, event.detail.c_str());
+        out += '}';
+      }
+      out += '}';
+    }
+    eventCount += buffer->events.size();
+    dropped += buffer->dropped;
+  }
+  out += "\n],\"otherData\":{\"droppedEvents\":" + std::to_string(dropped) + "}}\n";
+
+  std::ofstream file(std::filesystem::path(filePath), std::ios::binary | std::ios::trunc);
+  if (!file || !file.write(out.data(), static_cast<std::streamsize>(out.size())))
+  {
+    LOG_ERROR(L"写入性能追踪文件失败: " + filePath);
+    return false;
+  }
+  if (dropped > 0)
+  {
+    LOG_WARN_FMT("性能追踪缓冲已满，丢弃了 {} 个区间", dropped);
+  }
+  return true;
+}
+
+void Tracing::setThreadName(const char *name)
+{
+  ThreadBuffer &buffer = currentBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.threadName = name;
+}
+
+void Tracing::record(const char *category, const char *name, uint64_t startNs, uint64_t endNs, std::string &&detail)
+{
+  // 区间开始后追踪被停止 或开始于上一次追踪
+  if (!isEnabled() || startNs < g_epochNs.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  ThreadBuffer &buffer = currentBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  if (buffer.events.size() >= kMaxEventsPerThread)
+  {
+    ++buffer.dropped;
+    return;
+  }
+  buffer.events.push_back(TraceEvent{category, name, startNs, endNs - startNs, std::move(detail)});
+}
+
+void TraceScope::setDetail(const std::wstring &detail)
+{
+  m_detail = WideToMultiByte(detail);
+}
@@ -8,6 +8,8 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 
+#define LOG_MODULE Logging::Module::Ui
+
 #include "ui/mainwnd.h"
 #include "./ui_mainwnd.h"
 
@@ -48,8 +50,11 @@ void MainWnd::initUI()
     m_mainWindow->tableWidget_GameProcess->setColumnWidth(0, totalWidth * 0.7);
     m_mainWindow->tableWidget_GameProcess->setColumnWidth(1, totalWidth * 0.3);
 
+    // 取一次配置快照 后续读取不再拷贝配置
+    const auto config = m_application->getCurrentConfig();
+
     // 从配置文件加载游戏进程
-    loadGameProcessFromConfig(m_application->getCurrentConfig().processConfig.gameProcessList);
+    loadGameProcessFromConfig(config->processConfig.gameProcessList);
 
     // 初始化开关按钮的映射
     m_switchButtonMap[m_mainWindow->switchButton_SetAutoStartup] = [this](bool checked)
@@ -68,23 +73,59 @@ void MainWnd::initUI()
     { return m_application->setSystemSchedulerOptimization(checked); };
     m_switchButtonMap[m_mainWindow->switchButton_SetSystemServiceOptimization] = [this](bool checked)
     { return m_application->setSystemServiceOptimization(checked); };
+    m_switchButtonMap[m_mainWindow->switchButton_SetBackgroundEfficiency] = [this](bool checked)
+    { return m_application->setBackgroundEfficiencyMode(checked); };
+    m_switchButtonMap[m_mainWindow->switchButton_SetWorkingSetTrim] = [this](bool checked)
+    { return m_application->setWorkingSetTrim(checked); };
+    m_switchButtonMap[m_mainWindow->switchButton_SetMemoryPressureResponse] = [this](bool checked)
+    { return m_application->setMemoryPressureResponse(checked); };
+    m_switchButtonMap[m_mainWindow->switchButton_SetGamePrefetch] = [this](bool checked)
+    { return m_application->setGamePrefetch(checked); };
 
     // 设置开关按钮的初始状态
-    m_mainWindow->switchButton_SetAutoStartup->setChecked(m_application->getCurrentConfig().optimismConfig.autoStartUp);
+    m_mainWindow->switchButton_SetAutoStartup->setChecked(config->optimismConfig.autoStartUp);
 
     // 如果自动限制反作弊被启用, 则启动自动限制反作弊
-    if (m_application->getCurrentConfig().optimismConfig.autoLimitAntiCheat)
+    if (config->optimismConfig.autoLimitAntiCheat)
     {
         m_application->setAutoLimitAntiCheat(true);
     }
-    m_mainWindow->switchButton_SetAutoLimitAntiCheat->setChecked(m_application->getCurrentConfig().optimismConfig.autoLimitAntiCheat);
+    m_mainWindow->switchButton_SetAutoLimitAntiCheat->setChecked(config->optimismConfig.autoLimitAntiCheat);
+
+    m_mainWindow->switchButton_SetGameOptimizePowerPlan->setChecked(config->optimismConfig.powerPlan.optimizePowerPlan);
+    m_mainWindow->switchButton_SetPowerPlanLock->setChecked(config->optimismConfig.powerPlan.lockPowerPlan);
+    m_mainWindow->switchButton_SetLimitBackgroundActivity->setChecked(config->optimismConfig.limitBackgroundActivity);
+    m_mainWindow->switchButton_SetNetworkDelayOptimization->setChecked(config->optimismConfig.optimizeNetworkDelay);
+    m_mainWindow->switchButton_SetSystemSchedulerOptimization->setChecked(config->optimismConfig.optimizeSystemScheduling);
+    m_mainWindow->switchButton_SetSystemServiceOptimization->setChecked(config->optimismConfig.optimizeSystemService);
 
-    m_mainWindow->switchButton_SetGameOptimizePowerPlan->setChecked(m_application->getCurrentConfig().optimismConfig.powerPlan.optimizePowerPlan);
-    m_mainWindow->switchButton_SetPowerPlanLock->setChecked(m_application->getCurrentConfig().optimismConfig.powerPlan.lockPowerPlan);
-    m_mainWindow->switchButton_SetLimitBackgroundActivity->setChecked(m_application->getCurrentConfig().optimismConfig.limitBackgroundActivity);
-    m_mainWindow->switchButton_SetNetworkDelayOptimization->setChecked(m_application->getCurrentConfig().optimismConfig.optimizeNetworkDelay);
-    m_mainWindow->switchButton_SetSystemSchedulerOptimization->setChecked(m_application->getCurrentConfig().optimismConfig.optimizeSystemScheduling);
-    m_mainWindow->switchButton_SetSystemServiceOptimization->setChecked(m_application->getCurrentConfig().optimismConfig.optimizeSystemService);
+    // 如果后台能效模式被启用, 则启动游戏会话监听
+    if (config->optimismConfig.backgroundPolicy.efficiencyMode)
+    {
+        m_application->setBackgroundEfficiencyMode(true);
+    }
+    m_mainWindow->switchButton_SetBackgroundEfficiency->setChecked(config->optimismConfig.backgroundPolicy.efficiencyMode);
+
+    // 如果游戏时回收内存被启用, 则启动游戏会话监听
+    if (config->optimismConfig.backgroundPolicy.trimWorkingSet)
+    {
+        m_application->setWorkingSetTrim(true);
+    }
+    m_mainWindow->switchButton_SetWorkingSetTrim->setChecked(config->optimismConfig.backgroundPolicy.trimWorkingSet);
+
+    // 如果内存压力响应被启用, 则启动游戏会话监听
+    if (config->optimismConfig.backgroundPolicy.memoryPressureResponse)
+    {
+        m_application->setMemoryPressureResponse(true);
+    }
+    m_mainWindow->switchButton_SetMemoryPressureResponse->setChecked(config->optimismConfig.backgroundPolicy.memoryPressureResponse);
+
+    // 如果游戏文件预读被启用, 则启动游戏会话监听
+    if (config->optimismConfig.gamePrefetch)
+    {
+        m_application->setGamePrefetch(true);
+    }
+    m_mainWindow->switchButton_SetGamePrefetch->setChecked(config->optimismConfig.gamePrefetch);
 
     // 连接开关按钮的点击信号到槽函数
     connect(m_mainWindow->switchButton_SetAutoStartup, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
@@ -95,6 +136,33 @@ void MainWnd::initUI()
     connect(m_mainWindow->switchButton_SetNetworkDelayOptimization, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
     connect(m_mainWindow->switchButton_SetSystemSchedulerOptimization, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
     connect(m_mainWindow->switchButton_SetSystemServiceOptimization, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
+    connect(m_mainWindow->switchButton_SetBackgroundEfficiency, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
+    connect(m_mainWindow->switchButton_SetWorkingSetTrim, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
+    connect(m_mainWindow->switchButton_SetMemoryPressureResponse, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
+    connect(m_mainWindow->switchButton_SetGamePrefetch, &SwitchButton::clicked, this, &MainWnd::on_switchButton_clicked);
+
+    // 配置文件被外部修改后同步界面状态
+    m_application->setOnConfigReloadedCallback([this]()
+                                               { refreshFromConfig(); });
+}
+
+void MainWnd::refreshFromConfig()
+{
+    const auto config = m_application->getCurrentConfig();
+    loadGameProcessFromConfig(config->processConfig.gameProcessList);
+
+    m_mainWindow->switchButton_SetAutoStartup->setChecked(config->optimismConfig.autoStartUp);
+    m_mainWindow->switchButton_SetAutoLimitAntiCheat->setChecked(config->optimismConfig.autoLimitAntiCheat);
+    m_mainWindow->switchButton_SetGameOptimizePowerPlan->setChecked(config->optimismConfig.powerPlan.optimizePowerPlan);
+    m_mainWindow->switchButton_SetPowerPlanLock->setChecked(config->optimismConfig.powerPlan.lockPowerPlan);
+    m_mainWindow->switchButton_SetLimitBackgroundActivity->setChecked(config->optimismConfig.limitBackgroundActivity);
+    m_mainWindow->switchButton_SetNetworkDelayOptimization->setChecked(config->optimismConfig.optimizeNetworkDelay);
+    m_mainWindow->switchButton_SetSystemSchedulerOptimization->setChecked(config->optimismConfig.optimizeSystemScheduling);
+    m_mainWindow->switchButton_SetSystemServiceOptimization->setChecked(config->optimismConfig.optimizeSystemService);
+    m_mainWindow->switchButton_SetBackgroundEfficiency->setChecked(config->optimismConfig.backgroundPolicy.efficiencyMode);
+    m_mainWindow->switchButton_SetWorkingSetTrim->setChecked(config->optimismConfig.backgroundPolicy.trimWorkingSet);
+    m_mainWindow->switchButton_SetMemoryPressureResponse->setChecked(config->optimismConfig.backgroundPolicy.memoryPressureResponse);
+    m_mainWindow->switchButton_SetGamePrefetch->setChecked(config->optimismConfig.gamePrefetch);
 }
 
 void MainWnd::on_switchButton_clicked()
@@ -170,6 +238,12 @@ void MainWnd::cleanUp()
     // 清理资源
     // 关闭反作弊进程监控
     m_application->setAutoLimitAntiCheat(false, true);
+    // 关闭后台能效模式并还原被限制的后台进程
+    m_application->setBackgroundEfficiencyMode(false, true);
+    // 关闭内存压力响应并还原后台进程内存优先级
+    m_application->setMemoryPressureResponse(false, true);
+    // 写入尚未保存的配置修改
+    m_application->getConfigManager().flushConfig();
     // 设置按钮状态为假
     // m_mainWindow->switchButton_SetAutoLimitAntiCheat->setChecked(false);
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 
+#define LOG_MODULE Logging::Module::Ui
+
 #include "ui/tray_app.h"
 
 TrayApp::TrayApp(QObject *parent)
@@ -18,11 +20,16 @@ TrayApp::TrayApp(QObject *parent)
 {
   try
   {
+    Tracing::setThreadName("ui");
     // 使用 emplace_back 初始化
     m_actions.emplace_back(ActionType::ShowMain, nullptr, [this]()
                            { showMainWindow(); });
     m_actions.emplace_back(ActionType::OpenLog, nullptr, [this]()
                            { openLog(); });
+    m_actions.emplace_back(ActionType::DumpDiagnostics, nullptr, [this]()
+                           { dumpDiagnostics(); });
+    m_actions.emplace_back(ActionType::ToggleTrace, nullptr, [this]()
+                           { toggleTrace(); });
     m_actions.emplace_back(ActionType::About, nullptr, [this]()
                            { showAbout(); });
     m_actions.emplace_back(ActionType::Quit, nullptr, [this]()
@@ -114,6 +121,10 @@ QString TrayApp::getActionName(ActionType type)
     return "显示主窗口";
   case ActionType::OpenLog:
     return "打开日志";
+  case ActionType::DumpDiagnostics:
+    return "导出诊断记录";
+  case ActionType::ToggleTrace:
+    return Tracing::isEnabled() ? "停止性能追踪" : "开始性能追踪";
   case ActionType::About:
     return "关于";
   case ActionType::Quit:
@@ -171,6 +182,48 @@ void TrayApp::openLog()
   }
 }
 
+void TrayApp::dumpDiagnostics()
+{
+  if (Logging::dumpFlightRecorder(Logging::DumpTrigger::Manual, "tray menu"))
+  {
+    ShowTrayMessage("导出诊断记录", "诊断记录已导出到日志目录");
+  }
+  else
+  {
+    ShowTrayMessage("导出诊断记录", "导出失败，请确认已开启飞行记录器");
+  }
+}
+
+void TrayApp::toggleTrace()
+{
+  if (!Tracing::isEnabled())
+  {
+    Tracing::start();
+    ShowTrayMessage("性能追踪", "性能追踪已开始，再次点击停止并导出");
+  }
+  else
+  {
+    std::wstring filePath;
+    if (Tracing::stopAndExport(filePath))
+    {
+      ShowTrayMessage("性能追踪", "追踪已导出到 " + QString::fromStdWString(filePath) + "，可用 Perfetto UI 或 chrome://tracing 打开");
+    }
+    else
+    {
+      ShowTrayMessage("性能追踪", "追踪导出失败，详情见日志");
+    }
+  }
+
+  // 更新菜单项文字
+  for (auto &action : m_actions)
+  {
+    if (action.type == ActionType::ToggleTrace && action.action)
+    {
+      action.action->setText(getActionName(action.type));
+    }
+  }
+}
+
 void TrayApp::showAbout()
 {
   MessageBoxW(nullptr,
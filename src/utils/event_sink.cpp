@@ -8,8 +8,12 @@
  * Copyright (c) 2025 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
  */
 
+#define LOG_MODULE Logging::Module::Process
+
 #include "utils/event_sink.h"
 
+#include "metrics/tracing.h"
+
 // 静态创建函数实现
 HRESULT EventSink::CreateInstance(ProcessManager *pMgr, EventSink **ppSink)
 {
@@ -45,10 +49,11 @@ void EventSink::SetProcessManager(ProcessManager *pMgr)
 
 STDMETHODIMP EventSink::Indicate(long lObjectCount, IWbemClassObject **apObjArray)
 {
+  TRACE_SCOPE("wmi", "indicate");
   if (!m_pProcessManager)
   {
     // Should not happen if properly initialized
-    LOG_ERROR(L"EventSink::Indicate - m_pProcessManager is null.");
+    LOG_HRESULT_LIMITED(L"EventSink::Indicate - m_pProcessManager is null.", WBEM_E_INVALID_PARAMETER);
     return WBEM_E_INVALID_PARAMETER;
   }
 
@@ -135,7 +140,7 @@ STDMETHODIMP EventSink::Indicate(long lObjectCount, IWbemClassObject **apObjArra
     if (FAILED(hr))
     {
       // 获取 ProcessId 失败，PID 将保持为 0
-      LOG_HRESULT("Get ProcessId failed", hr);
+      LOG_HRESULT_LIMITED("Get ProcessId failed", hr);
       m_pProcessManager->triggerErrorCallback(hr);
       vtProcId.Clear();
       // pTargetInst is released by CComPtr
@@ -153,7 +158,7 @@ STDMETHODIMP EventSink::Indicate(long lObjectCount, IWbemClassObject **apObjArra
     else
     {
       // 如果类型不匹配，可以记录一个警告或错误，PID 将保持为 0
-      LOG_HRESULT(L"ProcessId for " + processName + L" has unexpected VARIANT type: " + std::to_wstring(vtProcId.vt), WBEM_E_TYPE_MISMATCH);
+      LOG_HRESULT_FMT_LIMITED(WBEM_E_TYPE_MISMATCH, "ProcessId for {} has unexpected VARIANT type: {}", processName, vtProcId.vt);
       m_pProcessManager->triggerErrorCallback(WBEM_E_TYPE_MISMATCH);
     }
 
@@ -210,12 +215,8 @@ STDMETHODIMP EventSink::SetStatus(
 
   if (lFlags == WBEM_STATUS_COMPLETE)
   {
-    LOG_HRESULT(L"EventSink::SetStatus - WBEM_STATUS_COMPLETE received", hResult);
-    if (strParam)
-    {
-      std::wcout << L", Param: " << strParam;
-    }
-    std::wcout << std::endl;
+    LOG_HRESULT_FMT_LIMITED(hResult, "EventSink::SetStatus - WBEM_STATUS_COMPLETE received, Param: {}",
+                            strParam ? strParam : L"");
 
     // hResult indicates the success or failure of the ExecNotificationQueryAsync operation.
     // If FAILED(hResult), it means the event subscription itself failed or was terminated.
@@ -233,6 +234,10 @@ STDMETHODIMP EventSink::SetStatus(
         // Forward a more general error, or a specific one if hResult indicates a problem
         // that ProcessManager should know about beyond individual event errors.
         m_pProcessManager->triggerErrorCallback(hResult);
+        // 事件订阅已终止 保留之前的调试日志
+        char detail[64];
+        snprintf(detail, sizeof(detail), "WMI subscription terminated 0x%08X", static_cast<unsigned int>(hResult));
+        Logging::dumpFlightRecorder(Logging::DumpTrigger::Error, detail);
       }
     }
   }
@@ -267,4 +267,180 @@ bool SetProcessPriorityAndAffinity(const std::wstring &processName, const std::w
     LOG_ERROR(L"Failed to set process priority and affinity: " + result);
     return false;
   }
-}
\ No newline at end of file
+}
+
+std::vector<ProcessEntry> getProcessSnapshot()
+{
+  std::vector<ProcessEntry> processEntries;
+  HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+  if (hSnapshot == INVALID_HANDLE_VALUE)
+  {
+    LOG_HRESULT(L"创建进程快照失败", HRESULT_FROM_WIN32(GetLastError()));
+    return processEntries;
+  }
+
+  PROCESSENTRY32W entry = {};
+  entry.dwSize = sizeof(entry);
+  if (Process32FirstW(hSnapshot, &entry))
+  {
+    do
+    {
+      ProcessEntry processEntry;
+      processEntry.processId = entry.th32ProcessID;
+      processEntry.parentProcessId = entry.th32ParentProcessID;
+      processEntry.exeName = entry.szExeFile;
+      processEntries.push_back(std::move(processEntry));
+    } while (Process32NextW(hSnapshot, &entry));
+  }
+
+  CloseHandle(hSnapshot);
+  return processEntries;
+}
+
+std::unordered_set<DWORD> collectProcessTree(const std::vector<ProcessEntry> &snapshot, const std::vector<DWORD> &rootProcessIds)
+{
+  std::unordered_set<DWORD> processTree(rootProcessIds.begin(), rootProcessIds.end());
+
+  // 反复扫描直到没有新的子进程加入
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    for (const auto &processEntry : snapshot)
+    {
+      if (processTree.count(processEntry.parentProcessId) && !processTree.count(processEntry.processId))
+      {
+        processTree.insert(processEntry.processId);
+        changed = true;
+      }
+    }
+  }
+  return processTree;
+}
+
+bool isCriticalSystemProcess(const std::wstring &exeName)
+{
+  static const wchar_t *criticalProcesses[] = {
+      L"System", L"Idle", L"smss.exe", L"csrss.exe", L"wininit.exe", L"winlogon.exe",
+      L"services.exe", L"lsass.exe", L"dwm.exe", L"audiodg.exe", L"fontdrvhost.exe",
+      L"explorer.exe", L"ctfmon.exe", L"sihost.exe"};
+
+  for (const auto *criticalProcess : criticalProcesses)
+  {
+    if (_wcsicmp(exeName.c_str(), criticalProcess) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace
+{
+  // ntdll 中未公开的 PROCESSINFOCLASS 值
+  constexpr ULONG kProcessIoPriority = 33;
+
+  using NtQueryInformationProcessFn = LONG(NTAPI *)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+  using NtSetInformationProcessFn = LONG(NTAPI *)(HANDLE, ULONG, PVOID, ULONG);
+
+  FARPROC getNtdllProc(const char *procName)
+  {
+    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+    return hNtdll ? GetProcAddress(hNtdll, procName) : nullptr;
+  }
+}
+
+bool getProcessIoPriority(HANDLE hProcess, ULONG &ioPriority)
+{
+  static const auto ntQueryInformationProcess =
+      reinterpret_cast<NtQueryInformationProcessFn>(getNtdllProc("NtQueryInformationProcess"));
+  if (ntQueryInformationProcess == nullptr)
+  {
+    LOG_ERROR("获取 NtQueryInformationProcess 失败");
+    return false;
+  }
+
+  ULONG value = 0;
+  LONG status = ntQueryInformationProcess(hProcess, kProcessIoPriority, &value, sizeof(value), nullptr);
+  if (status < 0)
+  {
+    return false;
+  }
+  ioPriority = value;
+  return true;
+}
+
+bool setProcessIoPriority(HANDLE hProcess, ULONG ioPriority)
+{
+  static const auto ntSetInformationProcess =
+      reinterpret_cast<NtSetInformationProcessFn>(getNtdllProc("NtSetInformationProcess"));
+  if (ntSetInformationProcess == nullptr)
+  {
+    LOG_ERROR("获取 NtSetInformationProcess 失败");
+    return false;
+  }
+
+  LONG status = ntSetInformationProcess(hProcess, kProcessIoPriority, &ioPriority, sizeof(ioPriority));
+  if (status < 0)
+  {
+    LOG_ERROR("设置进程 I/O 优先级失败，NTSTATUS: " + std::to_string(status));
+    return false;
+  }
+
+  // 回读校验 部分受保护进程会静默忽略设置
+  ULONG currentPriority = 0;
+  if (!getProcessIoPriority(hProcess, currentPriority) || currentPriority != ioPriority)
+  {
+    LOG_ERROR("进程 I/O 优先级校验失败，期望: " + std::to_string(ioPriority) + " 实际: " + std::to_string(currentPriority));
+    return false;
+  }
+  return true;
+}
+
+bool writeFileAtomically(const std::wstring &filePath, const std::string &content)
+{
+  const std::wstring tempPath = filePath + L".tmp";
+  HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (hFile == INVALID_HANDLE_VALUE)
+  {
+    LOG_ERROR(L"无法创建临时文件: " + tempPath + L" 错误码: " + std::to_wstring(GetLastError()));
+    return false;
+  }
+
+  bool result = true;
+  const char *data = content.data();
+  size_t remaining = content.size();
+  while (remaining > 0)
+  {
+    DWORD bytesWritten = 0;
+    DWORD bytesToWrite = static_cast<DWORD>(remaining > MAXDWORD ? MAXDWORD : remaining);
+    if (!WriteFile(hFile, data, bytesToWrite, &bytesWritten, nullptr))
+    {
+      LOG_ERROR(L"写入临时文件失败: " + tempPath + L" 错误码: " + std::to_wstring(GetLastError()));
+      result = false;
+      break;
+    }
+    data += bytesWritten;
+    remaining -= bytesWritten;
+  }
+
+  // 刷盘后再替换 否则断电时可能替换为未写完的文件
+  if (result && !FlushFileBuffers(hFile))
+  {
+    LOG_ERROR(L"临时文件刷盘失败: " + tempPath + L" 错误码: " + std::to_wstring(GetLastError()));
+    result = false;
+  }
+  CloseHandle(hFile);
+
+  if (result && !MoveFileExW(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+  {
+    LOG_ERROR(L"替换文件失败: " + filePath + L" 错误码: " + std::to_wstring(GetLastError()));
+    result = false;
+  }
+
+  if (!result)
+  {
+    DeleteFileW(tempPath.c_str());
+  }
+  return result;
+}
@@ -0,0 +1,104 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:31:40
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:31:40
+ * @FilePath: \GameOptimizerPro\tools\config_bench\main.cpp
+ * @Description: 配置读写基准，比较 ConfigSerializer 与 nlohmann::json DOM 加载和保存大配置的耗时
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "config/app_config.h"
+#include "config/config_serializer.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 生成包含 entryCount 个游戏条目的配置 每个条目两个进程名 一半设置 I/O 优先级
+static AppConfig makeConfig(int entryCount)
+{
+  AppConfig config;
+  for (int i = 0; i < entryCount; ++i)
+  {
+    ProcessInfo process;
+    process.name = "Game " + std::to_string(i);
+    process.processList = {"game" + std::to_string(i) + ".exe", "launcher" + std::to_string(i) + ".exe"};
+    process.ioPriority = i % 2 ? IoPriority::LOW : IoPriority::UNCHANGED;
+    config.processConfig.gameProcessList.push_back(process);
+  }
+  return config;
+}
+
+// 执行 iterations 次 返回每次的平均毫秒数
+template <typename Function>
+static double measure(int iterations, Function function)
+{
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    function();
+  }
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+  const int entryCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+  const int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+  if (entryCount < 0 || iterations <= 0)
+  {
+    std::cerr << "Usage: ConfigBench [entries=10000] [iterations=20]" << std::endl;
+    return 1;
+  }
+
+  const AppConfig config = makeConfig(entryCount);
+  const std::string text = ConfigSerializer::write(config);
+
+  // 先确认两种方式读写的结果一致 再比较耗时
+  AppConfig loaded;
+  std::string error;
+  std::istringstream input(text);
+  if (!ConfigSerializer::read(input, loaded, error) || loaded != config)
+  {
+    std::cerr << "ConfigSerializer round-trip failed: " << error << std::endl;
+    return 1;
+  }
+  nlohmann::ordered_json document;
+  document["appConfig"] = config.toJson();
+  if (document.dump(4) != text)
+  {
+    std::cerr << "ConfigSerializer output differs from dump(4)" << std::endl;
+    return 1;
+  }
+
+  const double streamSave = measure(iterations, [&]()
+                                    { ConfigSerializer::write(config); });
+  const double saxLoad = measure(iterations, [&]()
+                                 {
+                                   AppConfig result;
+                                   std::istringstream stream(text);
+                                   ConfigSerializer::read(stream, result, error); });
+  const double domSave = measure(iterations, [&]()
+                                 {
+                                   nlohmann::ordered_json root;
+                                   root["appConfig"] = config.toJson();
+                                   root.dump(4); });
+  const double domLoad = measure(iterations, [&]()
+                                 {
+                                   std::istringstream stream(text);
+                                   const auto root = nlohmann::json::parse(stream);
+                                   AppConfig result;
+                                   result.fromJson(root["appConfig"]); });
+
+  std::cout << entryCount << " process entries, " << text.size() << " bytes, " << iterations << " iterations" << std::endl;
+  std::cout << "load: ConfigSerializer " << saxLoad << " ms, parse+fromJson " << domLoad << " ms" << std::endl;
+  std::cout << "save: ConfigSerializer " << streamSave << " ms, toJson+dump(4) " << domSave << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 15:24:18
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 15:24:18
+ * @FilePath: \GameOptimizerPro\tools\game_db_compiler\main.cpp
+ * @Description: 游戏数据库编译工具，把 JSON/CSV 格式的游戏数据库编译为程序运行时内存映射的二进制索引
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "config/process_info.h"
+#include "utils/game_db_format.h"
+
+// 编译前的一条数据库记录
+struct TitleSource
+{
+  std::string name;
+  GameDb::TitleType type = GameDb::TitleType::Game;
+  IoPriority ioPriority = IoPriority::UNCHANGED;
+  uint8_t flags = GameDb::FlagNone;
+  std::vector<std::string> processList;
+};
+
+static std::string toLower(std::string value)
+{
+  std::transform(value.begin(), value.end(), value.begin(), GameDb::toLowerAscii);
+  return value;
+}
+
+static std::string trim(const std::string &value)
+{
+  const auto begin = value.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos)
+  {
+    return "";
+  }
+  const auto end = value.find_last_not_of(" \t\r\n");
+  return value.substr(begin, end - begin + 1);
+}
+
+static bool parseTitleType(const std::string &value, GameDb::TitleType &type)
+{
+  if (value.empty() || value == "game")
+  {
+    type = GameDb::TitleType::Game;
+    return true;
+  }
+  if (value == "antiCheat")
+  {
+    type = GameDb::TitleType::AntiCheat;
+    return true;
+  }
+  return false;
+}
+
+// 解析 JSON 中的一条记录 字段与配置文件中的 ProcessInfo 一致
+static bool parseJsonTitle(const nlohmann::json &titleJson, GameDb::TitleType defaultType, TitleSource &title)
+{
+  title.name = titleJson.value("name", "");
+  title.type = defaultType;
+  if (titleJson.contains("type") && !parseTitleType(titleJson["type"].get<std::string>(), title.type))
+  {
+    std::cerr << "Unknown title type for: " << title.name << std::endl;
+    return false;
+  }
+  title.ioPriority = ProcessInfo::ioPriorityFromString(titleJson.value("ioPriority", ""));
+  if (titleJson.value("skipPrefetch", false))
+  {
+    title.flags |= GameDb::FlagSkipPrefetch;
+  }
+  if (titleJson.contains("processList"))
+  {
+    title.processList = titleJson["processList"].get<std::vector<std::string>>();
+  }
+  return true;
+}
+
+/**
+ * 支持三种 JSON 布局:
+ *   {"titles": [{"name", "type", "processList", "ioPriority", "skipPrefetch"}]}
+ *   {"gameProcessList": [...], "antiCheatProcessList": [...]}  与配置文件的 processConfig 相同
+ *   完整的 config.json
+ */
+static bool loadJson(const std::filesystem::path &inputPath, std::vector<TitleSource> &titles)
+{
+  std::ifstream input(inputPath, std::ios::binary);
+  nlohmann::json root;
+  try
+  {
+    root = nlohmann::json::parse(input);
+  }
+  catch (const nlohmann::json::exception &e)
+  {
+    std::cerr << "Failed to parse JSON: " << e.what() << std::endl;
+    return false;
+  }
+
+  if (root.contains("appConfig") && root["appConfig"].contains("processConfig"))
+  {
+    root = root["appConfig"]["processConfig"];
+  }
+
+  auto loadList = [&titles, &root](const char *key, GameDb::TitleType defaultType)
+  {
+    if (!root.contains(key))
+    {
+      return true;
+    }
+    for (const auto &titleJson : root[key])
+    {
+      TitleSource title;
+      if (!parseJsonTitle(titleJson, defaultType, title))
+      {
+        return false;
+      }
+      titles.push_back(std::move(title));
+    }
+    return true;
+  };
+
+  return loadList("titles", GameDb::TitleType::Game) &&
+         loadList("gameProcessList", GameDb::TitleType::Game) &&
+         loadList("antiCheatProcessList", GameDb::TitleType::AntiCheat);
+}
+
+// 按逗号拆分一行 CSV 支持双引号包裹含逗号的字段
+static std::vector<std::string> splitCsvLine(const std::string &line)
+{
+  std::vector<std::string> fields;
+  std::string field;
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    char c = line[i];
+    if (quoted)
+    {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+      {
+        field += '"';
+        ++i;
+      }
+      else if (c == '"')
+      {
+        quoted = false;
+      }
+      else
+      {
+        field += c;
+      }
+    }
+    else if (c == '"')
+    {
+      quoted = true;
+    }
+    else if (c == ',')
+    {
+      fields.push_back(trim(field));
+      field.clear();
+    }
+    else
+    {
+      field += c;
+    }
+  }
+  fields.push_back(trim(field));
+  return fields;
+}
+
+/**
+ * CSV 每行一条记录，# 开头的行为注释，首行可以是表头:
+ *   name,type,processList,ioPriority,skipPrefetch
+ * processList 中的多个可执行文件用 ; 分隔，type 为 game 或 antiCheat，后两列可省略
+ */
+static bool loadCsv(const std::filesystem::path &inputPath, std::vector<TitleSource> &titles)
+{
+  std::ifstream input(inputPath, std::ios::binary);
+  std::string line;
+  size_t lineNumber = 0;
+  bool firstRecord = true;
+  while (std::getline(input, line))
+  {
+    ++lineNumber;
+    // 跳过 UTF-8 BOM
+    if (lineNumber == 1 && line.compare(0, 3, "\xEF\xBB\xBF") == 0)
+    {
+      line.erase(0, 3);
+    }
+    line = trim(line);
+    if (line.empty() || line[0] == '#')
+    {
+      continue;
+    }
+
+    auto fields = splitCsvLine(line);
+    // 第一条记录可以是表头
+    if (firstRecord && fields[0] == "name")
+    {
+      firstRecord = false;
+      continue;
+    }
+    firstRecord = false;
+    if (fields.size() < 3)
+    {
+      std::cerr << inputPath.string() << ":" << lineNumber << ": expected at least 3 columns" << std::endl;
+      return false;
+    }
+
+    TitleSource title;
+    title.name = fields[0];
+    if (!parseTitleType(fields[1], title.type))
+    {
+      std::cerr << inputPath.string() << ":" << lineNumber << ": unknown type '" << fields[1] << "'" << std::endl;
+      return false;
+    }
+    std::stringstream processStream(fields[2]);
+    std::string processName;
+    while (std::getline(processStream, processName, ';'))
+    {
+      processName = trim(processName);
+      if (!processName.empty())
+      {
+        title.processList.push_back(processName);
+      }
+    }
+    if (fields.size() > 3)
+    {
+      title.ioPriority = ProcessInfo::ioPriorityFromString(fields[3]);
+    }
+    if (fields.size() > 4 && (fields[4] == "1" || fields[4] == "true"))
+    {
+      title.flags |= GameDb::FlagSkipPrefetch;
+    }
+    titles.push_back(std::move(title));
+  }
+  return true;
+}
+
+static uint32_t alignTo(size_t value, size_t alignment)
+{
+  return static_cast<uint32_t>((value + alignment - 1) / alignment * alignment);
+}
+
+static bool writeDatabase(const std::vector<TitleSource> &titles, const std::filesystem::path &outputPath)
+{
+  // 字符串表 相同的字符串只保存一次
+  std::string strings;
+  std::unordered_map<std::string, uint32_t> stringOffsets;
+  auto addString = [&strings, &stringOffsets](const std::string &value)
+  {
+    auto it = stringOffsets.find(value);
+    if (it != stringOffsets.end())
+    {
+      return it->second;
+    }
+    uint32_t offset = static_cast<uint32_t>(strings.size());
+    strings.append(value);
+    strings.push_back('\0');
+    stringOffsets.emplace(value, offset);
+    return offset;
+  };
+
+  std::vector<GameDb::TitleRecord> records;
+  std::vector<GameDb::ExeEntry> entries;
+  std::unordered_map<std::string, std::string> exeOwners;
+  for (const auto &title : titles)
+  {
+    if (title.name.empty() || title.processList.empty())
+    {
+      std::cerr << "Skipping title without name or processList: " << title.name << std::endl;
+      continue;
+    }
+
+    GameDb::TitleRecord record = {};
+    record.nameOffset = addString(title.name);
+    record.type = static_cast<uint8_t>(title.type);
+    record.ioPriority = static_cast<int8_t>(title.ioPriority);
+    record.flags = title.flags;
+    const uint32_t titleIndex = static_cast<uint32_t>(records.size());
+    records.push_back(record);
+
+    for (const auto &processName : title.processList)
+    {
+      std::string lowerName = toLower(processName);
+      if (lowerName.size() > GameDb::kMaxExeNameLength)
+      {
+        std::cerr << "Skipping executable name longer than " << GameDb::kMaxExeNameLength << ": " << processName << std::endl;
+        continue;
+      }
+      // 同一个可执行文件只归属于最先出现的条目
+      auto owner = exeOwners.emplace(lowerName, title.name);
+      if (!owner.second)
+      {
+        std::cerr << "Duplicate executable " << processName << " in '" << title.name
+                  << "', already owned by '" << owner.first->second << "'" << std::endl;
+        continue;
+      }
+
+      GameDb::ExeEntry entry = {};
+      entry.hash = GameDb::hashName(lowerName);
+      entry.nameOffset = addString(lowerName);
+      entry.titleIndex = titleIndex;
+      entries.push_back(entry);
+    }
+  }
+
+  // 桶数量取不小于条目数的 2 的幂 平均每桶不超过一个条目
+  uint32_t bucketCount = 1;
+  while (bucketCount < entries.size())
+  {
+    bucketCount <<= 1;
+  }
+  std::stable_sort(entries.begin(), entries.end(),
+                   [bucketCount](const GameDb::ExeEntry &a, const GameDb::ExeEntry &b)
+                   { return (a.hash & (bucketCount - 1)) < (b.hash & (bucketCount - 1)); });
+
+  std::vector<uint32_t> buckets(static_cast<size_t>(bucketCount) + 1, 0);
+  for (const auto &entry : entries)
+  {
+    ++buckets[(entry.hash & (bucketCount - 1)) + 1];
+  }
+  for (size_t i = 1; i < buckets.size(); ++i)
+  {
+    buckets[i] += buckets[i - 1];
+  }
+  if (strings.empty())
+  {
+    strings.push_back('\0');
+  }
+
+  GameDb::Header header = {};
+  std::memcpy(header.magic, GameDb::kMagic, sizeof(header.magic));
+  header.version = GameDb::kVersion;
+  header.titleCount = static_cast<uint32_t>(records.size());
+  header.entryCount = static_cast<uint32_t>(entries.size());
+  header.bucketCount = bucketCount;
+  header.titlesOffset = alignTo(sizeof(GameDb::Header), 8);
+  header.bucketsOffset = alignTo(header.titlesOffset + records.size() * sizeof(GameDb::TitleRecord), 8);
+  header.entriesOffset = alignTo(header.bucketsOffset + buckets.size() * sizeof(uint32_t), 8);
+  header.stringsOffset = alignTo(header.entriesOffset + entries.size() * sizeof(GameDb::ExeEntry), 8);
+  header.stringsSize = static_cast<uint32_t>(strings.size());
+  header.fileSize = header.stringsOffset + header.stringsSize;
+
+  std::vector<char> image(header.fileSize, 0);
+  std::memcpy(image.data(), &header, sizeof(header));
+  std::memcpy(image.data() + header.titlesOffset, records.data(), records.size() * sizeof(GameDb::TitleRecord));
+  std::memcpy(image.data() + header.bucketsOffset, buckets.data(), buckets.size() * sizeof(uint32_t));
+  std::memcpy(image.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(GameDb::ExeEntry));
+  std::memcpy(image.data() + header.stringsOffset, strings.data(), strings.size());
+
+  std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+  if (!output.write(image.data(), static_cast<std::streamsize>(image.size())))
+  {
+    std::cerr << "Failed to write " << outputPath.string() << std::endl;
+    return false;
+  }
+
+  std::cout << "Compiled " << header.titleCount << " titles, " << header.entryCount << " executables, "
+            << header.fileSize << " bytes -> " << outputPath.string() << std::endl;
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: GameDbCompiler <input.json|input.csv> <output.bin>" << std::endl;
+    return 2;
+  }
+
+  const std::filesystem::path inputPath = std::filesystem::u8path(argv[1]);
+  const std::filesystem::path outputPath = std::filesystem::u8path(argv[2]);
+  if (!std::filesystem::exists(inputPath))
+  {
+    std::cerr << "Input not found: " << inputPath.string() << std::endl;
+    return 1;
+  }
+
+  std::vector<TitleSource> titles;
+  const std::string extension = toLower(inputPath.extension().string());
+  bool loaded = extension == ".csv" ? loadCsv(inputPath, titles) : loadJson(inputPath, titles);
+  if (!loaded)
+  {
+    return 1;
+  }
+
+  return writeDatabase(titles, outputPath) ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:42:15
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:42:15
+ * @FilePath: \GameOptimizerPro\tools\log_bench\main.cpp
+ * @Description: 日志基准，测量同步和异步模式下调用方每次写日志的耗时，以及异步文本日志的吞吐量
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log/logging.h"
+
+using Clock = std::chrono::steady_clock;
+
+// 多个线程同时写日志 返回调用方平均每次调用的微秒数 不包含写线程落盘的时间
+static double measureProducer(bool async, int threadCount, int messageCount)
+{
+  Logging::Options options;
+  options.async = async;
+  Logging::configure(options);
+
+  std::vector<double> threadMicroseconds(threadCount, 0.0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; ++t)
+  {
+    threads.emplace_back([t, messageCount, &threadMicroseconds]()
+                         {
+                           const std::string processName = "game_client_win64_shipping.exe";
+                           const auto start = Clock::now();
+                           for (int i = 0; i < messageCount; ++i)
+                           {
+                             LOG_INFO("限制进程 " + processName + " PID: " + std::to_string(i) + " 线程: " + std::to_string(t));
+                           }
+                           threadMicroseconds[t] = std::chrono::duration<double, std::micro>(Clock::now() - start).count(); });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  double totalMicroseconds = 0.0;
+  for (double microseconds : threadMicroseconds)
+  {
+    totalMicroseconds += microseconds;
+  }
+  return totalMicroseconds / (static_cast<double>(threadCount) * messageCount);
+}
+
+static int runProducer(int threadCount, int messageCount)
+{
+  // 先测同步模式 切换到异步时不需要等待队列写完
+  const double syncMicroseconds = measureProducer(false, threadCount, messageCount);
+  const double asyncMicroseconds = measureProducer(true, threadCount, messageCount);
+  std::cout << threadCount << " threads x " << messageCount << " messages" << std::endl;
+  std::cout << "producer: sync " << syncMicroseconds << " us/call, async " << asyncMicroseconds << " us/call" << std::endl;
+  return 0;
+}
+
+// 单线程写 recordCount 条 WARN 记录 包含格式化参数、窄字符串和宽字符串拼接三种调用
+// 计时到 shutdown 写完全部记录为止
+static int runThroughput(const std::filesystem::path &logFilePath, int recordCount)
+{
+  Logging::Options options;
+  options.async = true;
+  options.flushPolicy = Logging::FlushPolicy::Interval;
+  Logging::configure(options);
+
+  const std::wstring processName = L"game_client_win64_shipping.exe";
+  const std::string registryMessage = "registry value HKLM\\SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters updated";
+  const auto start = Clock::now();
+  for (int i = 0; i < recordCount; ++i)
+  {
+    switch (i % 3)
+    {
+    case 0:
+      LOG_WARN_FMT("process started: {} PID: {}", processName, i);
+      break;
+    case 1:
+      LOG_WARN(registryMessage);
+      break;
+    default:
+      LOG_WARN(L"wide message " + processName);
+      break;
+    }
+  }
+  Logging::shutdown();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::error_code errorCode;
+  const auto fileBytes = std::filesystem::file_size(logFilePath, errorCode);
+  std::cout << recordCount << " records in " << seconds << " s: " << static_cast<uint64_t>(recordCount / seconds)
+            << " records/s, " << (errorCode ? 0.0 : static_cast<double>(fileBytes) / seconds / 1e6) << " MB/s" << std::endl;
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  const std::string mode = argc > 1 ? argv[1] : "";
+  if (mode != "producer" && mode != "throughput")
+  {
+    std::cerr << "Usage: LogBench producer [threads=4] [messages=1500]" << std::endl;
+    std::cerr << "       LogBench throughput [records=1000000]" << std::endl;
+    return 1;
+  }
+
+  // 日志写到临时目录 每次运行前清空
+  const auto logDirectory = std::filesystem::temp_directory_path() / "GameOptimizerProLogBench";
+  std::error_code errorCode;
+  std::filesystem::remove_all(logDirectory, errorCode);
+  const auto logFilePath = logDirectory / "bench.log";
+  if (!Logging::initialize(logFilePath.wstring()))
+  {
+    std::cerr << "Failed to initialize logging in " << logDirectory.string() << std::endl;
+    return 1;
+  }
+
+  if (mode == "throughput")
+  {
+    const int recordCount = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    if (recordCount <= 0)
+    {
+      Logging::shutdown();
+      return 1;
+    }
+    // runThroughput 计时包含 shutdown
+    return runThroughput(logFilePath, recordCount);
+  }
+
+  const int threadCount = argc > 2 ? std::atoi(argv[2]) : 4;
+  const int messageCount = argc > 3 ? std::atoi(argv[3]) : 1500;
+  const int result = threadCount > 0 && messageCount > 0 ? runProducer(threadCount, messageCount) : 1;
+  Logging::shutdown();
+  return result;
+}
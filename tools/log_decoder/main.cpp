@@ -0,0 +1,254 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 17:48:06
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 17:48:06
+ * @FilePath: \GameOptimizerPro\tools\log_decoder\main.cpp
+ * @Description: 二进制日志解码工具，把 .binlog 文件转换为与文本日志相同格式的 UTF-8 文本
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "log/binlog_format.h"
+
+// 文件中定义的日志点
+struct SiteDefinition
+{
+  uint8_t level = 0;
+  int32_t line = 0;
+  std::string function;
+  std::string file;
+  std::string format;
+};
+
+// 按顺序读取记录字段 数据不足时置为失败
+class Reader
+{
+public:
+  Reader(const char *data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+  template <typename T>
+  bool read(T &value)
+  {
+    if (static_cast<size_t>(m_end - m_cursor) < sizeof(T))
+    {
+      return false;
+    }
+    std::memcpy(&value, m_cursor, sizeof(T));
+    m_cursor += sizeof(T);
+    return true;
+  }
+
+  bool readBytes(size_t size, const char *&data)
+  {
+    if (static_cast<size_t>(m_end - m_cursor) < size)
+    {
+      return false;
+    }
+    data = m_cursor;
+    m_cursor += size;
+    return true;
+  }
+
+  bool atEnd() const { return m_cursor >= m_end; }
+
+private:
+  const char *m_cursor;
+  const char *m_end;
+};
+
+// FILETIME(UTC) 转为本地时间 与文本日志的时间格式一致
+static void appendTimestamp(std::string &output, uint64_t timestamp)
+{
+  constexpr uint64_t kUnixEpoch = 116444736000000000ULL;
+  const uint64_t ticks = timestamp > kUnixEpoch ? timestamp - kUnixEpoch : 0;
+  const std::time_t seconds = static_cast<std::time_t>(ticks / 10000000ULL);
+  const unsigned milliseconds = static_cast<unsigned>((ticks / 10000ULL) % 1000ULL);
+
+  std::tm localTime = {};
+#if defined(_WIN32)
+  localtime_s(&localTime, &seconds);
+#else
+  localtime_r(&seconds, &localTime);
+#endif
+
+  char timeBuf[64];
+  std::snprintf(timeBuf, sizeof(timeBuf), "[%04d-%02d-%02d %02d:%02d:%02d.%03u]",
+                localTime.tm_year + 1900, localTime.tm_mon + 1, localTime.tm_mday,
+                localTime.tm_hour, localTime.tm_min, localTime.tm_sec, milliseconds);
+  output += timeBuf;
+}
+
+static const char *levelName(uint8_t level)
+{
+  // 与 Logging::LogLevel 的顺序一致
+  switch (level)
+  {
+  case 0:
+    return "INFO";
+  case 1:
+    return "WARN";
+  case 2:
+    return "ERROR";
+  case 3:
+    return "DEBUG";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+static bool decode(const std::vector<char> &content, std::ostream &output)
+{
+  if (content.size() < sizeof(BinLog::FileHeader))
+  {
+    std::cerr << "Not a binary log file" << std::endl;
+    return false;
+  }
+
+  BinLog::FileHeader fileHeader;
+  std::memcpy(&fileHeader, content.data(), sizeof(fileHeader));
+  if (std::memcmp(fileHeader.magic, BinLog::kMagic, sizeof(fileHeader.magic)) != 0)
+  {
+    std::cerr << "Not a binary log file" << std::endl;
+    return false;
+  }
+  if (fileHeader.version != BinLog::kVersion)
+  {
+    std::cerr << "Unsupported binary log version: " << fileHeader.version << std::endl;
+    return false;
+  }
+
+  Reader reader(content.data() + sizeof(fileHeader), content.size() - sizeof(fileHeader));
+  std::unordered_map<uint32_t, SiteDefinition> sites;
+  std::string line;
+  size_t events = 0;
+
+  while (!reader.atEnd())
+  {
+    uint8_t type = 0;
+    uint32_t siteId = 0;
+    if (!reader.read(type) || !reader.read(siteId))
+    {
+      break;
+    }
+
+    if (type == static_cast<uint8_t>(BinLog::RecordType::Site))
+    {
+      // 程序重新启动后追加写入时会重新定义日志点 以最新的定义为准
+      SiteDefinition site;
+      uint16_t functionBytes = 0;
+      uint16_t fileBytes = 0;
+      uint32_t formatBytes = 0;
+      const char *function = nullptr;
+      const char *file = nullptr;
+      const char *format = nullptr;
+      if (!reader.read(site.level) || !reader.read(site.line) ||
+          !reader.read(functionBytes) || !reader.readBytes(functionBytes, function) ||
+          !reader.read(fileBytes) || !reader.readBytes(fileBytes, file) ||
+          !reader.read(formatBytes) || !reader.readBytes(formatBytes, format))
+      {
+        std::cerr << "Truncated site record, stopping" << std::endl;
+        break;
+      }
+      site.function.assign(function, functionBytes);
+      site.file.assign(file, fileBytes);
+      site.format.assign(format, formatBytes);
+      sites[siteId] = std::move(site);
+      continue;
+    }
+
+    if (type != static_cast<uint8_t>(BinLog::RecordType::Event))
+    {
+      std::cerr << "Unknown record type " << static_cast<int>(type) << ", stopping" << std::endl;
+      break;
+    }
+
+    uint64_t timestamp = 0;
+    int32_t hr = 0;
+    uint32_t argsBytes = 0;
+    const char *args = nullptr;
+    if (!reader.read(timestamp) || !reader.read(hr) || !reader.read(argsBytes) || !reader.readBytes(argsBytes, args))
+    {
+      // 程序异常退出时最后一条记录可能不完整
+      std::cerr << "Truncated event record, stopping" << std::endl;
+      break;
+    }
+
+    auto it = sites.find(siteId);
+    if (it == sites.end())
+    {
+      std::cerr << "Event references undefined site " << siteId << ", skipped" << std::endl;
+      continue;
+    }
+    const SiteDefinition &site = it->second;
+
+    // [YYYY-MM-DD HH:MM:SS.ms][LEVEL][Function:Line] Message (HRESULT: 0x...)
+    line.clear();
+    appendTimestamp(line, timestamp);
+    line += "[";
+    line += levelName(site.level);
+    line += "][";
+    line += site.function;
+    line += ":";
+    BinLog::appendNumber(line, site.line);
+    line += "] ";
+    BinLog::render(
+        site.format.c_str(), args, argsBytes,
+        [&line](const char *text, size_t length)
+        { line.append(text, length); },
+        [&line](const BinLog::Arg &arg)
+        { BinLog::appendArgText(line, arg); });
+    if (hr < 0)
+    {
+      char hrBuf[32];
+      std::snprintf(hrBuf, sizeof(hrBuf), " (HRESULT: 0x%08X)", static_cast<unsigned int>(hr));
+      line += hrBuf;
+    }
+    line += "\n";
+    output.write(line.data(), static_cast<std::streamsize>(line.size()));
+    ++events;
+  }
+
+  std::cerr << "Decoded " << events << " records, " << sites.size() << " log sites" << std::endl;
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2 && argc != 3)
+  {
+    std::cerr << "Usage: LogDecoder <input.binlog> [output.log]" << std::endl;
+    return 2;
+  }
+
+  const std::filesystem::path inputPath = std::filesystem::u8path(argv[1]);
+  std::ifstream input(inputPath, std::ios::binary);
+  if (!input)
+  {
+    std::cerr << "Input not found: " << inputPath.string() << std::endl;
+    return 1;
+  }
+  const std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+  if (argc == 3)
+  {
+    std::ofstream output(std::filesystem::u8path(argv[2]), std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+      std::cerr << "Cannot write output: " << argv[2] << std::endl;
+      return 1;
+    }
+    return decode(content, output) ? 0 : 1;
+  }
+  return decode(content, std::cout) ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/*
+ * @Author: vdavidyang vdavidyang@gmail.com
+ * @Date: 2026-10-19 23:55:20
+ * @LastEditors: vdavidyang vdavidyang@gmail.com
+ * @LastEditTime: 2026-10-19 23:55:20
+ * @FilePath: \GameOptimizerPro\tools\registry_bench\main.cpp
+ * @Description: 注册表基准，在 MemoryRegistryBackend 上比较逐值写入和 RegistryBatch 批量写入的打开次数和耗时
+ * Copyright (c) 2026 by vdavidyang vdavidyang@gmail.com, All Rights Reserved.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/registry_backend.h"
+#include "core/registry_manager.h"
+#include "log/logging.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+  const std::string kInterfacesPath = "SYSTEM\\CurrentControlSet\\Services\\Tcpip\\Parameters\\Interfaces\\";
+  const std::string kImageOptionsPath = "SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion\\Image File Execution Options\\";
+  const char *const kPerfOptionValues[] = {"CpuPriorityClass", "IoPriority", "MemoryPriority"};
+
+  // 一种写法的测量结果 每次开关的平均值
+  struct Sample
+  {
+    double microseconds = 0.0;
+    double opens = 0.0;
+  };
+
+  // 执行 iterations 次开关 参数为本次开关的序号 奇偶交替写入不同的值 避免批量写入跳过未变化的值
+  template <typename Function>
+  Sample measure(MemoryRegistryBackend &backend, int iterations, Function function)
+  {
+    const uint64_t openCount = backend.openCount();
+    const auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+      function(i);
+    }
+    Sample sample;
+    sample.microseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+    sample.opens = static_cast<double>(backend.openCount() - openCount) / iterations;
+    return sample;
+  }
+
+  void printSample(const std::string &name, const Sample &perValue, const Sample &batch)
+  {
+    std::cout << name << ": per-value " << perValue.opens << " opens " << perValue.microseconds << " us, batch "
+              << batch.opens << " opens " << batch.microseconds << " us" << std::endl;
+  }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+  if (iterations <= 0)
+  {
+    std::cerr << "Usage: RegistryBench [iterations=20000]" << std::endl;
+    return 1;
+  }
+
+  // 日志写到临时目录 每次运行前清空
+  const auto logDirectory = std::filesystem::temp_directory_path() / "GameOptimizerProRegistryBench";
+  std::error_code errorCode;
+  std::filesystem::remove_all(logDirectory, errorCode);
+  if (!Logging::initialize((logDirectory / "bench.log").wstring()))
+  {
+    std::cerr << "Failed to initialize logging in " << logDirectory.string() << std::endl;
+    return 1;
+  }
+
+  // RegistryManager 持有后端 保留指针读取打开次数
+  auto ownedBackend = std::make_unique<MemoryRegistryBackend>();
+  MemoryRegistryBackend &backend = *ownedBackend;
+  RegistryManager registryManager(std::move(ownedBackend));
+
+  // 与网络延迟优化相同 8 张网卡 每张写 2 个值
+  std::vector<std::string> interfaces;
+  for (int i = 0; i < 8; ++i)
+  {
+    const std::string path = kInterfacesPath + "{0000000" + std::to_string(i) + "-AAAA-BBBB-CCCC-DDDDDDDDDDDD}";
+    HKEY hKey;
+    if (backend.createKey(HKEY_LOCAL_MACHINE, path, KEY_WRITE, hKey) == ERROR_SUCCESS)
+    {
+      backend.closeKey(hKey);
+    }
+    interfaces.push_back(path);
+  }
+
+  const Sample networkPerValue = measure(backend, iterations, [&](int i)
+                                         {
+                                           const DWORD value = static_cast<DWORD>(i % 2);
+                                           for (const auto &path : interfaces)
+                                           {
+                                             registryManager.setRegistryDWORDValue(HKEY_LOCAL_MACHINE, path, "TcpAckFrequency", value);
+                                             registryManager.setRegistryDWORDValue(HKEY_LOCAL_MACHINE, path, "TCPNoDelay", value);
+                                           } });
+  const Sample networkBatch = measure(backend, iterations, [&](int i)
+                                      {
+                                        const DWORD value = static_cast<DWORD>(i % 2);
+                                        RegistryBatch batch;
+                                        for (const auto &path : interfaces)
+                                        {
+                                          batch.setDWORD(HKEY_LOCAL_MACHINE, path, "TcpAckFrequency", value);
+                                          batch.setDWORD(HKEY_LOCAL_MACHINE, path, "TCPNoDelay", value);
+                                        }
+                                        registryManager.applyBatch(batch); });
+
+  // 与游戏优化相同 4 个进程 每个进程创建 PerfOptions 项并写 3 个值
+  // createRegistryKey 只创建最后一级 先创建父项
+  HKEY hImageOptionsKey;
+  if (backend.createKey(HKEY_LOCAL_MACHINE, kImageOptionsPath, KEY_WRITE, hImageOptionsKey) == ERROR_SUCCESS)
+  {
+    backend.closeKey(hImageOptionsKey);
+  }
+  const std::vector<std::string> processes = {"game.exe", "launcher.exe", "crash.exe", "anticheat.exe"};
+  const Sample gamePerValue = measure(backend, iterations, [&](int i)
+                                      {
+                                        const DWORD value = static_cast<DWORD>(2 + i % 2);
+                                        for (const auto &process : processes)
+                                        {
+                                          registryManager.createRegistryKey(HKEY_LOCAL_MACHINE, kImageOptionsPath, process);
+                                          registryManager.createRegistryKey(HKEY_LOCAL_MACHINE, kImageOptionsPath + process, "PerfOptions");
+                                          for (const char *valueName : kPerfOptionValues)
+                                          {
+                                            registryManager.setRegistryDWORDValue(HKEY_LOCAL_MACHINE, kImageOptionsPath + process + "\\PerfOptions", valueName, value);
+                                          }
+                                        } });
+  const Sample gameBatch = measure(backend, iterations, [&](int i)
+                                   {
+                                     const DWORD value = static_cast<DWORD>(2 + i % 2);
+                                     RegistryBatch batch;
+                                     for (const auto &process : processes)
+                                     {
+                                       const std::string path = kImageOptionsPath + process + "\\PerfOptions";
+                                       batch.createKey(HKEY_LOCAL_MACHINE, path);
+                                       for (const char *valueName : kPerfOptionValues)
+                                       {
+                                         batch.setDWORD(HKEY_LOCAL_MACHINE, path, valueName, value);
+                                       }
+                                     }
+                                     registryManager.applyBatch(batch); });
+
+  // 存在性检查复用缓存的只读句柄
+  int found = 0;
+  const Sample check = measure(backend, iterations, [&](int)
+                               {
+                                 for (const auto &process : processes)
+                                 {
+                                   found += registryManager.checkRegistryKey(HKEY_LOCAL_MACHINE, kImageOptionsPath, process) ? 1 : 0;
+                                 }
+                               });
+
+  std::cout << iterations << " toggles per case, opens and time per toggle" << std::endl;
+  printSample("network delay 8 NICs x 2 values", networkPerValue, networkBatch);
+  printSample("game perf options 4 processes", gamePerValue, gameBatch);
+  std::cout << "checkRegistryKey: " << iterations * static_cast<int>(processes.size()) << " checks, "
+            << check.opens * iterations << " opens in total, " << found << " found" << std::endl;
+
+  Logging::shutdown();
+  return 0;
+}